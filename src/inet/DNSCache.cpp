@@ -0,0 +1,338 @@
+/*
+ *
+ *    Copyright (c) 2018 Google LLC.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements DNSCache, the cache of recent host name
+ *      resolutions consulted by InetLayer::ResolveHostAddress().
+ *
+ */
+
+#include <InetLayer/InetLayer.h>
+#include <InetLayer/DNSCache.h>
+
+#if INET_CONFIG_ENABLE_DNS_CACHE
+
+#include <string.h>
+
+#include <Weave/Support/CodeUtils.h>
+
+namespace nl {
+namespace Inet {
+
+using Weave::System::Layer;
+
+/**
+ *  Set the function used to resolve host names in place of the platform resolver, or restore the platform resolver.
+ *  The stub is called from the event loop, after the request that caused the lookup has returned, so that concurrent
+ *  requests are coalesced exactly as they are with an asynchronous resolver.
+ *
+ *  @note
+ *    Resolutions already cached are kept; call Flush() to discard them.
+ *
+ *  @param[in]  aStubResolver   The stub resolver, or NULL to use the platform resolver.
+ */
+void DNSCache::SetStubResolver(StubResolveFunct aStubResolver)
+{
+    mStubResolver = aStubResolver;
+}
+
+/**
+ *  Discard all cached resolutions. Resolutions in progress are unaffected, and are cached when they complete.
+ */
+void DNSCache::Flush(void)
+{
+    for (size_t i = 0; i < INET_CONFIG_DNS_CACHE_SIZE; i++)
+    {
+        if (mEntries[i].mState != kEntryState_Pending)
+            mEntries[i].mState = kEntryState_Empty;
+    }
+}
+
+/**
+ *  @param[out] aOutStats   The counters of the requests answered by the cache since the InetLayer was initialized.
+ */
+void DNSCache::GetStats(Stats &aOutStats) const
+{
+    aOutStats = mStats;
+}
+
+void DNSCache::Init(InetLayer &aInet)
+{
+    mInet = &aInet;
+    mStubResolver = NULL;
+    memset(&mStats, 0, sizeof(mStats));
+
+    for (size_t i = 0; i < INET_CONFIG_DNS_CACHE_SIZE; i++)
+    {
+        mEntries[i].mCache = this;
+        mEntries[i].mState = kEntryState_Empty;
+        mEntries[i].mLookupId = 0;
+    }
+
+    for (size_t i = 0; i < INET_CONFIG_DNS_CACHE_MAX_WAITERS; i++)
+        mWaiters[i].mEntry = NULL;
+}
+
+// Drop all entries and waiters, without calling the waiters back. The platform lookups in progress are canceled by
+// InetLayer::Shutdown() along with all other DNS requests.
+void DNSCache::Shutdown(void)
+{
+    for (size_t i = 0; i < INET_CONFIG_DNS_CACHE_SIZE; i++)
+        mEntries[i].mState = kEntryState_Empty;
+
+    for (size_t i = 0; i < INET_CONFIG_DNS_CACHE_MAX_WAITERS; i++)
+        mWaiters[i].mEntry = NULL;
+}
+
+// Answer a request for a host name that is not a text-form address. A fresh cached resolution is reported to the
+// caller before returning; otherwise the caller waits for the lookup in progress for the host name, starting one if
+// there is none.
+INET_ERROR DNSCache::Resolve(const char *hostName, uint16_t hostNameLen, uint8_t options, uint8_t maxAddrs,
+                             IPAddress *addrArray, DNSResolver::OnResolveCompleteFunct onComplete, void *appState)
+{
+    INET_ERROR err = INET_NO_ERROR;
+    const uint64_t nowMS = Layer::GetClock_MonotonicMS();
+    Entry *entry = FindEntry(hostName, hostNameLen, options);
+    Waiter *waiter = NULL;
+
+    // Answer from a fresh resolution.
+    if (entry != NULL && entry->mState != kEntryState_Pending && nowMS < entry->mExpiryMS)
+    {
+        uint8_t numAddrs = (entry->mNumAddrs < maxAddrs) ? entry->mNumAddrs : maxAddrs;
+
+        entry->mLastUseMS = nowMS;
+
+        if (entry->mState == kEntryState_Resolved)
+            mStats.Hits++;
+        else
+            mStats.NegativeHits++;
+
+        memcpy(addrArray, entry->mAddrs, numAddrs * sizeof(IPAddress));
+
+        if (onComplete != NULL)
+            onComplete(appState, entry->mError, numAddrs, addrArray);
+
+        ExitNow();
+    }
+
+    waiter = AllocWaiter();
+    VerifyOrExit(waiter != NULL, err = INET_ERROR_NO_MEMORY);
+
+    if (entry == NULL)
+    {
+        entry = AllocEntry();
+        VerifyOrExit(entry != NULL, err = INET_ERROR_NO_MEMORY);
+
+        memcpy(entry->mHostName, hostName, hostNameLen);
+        entry->mHostName[hostNameLen] = 0;
+        entry->mOptions = options;
+    }
+
+    waiter->mEntry = entry;
+    waiter->mMaxAddrs = maxAddrs;
+    waiter->mAddrArray = addrArray;
+    waiter->mOnComplete = onComplete;
+    waiter->mAppState = appState;
+
+    // Wait for the lookup already in progress.
+    if (entry->mState == kEntryState_Pending)
+    {
+        waiter->mLookupId = entry->mLookupId;
+        mStats.Coalesced++;
+        ExitNow();
+    }
+
+    // Otherwise start one; the entry is either new or stale.
+    entry->mState = kEntryState_Pending;
+    entry->mLastUseMS = nowMS;
+    entry->mLookupId++;
+    waiter->mLookupId = entry->mLookupId;
+
+    err = StartLookup(*entry);
+    if (err != INET_NO_ERROR)
+    {
+        // The lookup was never started, so no one else can be waiting for it.
+        entry->mState = kEntryState_Empty;
+        waiter->mEntry = NULL;
+    }
+
+exit:
+    return err;
+}
+
+// Remove the first waiter matching the completion function and application state, returning whether there was one. The
+// lookup it waited for continues, and its result is cached.
+bool DNSCache::Cancel(DNSResolver::OnResolveCompleteFunct onComplete, void *appState)
+{
+    for (size_t i = 0; i < INET_CONFIG_DNS_CACHE_MAX_WAITERS; i++)
+    {
+        Waiter &waiter = mWaiters[i];
+
+        if (waiter.mEntry != NULL && waiter.mOnComplete == onComplete && waiter.mAppState == appState)
+        {
+            waiter.mEntry = NULL;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+DNSCache::Entry *DNSCache::FindEntry(const char *hostName, uint16_t hostNameLen, uint8_t options)
+{
+    for (size_t i = 0; i < INET_CONFIG_DNS_CACHE_SIZE; i++)
+    {
+        Entry &entry = mEntries[i];
+
+        if (entry.mState != kEntryState_Empty && entry.mOptions == options &&
+            strncmp(entry.mHostName, hostName, hostNameLen) == 0 && entry.mHostName[hostNameLen] == 0)
+        {
+            return &entry;
+        }
+    }
+
+    return NULL;
+}
+
+// Find a free entry, evicting the least recently used resolution if necessary. Entries with lookups in progress are never
+// evicted.
+DNSCache::Entry *DNSCache::AllocEntry(void)
+{
+    Entry *lruEntry = NULL;
+
+    for (size_t i = 0; i < INET_CONFIG_DNS_CACHE_SIZE; i++)
+    {
+        Entry &entry = mEntries[i];
+
+        if (entry.mState == kEntryState_Empty)
+            return &entry;
+
+        if (entry.mState != kEntryState_Pending && (lruEntry == NULL || entry.mLastUseMS < lruEntry->mLastUseMS))
+            lruEntry = &entry;
+    }
+
+    return lruEntry;
+}
+
+DNSCache::Waiter *DNSCache::AllocWaiter(void)
+{
+    for (size_t i = 0; i < INET_CONFIG_DNS_CACHE_MAX_WAITERS; i++)
+    {
+        if (mWaiters[i].mEntry == NULL)
+            return &mWaiters[i];
+    }
+
+    return NULL;
+}
+
+INET_ERROR DNSCache::StartLookup(Entry &aEntry)
+{
+    mStats.Lookups++;
+
+    if (mStubResolver != NULL)
+        return mInet->SystemLayer()->ScheduleWork(HandleStubLookup, &aEntry);
+
+    // Recognized by InetLayer::ResolveHostAddress(), which passes the request straight to the resolver.
+    return mInet->ResolveHostAddress(aEntry.mHostName, static_cast<uint16_t>(strlen(aEntry.mHostName)), aEntry.mOptions,
+                                     INET_CONFIG_DNS_CACHE_MAX_ADDRS, aEntry.mAddrs, HandleLookupComplete, &aEntry);
+}
+
+// Cache the result of a lookup and report it to the requests waiting for it.
+void DNSCache::CompleteLookup(Entry &aEntry, INET_ERROR aError, uint8_t aNumAddrs, uint32_t aTTLSecs)
+{
+    const uint16_t lookupId = aEntry.mLookupId;
+    IPAddress addrs[INET_CONFIG_DNS_CACHE_MAX_ADDRS];
+
+    if (aError != INET_NO_ERROR)
+        aNumAddrs = 0;
+    else if (aNumAddrs > INET_CONFIG_DNS_CACHE_MAX_ADDRS)
+        aNumAddrs = INET_CONFIG_DNS_CACHE_MAX_ADDRS;
+
+    aEntry.mError = aError;
+    aEntry.mNumAddrs = aNumAddrs;
+    aEntry.mExpiryMS = Layer::GetClock_MonotonicMS() + static_cast<uint64_t>(aTTLSecs) * 1000;
+
+    // Answers from the name service are cached; local failures, such as a full resolver pool, are not.
+    if (aError == INET_NO_ERROR)
+        aEntry.mState = kEntryState_Resolved;
+    else if (aError == INET_ERROR_HOST_NOT_FOUND || aError == INET_ERROR_DNS_TRY_AGAIN || aError == INET_ERROR_DNS_NO_RECOVERY)
+        aEntry.mState = kEntryState_Failed;
+    else
+        aEntry.mState = kEntryState_Empty;
+
+    // The callbacks may make new requests, which can evict the entry and reuse it for another lookup, so work from a copy
+    // of the result and only call back the waiters of this lookup.
+    memcpy(addrs, aEntry.mAddrs, aNumAddrs * sizeof(IPAddress));
+
+    for (size_t i = 0; i < INET_CONFIG_DNS_CACHE_MAX_WAITERS; i++)
+    {
+        Waiter &waiter = mWaiters[i];
+        uint8_t numAddrs = (aNumAddrs < waiter.mMaxAddrs) ? aNumAddrs : waiter.mMaxAddrs;
+
+        if (waiter.mEntry != &aEntry || waiter.mLookupId != lookupId)
+            continue;
+
+        waiter.mEntry = NULL;
+        memcpy(waiter.mAddrArray, addrs, numAddrs * sizeof(IPAddress));
+
+        if (waiter.mOnComplete != NULL)
+            waiter.mOnComplete(waiter.mAppState, aError, numAddrs, waiter.mAddrArray);
+    }
+}
+
+void DNSCache::HandleLookupComplete(void *appState, INET_ERROR err, uint8_t addrCount, IPAddress *addrArray)
+{
+    Entry &entry = *static_cast<Entry *>(appState);
+
+    entry.mCache->CompleteLookup(entry, err, addrCount,
+                                 (err == INET_NO_ERROR) ? INET_CONFIG_DNS_CACHE_POSITIVE_TTL : INET_CONFIG_DNS_CACHE_NEGATIVE_TTL);
+}
+
+void DNSCache::HandleStubLookup(Layer *aLayer, void *aAppState, Weave::System::Error aError)
+{
+    Entry &entry = *static_cast<Entry *>(aAppState);
+    DNSCache &cache = *entry.mCache;
+    uint8_t numAddrs = 0;
+    uint32_t ttlSecs = 0;
+    INET_ERROR err;
+
+    // The entry may have been dropped by InetLayer::Shutdown(), or its lookup already run by an earlier call scheduled
+    // for the same entry.
+    if (entry.mState != kEntryState_Pending)
+        return;
+
+    // Fail the waiters, without caching the failure, if the stub was removed before it could be called.
+    if (cache.mStubResolver == NULL)
+    {
+        cache.CompleteLookup(entry, INET_ERROR_INCORRECT_STATE, 0, 0);
+        return;
+    }
+
+    err = cache.mStubResolver(entry.mHostName, entry.mOptions, INET_CONFIG_DNS_CACHE_MAX_ADDRS, entry.mAddrs, numAddrs, ttlSecs);
+
+    if (ttlSecs == 0)
+        ttlSecs = (err == INET_NO_ERROR) ? INET_CONFIG_DNS_CACHE_POSITIVE_TTL : INET_CONFIG_DNS_CACHE_NEGATIVE_TTL;
+
+    cache.CompleteLookup(entry, err, numAddrs, ttlSecs);
+}
+
+} // namespace Inet
+} // namespace nl
+
+#endif // INET_CONFIG_ENABLE_DNS_CACHE
@@ -0,0 +1,150 @@
+/*
+ *
+ *    Copyright (c) 2018 Google LLC.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file defines DNSCache, the cache of recent host name
+ *      resolutions consulted by InetLayer::ResolveHostAddress().
+ *
+ */
+
+#ifndef DNSCACHE_H
+#define DNSCACHE_H
+
+#include <InetLayer/DNSResolver.h>
+
+#include <SystemLayer/SystemLayer.h>
+
+#if INET_CONFIG_ENABLE_DNS_CACHE
+
+namespace nl {
+namespace Inet {
+
+class InetLayer;
+
+/**
+ *  @class DNSCache
+ *
+ *  @brief
+ *    A cache of recent host name resolutions, successful and failed,
+ *    which also coalesces concurrent requests for the same host name
+ *    into a single lookup.
+ *
+ *  @details
+ *    Entries are keyed by host name and DNS options. Lookups are made
+ *    with the platform resolver or, if one is set, with a stub resolver,
+ *    which lets tests and tools answer requests without a name server.
+ */
+class NL_DLL_EXPORT DNSCache
+{
+public:
+    /**
+     * @brief   Type of a stub resolver function.
+     *
+     * @param[in]   hostName    The NUL-terminated host name to resolve.
+     * @param[in]   options     The #DNSOptions of the request.
+     * @param[in]   maxAddrs    The size of \c addrArray.
+     * @param[out]  addrArray   The array to fill with the resolved addresses.
+     * @param[out]  numAddrs    The number of addresses stored in \c addrArray.
+     * @param[out]  ttlSecs     The time to live of the answer, in seconds. If left at 0, the answer is cached for
+     *                          #INET_CONFIG_DNS_CACHE_POSITIVE_TTL or #INET_CONFIG_DNS_CACHE_NEGATIVE_TTL.
+     *
+     * @return #INET_NO_ERROR if the host name was resolved, otherwise the error to report to the callers, such as
+     *         #INET_ERROR_HOST_NOT_FOUND.
+     */
+    typedef INET_ERROR (*StubResolveFunct)(const char *hostName, uint8_t options, uint8_t maxAddrs, IPAddress *addrArray,
+                                           uint8_t &numAddrs, uint32_t &ttlSecs);
+
+    /**
+     *  Counters of the requests answered by the cache.
+     */
+    struct Stats
+    {
+        uint32_t Hits;                  /**< Requests answered from a cached successful resolution. */
+        uint32_t NegativeHits;          /**< Requests answered from a cached failed resolution. */
+        uint32_t Coalesced;             /**< Requests that waited for a resolution already in progress. */
+        uint32_t Lookups;               /**< Resolutions started. */
+    };
+
+    void SetStubResolver(StubResolveFunct aStubResolver);
+    void Flush(void);
+    void GetStats(Stats &aOutStats) const;
+
+private:
+    friend class InetLayer;
+
+    enum
+    {
+        kEntryState_Empty       = 0,
+        kEntryState_Pending     = 1,
+        kEntryState_Resolved    = 2,
+        kEntryState_Failed      = 3
+    };
+
+    struct Entry
+    {
+        DNSCache *mCache;
+        uint64_t mExpiryMS;
+        uint64_t mLastUseMS;
+        INET_ERROR mError;
+        uint16_t mLookupId;
+        uint8_t mState;
+        uint8_t mOptions;
+        uint8_t mNumAddrs;
+        IPAddress mAddrs[INET_CONFIG_DNS_CACHE_MAX_ADDRS];
+        char mHostName[NL_DNS_HOSTNAME_MAX_LEN + 1];
+    };
+
+    struct Waiter
+    {
+        Entry *mEntry;
+        uint16_t mLookupId;
+        uint8_t mMaxAddrs;
+        IPAddress *mAddrArray;
+        DNSResolver::OnResolveCompleteFunct mOnComplete;
+        void *mAppState;
+    };
+
+    InetLayer *mInet;
+    StubResolveFunct mStubResolver;
+    Stats mStats;
+    Entry mEntries[INET_CONFIG_DNS_CACHE_SIZE];
+    Waiter mWaiters[INET_CONFIG_DNS_CACHE_MAX_WAITERS];
+
+    void Init(InetLayer &aInet);
+    void Shutdown(void);
+
+    INET_ERROR Resolve(const char *hostName, uint16_t hostNameLen, uint8_t options, uint8_t maxAddrs, IPAddress *addrArray,
+                       DNSResolver::OnResolveCompleteFunct onComplete, void *appState);
+    bool Cancel(DNSResolver::OnResolveCompleteFunct onComplete, void *appState);
+
+    Entry *FindEntry(const char *hostName, uint16_t hostNameLen, uint8_t options);
+    Entry *AllocEntry(void);
+    Waiter *AllocWaiter(void);
+    INET_ERROR StartLookup(Entry &aEntry);
+    void CompleteLookup(Entry &aEntry, INET_ERROR aError, uint8_t aNumAddrs, uint32_t aTTLSecs);
+
+    static void HandleLookupComplete(void *appState, INET_ERROR err, uint8_t addrCount, IPAddress *addrArray);
+    static void HandleStubLookup(Weave::System::Layer *aLayer, void *aAppState, Weave::System::Error aError);
+};
+
+} // namespace Inet
+} // namespace nl
+
+#endif // INET_CONFIG_ENABLE_DNS_CACHE
+#endif // !defined(DNSCACHE_H)
@@ -77,6 +77,10 @@ class DNSResolver: public InetLayerBasis
 private:
     friend class InetLayer;
 
+#if INET_CONFIG_ENABLE_DNS_CACHE
+    friend class DNSCache;
+#endif // INET_CONFIG_ENABLE_DNS_CACHE
+
 #if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 #if INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS
     friend class AsyncDNSResolverSockets;
@@ -41,6 +41,11 @@ void EndPointBasis::InitEndPointBasis(InetLayer& aInetLayer, void* aAppState)
 #if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
     mSocket = INET_INVALID_SOCKET_FD;
     mPendingIO.Clear();
+
+#if INET_CONFIG_ENABLE_EPOLL
+    mWatchedIO.Clear();
+    mSocketEndPointType = kSocketEndPointType_Unknown;
+#endif // INET_CONFIG_ENABLE_EPOLL
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 }
 
@@ -60,6 +60,10 @@ namespace Inet {
  */
 class NL_DLL_EXPORT EndPointBasis : public InetLayerBasis
 {
+#if INET_CONFIG_ENABLE_EPOLL
+    friend class InetLayer;
+#endif // INET_CONFIG_ENABLE_EPOLL
+
 public:
     /** Common state codes */
     enum {
@@ -84,6 +88,22 @@ protected:
     int mSocket;                    /**< Encapsulated socket descriptor. */
     IPAddressType mAddrType;        /**< Protocol family, i.e. IPv4 or IPv6. */
     SocketEvents mPendingIO;        /**< Socket event masks */
+
+#if INET_CONFIG_ENABLE_EPOLL
+    SocketEvents mWatchedIO;        /**< Socket events currently registered with the epoll instance */
+
+    enum
+    {
+        kSocketEndPointType_Unknown = 0,
+
+        kSocketEndPointType_Raw     = 1,
+        kSocketEndPointType_UDP     = 2,
+        kSocketEndPointType_TCP     = 3,
+        kSocketEndPointType_Tun     = 4
+    };
+
+    uint8_t mSocketEndPointType;
+#endif // INET_CONFIG_ENABLE_EPOLL
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
 #if WEAVE_SYSTEM_CONFIG_USE_LWIP
@@ -0,0 +1,311 @@
+/*
+ *
+ *    Copyright (c) 2018 Google LLC.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements the <tt>nl::Inet::EventLoopShards</tt> class,
+ *      which runs several System::Layer / InetLayer pairs, each servicing
+ *      its own timers and end points on its own thread.
+ *
+ */
+
+#include <InetLayer/EventLoopShards.h>
+
+#if INET_CONFIG_ENABLE_EVENT_LOOP_SHARDS
+
+#include <errno.h>
+#include <string.h>
+#include <sys/select.h>
+
+#include <Weave/Support/CodeUtils.h>
+#include <Weave/Support/logging/WeaveLogging.h>
+
+namespace nl {
+namespace Inet {
+
+using Weave::System::Layer;
+
+// The longest a shard sleeps in select(); timers and ScheduleWork() wake it sooner.
+static const time_t kMaxShardSleepSeconds = 10;
+
+EventLoopShards::EventLoopShards(void) :
+    mNumShards(0),
+    mRunning(false),
+    mStopRequested(false)
+{
+}
+
+/**
+ *  Initialize the System::Layer and InetLayer of each shard.
+ *
+ *  @param[in]  aNumShards  The number of shards, at least one and at most
+ *                          #INET_CONFIG_MAX_EVENT_LOOP_SHARDS.
+ *  @param[in]  aContext    The platform context passed to each layer's Init().
+ *
+ *  @retval #INET_NO_ERROR               On success.
+ *  @retval #INET_ERROR_INCORRECT_STATE  If the shards are already initialized.
+ *  @retval #INET_ERROR_BAD_ARGS         If \c aNumShards is out of range.
+ *  @retval other                        Any error from initializing a layer; the
+ *                                       shards initialized so far are shut down.
+ */
+INET_ERROR EventLoopShards::Init(size_t aNumShards, void *aContext)
+{
+    INET_ERROR err = INET_NO_ERROR;
+    size_t i = 0;
+
+    VerifyOrExit(mNumShards == 0, err = INET_ERROR_INCORRECT_STATE);
+    VerifyOrExit(aNumShards > 0 && aNumShards <= INET_CONFIG_MAX_EVENT_LOOP_SHARDS, err = INET_ERROR_BAD_ARGS);
+
+    for (i = 0; i < aNumShards; i++)
+    {
+        Shard &shard = mShards[i];
+
+        shard.mShards = this;
+
+        err = shard.mSystemLayer.Init(aContext);
+        SuccessOrExit(err);
+
+        err = shard.mInet.Init(shard.mSystemLayer, aContext);
+        if (err != INET_NO_ERROR)
+        {
+            shard.mSystemLayer.Shutdown();
+            ExitNow();
+        }
+    }
+
+    mNumShards = aNumShards;
+    mStopRequested = false;
+
+exit:
+    if (err != INET_NO_ERROR && mNumShards == 0)
+    {
+        // Shut down the shards initialized before the failure.
+        while (i-- > 0)
+        {
+            mShards[i].mInet.Shutdown();
+            mShards[i].mSystemLayer.Shutdown();
+        }
+    }
+
+    return err;
+}
+
+/**
+ *  Stop the shard threads, if running, and shut down the layers of every shard.
+ *
+ *  @note
+ *    End points should be closed and freed, from their shards, before calling this.
+ *
+ *  @retval #INET_NO_ERROR  Unconditionally.
+ */
+INET_ERROR EventLoopShards::Shutdown(void)
+{
+    Stop();
+
+    for (size_t i = 0; i < mNumShards; i++)
+    {
+        mShards[i].mInet.Shutdown();
+        mShards[i].mSystemLayer.Shutdown();
+    }
+
+    mNumShards = 0;
+
+    return INET_NO_ERROR;
+}
+
+/**
+ *  Start one thread per shard to service the shard's timers and end points.
+ *
+ *  @retval #INET_NO_ERROR               On success.
+ *  @retval #INET_ERROR_INCORRECT_STATE  If the shards are not initialized or are already running.
+ *  @retval other                        A POSIX error creating a thread; the threads started so far are
+ *                                       stopped.
+ */
+INET_ERROR EventLoopShards::Start(void)
+{
+    INET_ERROR err = INET_NO_ERROR;
+    size_t i = 0;
+
+    VerifyOrExit(mNumShards > 0 && !mRunning, err = INET_ERROR_INCORRECT_STATE);
+
+    __atomic_store_n(&mStopRequested, false, __ATOMIC_RELEASE);
+
+    for (i = 0; i < mNumShards; i++)
+    {
+        int pthreadErr = pthread_create(&mShards[i].mThread, NULL, RunShard, &mShards[i]);
+        VerifyOrExit(pthreadErr == 0, err = Weave::System::MapErrorPOSIX(pthreadErr));
+    }
+
+    mRunning = true;
+
+exit:
+    if (err != INET_NO_ERROR && i > 0)
+    {
+        __atomic_store_n(&mStopRequested, true, __ATOMIC_RELEASE);
+
+        while (i-- > 0)
+        {
+            mShards[i].mSystemLayer.WakeSelect();
+            pthread_join(mShards[i].mThread, NULL);
+        }
+    }
+
+    return err;
+}
+
+/**
+ *  Stop the shard threads and wait for them to exit. Any event being handled is completed first; the
+ *  timers and end points of each shard are left as they are.
+ *
+ *  @note
+ *    This must not be called from a shard thread.
+ *
+ *  @retval #INET_NO_ERROR  Unconditionally.
+ */
+INET_ERROR EventLoopShards::Stop(void)
+{
+    if (mRunning)
+    {
+        __atomic_store_n(&mStopRequested, true, __ATOMIC_RELEASE);
+
+        for (size_t i = 0; i < mNumShards; i++)
+            mShards[i].mSystemLayer.WakeSelect();
+
+        for (size_t i = 0; i < mNumShards; i++)
+            pthread_join(mShards[i].mThread, NULL);
+
+        mRunning = false;
+    }
+
+    return INET_NO_ERROR;
+}
+
+/**
+ *  Find the shard that owns a System::Layer, typically the one passed to a ScheduleWork() or timer callback.
+ *
+ *  @param[in]  aSystemLayer    A pointer to the System::Layer.
+ *
+ *  @return The index of the shard, or -1 if the layer does not belong to any shard.
+ */
+int EventLoopShards::ShardIndexFor(const Layer *aSystemLayer) const
+{
+    for (size_t i = 0; i < mNumShards; i++)
+    {
+        if (&mShards[i].mSystemLayer == aSystemLayer)
+            return static_cast<int>(i);
+    }
+
+    return -1;
+}
+
+/**
+ *  Map a key, such as a peer node identifier, onto a shard, so that all work for the key is handled by the same shard.
+ *
+ *  @param[in]  aKey    The key.
+ *
+ *  @return The index of the shard, less than NumShards().
+ */
+size_t EventLoopShards::ShardIndexForKey(uint64_t aKey) const
+{
+    // Mix the bits so that sequential keys spread evenly.
+    aKey ^= aKey >> 33;
+    aKey *= UINT64_C(0xff51afd7ed558ccd);
+    aKey ^= aKey >> 33;
+
+    return static_cast<size_t>(aKey % mNumShards);
+}
+
+/**
+ *  Arrange for a function to be called on a shard's thread, after the event the shard is currently handling. This may be
+ *  called from any thread, including the threads of other shards.
+ *
+ *  @param[in]  aShardIndex     The index of the shard, less than NumShards().
+ *  @param[in]  aComplete       The function to call. Its \c aLayer argument is the shard's System::Layer.
+ *  @param[in]  aAppState       The application state passed to \c aComplete.
+ *
+ *  @retval #INET_NO_ERROR          On success.
+ *  @retval #INET_ERROR_BAD_ARGS    If \c aShardIndex is out of range.
+ *  @retval other                   Any error returned by System::Layer::ScheduleWork().
+ */
+INET_ERROR EventLoopShards::ScheduleWork(size_t aShardIndex, Layer::TimerCompleteFunct aComplete, void *aAppState)
+{
+    if (aShardIndex >= mNumShards)
+        return INET_ERROR_BAD_ARGS;
+
+    return mShards[aShardIndex].mSystemLayer.ScheduleWork(aComplete, aAppState);
+}
+
+/**
+ *  Arrange for a function to be called once on each shard's thread, for example to create a listening end point in every
+ *  shard.
+ *
+ *  @param[in]  aComplete       The function to call.
+ *  @param[in]  aAppState       The application state passed to \c aComplete.
+ *
+ *  @retval #INET_NO_ERROR  On success.
+ *  @retval other           The first error returned by System::Layer::ScheduleWork(); later shards are not scheduled.
+ */
+INET_ERROR EventLoopShards::ScheduleWorkOnAll(Layer::TimerCompleteFunct aComplete, void *aAppState)
+{
+    INET_ERROR err = INET_NO_ERROR;
+
+    for (size_t i = 0; i < mNumShards && err == INET_NO_ERROR; i++)
+        err = mShards[i].mSystemLayer.ScheduleWork(aComplete, aAppState);
+
+    return err;
+}
+
+void *EventLoopShards::RunShard(void *aShard)
+{
+    Shard &shard = *static_cast<Shard *>(aShard);
+
+    while (!__atomic_load_n(&shard.mShards->mStopRequested, __ATOMIC_ACQUIRE))
+    {
+        struct timeval sleepTime = { kMaxShardSleepSeconds, 0 };
+        fd_set readFDs, writeFDs, exceptFDs;
+        int numFDs = 0;
+        int selectRes;
+
+        FD_ZERO(&readFDs);
+        FD_ZERO(&writeFDs);
+        FD_ZERO(&exceptFDs);
+
+        shard.mSystemLayer.PrepareSelect(numFDs, &readFDs, &writeFDs, &exceptFDs, sleepTime);
+        shard.mInet.PrepareSelect(numFDs, &readFDs, &writeFDs, &exceptFDs, sleepTime);
+
+        selectRes = select(numFDs, &readFDs, &writeFDs, &exceptFDs, &sleepTime);
+        if (selectRes < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            WeaveLogError(Inet, "Shard %p select failed: %s", &shard, strerror(errno));
+            break;
+        }
+
+        shard.mSystemLayer.HandleSelectResult(selectRes, &readFDs, &writeFDs, &exceptFDs);
+        shard.mInet.HandleSelectResult(selectRes, &readFDs, &writeFDs, &exceptFDs);
+    }
+
+    return NULL;
+}
+
+} // namespace Inet
+} // namespace nl
+
+#endif // INET_CONFIG_ENABLE_EVENT_LOOP_SHARDS
@@ -0,0 +1,135 @@
+/*
+ *
+ *    Copyright (c) 2018 Google LLC.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This header file defines the <tt>nl::Inet::EventLoopShards</tt>
+ *      class, which runs several System::Layer / InetLayer pairs, each
+ *      servicing its own timers and end points on its own thread.
+ *
+ */
+
+#ifndef EVENTLOOPSHARDS_H
+#define EVENTLOOPSHARDS_H
+
+#include <InetLayer/InetLayer.h>
+
+#if INET_CONFIG_ENABLE_EVENT_LOOP_SHARDS
+
+#include <pthread.h>
+
+namespace nl {
+namespace Inet {
+
+/**
+ *  @class EventLoopShards
+ *
+ *  @brief
+ *    A set of independent event loops, or shards, each consisting of a
+ *    System::Layer, an InetLayer and a thread that services them.
+ *
+ *  @details
+ *    Every timer and end point belongs to exactly one shard, and is only
+ *    ever touched from that shard's thread. End points should therefore be
+ *    created either before Start() or from work scheduled on the shard
+ *    with ScheduleWork(); the latter may be called from any thread, and
+ *    is the mailbox through which shards hand work to one another.
+ *
+ *    To spread load across shards, bind a listening end point to the same
+ *    port in every shard. UDP end points, and TCP end points bound with
+ *    address reuse, set SO_REUSEPORT, so the kernel distributes incoming
+ *    datagrams and connections among them.
+ *
+ *    The packet buffer, timer and end point pools are shared by all
+ *    shards. The Weave message layer is not sharded; a
+ *    WeaveMessageLayer must be used from a single shard.
+ */
+class NL_DLL_EXPORT EventLoopShards
+{
+public:
+    EventLoopShards(void);
+
+    INET_ERROR Init(size_t aNumShards, void *aContext = NULL);
+    INET_ERROR Shutdown(void);
+
+    INET_ERROR Start(void);
+    INET_ERROR Stop(void);
+
+    size_t NumShards(void) const;
+    Weave::System::Layer &SystemLayer(size_t aShardIndex);
+    InetLayer &Inet(size_t aShardIndex);
+
+    int ShardIndexFor(const Weave::System::Layer *aSystemLayer) const;
+    size_t ShardIndexForKey(uint64_t aKey) const;
+
+    INET_ERROR ScheduleWork(size_t aShardIndex, Weave::System::Layer::TimerCompleteFunct aComplete, void *aAppState);
+    INET_ERROR ScheduleWorkOnAll(Weave::System::Layer::TimerCompleteFunct aComplete, void *aAppState);
+
+private:
+    struct Shard
+    {
+        Weave::System::Layer mSystemLayer;
+        InetLayer mInet;
+        pthread_t mThread;
+        EventLoopShards *mShards;
+    };
+
+    Shard mShards[INET_CONFIG_MAX_EVENT_LOOP_SHARDS];
+    size_t mNumShards;
+    bool mRunning;
+    volatile bool mStopRequested;
+
+    static void *RunShard(void *aShard);
+
+    EventLoopShards(const EventLoopShards &);               // not defined
+    EventLoopShards &operator =(const EventLoopShards &);    // not defined
+};
+
+/**
+ *  @return The number of initialized shards.
+ */
+inline size_t EventLoopShards::NumShards(void) const
+{
+    return mNumShards;
+}
+
+/**
+ *  @param[in]  aShardIndex     The index of the shard, less than NumShards().
+ *
+ *  @return The System::Layer of the shard.
+ */
+inline Weave::System::Layer &EventLoopShards::SystemLayer(size_t aShardIndex)
+{
+    return mShards[aShardIndex].mSystemLayer;
+}
+
+/**
+ *  @param[in]  aShardIndex     The index of the shard, less than NumShards().
+ *
+ *  @return The InetLayer of the shard.
+ */
+inline InetLayer &EventLoopShards::Inet(size_t aShardIndex)
+{
+    return mShards[aShardIndex].mInet;
+}
+
+} // namespace Inet
+} // namespace nl
+
+#endif // INET_CONFIG_ENABLE_EVENT_LOOP_SHARDS
+#endif // !defined(EVENTLOOPSHARDS_H)
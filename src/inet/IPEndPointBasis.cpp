@@ -96,6 +96,99 @@ union PeerSockAddr
     sockaddr_in  in;
     sockaddr_in6 in6;
 };
+
+/**
+ *  Storage for the message header of a single datagram passed to sendmsg()/sendmmsg() or recvmsg()/recvmmsg().
+ */
+struct MsgStorage
+{
+    struct msghdr   mHeader;
+    struct iovec    mIOV;
+    PeerSockAddr    mPeerAddr;
+    uint8_t         mControlData[256];
+};
+
+/**
+ *  Fill in the inbound message header in \c aStorage for receiving a datagram into \c aBuffer.
+ */
+static void PrepareRecvMsg(PacketBuffer *aBuffer, MsgStorage &aStorage)
+{
+    aStorage.mIOV.iov_base = aBuffer->Start();
+    aStorage.mIOV.iov_len = aBuffer->AvailableDataLength();
+
+    memset(&aStorage.mPeerAddr, 0, sizeof (aStorage.mPeerAddr));
+
+    memset(&aStorage.mHeader, 0, sizeof (aStorage.mHeader));
+
+    aStorage.mHeader.msg_name = &aStorage.mPeerAddr;
+    aStorage.mHeader.msg_namelen = sizeof (aStorage.mPeerAddr);
+    aStorage.mHeader.msg_iov = &aStorage.mIOV;
+    aStorage.mHeader.msg_iovlen = 1;
+    aStorage.mHeader.msg_control = aStorage.mControlData;
+    aStorage.mHeader.msg_controllen = sizeof (aStorage.mControlData);
+}
+
+/**
+ *  Set the length of \c aBuffer to that of the datagram of \c aRcvLen bytes received into it, and extract the
+ *  source address and the destination address and interface from the received message header \c aMsgHeader
+ *  into \c aPktInfo.
+ */
+static INET_ERROR DecodeRecvMsg(struct msghdr &aMsgHeader, PacketBuffer *aBuffer, size_t aRcvLen, IPPacketInfo &aPktInfo)
+{
+    INET_ERROR lStatus = INET_NO_ERROR;
+    const PeerSockAddr &lPeerSockAddr = *static_cast<const PeerSockAddr *>(aMsgHeader.msg_name);
+
+    VerifyOrExit(aRcvLen <= aBuffer->AvailableDataLength(), lStatus = INET_ERROR_INBOUND_MESSAGE_TOO_BIG);
+
+    aBuffer->SetDataLength((uint16_t) aRcvLen);
+
+    if (lPeerSockAddr.any.sa_family == AF_INET6)
+    {
+        aPktInfo.SrcAddress = IPAddress::FromIPv6(lPeerSockAddr.in6.sin6_addr);
+        aPktInfo.SrcPort = ntohs(lPeerSockAddr.in6.sin6_port);
+    }
+#if INET_CONFIG_ENABLE_IPV4
+    else if (lPeerSockAddr.any.sa_family == AF_INET)
+    {
+        aPktInfo.SrcAddress = IPAddress::FromIPv4(lPeerSockAddr.in.sin_addr);
+        aPktInfo.SrcPort = ntohs(lPeerSockAddr.in.sin_port);
+    }
+#endif // INET_CONFIG_ENABLE_IPV4
+    else
+    {
+        ExitNow(lStatus = INET_ERROR_INCORRECT_STATE);
+    }
+
+    for (struct cmsghdr *controlHdr = CMSG_FIRSTHDR(&aMsgHeader);
+         controlHdr != NULL;
+         controlHdr = CMSG_NXTHDR(&aMsgHeader, controlHdr))
+    {
+#if INET_CONFIG_ENABLE_IPV4
+#ifdef IP_PKTINFO
+        if (controlHdr->cmsg_level == IPPROTO_IP && controlHdr->cmsg_type == IP_PKTINFO)
+        {
+            struct in_pktinfo *inPktInfo = (struct in_pktinfo *)CMSG_DATA(controlHdr);
+            aPktInfo.Interface = inPktInfo->ipi_ifindex;
+            aPktInfo.DestAddress = IPAddress::FromIPv4(inPktInfo->ipi_addr);
+            continue;
+        }
+#endif // defined(IP_PKTINFO)
+#endif // INET_CONFIG_ENABLE_IPV4
+
+#ifdef IPV6_PKTINFO
+        if (controlHdr->cmsg_level == IPPROTO_IPV6 && controlHdr->cmsg_type == IPV6_PKTINFO)
+        {
+            struct in6_pktinfo *in6PktInfo = (struct in6_pktinfo *)CMSG_DATA(controlHdr);
+            aPktInfo.Interface = in6PktInfo->ipi6_ifindex;
+            aPktInfo.DestAddress = IPAddress::FromIPv6(in6PktInfo->ipi6_addr);
+            continue;
+        }
+#endif // defined(IPV6_PKTINFO)
+    }
+
+exit:
+    return (lStatus);
+}
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
 #if WEAVE_SYSTEM_CONFIG_USE_LWIP
@@ -571,6 +664,10 @@ void IPEndPointBasis::Init(InetLayer *aInetLayer)
 
 #if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
     mBoundIntfId = INET_NULL_INTERFACEID;
+
+#if INET_CONFIG_ENABLE_UDP_BATCH_IO
+    memset(mRecvBatch, 0, sizeof (mRecvBatch));
+#endif // INET_CONFIG_ENABLE_UDP_BATCH_IO
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 }
 
@@ -760,47 +857,48 @@ INET_ERROR IPEndPointBasis::BindInterface(IPAddressType aAddressType, InterfaceI
     return (lRetval);
 }
 
-INET_ERROR IPEndPointBasis::SendMsg(const IPPacketInfo *aPktInfo, Weave::System::PacketBuffer *aBuffer, uint16_t aSendFlags)
+/**
+ *  Fill in the outbound message header in \c aStorage for sending \c aBuffer to the destination described by
+ *  \c aPktInfo from an endpoint of type \c aAddrType, bound to interface \c aBoundIntfId.
+ */
+static INET_ERROR PrepareSendMsg(IPAddressType aAddrType, InterfaceId aBoundIntfId, const IPPacketInfo *aPktInfo,
+    PacketBuffer *aBuffer, MsgStorage &aStorage)
 {
     INET_ERROR     res = INET_NO_ERROR;
-    PeerSockAddr   peerSockAddr;
-    struct iovec   msgIOV;
-    uint8_t        controlData[256];
-    struct msghdr  msgHeader;
     InterfaceId    intfId = aPktInfo->Interface;
 
     // Ensure the destination address type is compatible with the endpoint address type.
-    VerifyOrExit(mAddrType == aPktInfo->DestAddress.Type(), res = INET_ERROR_BAD_ARGS);
+    VerifyOrExit(aAddrType == aPktInfo->DestAddress.Type(), res = INET_ERROR_BAD_ARGS);
 
     // For now the entire message must fit within a single buffer.
     VerifyOrExit(aBuffer->Next() == NULL, res = INET_ERROR_MESSAGE_TOO_LONG);
 
-    memset(&msgHeader, 0, sizeof (msgHeader));
+    memset(&aStorage.mHeader, 0, sizeof (aStorage.mHeader));
 
-    msgIOV.iov_base      = aBuffer->Start();
-    msgIOV.iov_len       = aBuffer->DataLength();
-    msgHeader.msg_iov    = &msgIOV;
-    msgHeader.msg_iovlen = 1;
+    aStorage.mIOV.iov_base      = aBuffer->Start();
+    aStorage.mIOV.iov_len       = aBuffer->DataLength();
+    aStorage.mHeader.msg_iov    = &aStorage.mIOV;
+    aStorage.mHeader.msg_iovlen = 1;
 
     // Construct a sockaddr_in/sockaddr_in6 structure containing the destination information.
-    memset(&peerSockAddr, 0, sizeof (peerSockAddr));
-    msgHeader.msg_name = &peerSockAddr;
-    if (mAddrType == kIPAddressType_IPv6)
+    memset(&aStorage.mPeerAddr, 0, sizeof (aStorage.mPeerAddr));
+    aStorage.mHeader.msg_name = &aStorage.mPeerAddr;
+    if (aAddrType == kIPAddressType_IPv6)
     {
-        peerSockAddr.in6.sin6_family    = AF_INET6;
-        peerSockAddr.in6.sin6_port      = htons(aPktInfo->DestPort);
-        peerSockAddr.in6.sin6_flowinfo  = 0;
-        peerSockAddr.in6.sin6_addr      = aPktInfo->DestAddress.ToIPv6();
-        peerSockAddr.in6.sin6_scope_id  = aPktInfo->Interface;
-        msgHeader.msg_namelen           = sizeof(sockaddr_in6);
+        aStorage.mPeerAddr.in6.sin6_family    = AF_INET6;
+        aStorage.mPeerAddr.in6.sin6_port      = htons(aPktInfo->DestPort);
+        aStorage.mPeerAddr.in6.sin6_flowinfo  = 0;
+        aStorage.mPeerAddr.in6.sin6_addr      = aPktInfo->DestAddress.ToIPv6();
+        aStorage.mPeerAddr.in6.sin6_scope_id  = aPktInfo->Interface;
+        aStorage.mHeader.msg_namelen          = sizeof(sockaddr_in6);
     }
 #if INET_CONFIG_ENABLE_IPV4
     else
     {
-        peerSockAddr.in.sin_family      = AF_INET;
-        peerSockAddr.in.sin_port        = htons(aPktInfo->DestPort);
-        peerSockAddr.in.sin_addr        = aPktInfo->DestAddress.ToIPv4();
-        msgHeader.msg_namelen           = sizeof(sockaddr_in);
+        aStorage.mPeerAddr.in.sin_family      = AF_INET;
+        aStorage.mPeerAddr.in.sin_port        = htons(aPktInfo->DestPort);
+        aStorage.mPeerAddr.in.sin_addr        = aPktInfo->DestAddress.ToIPv4();
+        aStorage.mHeader.msg_namelen          = sizeof(sockaddr_in);
     }
 #endif // INET_CONFIG_ENABLE_IPV4
 
@@ -811,7 +909,7 @@ INET_ERROR IPEndPointBasis::SendMsg(const IPPacketInfo *aPktInfo, Weave::System:
     // don't seem to get sent out the correct interface, despite
     // the socket being bound.
     if (intfId == INET_NULL_INTERFACEID)
-        intfId = mBoundIntfId;
+        intfId = aBoundIntfId;
 
     // If the packet should be sent over a specific interface, or with a specific source
     // address, construct an IP_PKTINFO/IPV6_PKTINFO "control message" to that effect
@@ -820,15 +918,15 @@ INET_ERROR IPEndPointBasis::SendMsg(const IPPacketInfo *aPktInfo, Weave::System:
     if (intfId != INET_NULL_INTERFACEID || aPktInfo->SrcAddress.Type() != kIPAddressType_Any)
     {
 #if defined(IP_PKTINFO) || defined(IPV6_PKTINFO)
-        memset(controlData, 0, sizeof(controlData));
-        msgHeader.msg_control = controlData;
-        msgHeader.msg_controllen = sizeof(controlData);
+        memset(aStorage.mControlData, 0, sizeof(aStorage.mControlData));
+        aStorage.mHeader.msg_control = aStorage.mControlData;
+        aStorage.mHeader.msg_controllen = sizeof(aStorage.mControlData);
 
-        struct cmsghdr *controlHdr = CMSG_FIRSTHDR(&msgHeader);
+        struct cmsghdr *controlHdr = CMSG_FIRSTHDR(&aStorage.mHeader);
 
 #if INET_CONFIG_ENABLE_IPV4
 
-        if (mAddrType == kIPAddressType_IPv4)
+        if (aAddrType == kIPAddressType_IPv4)
         {
 #if defined(IP_PKTINFO)
             controlHdr->cmsg_level = IPPROTO_IP;
@@ -839,7 +937,7 @@ INET_ERROR IPEndPointBasis::SendMsg(const IPPacketInfo *aPktInfo, Weave::System:
             pktInfo->ipi_ifindex = intfId;
             pktInfo->ipi_spec_dst = aPktInfo->SrcAddress.ToIPv4();
 
-            msgHeader.msg_controllen = CMSG_SPACE(sizeof(in_pktinfo));
+            aStorage.mHeader.msg_controllen = CMSG_SPACE(sizeof(in_pktinfo));
 #else // !defined(IP_PKTINFO)
             ExitNow(res = INET_ERROR_NOT_SUPPORTED);
 #endif // !defined(IP_PKTINFO)
@@ -847,7 +945,7 @@ INET_ERROR IPEndPointBasis::SendMsg(const IPPacketInfo *aPktInfo, Weave::System:
 
 #endif // INET_CONFIG_ENABLE_IPV4
 
-        if (mAddrType == kIPAddressType_IPv6)
+        if (aAddrType == kIPAddressType_IPv6)
         {
 #if defined(IPV6_PKTINFO)
             controlHdr->cmsg_level = IPPROTO_IPV6;
@@ -858,7 +956,7 @@ INET_ERROR IPEndPointBasis::SendMsg(const IPPacketInfo *aPktInfo, Weave::System:
             pktInfo->ipi6_ifindex = intfId;
             pktInfo->ipi6_addr = aPktInfo->SrcAddress.ToIPv6();
 
-            msgHeader.msg_controllen = CMSG_SPACE(sizeof(in6_pktinfo));
+            aStorage.mHeader.msg_controllen = CMSG_SPACE(sizeof(in6_pktinfo));
 #else // !defined(IPV6_PKTINFO)
             ExitNow(res = INET_ERROR_NOT_SUPPORTED);
 #endif // !defined(IPV6_PKTINFO)
@@ -871,9 +969,21 @@ INET_ERROR IPEndPointBasis::SendMsg(const IPPacketInfo *aPktInfo, Weave::System:
 #endif // !(defined(IP_PKTINFO) && defined(IPV6_PKTINFO))
     }
 
+exit:
+    return (res);
+}
+
+INET_ERROR IPEndPointBasis::SendMsg(const IPPacketInfo *aPktInfo, Weave::System::PacketBuffer *aBuffer, uint16_t aSendFlags)
+{
+    INET_ERROR  res;
+    MsgStorage  lStorage;
+
+    res = PrepareSendMsg(mAddrType, mBoundIntfId, aPktInfo, aBuffer, lStorage);
+    SuccessOrExit(res);
+
     // Send IP packet.
     {
-        const ssize_t lenSent = sendmsg(mSocket, &msgHeader, 0);
+        const ssize_t lenSent = sendmsg(mSocket, &lStorage.mHeader, 0);
         if (lenSent == -1)
             res = Weave::System::MapErrorPOSIX(errno);
         else if (lenSent != aBuffer->DataLength())
@@ -884,6 +994,68 @@ exit:
     return (res);
 }
 
+#if INET_CONFIG_ENABLE_UDP_BATCH_IO
+/**
+ *  Send the message in \c aBuffer to each of the \c aCount destinations in \c aPktInfos, issuing one sendmmsg() call
+ *  per #INET_CONFIG_UDP_BATCH_SIZE destinations.
+ *
+ *  The buffer is neither modified nor freed. The outcome of the send to \c aPktInfos[i] is stored in \c aErrors[i], and
+ *  the first error encountered, if any, is returned.
+ */
+INET_ERROR IPEndPointBasis::SendMsgBatch(const IPPacketInfo *aPktInfos, size_t aCount, PacketBuffer *aBuffer, INET_ERROR *aErrors)
+{
+    INET_ERROR     res = INET_NO_ERROR;
+    MsgStorage     lStorage[INET_CONFIG_UDP_BATCH_SIZE];
+    struct mmsghdr lMsgs[INET_CONFIG_UDP_BATCH_SIZE];
+    size_t         lDestIndex[INET_CONFIG_UDP_BATCH_SIZE];
+    size_t         lNext = 0;
+
+    while (lNext < aCount)
+    {
+        unsigned int lNumMsgs = 0;
+        unsigned int lNumSent = 0;
+
+        // Build the headers for the next batch. A destination whose header cannot be built is left out of the batch
+        // with its error recorded.
+        for (; lNext < aCount && lNumMsgs < INET_CONFIG_UDP_BATCH_SIZE; lNext++)
+        {
+            aErrors[lNext] = PrepareSendMsg(mAddrType, mBoundIntfId, &aPktInfos[lNext], aBuffer, lStorage[lNumMsgs]);
+
+            if (aErrors[lNext] == INET_NO_ERROR)
+            {
+                lMsgs[lNumMsgs].msg_hdr = lStorage[lNumMsgs].mHeader;
+                lMsgs[lNumMsgs].msg_len = 0;
+                lDestIndex[lNumMsgs] = lNext;
+                lNumMsgs++;
+            }
+        }
+
+        while (lNumSent < lNumMsgs)
+        {
+            const int lResult = sendmmsg(mSocket, &lMsgs[lNumSent], lNumMsgs - lNumSent, 0);
+
+            if (lResult < 0)
+            {
+                // The error pertains to the first unsent message; skip it and carry on with the remainder.
+                aErrors[lDestIndex[lNumSent++]] = Weave::System::MapErrorPOSIX(errno);
+                continue;
+            }
+
+            for (int i = 0; i < lResult; i++, lNumSent++)
+            {
+                if (lMsgs[lNumSent].msg_len != aBuffer->DataLength())
+                    aErrors[lDestIndex[lNumSent]] = INET_ERROR_OUTBOUND_MESSAGE_TRUNCATED;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < aCount && res == INET_NO_ERROR; i++)
+        res = aErrors[i];
+
+    return (res);
+}
+#endif // INET_CONFIG_ENABLE_UDP_BATCH_IO
+
 INET_ERROR IPEndPointBasis::GetSocket(IPAddressType aAddressType, int aType, int aProtocol)
 {
     INET_ERROR res = INET_NO_ERROR;
@@ -1007,6 +1179,111 @@ SocketEvents IPEndPointBasis::PrepareIO(void)
     return res;
 }
 
+#if INET_CONFIG_ENABLE_UDP_BATCH_IO
+/**
+ *  Receive up to #INET_CONFIG_UDP_BATCH_SIZE pending datagrams with a single recvmmsg() call and deliver each of them
+ *  to the message reception handler.
+ *
+ *  The endpoint retains its receive buffers between calls and only replaces those consumed by received datagrams.
+ */
+void IPEndPointBasis::HandlePendingIO(uint16_t aPort)
+{
+    INET_ERROR      lStatus = INET_NO_ERROR;
+    MsgStorage      lStorage[INET_CONFIG_UDP_BATCH_SIZE];
+    struct mmsghdr  lMsgs[INET_CONFIG_UDP_BATCH_SIZE];
+    PacketBuffer *  lReceived[INET_CONFIG_UDP_BATCH_SIZE];
+    unsigned int    lNumBuffers;
+    int             lNumReceived;
+
+    for (lNumBuffers = 0; lNumBuffers < INET_CONFIG_UDP_BATCH_SIZE; lNumBuffers++)
+    {
+        if (mRecvBatch[lNumBuffers] == NULL)
+        {
+            mRecvBatch[lNumBuffers] = PacketBuffer::New(0);
+            if (mRecvBatch[lNumBuffers] == NULL)
+                break;
+        }
+
+        PrepareRecvMsg(mRecvBatch[lNumBuffers], lStorage[lNumBuffers]);
+        lMsgs[lNumBuffers].msg_hdr = lStorage[lNumBuffers].mHeader;
+        lMsgs[lNumBuffers].msg_len = 0;
+    }
+
+    VerifyOrExit(lNumBuffers > 0, lStatus = INET_ERROR_NO_MEMORY);
+
+    lNumReceived = recvmmsg(mSocket, lMsgs, lNumBuffers, MSG_DONTWAIT, NULL);
+    VerifyOrExit(lNumReceived >= 0, lStatus = Weave::System::MapErrorPOSIX(errno));
+
+    // Take ownership of the filled buffers before dispatching any of them, since a handler may close the endpoint.
+    for (int i = 0; i < lNumReceived; i++)
+    {
+        lReceived[i] = mRecvBatch[i];
+        mRecvBatch[i] = NULL;
+    }
+
+    Retain();
+
+    for (int i = 0; i < lNumReceived; i++)
+    {
+        IPPacketInfo lPacketInfo;
+        INET_ERROR   lMsgStatus;
+
+        // A handler invoked for an earlier datagram may have closed the endpoint or stopped listening.
+        if (mState != kState_Listening || OnMessageReceived == NULL)
+        {
+            PacketBuffer::Free(lReceived[i]);
+            continue;
+        }
+
+        lPacketInfo.Clear();
+        lPacketInfo.DestPort = aPort;
+
+        if (lMsgs[i].msg_hdr.msg_flags & MSG_TRUNC)
+            lMsgStatus = INET_ERROR_INBOUND_MESSAGE_TOO_BIG;
+        else
+            lMsgStatus = DecodeRecvMsg(lMsgs[i].msg_hdr, lReceived[i], lMsgs[i].msg_len, lPacketInfo);
+
+        if (lMsgStatus == INET_NO_ERROR)
+            OnMessageReceived(this, lReceived[i], &lPacketInfo);
+        else
+        {
+            PacketBuffer::Free(lReceived[i]);
+            if (OnReceiveError != NULL)
+                OnReceiveError(this, lMsgStatus, NULL);
+        }
+    }
+
+    Release();
+
+exit:
+    if (lStatus != INET_NO_ERROR)
+    {
+        if (OnReceiveError != NULL
+            && lStatus != Weave::System::MapErrorPOSIX(EAGAIN)
+           )
+            OnReceiveError(this, lStatus, NULL);
+    }
+
+    return;
+}
+
+/**
+ *  Free the receive buffers retained by the endpoint for batched reception.
+ */
+void IPEndPointBasis::ReleaseRecvBatch(void)
+{
+    for (size_t i = 0; i < INET_CONFIG_UDP_BATCH_SIZE; i++)
+    {
+        if (mRecvBatch[i] != NULL)
+        {
+            PacketBuffer::Free(mRecvBatch[i]);
+            mRecvBatch[i] = NULL;
+        }
+    }
+}
+
+#else // !INET_CONFIG_ENABLE_UDP_BATCH_IO
+
 void IPEndPointBasis::HandlePendingIO(uint16_t aPort)
 {
     INET_ERROR      lStatus = INET_NO_ERROR;
@@ -1020,85 +1297,19 @@ void IPEndPointBasis::HandlePendingIO(uint16_t aPort)
 
     if (lBuffer != NULL)
     {
-        struct iovec msgIOV;
-        PeerSockAddr lPeerSockAddr;
-        uint8_t controlData[256];
-        struct msghdr msgHeader;
-
-        msgIOV.iov_base = lBuffer->Start();
-        msgIOV.iov_len = lBuffer->AvailableDataLength();
+        MsgStorage lStorage;
 
-        memset(&lPeerSockAddr, 0, sizeof (lPeerSockAddr));
+        PrepareRecvMsg(lBuffer, lStorage);
 
-        memset(&msgHeader, 0, sizeof (msgHeader));
-
-        msgHeader.msg_name = &lPeerSockAddr;
-        msgHeader.msg_namelen = sizeof (lPeerSockAddr);
-        msgHeader.msg_iov = &msgIOV;
-        msgHeader.msg_iovlen = 1;
-        msgHeader.msg_control = controlData;
-        msgHeader.msg_controllen = sizeof (controlData);
-
-        ssize_t rcvLen = recvmsg(mSocket, &msgHeader, MSG_DONTWAIT);
+        ssize_t rcvLen = recvmsg(mSocket, &lStorage.mHeader, MSG_DONTWAIT);
 
         if (rcvLen < 0)
         {
             lStatus = Weave::System::MapErrorPOSIX(errno);
         }
-        else if (rcvLen > lBuffer->AvailableDataLength())
-        {
-            lStatus = INET_ERROR_INBOUND_MESSAGE_TOO_BIG;
-        }
         else
         {
-            lBuffer->SetDataLength((uint16_t) rcvLen);
-
-            if (lPeerSockAddr.any.sa_family == AF_INET6)
-            {
-                lPacketInfo.SrcAddress = IPAddress::FromIPv6(lPeerSockAddr.in6.sin6_addr);
-                lPacketInfo.SrcPort = ntohs(lPeerSockAddr.in6.sin6_port);
-            }
-#if INET_CONFIG_ENABLE_IPV4
-            else if (lPeerSockAddr.any.sa_family == AF_INET)
-            {
-                lPacketInfo.SrcAddress = IPAddress::FromIPv4(lPeerSockAddr.in.sin_addr);
-                lPacketInfo.SrcPort = ntohs(lPeerSockAddr.in.sin_port);
-            }
-#endif // INET_CONFIG_ENABLE_IPV4
-            else
-            {
-                lStatus = INET_ERROR_INCORRECT_STATE;
-            }
-        }
-
-        if (lStatus == INET_NO_ERROR)
-        {
-            for (struct cmsghdr *controlHdr = CMSG_FIRSTHDR(&msgHeader);
-                 controlHdr != NULL;
-                 controlHdr = CMSG_NXTHDR(&msgHeader, controlHdr))
-            {
-#if INET_CONFIG_ENABLE_IPV4
-#ifdef IP_PKTINFO
-                if (controlHdr->cmsg_level == IPPROTO_IP && controlHdr->cmsg_type == IP_PKTINFO)
-                {
-                    struct in_pktinfo *inPktInfo = (struct in_pktinfo *)CMSG_DATA(controlHdr);
-                    lPacketInfo.Interface = inPktInfo->ipi_ifindex;
-                    lPacketInfo.DestAddress = IPAddress::FromIPv4(inPktInfo->ipi_addr);
-                    continue;
-                }
-#endif // defined(IP_PKTINFO)
-#endif // INET_CONFIG_ENABLE_IPV4
-
-#ifdef IPV6_PKTINFO
-                if (controlHdr->cmsg_level == IPPROTO_IPV6 && controlHdr->cmsg_type == IPV6_PKTINFO)
-                {
-                    struct in6_pktinfo *in6PktInfo = (struct in6_pktinfo *)CMSG_DATA(controlHdr);
-                    lPacketInfo.Interface = in6PktInfo->ipi6_ifindex;
-                    lPacketInfo.DestAddress = IPAddress::FromIPv6(in6PktInfo->ipi6_addr);
-                    continue;
-                }
-#endif // defined(IPV6_PKTINFO)
-            }
+            lStatus = DecodeRecvMsg(lStorage.mHeader, lBuffer, static_cast<size_t>(rcvLen), lPacketInfo);
         }
     }
     else
@@ -1119,6 +1330,8 @@ void IPEndPointBasis::HandlePendingIO(uint16_t aPort)
 
     return;
 }
+
+#endif // !INET_CONFIG_ENABLE_UDP_BATCH_IO
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
 } // namespace Inet
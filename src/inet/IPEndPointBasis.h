@@ -146,6 +146,13 @@ protected:
     INET_ERROR GetSocket(IPAddressType aAddressType, int aType, int aProtocol);
     SocketEvents PrepareIO(void);
     void HandlePendingIO(uint16_t aPort);
+
+#if INET_CONFIG_ENABLE_UDP_BATCH_IO
+    Weave::System::PacketBuffer *mRecvBatch[INET_CONFIG_UDP_BATCH_SIZE];
+
+    INET_ERROR SendMsgBatch(const IPPacketInfo *aPktInfos, size_t aCount, Weave::System::PacketBuffer *aBuffer, INET_ERROR *aErrors);
+    void ReleaseRecvBatch(void);
+#endif // INET_CONFIG_ENABLE_UDP_BATCH_IO
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
 private:
@@ -60,4 +60,8 @@
 #include <InetLayer/TunEndPoint.h>
 #endif // INET_CONFIG_ENABLE_TUN_ENDPOINT
 
+#if INET_CONFIG_ENABLE_EVENT_LOOP_SHARDS
+#include <InetLayer/EventLoopShards.h>
+#endif // INET_CONFIG_ENABLE_EVENT_LOOP_SHARDS
+
 #endif // !defined(INET_H)
@@ -726,6 +726,363 @@
 #ifndef INET_CONFIG_IP_MULTICAST_HOP_LIMIT
 #define INET_CONFIG_IP_MULTICAST_HOP_LIMIT                 (64)
 #endif // INET_CONFIG_IP_MULTICAST_HOP_LIMIT
+
+/**
+ *  @def INET_CONFIG_ENABLE_EPOLL
+ *
+ *  @brief
+ *    Defines whether (1) or not (0) the InetLayer tracks endpoint socket
+ *    readiness with a Linux epoll instance rather than adding every
+ *    endpoint socket to the select() file descriptor sets.
+ *
+ *  @details
+ *    When enabled, endpoint sockets are registered with the epoll instance
+ *    once, when they are created, and their interest set is only updated
+ *    when it changes. The InetLayer contributes a single descriptor, the
+ *    epoll instance itself, to the select() sets, so the number of endpoint
+ *    sockets is no longer bounded by FD_SETSIZE and the per-wakeup cost is
+ *    proportional to the number of ready sockets rather than to the size of
+ *    the endpoint pools.
+ *
+ *    Callback pointers modified directly on an endpoint, outside of the
+ *    endpoint API, take effect the next time the endpoint is dispatched or
+ *    one of its API methods is called.
+ *
+ *    This option is only available on Linux with the sockets-based
+ *    system layer.
+ */
+#ifndef INET_CONFIG_ENABLE_EPOLL
+#define INET_CONFIG_ENABLE_EPOLL                           0
+#endif // INET_CONFIG_ENABLE_EPOLL
+
+#if INET_CONFIG_ENABLE_EPOLL && !WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+#error "INET_CONFIG_ENABLE_EPOLL requires WEAVE_SYSTEM_CONFIG_USE_SOCKETS"
+#endif // INET_CONFIG_ENABLE_EPOLL && !WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+
+/**
+ *  @def INET_CONFIG_EPOLL_EDGE_TRIGGERED
+ *
+ *  @brief
+ *    Defines whether (1) or not (0) endpoint sockets are registered with
+ *    the epoll instance in edge-triggered mode.
+ *
+ *  @details
+ *    In edge-triggered mode the interest set of each dispatched endpoint
+ *    is re-armed after its pending I/O has been handled, so readiness that
+ *    was not fully drained by the handler (e.g. a UDP socket with several
+ *    queued datagrams) is reported again on the next wakeup.
+ *
+ *    This option is only meaningful when #INET_CONFIG_ENABLE_EPOLL is
+ *    enabled.
+ */
+#ifndef INET_CONFIG_EPOLL_EDGE_TRIGGERED
+#define INET_CONFIG_EPOLL_EDGE_TRIGGERED                   0
+#endif // INET_CONFIG_EPOLL_EDGE_TRIGGERED
+
+/**
+ *  @def INET_CONFIG_EPOLL_MAX_EVENTS
+ *
+ *  @brief
+ *    The maximum number of ready endpoint sockets retrieved from the
+ *    epoll instance per event loop iteration.
+ *
+ *  @details
+ *    Sockets that are ready but not retrieved in one iteration remain
+ *    ready and are reported in a subsequent iteration.
+ *
+ *    This option is only meaningful when #INET_CONFIG_ENABLE_EPOLL is
+ *    enabled.
+ */
+#ifndef INET_CONFIG_EPOLL_MAX_EVENTS
+#define INET_CONFIG_EPOLL_MAX_EVENTS                       64
+#endif // INET_CONFIG_EPOLL_MAX_EVENTS
+
+/**
+ *  @def INET_CONFIG_ENABLE_UDP_BATCH_IO
+ *
+ *  @brief
+ *    Defines whether (1) or not (0) UDP and raw endpoints use the Linux
+ *    recvmmsg() and sendmmsg() system calls to move several datagrams per
+ *    system call.
+ *
+ *  @details
+ *    When enabled, each readiness notification on a listening endpoint
+ *    drains up to #INET_CONFIG_UDP_BATCH_SIZE datagrams with a single
+ *    recvmmsg() call, and UDPEndPoint::SendMsgBatch() is available for
+ *    sending one message to several destinations (e.g. multicast over
+ *    every local interface) with a single sendmmsg() call.
+ *
+ *    Each listening endpoint keeps up to #INET_CONFIG_UDP_BATCH_SIZE
+ *    receive buffers allocated between notifications; they are released
+ *    when the endpoint is closed. Where packet buffers come from a fixed
+ *    pool (#WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC), the pool should be
+ *    sized to accommodate these buffers for every listening endpoint.
+ *
+ *    This option is only available on Linux with the sockets-based
+ *    system layer.
+ */
+#ifndef INET_CONFIG_ENABLE_UDP_BATCH_IO
+#define INET_CONFIG_ENABLE_UDP_BATCH_IO                    0
+#endif // INET_CONFIG_ENABLE_UDP_BATCH_IO
+
+#if INET_CONFIG_ENABLE_UDP_BATCH_IO && !WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+#error "INET_CONFIG_ENABLE_UDP_BATCH_IO requires WEAVE_SYSTEM_CONFIG_USE_SOCKETS"
+#endif // INET_CONFIG_ENABLE_UDP_BATCH_IO && !WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+
+/**
+ *  @def INET_CONFIG_UDP_BATCH_SIZE
+ *
+ *  @brief
+ *    The maximum number of datagrams received, or sent, by a single
+ *    recvmmsg() or sendmmsg() call.
+ *
+ *  @details
+ *    This option is only meaningful when #INET_CONFIG_ENABLE_UDP_BATCH_IO
+ *    is enabled.
+ */
+#ifndef INET_CONFIG_UDP_BATCH_SIZE
+#define INET_CONFIG_UDP_BATCH_SIZE                         16
+#endif // INET_CONFIG_UDP_BATCH_SIZE
+
+#if INET_CONFIG_ENABLE_UDP_BATCH_IO && INET_CONFIG_UDP_BATCH_SIZE < 1
+#error "INET_CONFIG_UDP_BATCH_SIZE must be at least 1"
+#endif // INET_CONFIG_ENABLE_UDP_BATCH_IO && INET_CONFIG_UDP_BATCH_SIZE < 1
+
+#if INET_CONFIG_ENABLE_UDP_BATCH_IO && WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC && INET_CONFIG_UDP_BATCH_SIZE >= WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC
+#error "INET_CONFIG_UDP_BATCH_SIZE must be less than WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC"
+#endif // INET_CONFIG_ENABLE_UDP_BATCH_IO && WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC && INET_CONFIG_UDP_BATCH_SIZE >= WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC
+
+/**
+ *  @def INET_CONFIG_ENABLE_TCP_SEND_GATHER
+ *
+ *  @brief
+ *    Defines whether (1) or not (0) TCP endpoints hand the buffers of
+ *    their send queue to the kernel with a single vectored sendmsg() call,
+ *    rather than calling send() once per buffer.
+ *
+ *  @details
+ *    When enabled, each write readiness notification sends up to
+ *    #INET_CONFIG_TCP_SEND_GATHER_MAX_IOV queued buffers, and at most
+ *    UINT16_MAX bytes, per system call. The buffers are passed in place,
+ *    without being copied into a contiguous staging area.
+ *
+ *    This option is only available with the sockets-based system layer.
+ */
+#ifndef INET_CONFIG_ENABLE_TCP_SEND_GATHER
+#define INET_CONFIG_ENABLE_TCP_SEND_GATHER                 0
+#endif // INET_CONFIG_ENABLE_TCP_SEND_GATHER
+
+#if INET_CONFIG_ENABLE_TCP_SEND_GATHER && !WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+#error "INET_CONFIG_ENABLE_TCP_SEND_GATHER requires WEAVE_SYSTEM_CONFIG_USE_SOCKETS"
+#endif // INET_CONFIG_ENABLE_TCP_SEND_GATHER && !WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+
+/**
+ *  @def INET_CONFIG_TCP_SEND_GATHER_MAX_IOV
+ *
+ *  @brief
+ *    The maximum number of packet buffers passed to a single vectored
+ *    sendmsg() call on a TCP endpoint.
+ *
+ *  @details
+ *    This option is only meaningful when #INET_CONFIG_ENABLE_TCP_SEND_GATHER
+ *    is enabled. It must not exceed the system's IOV_MAX.
+ */
+#ifndef INET_CONFIG_TCP_SEND_GATHER_MAX_IOV
+#define INET_CONFIG_TCP_SEND_GATHER_MAX_IOV                16
+#endif // INET_CONFIG_TCP_SEND_GATHER_MAX_IOV
+
+#if INET_CONFIG_ENABLE_TCP_SEND_GATHER && INET_CONFIG_TCP_SEND_GATHER_MAX_IOV < 1
+#error "INET_CONFIG_TCP_SEND_GATHER_MAX_IOV must be at least 1"
+#endif // INET_CONFIG_ENABLE_TCP_SEND_GATHER && INET_CONFIG_TCP_SEND_GATHER_MAX_IOV < 1
+
+/**
+ *  @def INET_CONFIG_ENABLE_TCP_SEND_ZEROCOPY
+ *
+ *  @brief
+ *    Defines whether (1) or not (0) TCP endpoints use the Linux
+ *    MSG_ZEROCOPY facility for large vectored sends.
+ *
+ *  @details
+ *    When enabled, a vectored send of at least
+ *    #INET_CONFIG_TCP_SEND_ZEROCOPY_THRESHOLD bytes asks the kernel to
+ *    transmit directly from the packet buffers instead of copying them
+ *    into the socket. Buffers sent this way are held by the endpoint, up
+ *    to #INET_CONFIG_TCP_SEND_ZEROCOPY_MAX_PENDING of them, until the
+ *    kernel reports on the socket error queue that it no longer
+ *    references them; when that limit is reached, sends fall back to
+ *    copying until completions catch up. Buffers still held when the
+ *    endpoint is closed are released at that point.
+ *
+ *    If the kernel does not support SO_ZEROCOPY, endpoints silently use
+ *    copying sends. Zero-copy transmission only pays off for large
+ *    writes; small sends are always copied.
+ *
+ *    This option requires #INET_CONFIG_ENABLE_TCP_SEND_GATHER and is only
+ *    available on Linux.
+ */
+#ifndef INET_CONFIG_ENABLE_TCP_SEND_ZEROCOPY
+#define INET_CONFIG_ENABLE_TCP_SEND_ZEROCOPY               0
+#endif // INET_CONFIG_ENABLE_TCP_SEND_ZEROCOPY
+
+#if INET_CONFIG_ENABLE_TCP_SEND_ZEROCOPY && !INET_CONFIG_ENABLE_TCP_SEND_GATHER
+#error "INET_CONFIG_ENABLE_TCP_SEND_ZEROCOPY requires INET_CONFIG_ENABLE_TCP_SEND_GATHER"
+#endif // INET_CONFIG_ENABLE_TCP_SEND_ZEROCOPY && !INET_CONFIG_ENABLE_TCP_SEND_GATHER
+
+/**
+ *  @def INET_CONFIG_TCP_SEND_ZEROCOPY_THRESHOLD
+ *
+ *  @brief
+ *    The minimum size, in bytes, of a vectored TCP send for which
+ *    MSG_ZEROCOPY is requested.
+ *
+ *  @details
+ *    This option is only meaningful when
+ *    #INET_CONFIG_ENABLE_TCP_SEND_ZEROCOPY is enabled.
+ */
+#ifndef INET_CONFIG_TCP_SEND_ZEROCOPY_THRESHOLD
+#define INET_CONFIG_TCP_SEND_ZEROCOPY_THRESHOLD            10240
+#endif // INET_CONFIG_TCP_SEND_ZEROCOPY_THRESHOLD
+
+/**
+ *  @def INET_CONFIG_TCP_SEND_ZEROCOPY_MAX_PENDING
+ *
+ *  @brief
+ *    The maximum number of sent packet buffers a TCP endpoint holds while
+ *    waiting for zero-copy completion notifications.
+ *
+ *  @details
+ *    This option is only meaningful when
+ *    #INET_CONFIG_ENABLE_TCP_SEND_ZEROCOPY is enabled.
+ */
+#ifndef INET_CONFIG_TCP_SEND_ZEROCOPY_MAX_PENDING
+#define INET_CONFIG_TCP_SEND_ZEROCOPY_MAX_PENDING          32
+#endif // INET_CONFIG_TCP_SEND_ZEROCOPY_MAX_PENDING
+
+/**
+ *  @def INET_CONFIG_ENABLE_EVENT_LOOP_SHARDS
+ *
+ *  @brief
+ *    Defines whether (1) or not (0) the nl::Inet::EventLoopShards class,
+ *    which runs several System::Layer / InetLayer pairs, each on its own
+ *    thread, is available.
+ *
+ *  @details
+ *    Each shard owns its own timers and end points and services them
+ *    from its own select loop; work is handed between shards with
+ *    System::Layer::ScheduleWork. Listening UDP and TCP end points bound
+ *    to the same port in every shard share it through SO_REUSEPORT, so
+ *    the kernel spreads datagrams and incoming connections across the
+ *    shards.
+ *
+ *    This option requires sockets and #WEAVE_SYSTEM_CONFIG_POSIX_LOCKING,
+ *    since the packet buffer pool is shared by all shards.
+ */
+#ifndef INET_CONFIG_ENABLE_EVENT_LOOP_SHARDS
+#define INET_CONFIG_ENABLE_EVENT_LOOP_SHARDS               0
+#endif // INET_CONFIG_ENABLE_EVENT_LOOP_SHARDS
+
+#if INET_CONFIG_ENABLE_EVENT_LOOP_SHARDS && !(WEAVE_SYSTEM_CONFIG_USE_SOCKETS && WEAVE_SYSTEM_CONFIG_POSIX_LOCKING)
+#error "INET_CONFIG_ENABLE_EVENT_LOOP_SHARDS requires WEAVE_SYSTEM_CONFIG_USE_SOCKETS and WEAVE_SYSTEM_CONFIG_POSIX_LOCKING"
+#endif // INET_CONFIG_ENABLE_EVENT_LOOP_SHARDS && !(WEAVE_SYSTEM_CONFIG_USE_SOCKETS && WEAVE_SYSTEM_CONFIG_POSIX_LOCKING)
+
+/**
+ *  @def INET_CONFIG_MAX_EVENT_LOOP_SHARDS
+ *
+ *  @brief
+ *    The maximum number of shards an nl::Inet::EventLoopShards object
+ *    can run.
+ *
+ *  @details
+ *    This option is only meaningful when
+ *    #INET_CONFIG_ENABLE_EVENT_LOOP_SHARDS is enabled. The end point and
+ *    timer pools are shared by all shards, so they should be sized for
+ *    the total across shards.
+ */
+#ifndef INET_CONFIG_MAX_EVENT_LOOP_SHARDS
+#define INET_CONFIG_MAX_EVENT_LOOP_SHARDS                  8
+#endif // INET_CONFIG_MAX_EVENT_LOOP_SHARDS
+
+/**
+ *  @def INET_CONFIG_ENABLE_DNS_CACHE
+ *
+ *  @brief
+ *    Defines whether (1) or not (0) InetLayer::ResolveHostAddress()
+ *    answers requests from a cache of recent host name resolutions.
+ *
+ *  @details
+ *    Both successful and failed resolutions are cached, for
+ *    #INET_CONFIG_DNS_CACHE_POSITIVE_TTL and
+ *    #INET_CONFIG_DNS_CACHE_NEGATIVE_TTL seconds respectively. Requests
+ *    for a host name whose resolution is already in progress wait for
+ *    that resolution rather than starting another, so that many
+ *    connections re-established at once cause a single lookup.
+ *
+ *    This option requires #INET_CONFIG_ENABLE_DNS_RESOLVER.
+ */
+#ifndef INET_CONFIG_ENABLE_DNS_CACHE
+#define INET_CONFIG_ENABLE_DNS_CACHE                       0
+#endif // INET_CONFIG_ENABLE_DNS_CACHE
+
+#if INET_CONFIG_ENABLE_DNS_CACHE && !INET_CONFIG_ENABLE_DNS_RESOLVER
+#error "INET_CONFIG_ENABLE_DNS_CACHE requires INET_CONFIG_ENABLE_DNS_RESOLVER"
+#endif // INET_CONFIG_ENABLE_DNS_CACHE && !INET_CONFIG_ENABLE_DNS_RESOLVER
+
+/**
+ *  @def INET_CONFIG_DNS_CACHE_SIZE
+ *
+ *  @brief
+ *    The number of host names, including those being resolved, the
+ *    DNS cache holds. The least recently used resolution is evicted to
+ *    make room for a new one.
+ */
+#ifndef INET_CONFIG_DNS_CACHE_SIZE
+#define INET_CONFIG_DNS_CACHE_SIZE                         8
+#endif // INET_CONFIG_DNS_CACHE_SIZE
+
+/**
+ *  @def INET_CONFIG_DNS_CACHE_MAX_ADDRS
+ *
+ *  @brief
+ *    The maximum number of addresses the DNS cache keeps for a host
+ *    name; callers asking for more receive at most this many.
+ */
+#ifndef INET_CONFIG_DNS_CACHE_MAX_ADDRS
+#define INET_CONFIG_DNS_CACHE_MAX_ADDRS                    4
+#endif // INET_CONFIG_DNS_CACHE_MAX_ADDRS
+
+/**
+ *  @def INET_CONFIG_DNS_CACHE_MAX_WAITERS
+ *
+ *  @brief
+ *    The maximum number of requests that may be waiting, across all
+ *    host names, for resolutions in progress in the DNS cache.
+ */
+#ifndef INET_CONFIG_DNS_CACHE_MAX_WAITERS
+#define INET_CONFIG_DNS_CACHE_MAX_WAITERS                  16
+#endif // INET_CONFIG_DNS_CACHE_MAX_WAITERS
+
+/**
+ *  @def INET_CONFIG_DNS_CACHE_POSITIVE_TTL
+ *
+ *  @brief
+ *    The time, in seconds, a successful resolution is cached when the
+ *    resolver does not report a time to live. The platform resolvers
+ *    never do; a stub resolver may.
+ */
+#ifndef INET_CONFIG_DNS_CACHE_POSITIVE_TTL
+#define INET_CONFIG_DNS_CACHE_POSITIVE_TTL                 300
+#endif // INET_CONFIG_DNS_CACHE_POSITIVE_TTL
+
+/**
+ *  @def INET_CONFIG_DNS_CACHE_NEGATIVE_TTL
+ *
+ *  @brief
+ *    The time, in seconds, a failed resolution is cached when the
+ *    resolver does not report a time to live.
+ */
+#ifndef INET_CONFIG_DNS_CACHE_NEGATIVE_TTL
+#define INET_CONFIG_DNS_CACHE_NEGATIVE_TTL                 30
+#endif // INET_CONFIG_DNS_CACHE_NEGATIVE_TTL
 // clang-format on
 
 #endif /* INETCONFIG_H */
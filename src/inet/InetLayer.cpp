@@ -65,6 +65,9 @@
 #include <unistd.h>
 #include <fcntl.h>
 #include <net/if.h>
+#if INET_CONFIG_ENABLE_EPOLL
+#include <sys/epoll.h>
+#endif // INET_CONFIG_ENABLE_EPOLL
 #ifdef __ANDROID__
 #include <ifaddrs-android.h>
 #else
@@ -129,6 +132,10 @@ InetLayer::InetLayer(void)
 {
     State = kState_NotInitialized;
 
+#if INET_CONFIG_ENABLE_EPOLL
+    mEpollFD = INET_INVALID_SOCKET_FD;
+#endif // INET_CONFIG_ENABLE_EPOLL
+
 #if WEAVE_SYSTEM_CONFIG_USE_LWIP
     if (!sInetEventHandlerDelegate.IsInitialized())
         sInetEventHandlerDelegate.Init(HandleInetLayerEvent);
@@ -303,8 +310,17 @@ INET_ERROR InetLayer::Init(Weave::System::Layer& aSystemLayer, void *aContext)
     mSystemLayer->AddEventHandlerDelegate(sInetEventHandlerDelegate);
 #endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
 
+#if INET_CONFIG_ENABLE_EPOLL
+    mEpollFD = epoll_create1(EPOLL_CLOEXEC);
+    VerifyOrExit(mEpollFD != INET_INVALID_SOCKET_FD, err = Weave::System::MapErrorPOSIX(errno));
+#endif // INET_CONFIG_ENABLE_EPOLL
+
     State = kState_Initialized;
 
+#if INET_CONFIG_ENABLE_DNS_CACHE
+    mDNSCache.Init(*this);
+#endif // INET_CONFIG_ENABLE_DNS_CACHE
+
 #if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 #if INET_CONFIG_ENABLE_DNS_RESOLVER && INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS
 
@@ -343,9 +359,13 @@ INET_ERROR InetLayer::Shutdown(void)
 
     if (State == kState_Initialized)
     {
+#if INET_CONFIG_ENABLE_DNS_CACHE
+        mDNSCache.Shutdown();
+#endif // INET_CONFIG_ENABLE_DNS_CACHE
+
 #if INET_CONFIG_ENABLE_DNS_RESOLVER
         // Cancel all DNS resolution requests owned by this instance.
-        for (size_t i = 0; i < DNSResolver::sPool.Size(); i++)
+        for (size_t i = DNSResolver::sPool.NextIndex(0); i < DNSResolver::sPool.Size(); i = DNSResolver::sPool.NextIndex(i + 1))
         {
             DNSResolver* lResolver = DNSResolver::sPool.Get(*mSystemLayer, i);
             if ((lResolver != NULL) && lResolver->IsCreatedByInetLayer(*this))
@@ -363,7 +383,7 @@ INET_ERROR InetLayer::Shutdown(void)
 
 #if INET_CONFIG_ENABLE_RAW_ENDPOINT
         // Close all raw endpoints owned by this Inet layer instance.
-        for (size_t i = 0; i < RawEndPoint::sPool.Size(); i++)
+        for (size_t i = RawEndPoint::sPool.NextIndex(0); i < RawEndPoint::sPool.Size(); i = RawEndPoint::sPool.NextIndex(i + 1))
         {
             RawEndPoint* lEndPoint = RawEndPoint::sPool.Get(*mSystemLayer, i);
             if ((lEndPoint != NULL) && lEndPoint->IsCreatedByInetLayer(*this))
@@ -375,7 +395,7 @@ INET_ERROR InetLayer::Shutdown(void)
 
 #if INET_CONFIG_ENABLE_TCP_ENDPOINT
         // Abort all TCP endpoints owned by this instance.
-        for (size_t i = 0; i < TCPEndPoint::sPool.Size(); i++)
+        for (size_t i = TCPEndPoint::sPool.NextIndex(0); i < TCPEndPoint::sPool.Size(); i = TCPEndPoint::sPool.NextIndex(i + 1))
         {
             TCPEndPoint* lEndPoint = TCPEndPoint::sPool.Get(*mSystemLayer, i);
             if ((lEndPoint != NULL) && lEndPoint->IsCreatedByInetLayer(*this))
@@ -387,7 +407,7 @@ INET_ERROR InetLayer::Shutdown(void)
 
 #if INET_CONFIG_ENABLE_UDP_ENDPOINT
         // Close all UDP endpoints owned by this instance.
-        for (size_t i = 0; i < UDPEndPoint::sPool.Size(); i++)
+        for (size_t i = UDPEndPoint::sPool.NextIndex(0); i < UDPEndPoint::sPool.Size(); i = UDPEndPoint::sPool.NextIndex(i + 1))
         {
             UDPEndPoint* lEndPoint = UDPEndPoint::sPool.Get(*mSystemLayer, i);
             if ((lEndPoint != NULL) && lEndPoint->IsCreatedByInetLayer(*this))
@@ -397,6 +417,11 @@ INET_ERROR InetLayer::Shutdown(void)
         }
 #endif // INET_CONFIG_ENABLE_UDP_ENDPOINT
 
+#if INET_CONFIG_ENABLE_EPOLL
+        close(mEpollFD);
+        mEpollFD = INET_INVALID_SOCKET_FD;
+#endif // INET_CONFIG_ENABLE_EPOLL
+
 #if INET_CONFIG_PROVIDE_OBSOLESCENT_INTERFACES
         if (mSystemLayer == &mImplicitSystemLayer)
         {
@@ -446,7 +471,7 @@ bool InetLayer::IsIdleTimerRunning(void)
     bool timerRunning = false;
 
     // see if there are any TCP connections with the idle timer check in use.
-    for (size_t i = 0; i < TCPEndPoint::sPool.Size(); i++)
+    for (size_t i = TCPEndPoint::sPool.NextIndex(0); i < TCPEndPoint::sPool.Size(); i = TCPEndPoint::sPool.NextIndex(i + 1))
     {
         TCPEndPoint* lEndPoint = TCPEndPoint::sPool.Get(*mSystemLayer, i);
 
@@ -879,6 +904,14 @@ INET_ERROR InetLayer::ResolveHostAddress(const char *hostName, uint16_t hostName
     VerifyOrExit(hostNameLen <= NL_DNS_HOSTNAME_MAX_LEN, err = INET_ERROR_HOST_NAME_TOO_LONG);
     VerifyOrExit(maxAddrs > 0, err = INET_ERROR_NO_MEMORY);
 
+#if INET_CONFIG_ENABLE_DNS_CACHE
+    // Answer host names, other than text-form addresses, from the cache, unless this is the cache's own lookup.
+    if (onComplete != DNSCache::HandleLookupComplete && !IPAddress::FromString(hostName, hostNameLen, *addrArray))
+    {
+        ExitNow(err = mDNSCache.Resolve(hostName, hostNameLen, options, maxAddrs, addrArray, onComplete, appState));
+    }
+#endif // INET_CONFIG_ENABLE_DNS_CACHE
+
     resolver = DNSResolver::sPool.TryCreate(*mSystemLayer);
     if (resolver != NULL)
     {
@@ -961,7 +994,12 @@ void InetLayer::CancelResolveHostAddress(DNSResolveCompleteFunct onComplete, voi
     if (State != kState_Initialized)
         return;
 
-    for (size_t i = 0; i < DNSResolver::sPool.Size(); i++)
+#if INET_CONFIG_ENABLE_DNS_CACHE
+    if (mDNSCache.Cancel(onComplete, appState))
+        return;
+#endif // INET_CONFIG_ENABLE_DNS_CACHE
+
+    for (size_t i = DNSResolver::sPool.NextIndex(0); i < DNSResolver::sPool.Size(); i = DNSResolver::sPool.NextIndex(i + 1))
     {
         DNSResolver* lResolver = DNSResolver::sPool.Get(*mSystemLayer, i);
 
@@ -1165,7 +1203,7 @@ void InetLayer::HandleTCPInactivityTimer(Weave::System::Layer* aSystemLayer, voi
     InetLayer& lInetLayer = *reinterpret_cast<InetLayer*>(aAppState);
     bool lTimerRequired = lInetLayer.IsIdleTimerRunning();
 
-    for (size_t i = 0; i < INET_CONFIG_NUM_TCP_ENDPOINTS; i++)
+    for (size_t i = TCPEndPoint::sPool.NextIndex(0); i < TCPEndPoint::sPool.Size(); i = TCPEndPoint::sPool.NextIndex(i + 1))
     {
         TCPEndPoint* lEndPoint = TCPEndPoint::sPool.Get(*aSystemLayer, i);
 
@@ -1429,8 +1467,16 @@ void InetLayer::PrepareSelect(int& nfds, fd_set *readfds, fd_set *writefds, fd_s
     if (State != kState_Initialized)
         return;
 
+#if INET_CONFIG_ENABLE_EPOLL
+    // Endpoint sockets are tracked by the epoll instance, which is itself
+    // readable whenever any of them is ready.
+    FD_SET(mEpollFD, readfds);
+    if (mEpollFD + 1 > nfds)
+        nfds = mEpollFD + 1;
+#else // !INET_CONFIG_ENABLE_EPOLL
+
 #if INET_CONFIG_ENABLE_RAW_ENDPOINT
-    for (size_t i = 0; i < RawEndPoint::sPool.Size(); i++)
+    for (size_t i = RawEndPoint::sPool.NextIndex(0); i < RawEndPoint::sPool.Size(); i = RawEndPoint::sPool.NextIndex(i + 1))
     {
         RawEndPoint* lEndPoint = RawEndPoint::sPool.Get(*mSystemLayer, i);
         if ((lEndPoint != NULL) && lEndPoint->IsCreatedByInetLayer(*this))
@@ -1439,7 +1485,7 @@ void InetLayer::PrepareSelect(int& nfds, fd_set *readfds, fd_set *writefds, fd_s
 #endif // INET_CONFIG_ENABLE_RAW_ENDPOINT
 
 #if INET_CONFIG_ENABLE_TCP_ENDPOINT
-    for (size_t i = 0; i < TCPEndPoint::sPool.Size(); i++)
+    for (size_t i = TCPEndPoint::sPool.NextIndex(0); i < TCPEndPoint::sPool.Size(); i = TCPEndPoint::sPool.NextIndex(i + 1))
     {
         TCPEndPoint* lEndPoint = TCPEndPoint::sPool.Get(*mSystemLayer, i);
         if ((lEndPoint != NULL) && lEndPoint->IsCreatedByInetLayer(*this))
@@ -1448,7 +1494,7 @@ void InetLayer::PrepareSelect(int& nfds, fd_set *readfds, fd_set *writefds, fd_s
 #endif // INET_CONFIG_ENABLE_TCP_ENDPOINT
 
 #if INET_CONFIG_ENABLE_UDP_ENDPOINT
-    for (size_t i = 0; i < UDPEndPoint::sPool.Size(); i++)
+    for (size_t i = UDPEndPoint::sPool.NextIndex(0); i < UDPEndPoint::sPool.Size(); i = UDPEndPoint::sPool.NextIndex(i + 1))
     {
         UDPEndPoint* lEndPoint = UDPEndPoint::sPool.Get(*mSystemLayer, i);
         if ((lEndPoint != NULL) && lEndPoint->IsCreatedByInetLayer(*this))
@@ -1457,13 +1503,14 @@ void InetLayer::PrepareSelect(int& nfds, fd_set *readfds, fd_set *writefds, fd_s
 #endif // INET_CONFIG_ENABLE_UDP_ENDPOINT
 
 #if INET_CONFIG_ENABLE_TUN_ENDPOINT
-    for (size_t i = 0; i < TunEndPoint::sPool.Size(); i++)
+    for (size_t i = TunEndPoint::sPool.NextIndex(0); i < TunEndPoint::sPool.Size(); i = TunEndPoint::sPool.NextIndex(i + 1))
     {
         TunEndPoint* lEndPoint = TunEndPoint::sPool.Get(*mSystemLayer, i);
         if ((lEndPoint != NULL) && lEndPoint->IsCreatedByInetLayer(*this))
             lEndPoint->PrepareIO().SetFDs(lEndPoint->mSocket, nfds, readfds, writefds, exceptfds);
     }
 #endif // INET_CONFIG_ENABLE_TUN_ENDPOINT
+#endif // !INET_CONFIG_ENABLE_EPOLL
 
 #if INET_CONFIG_PROVIDE_OBSOLESCENT_INTERFACES
     if (mSystemLayer == &mImplicitSystemLayer)
@@ -1508,11 +1555,17 @@ void InetLayer::HandleSelectResult(int selectRes, fd_set *readfds, fd_set *write
     if (selectRes < 0)
         return;
 
+#if INET_CONFIG_ENABLE_EPOLL
+    if (selectRes > 0 && FD_ISSET(mEpollFD, readfds))
+    {
+        HandleEpollEvents();
+    }
+#else // !INET_CONFIG_ENABLE_EPOLL
     if (selectRes > 0)
     {
         // Set the pending I/O field for each active endpoint based on the value returned by select.
 #if INET_CONFIG_ENABLE_RAW_ENDPOINT
-        for (size_t i = 0; i < RawEndPoint::sPool.Size(); i++)
+        for (size_t i = RawEndPoint::sPool.NextIndex(0); i < RawEndPoint::sPool.Size(); i = RawEndPoint::sPool.NextIndex(i + 1))
         {
             RawEndPoint* lEndPoint = RawEndPoint::sPool.Get(*mSystemLayer, i);
             if ((lEndPoint != NULL) && lEndPoint->IsCreatedByInetLayer(*this))
@@ -1523,7 +1576,7 @@ void InetLayer::HandleSelectResult(int selectRes, fd_set *readfds, fd_set *write
 #endif // INET_CONFIG_ENABLE_RAW_ENDPOINT
 
 #if INET_CONFIG_ENABLE_TCP_ENDPOINT
-        for (size_t i = 0; i < TCPEndPoint::sPool.Size(); i++)
+        for (size_t i = TCPEndPoint::sPool.NextIndex(0); i < TCPEndPoint::sPool.Size(); i = TCPEndPoint::sPool.NextIndex(i + 1))
         {
             TCPEndPoint* lEndPoint = TCPEndPoint::sPool.Get(*mSystemLayer, i);
             if ((lEndPoint != NULL) && lEndPoint->IsCreatedByInetLayer(*this))
@@ -1534,7 +1587,7 @@ void InetLayer::HandleSelectResult(int selectRes, fd_set *readfds, fd_set *write
 #endif // INET_CONFIG_ENABLE_TCP_ENDPOINT
 
 #if INET_CONFIG_ENABLE_UDP_ENDPOINT
-        for (size_t i = 0; i < UDPEndPoint::sPool.Size(); i++)
+        for (size_t i = UDPEndPoint::sPool.NextIndex(0); i < UDPEndPoint::sPool.Size(); i = UDPEndPoint::sPool.NextIndex(i + 1))
         {
             UDPEndPoint* lEndPoint = UDPEndPoint::sPool.Get(*mSystemLayer, i);
             if ((lEndPoint != NULL) && lEndPoint->IsCreatedByInetLayer(*this))
@@ -1545,7 +1598,7 @@ void InetLayer::HandleSelectResult(int selectRes, fd_set *readfds, fd_set *write
 #endif // INET_CONFIG_ENABLE_UDP_ENDPOINT
 
 #if INET_CONFIG_ENABLE_TUN_ENDPOINT
-        for (size_t i = 0; i < TunEndPoint::sPool.Size(); i++)
+        for (size_t i = TunEndPoint::sPool.NextIndex(0); i < TunEndPoint::sPool.Size(); i = TunEndPoint::sPool.NextIndex(i + 1))
         {
             TunEndPoint* lEndPoint = TunEndPoint::sPool.Get(*mSystemLayer, i);
             if ((lEndPoint != NULL) && lEndPoint->IsCreatedByInetLayer(*this))
@@ -1557,7 +1610,7 @@ void InetLayer::HandleSelectResult(int selectRes, fd_set *readfds, fd_set *write
 
         // Now call each active endpoint to handle its pending I/O.
 #if INET_CONFIG_ENABLE_RAW_ENDPOINT
-        for (size_t i = 0; i < RawEndPoint::sPool.Size(); i++)
+        for (size_t i = RawEndPoint::sPool.NextIndex(0); i < RawEndPoint::sPool.Size(); i = RawEndPoint::sPool.NextIndex(i + 1))
         {
             RawEndPoint* lEndPoint = RawEndPoint::sPool.Get(*mSystemLayer, i);
             if ((lEndPoint != NULL) && lEndPoint->IsCreatedByInetLayer(*this))
@@ -1568,7 +1621,7 @@ void InetLayer::HandleSelectResult(int selectRes, fd_set *readfds, fd_set *write
 #endif // INET_CONFIG_ENABLE_RAW_ENDPOINT
 
 #if INET_CONFIG_ENABLE_TCP_ENDPOINT
-        for (size_t i = 0; i < TCPEndPoint::sPool.Size(); i++)
+        for (size_t i = TCPEndPoint::sPool.NextIndex(0); i < TCPEndPoint::sPool.Size(); i = TCPEndPoint::sPool.NextIndex(i + 1))
         {
             TCPEndPoint* lEndPoint = TCPEndPoint::sPool.Get(*mSystemLayer, i);
             if ((lEndPoint != NULL) && lEndPoint->IsCreatedByInetLayer(*this))
@@ -1579,7 +1632,7 @@ void InetLayer::HandleSelectResult(int selectRes, fd_set *readfds, fd_set *write
 #endif // INET_CONFIG_ENABLE_TCP_ENDPOINT
 
 #if INET_CONFIG_ENABLE_UDP_ENDPOINT
-        for (size_t i = 0; i < UDPEndPoint::sPool.Size(); i++)
+        for (size_t i = UDPEndPoint::sPool.NextIndex(0); i < UDPEndPoint::sPool.Size(); i = UDPEndPoint::sPool.NextIndex(i + 1))
         {
             UDPEndPoint* lEndPoint = UDPEndPoint::sPool.Get(*mSystemLayer, i);
             if ((lEndPoint != NULL) && lEndPoint->IsCreatedByInetLayer(*this))
@@ -1590,7 +1643,7 @@ void InetLayer::HandleSelectResult(int selectRes, fd_set *readfds, fd_set *write
 #endif // INET_CONFIG_ENABLE_UDP_ENDPOINT
 
 #if INET_CONFIG_ENABLE_TUN_ENDPOINT
-        for (size_t i = 0; i < TunEndPoint::sPool.Size(); i++)
+        for (size_t i = TunEndPoint::sPool.NextIndex(0); i < TunEndPoint::sPool.Size(); i = TunEndPoint::sPool.NextIndex(i + 1))
         {
             TunEndPoint* lEndPoint = TunEndPoint::sPool.Get(*mSystemLayer, i);
             if ((lEndPoint != NULL) && lEndPoint->IsCreatedByInetLayer(*this))
@@ -1600,6 +1653,7 @@ void InetLayer::HandleSelectResult(int selectRes, fd_set *readfds, fd_set *write
         }
 #endif // INET_CONFIG_ENABLE_TUN_ENDPOINT
     }
+#endif // !INET_CONFIG_ENABLE_EPOLL
 
 #if INET_CONFIG_PROVIDE_OBSOLESCENT_INTERFACES
     if (mSystemLayer == &mImplicitSystemLayer)
@@ -1609,6 +1663,252 @@ void InetLayer::HandleSelectResult(int selectRes, fd_set *readfds, fd_set *write
 #endif // INET_CONFIG_PROVIDE_OBSOLESCENT_INTERFACES
 }
 
+#if INET_CONFIG_ENABLE_EPOLL
+
+/**
+ *  Convert a set of requested socket events into the corresponding epoll event mask.
+ */
+static uint32_t EpollEventsFromSocketEvents(SocketEvents aEvents)
+{
+    uint32_t lEvents = 0;
+
+    if (aEvents.IsReadable())
+        lEvents |= EPOLLIN;
+    if (aEvents.IsWriteable())
+        lEvents |= EPOLLOUT;
+    if (aEvents.IsError())
+        lEvents |= EPOLLPRI;
+
+#if INET_CONFIG_EPOLL_EDGE_TRIGGERED
+    lEvents |= EPOLLET;
+#endif // INET_CONFIG_EPOLL_EDGE_TRIGGERED
+
+    return lEvents;
+}
+
+/**
+ *  Convert a set of epoll events reported for a socket into the pending socket events, restricted to those events
+ *  the endpoint is interested in. Error and hang-up conditions are reported as both readable and writable, so that
+ *  the endpoint discovers the condition through its normal read or write path.
+ */
+static SocketEvents SocketEventsFromEpollEvents(uint32_t aEvents, SocketEvents aWatched)
+{
+    SocketEvents lResult;
+
+    if (aEvents & (EPOLLIN | EPOLLERR | EPOLLHUP))
+        lResult.SetRead();
+    if (aEvents & (EPOLLOUT | EPOLLERR | EPOLLHUP))
+        lResult.SetWrite();
+    if (aEvents & EPOLLPRI)
+        lResult.SetError();
+
+    lResult.Value &= aWatched.Value;
+
+    return lResult;
+}
+
+/**
+ *  Associate a newly opened endpoint socket with this Inet layer's epoll instance.
+ *
+ *  The socket is only added to the epoll interest list once the endpoint requests I/O events; see UpdateWatchedIO().
+ *
+ *  @param[in]  aEndPoint       The endpoint owning the socket.
+ *  @param[in]  aEndPointType   The concrete type of the endpoint, one of the EndPointBasis::kSocketEndPointType_* values.
+ *
+ *  @retval #INET_NO_ERROR                  On success.
+ *  @retval #INET_ERROR_INCORRECT_STATE     If the endpoint does not have an open socket.
+ */
+INET_ERROR InetLayer::WatchSocket(EndPointBasis& aEndPoint, uint8_t aEndPointType)
+{
+    INET_ERROR err = INET_NO_ERROR;
+
+    VerifyOrExit(aEndPoint.mSocket != INET_INVALID_SOCKET_FD, err = INET_ERROR_INCORRECT_STATE);
+
+    aEndPoint.mSocketEndPointType = aEndPointType;
+
+exit:
+    return err;
+}
+
+/**
+ *  Remove an endpoint socket from this Inet layer's epoll instance. Must be called before the socket is closed.
+ */
+void InetLayer::UnwatchSocket(EndPointBasis& aEndPoint)
+{
+    if (aEndPoint.mWatchedIO.IsSet() && mEpollFD != INET_INVALID_SOCKET_FD)
+    {
+        epoll_ctl(mEpollFD, EPOLL_CTL_DEL, aEndPoint.mSocket, NULL);
+    }
+
+    aEndPoint.mWatchedIO.Clear();
+    aEndPoint.mPendingIO.Clear();
+    aEndPoint.mSocketEndPointType = EndPointBasis::kSocketEndPointType_Unknown;
+}
+
+/**
+ *  Bring the epoll registration of an endpoint socket in line with the I/O events the endpoint currently requests.
+ *
+ *  Sockets with no requested events are removed from the epoll interest list, so that error or hang-up conditions
+ *  on sockets nobody is waiting on do not repeatedly wake the event loop.
+ *
+ *  @param[in]  aEndPoint   The endpoint to update.
+ *  @param[in]  aRearm      Re-register the socket even if its requested events are unchanged. In edge-triggered
+ *                          mode this causes readiness left over after dispatch to be reported again.
+ */
+void InetLayer::UpdateWatchedIO(EndPointBasis& aEndPoint, bool aRearm)
+{
+    SocketEvents lRequested;
+    struct epoll_event lEvent;
+    int lOperation;
+
+    if (State != kState_Initialized ||
+        aEndPoint.mSocket == INET_INVALID_SOCKET_FD ||
+        aEndPoint.mSocketEndPointType == EndPointBasis::kSocketEndPointType_Unknown)
+        return;
+
+    lRequested = PrepareEndPointIO(aEndPoint);
+
+    if (lRequested.Value == aEndPoint.mWatchedIO.Value && !(aRearm && INET_CONFIG_EPOLL_EDGE_TRIGGERED))
+        return;
+
+    if (!lRequested.IsSet() && !aEndPoint.mWatchedIO.IsSet())
+        return;
+
+    if (!lRequested.IsSet())
+        lOperation = EPOLL_CTL_DEL;
+    else if (!aEndPoint.mWatchedIO.IsSet())
+        lOperation = EPOLL_CTL_ADD;
+    else
+        lOperation = EPOLL_CTL_MOD;
+
+    memset(&lEvent, 0, sizeof(lEvent));
+    lEvent.events = EpollEventsFromSocketEvents(lRequested);
+    lEvent.data.ptr = &aEndPoint;
+
+    if (epoll_ctl(mEpollFD, lOperation, aEndPoint.mSocket, &lEvent) != 0)
+    {
+        WeaveLogError(Inet, "epoll_ctl(%d) failed on fd %d: %d", lOperation, aEndPoint.mSocket, errno);
+        return;
+    }
+
+    aEndPoint.mWatchedIO = lRequested;
+}
+
+/**
+ *  Retrieve the ready endpoint sockets from the epoll instance and dispatch their pending I/O.
+ *
+ *  As with the select()-based dispatch, the pending I/O of every ready endpoint is recorded before any handler is
+ *  invoked, so that an endpoint closed by an earlier callback discards its stale events.
+ */
+void InetLayer::HandleEpollEvents(void)
+{
+    struct epoll_event lEvents[INET_CONFIG_EPOLL_MAX_EVENTS];
+    int lCount;
+
+    lCount = epoll_wait(mEpollFD, lEvents, INET_CONFIG_EPOLL_MAX_EVENTS, 0);
+    if (lCount <= 0)
+        return;
+
+    for (int i = 0; i < lCount; i++)
+    {
+        EndPointBasis* lEndPoint = static_cast<EndPointBasis*>(lEvents[i].data.ptr);
+
+        lEndPoint->mPendingIO = SocketEventsFromEpollEvents(lEvents[i].events, lEndPoint->mWatchedIO);
+    }
+
+    for (int i = 0; i < lCount; i++)
+    {
+        EndPointBasis* lEndPoint = static_cast<EndPointBasis*>(lEvents[i].data.ptr);
+
+        // The endpoint may have been closed, and possibly freed, by a callback made on behalf of an earlier event.
+        if (!lEndPoint->IsRetained(*mSystemLayer) || !lEndPoint->IsCreatedByInetLayer(*this))
+            continue;
+
+        HandleEndPointPendingIO(*lEndPoint);
+
+        if (lEndPoint->IsRetained(*mSystemLayer) && lEndPoint->IsCreatedByInetLayer(*this))
+            UpdateWatchedIO(*lEndPoint, true);
+    }
+}
+
+/**
+ *  Query the concrete endpoint for the I/O events it is currently waiting on.
+ */
+SocketEvents InetLayer::PrepareEndPointIO(EndPointBasis& aEndPoint)
+{
+    SocketEvents lResult;
+
+    switch (aEndPoint.mSocketEndPointType)
+    {
+#if INET_CONFIG_ENABLE_RAW_ENDPOINT
+    case EndPointBasis::kSocketEndPointType_Raw:
+        lResult = static_cast<RawEndPoint&>(aEndPoint).PrepareIO();
+        break;
+#endif // INET_CONFIG_ENABLE_RAW_ENDPOINT
+
+#if INET_CONFIG_ENABLE_UDP_ENDPOINT
+    case EndPointBasis::kSocketEndPointType_UDP:
+        lResult = static_cast<UDPEndPoint&>(aEndPoint).PrepareIO();
+        break;
+#endif // INET_CONFIG_ENABLE_UDP_ENDPOINT
+
+#if INET_CONFIG_ENABLE_TCP_ENDPOINT
+    case EndPointBasis::kSocketEndPointType_TCP:
+        lResult = static_cast<TCPEndPoint&>(aEndPoint).PrepareIO();
+        break;
+#endif // INET_CONFIG_ENABLE_TCP_ENDPOINT
+
+#if INET_CONFIG_ENABLE_TUN_ENDPOINT
+    case EndPointBasis::kSocketEndPointType_Tun:
+        lResult = static_cast<TunEndPoint&>(aEndPoint).PrepareIO();
+        break;
+#endif // INET_CONFIG_ENABLE_TUN_ENDPOINT
+
+    default:
+        break;
+    }
+
+    return lResult;
+}
+
+/**
+ *  Invoke the concrete endpoint's handler for its recorded pending I/O.
+ */
+void InetLayer::HandleEndPointPendingIO(EndPointBasis& aEndPoint)
+{
+    switch (aEndPoint.mSocketEndPointType)
+    {
+#if INET_CONFIG_ENABLE_RAW_ENDPOINT
+    case EndPointBasis::kSocketEndPointType_Raw:
+        static_cast<RawEndPoint&>(aEndPoint).HandlePendingIO();
+        break;
+#endif // INET_CONFIG_ENABLE_RAW_ENDPOINT
+
+#if INET_CONFIG_ENABLE_UDP_ENDPOINT
+    case EndPointBasis::kSocketEndPointType_UDP:
+        static_cast<UDPEndPoint&>(aEndPoint).HandlePendingIO();
+        break;
+#endif // INET_CONFIG_ENABLE_UDP_ENDPOINT
+
+#if INET_CONFIG_ENABLE_TCP_ENDPOINT
+    case EndPointBasis::kSocketEndPointType_TCP:
+        static_cast<TCPEndPoint&>(aEndPoint).HandlePendingIO();
+        break;
+#endif // INET_CONFIG_ENABLE_TCP_ENDPOINT
+
+#if INET_CONFIG_ENABLE_TUN_ENDPOINT
+    case EndPointBasis::kSocketEndPointType_Tun:
+        static_cast<TunEndPoint&>(aEndPoint).HandlePendingIO();
+        break;
+#endif // INET_CONFIG_ENABLE_TUN_ENDPOINT
+
+    default:
+        break;
+    }
+}
+
+#endif // INET_CONFIG_ENABLE_EPOLL
+
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
 /**
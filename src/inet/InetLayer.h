@@ -65,10 +65,18 @@
 #include <InetLayer/InetLayerBasis.h>
 #include <InetLayer/InetLayerEvents.h>
 
+#if INET_CONFIG_ENABLE_EPOLL
+#include <InetLayer/EndPointBasis.h>
+#endif // INET_CONFIG_ENABLE_EPOLL
+
 #if INET_CONFIG_ENABLE_DNS_RESOLVER
 #include <InetLayer/DNSResolver.h>
 #endif // INET_CONFIG_ENABLE_DNS_RESOLVER
 
+#if INET_CONFIG_ENABLE_DNS_CACHE
+#include <InetLayer/DNSCache.h>
+#endif // INET_CONFIG_ENABLE_DNS_CACHE
+
 #if INET_CONFIG_ENABLE_RAW_ENDPOINT
 #include <InetLayer/RawEndPoint.h>
 #endif // INET_CONFIG_ENABLE_RAW_ENDPOINT
@@ -243,6 +251,10 @@ class NL_DLL_EXPORT InetLayer
             DNSResolveCompleteFunct onComplete, void *appState);
     void CancelResolveHostAddress(DNSResolveCompleteFunct onComplete, void *appState);
 
+#if INET_CONFIG_ENABLE_DNS_CACHE
+    DNSCache& GetDNSCache(void);
+#endif // INET_CONFIG_ENABLE_DNS_CACHE
+
 #endif // INET_CONFIG_ENABLE_DNS_RESOLVER
 
     INET_ERROR GetInterfaceFromAddr(const IPAddress& addr, InterfaceId& intfId);
@@ -367,12 +379,26 @@ private:
     void*                   mPlatformData;
     Weave::System::Layer*   mSystemLayer;
 
+#if INET_CONFIG_ENABLE_DNS_CACHE
+    DNSCache                mDNSCache;
+#endif // INET_CONFIG_ENABLE_DNS_CACHE
+
 #if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 #if INET_CONFIG_ENABLE_DNS_RESOLVER && INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS
     AsyncDNSResolverSockets mAsyncDNSResolver;
 #endif // INET_CONFIG_ENABLE_DNS_RESOLVER && INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS
 
+#if INET_CONFIG_ENABLE_EPOLL
+    int                     mEpollFD;
+
+    INET_ERROR WatchSocket(EndPointBasis& aEndPoint, uint8_t aEndPointType);
+    void UnwatchSocket(EndPointBasis& aEndPoint);
+    void UpdateWatchedIO(EndPointBasis& aEndPoint, bool aRearm = false);
+    void HandleEpollEvents(void);
 
+    static SocketEvents PrepareEndPointIO(EndPointBasis& aEndPoint);
+    static void HandleEndPointPendingIO(EndPointBasis& aEndPoint);
+#endif // INET_CONFIG_ENABLE_EPOLL
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
     friend INET_ERROR Platform::InetLayer::WillInit(Inet::InetLayer *aLayer, void *aContext);
@@ -399,6 +425,16 @@ inline Weave::System::Layer* InetLayer::SystemLayer(void) const
     return mSystemLayer;
 }
 
+#if INET_CONFIG_ENABLE_DNS_CACHE
+/**
+ *  @return The cache consulted by ResolveHostAddress(), for setting a stub resolver, flushing it or reading its counters.
+ */
+inline DNSCache& InetLayer::GetDNSCache(void)
+{
+    return mDNSCache;
+}
+#endif // INET_CONFIG_ENABLE_DNS_CACHE
+
 #if INET_CONFIG_PROVIDE_OBSOLESCENT_INTERFACES
 inline INET_ERROR InetLayer::Init(void* aContext)
 {
@@ -130,6 +130,12 @@ public:
      */
     SocketEvents(const SocketEvents& other) { Value = other.Value; }
 
+    /**
+     *  Copy assignment operator for the SocketEvents class.
+     *
+     */
+    SocketEvents& operator =(const SocketEvents& other) { Value = other.Value; return *this; }
+
     /**
      *  Check if any of the bit flags for the socket events are set.
      *
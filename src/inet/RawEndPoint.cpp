@@ -353,6 +353,9 @@ INET_ERROR RawEndPoint::BindIPv6LinkLocal(InterfaceId intf, IPAddress addr)
 
 optfail:
     res = Weave::System::MapErrorPOSIX(errno);
+#if INET_CONFIG_ENABLE_EPOLL
+    Layer().UnwatchSocket(*this);
+#endif // INET_CONFIG_ENABLE_EPOLL
     ::close(mSocket);
     mSocket = INET_INVALID_SOCKET_FD;
     mAddrType = kIPAddressType_Unknown;
@@ -431,6 +434,10 @@ INET_ERROR RawEndPoint::Listen(void)
     if (res == INET_NO_ERROR)
     {
         mState = kState_Listening;
+
+#if INET_CONFIG_ENABLE_EPOLL
+        Layer().UpdateWatchedIO(*this);
+#endif // INET_CONFIG_ENABLE_EPOLL
     }
 
  exit:
@@ -479,6 +486,10 @@ void RawEndPoint::Close(void)
             // Wake the thread calling select so that it recognizes the socket is closed.
             lSystemLayer.WakeSelect();
 
+#if INET_CONFIG_ENABLE_EPOLL
+            Layer().UnwatchSocket(*this);
+#endif // INET_CONFIG_ENABLE_EPOLL
+
             close(mSocket);
             mSocket = INET_INVALID_SOCKET_FD;
         }
@@ -486,6 +497,10 @@ void RawEndPoint::Close(void)
         // Clear any results from select() that indicate pending I/O for the socket.
         mPendingIO.Clear();
 
+#if INET_CONFIG_ENABLE_UDP_BATCH_IO
+        ReleaseRecvBatch();
+#endif // INET_CONFIG_ENABLE_UDP_BATCH_IO
+
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
         mState = kState_Closed;
@@ -1110,6 +1125,11 @@ INET_ERROR RawEndPoint::GetSocket(IPAddressType aAddressType)
     lRetval = IPEndPointBasis::GetSocket(aAddressType, lType, lProtocol);
     SuccessOrExit(lRetval);
 
+#if INET_CONFIG_ENABLE_EPOLL
+    lRetval = Layer().WatchSocket(*this, kSocketEndPointType_Raw);
+    SuccessOrExit(lRetval);
+#endif // INET_CONFIG_ENABLE_EPOLL
+
 exit:
     return (lRetval);
 }
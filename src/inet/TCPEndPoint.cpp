@@ -58,6 +58,13 @@
 #include <fcntl.h>
 #include <errno.h>
 #include <netinet/tcp.h>
+#if INET_CONFIG_ENABLE_TCP_SEND_GATHER
+#include <sys/uio.h>
+#endif // INET_CONFIG_ENABLE_TCP_SEND_GATHER
+#if INET_CONFIG_ENABLE_TCP_SEND_ZEROCOPY
+#include <poll.h>
+#include <linux/errqueue.h>
+#endif // INET_CONFIG_ENABLE_TCP_SEND_ZEROCOPY
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
 #include "arpa-inet-compatibility.h"
@@ -291,6 +298,10 @@ INET_ERROR TCPEndPoint::Listen(uint16_t backlog)
         // [or on LwIP, DeferredRelease()] will happen in DoClose().
         Retain();
         State = kState_Listening;
+
+#if INET_CONFIG_ENABLE_EPOLL
+        Layer().UpdateWatchedIO(*this);
+#endif // INET_CONFIG_ENABLE_EPOLL
     }
 
     return res;
@@ -501,6 +512,10 @@ INET_ERROR TCPEndPoint::Connect(IPAddress addr, uint16_t port, InterfaceId intf)
     else
         State = kState_Connecting;
 
+#if INET_CONFIG_ENABLE_EPOLL
+    Layer().UpdateWatchedIO(*this);
+#endif // INET_CONFIG_ENABLE_EPOLL
+
     // Wake the thread calling select so that it recognizes the new socket.
     lSystemLayer.WakeSelect();
 
@@ -729,12 +744,20 @@ INET_ERROR TCPEndPoint::Send(PacketBuffer *data, bool push)
     if (push)
         res = DriveSending();
 
+#if INET_CONFIG_ENABLE_EPOLL
+    Layer().UpdateWatchedIO(*this);
+#endif // INET_CONFIG_ENABLE_EPOLL
+
     return res;
 }
 
 void TCPEndPoint::DisableReceive()
 {
     ReceiveEnabled = false;
+
+#if INET_CONFIG_ENABLE_EPOLL
+    Layer().UpdateWatchedIO(*this);
+#endif // INET_CONFIG_ENABLE_EPOLL
 }
 
 void TCPEndPoint::EnableReceive()
@@ -749,6 +772,10 @@ void TCPEndPoint::EnableReceive()
 
 #if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
+#if INET_CONFIG_ENABLE_EPOLL
+    Layer().UpdateWatchedIO(*this);
+#endif // INET_CONFIG_ENABLE_EPOLL
+
     // Wake the thread calling select so that it can include the socket
     // in the select read fd_set.
     lSystemLayer.WakeSelect();
@@ -1054,6 +1081,16 @@ INET_ERROR TCPEndPoint::PutBackReceivedData(PacketBuffer *data)
 
     mRcvQueue = data;
 
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+    // Find the tail once here, rather than on every subsequent read.
+    if (data != NULL)
+    {
+        mRcvQueueTail = data;
+        while (mRcvQueueTail->Next() != NULL)
+            mRcvQueueTail = mRcvQueueTail->Next();
+    }
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+
     return INET_NO_ERROR;
 }
 
@@ -1085,6 +1122,10 @@ INET_ERROR TCPEndPoint::Shutdown()
     {
         State = kState_SendShutdown;
         DriveSending();
+
+#if INET_CONFIG_ENABLE_EPOLL
+        Layer().UpdateWatchedIO(*this);
+#endif // INET_CONFIG_ENABLE_EPOLL
     }
 
     // Otherwise, if the peer has already closed their end of the connection,
@@ -1176,6 +1217,16 @@ void TCPEndPoint::Init(InetLayer *inetLayer)
     // Initialize to zero for using system defaults.
     mConnectTimeoutMsecs = 0;
 
+#if INET_CONFIG_ENABLE_TCP_SEND_ZEROCOPY
+    mZeroCopyPending = NULL;
+    mZeroCopyPendingHead = 0;
+    mZeroCopyPendingCount = 0;
+    mZeroCopyQueuedRefs = 0;
+    mZeroCopySendsIssued = 0;
+    mZeroCopySendsCompleted = 0;
+    mZeroCopyState = kZeroCopyState_Unknown;
+#endif // INET_CONFIG_ENABLE_TCP_SEND_ZEROCOPY
+
 #if INET_CONFIG_OVERRIDE_SYSTEM_TCP_USER_TIMEOUT
     mUserTimeoutMillis = INET_CONFIG_DEFAULT_TCP_USER_TIMEOUT_MSEC;
 
@@ -1307,11 +1358,65 @@ INET_ERROR TCPEndPoint::DriveSending()
                           return err;
                       });
 
+#if INET_CONFIG_ENABLE_TCP_SEND_ZEROCOPY
+    // Release any sent buffers the kernel has finished with before queueing more.
+    ReapZeroCopyCompletions();
+#endif // INET_CONFIG_ENABLE_TCP_SEND_ZEROCOPY
+
     while (mSendQueue != NULL)
     {
+#if INET_CONFIG_ENABLE_TCP_SEND_GATHER
+        struct iovec sendIOV[INET_CONFIG_TCP_SEND_GATHER_MAX_IOV];
+        struct msghdr sendMsg;
+        size_t bufLen = 0;
+        int sendMsgFlags = sendFlags;
+
+        // Gather as much of the send queue as fits in one call. The byte count is limited so that it can be reported
+        // through OnDataSent.
+        memset(&sendMsg, 0, sizeof(sendMsg));
+        sendMsg.msg_iov = sendIOV;
+
+        for (PacketBuffer *buf = mSendQueue; buf != NULL && sendMsg.msg_iovlen < INET_CONFIG_TCP_SEND_GATHER_MAX_IOV; buf = buf->Next())
+        {
+            const uint16_t dataLen = buf->DataLength();
+
+            if (bufLen + dataLen > UINT16_MAX)
+                break;
+
+            sendIOV[sendMsg.msg_iovlen].iov_base = buf->Start();
+            sendIOV[sendMsg.msg_iovlen].iov_len = dataLen;
+            sendMsg.msg_iovlen++;
+            bufLen += dataLen;
+        }
+
+#if INET_CONFIG_ENABLE_TCP_SEND_ZEROCOPY
+        if (UseZeroCopy(bufLen, sendMsg.msg_iovlen))
+            sendMsgFlags |= MSG_ZEROCOPY;
+#endif // INET_CONFIG_ENABLE_TCP_SEND_ZEROCOPY
+
+        ssize_t lenSent = sendmsg(mSocket, &sendMsg, sendMsgFlags);
+
+#if INET_CONFIG_ENABLE_TCP_SEND_ZEROCOPY
+        // The kernel refuses zero-copy sends when it cannot allocate the completion notification; copy instead.
+        if (lenSent == -1 && errno == ENOBUFS && (sendMsgFlags & MSG_ZEROCOPY))
+        {
+            sendMsgFlags &= ~MSG_ZEROCOPY;
+            lenSent = sendmsg(mSocket, &sendMsg, sendMsgFlags);
+        }
+
+        // Only sends that queued data consume a completion notification.
+        if (lenSent > 0 && (sendMsgFlags & MSG_ZEROCOPY))
+        {
+            mZeroCopySendsIssued++;
+            if (mZeroCopyQueuedRefs < sendMsg.msg_iovlen)
+                mZeroCopyQueuedRefs = sendMsg.msg_iovlen;
+        }
+#endif // INET_CONFIG_ENABLE_TCP_SEND_ZEROCOPY
+#else // !INET_CONFIG_ENABLE_TCP_SEND_GATHER
         uint16_t bufLen = mSendQueue->DataLength();
 
         ssize_t lenSent = send(mSocket, mSendQueue->Start(), (size_t) bufLen, sendFlags);
+#endif // !INET_CONFIG_ENABLE_TCP_SEND_GATHER
 
         if (lenSent == -1)
         {
@@ -1323,10 +1428,14 @@ INET_ERROR TCPEndPoint::DriveSending()
         // Mark the connection as being active.
         MarkActive();
 
+#if INET_CONFIG_ENABLE_TCP_SEND_GATHER
+        ReleaseSentData(static_cast<size_t>(lenSent));
+#else // !INET_CONFIG_ENABLE_TCP_SEND_GATHER
         if (lenSent < bufLen)
             mSendQueue->ConsumeHead(lenSent);
         else
             mSendQueue = PacketBuffer::FreeHead(mSendQueue);
+#endif // !INET_CONFIG_ENABLE_TCP_SEND_GATHER
 
         if (OnDataSent != NULL)
             OnDataSent(this, (uint16_t) lenSent);
@@ -1364,7 +1473,7 @@ INET_ERROR TCPEndPoint::DriveSending()
         }
 #endif // INET_CONFIG_OVERRIDE_SYSTEM_TCP_USER_TIMEOUT
 
-        if (lenSent < bufLen)
+        if (static_cast<size_t>(lenSent) < bufLen)
             break;
     }
 
@@ -1544,6 +1653,10 @@ INET_ERROR TCPEndPoint::DoClose(INET_ERROR err, bool suppressCallback)
                     WeaveLogError(Inet, "SO_LINGER: %d", errno);
             }
 
+#if INET_CONFIG_ENABLE_EPOLL
+            Layer().UnwatchSocket(*this);
+#endif // INET_CONFIG_ENABLE_EPOLL
+
             if (close(mSocket) != 0 && err == INET_NO_ERROR)
                 err = Weave::System::MapErrorPOSIX(errno);
             mSocket = INET_INVALID_SOCKET_FD;
@@ -1572,6 +1685,10 @@ INET_ERROR TCPEndPoint::DoClose(INET_ERROR err, bool suppressCallback)
         PacketBuffer::Free(mRcvQueue);
         mRcvQueue = NULL;
 
+#if INET_CONFIG_ENABLE_TCP_SEND_ZEROCOPY
+        ReleaseZeroCopyPending();
+#endif // INET_CONFIG_ENABLE_TCP_SEND_ZEROCOPY
+
         // Call the appropriate app callback if allowed.
         if (!suppressCallback)
         {
@@ -2257,6 +2374,12 @@ INET_ERROR TCPEndPoint::GetSocket(IPAddressType addrType)
             }
         }
 #endif // defined(SO_NOSIGPIPE)
+
+#if INET_CONFIG_ENABLE_EPOLL
+        INET_ERROR res = Layer().WatchSocket(*this, kSocketEndPointType_TCP);
+        if (res != INET_NO_ERROR)
+            return res;
+#endif // INET_CONFIG_ENABLE_EPOLL
     }
     else if (mAddrType != addrType)
         return INET_ERROR_INCORRECT_STATE;
@@ -2317,6 +2440,18 @@ void TCPEndPoint::HandlePendingIO()
 
     else
     {
+#if INET_CONFIG_ENABLE_TCP_SEND_ZEROCOPY
+        // Zero-copy completion notifications make the socket readable and writable. Once they have been consumed, check
+        // whether there is also data to be received, so that ReceiveData() is not called on an empty socket.
+        if (mZeroCopyPending != NULL && ReapZeroCopyCompletions() && mPendingIO.IsReadable())
+        {
+            struct pollfd pollFD = { mSocket, POLLIN, 0 };
+
+            if (poll(&pollFD, 1, 0) != 1 || (pollFD.revents & (POLLIN | POLLHUP)) == 0)
+                mPendingIO.ClearRead();
+        }
+#endif // INET_CONFIG_ENABLE_TCP_SEND_ZEROCOPY
+
         // If in a state where sending is allowed, and there is data to be sent, and the socket is ready for
         // writing, drive outbound data into the connection.
         if (IsConnected() && mSendQueue != NULL && mPendingIO.IsWriteable())
@@ -2333,6 +2468,166 @@ void TCPEndPoint::HandlePendingIO()
     Release();
 }
 
+#if INET_CONFIG_ENABLE_TCP_SEND_GATHER
+
+/**
+ *  Remove data accepted by the kernel from the head of the send queue.
+ *
+ *  Buffers that have been sent in full are released, or, if the kernel may still be transmitting directly from them,
+ *  moved to the zero-copy pending list.
+ *
+ *  @param[in]  aLenSent    The number of bytes the kernel accepted.
+ */
+void TCPEndPoint::ReleaseSentData(size_t aLenSent)
+{
+    while (mSendQueue != NULL)
+    {
+        const uint16_t dataLen = mSendQueue->DataLength();
+        PacketBuffer *sentBuf;
+
+        if (aLenSent < dataLen)
+        {
+            if (aLenSent > 0)
+                mSendQueue->ConsumeHead(aLenSent);
+            break;
+        }
+
+        aLenSent -= dataLen;
+        sentBuf = mSendQueue;
+        mSendQueue = sentBuf->DetachTail();
+
+#if INET_CONFIG_ENABLE_TCP_SEND_ZEROCOPY
+        if (mZeroCopyQueuedRefs > 0)
+        {
+            mZeroCopyQueuedRefs--;
+
+            // The buffer may be referenced by any zero-copy send issued so far.
+            if (mZeroCopySendsCompleted != mZeroCopySendsIssued)
+            {
+                const uint16_t tail = (mZeroCopyPendingHead + mZeroCopyPendingCount) % INET_CONFIG_TCP_SEND_ZEROCOPY_MAX_PENDING;
+
+                if (mZeroCopyPending == NULL)
+                    mZeroCopyPending = sentBuf;
+                else
+                    mZeroCopyPending->AddToEnd(sentBuf);
+                mZeroCopyPendingSends[tail] = mZeroCopySendsIssued;
+                mZeroCopyPendingCount++;
+                continue;
+            }
+        }
+#endif // INET_CONFIG_ENABLE_TCP_SEND_ZEROCOPY
+
+        PacketBuffer::Free(sentBuf);
+    }
+}
+
+#endif // INET_CONFIG_ENABLE_TCP_SEND_GATHER
+
+#if INET_CONFIG_ENABLE_TCP_SEND_ZEROCOPY
+
+/**
+ *  Decide whether the next vectored send should use MSG_ZEROCOPY, enabling SO_ZEROCOPY on the socket the first time.
+ *
+ *  @param[in]  aLenQueued  The number of bytes about to be sent.
+ *  @param[in]  aNumBufs    The number of buffers about to be sent.
+ *
+ *  @return \c true if the send is large enough, the pending list has room for the buffers and the socket supports it.
+ */
+bool TCPEndPoint::UseZeroCopy(size_t aLenQueued, size_t aNumBufs)
+{
+    const size_t numRefs = (aNumBufs > mZeroCopyQueuedRefs) ? aNumBufs : mZeroCopyQueuedRefs;
+
+    if (aLenQueued < INET_CONFIG_TCP_SEND_ZEROCOPY_THRESHOLD ||
+        mZeroCopyPendingCount + numRefs > INET_CONFIG_TCP_SEND_ZEROCOPY_MAX_PENDING)
+        return false;
+
+    if (mZeroCopyState == kZeroCopyState_Unknown)
+    {
+        const int enable = 1;
+
+        if (setsockopt(mSocket, SOL_SOCKET, SO_ZEROCOPY, &enable, sizeof(enable)) == 0)
+            mZeroCopyState = kZeroCopyState_Enabled;
+        else
+        {
+            WeaveLogProgress(Inet, "SO_ZEROCOPY: %d; using copying sends", errno);
+            mZeroCopyState = kZeroCopyState_Unsupported;
+        }
+    }
+
+    return mZeroCopyState == kZeroCopyState_Enabled;
+}
+
+/**
+ *  Consume the zero-copy completion notifications queued on the socket error queue, and release the pending buffers whose
+ *  zero-copy sends have all completed.
+ *
+ *  @return \c true if any notification was consumed.
+ */
+bool TCPEndPoint::ReapZeroCopyCompletions(void)
+{
+    bool reaped = false;
+
+    if (mZeroCopySendsCompleted == mZeroCopySendsIssued)
+        return false;
+
+    while (true)
+    {
+        uint8_t control[CMSG_SPACE(sizeof(struct sock_extended_err)) + CMSG_SPACE(sizeof(struct sockaddr_in6))];
+        struct msghdr msg;
+
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+
+        if (recvmsg(mSocket, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) == -1)
+            break;
+
+        for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL; cmsg = CMSG_NXTHDR(&msg, cmsg))
+        {
+            if ((cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR) ||
+                (cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR))
+            {
+                const struct sock_extended_err *extErr = reinterpret_cast<const struct sock_extended_err *>(CMSG_DATA(cmsg));
+
+                if (extErr->ee_errno == 0 && extErr->ee_origin == SO_EE_ORIGIN_ZEROCOPY)
+                {
+                    // The notification covers the sends numbered ee_info through ee_data, inclusive. TCP completes
+                    // sends in order, so everything up to ee_data is done.
+                    const uint32_t completed = extErr->ee_data + 1;
+
+                    if (static_cast<int32_t>(completed - mZeroCopySendsCompleted) > 0)
+                        mZeroCopySendsCompleted = completed;
+                    reaped = true;
+                }
+            }
+        }
+    }
+
+    while (mZeroCopyPendingCount > 0 &&
+           static_cast<int32_t>(mZeroCopyPendingSends[mZeroCopyPendingHead] - mZeroCopySendsCompleted) <= 0)
+    {
+        mZeroCopyPending = PacketBuffer::FreeHead(mZeroCopyPending);
+        mZeroCopyPendingHead = (mZeroCopyPendingHead + 1) % INET_CONFIG_TCP_SEND_ZEROCOPY_MAX_PENDING;
+        mZeroCopyPendingCount--;
+    }
+
+    return reaped;
+}
+
+/**
+ *  Release all pending zero-copy buffers when the connection is closed, along with the send queue.
+ */
+void TCPEndPoint::ReleaseZeroCopyPending(void)
+{
+    PacketBuffer::Free(mZeroCopyPending);
+    mZeroCopyPending = NULL;
+    mZeroCopyPendingHead = 0;
+    mZeroCopyPendingCount = 0;
+    mZeroCopyQueuedRefs = 0;
+}
+
+#endif // INET_CONFIG_ENABLE_TCP_SEND_ZEROCOPY
+
 void TCPEndPoint::ReceiveData()
 {
     PacketBuffer *rcvBuf;
@@ -2342,9 +2637,7 @@ void TCPEndPoint::ReceiveData()
         rcvBuf = PacketBuffer::New(0);
     else
     {
-        rcvBuf = mRcvQueue;
-        for (PacketBuffer *nextBuf = rcvBuf->Next(); nextBuf != NULL; rcvBuf = nextBuf, nextBuf = nextBuf->Next())
-            ;
+        rcvBuf = mRcvQueueTail;
 
         if (rcvBuf->AvailableDataLength() == 0)
             rcvBuf = PacketBuffer::New(0);
@@ -2456,6 +2749,7 @@ void TCPEndPoint::ReceiveData()
                 mRcvQueue = rcvBuf;
             else
                 mRcvQueue->AddToEnd(rcvBuf);
+            mRcvQueueTail = rcvBuf;
         }
 
         else
@@ -2531,8 +2825,23 @@ void TCPEndPoint::HandleIncomingConnection()
 #endif // !INET_CONFIG_ENABLE_IPV4
         conEP->Retain();
 
+#if INET_CONFIG_ENABLE_EPOLL
+        // If the new socket cannot be watched, abandon the connection below rather than hand the app an end point that will
+        // never see any I/O.
+        err = conEP->Layer().WatchSocket(*conEP, kSocketEndPointType_TCP);
+    }
+
+    if (err == INET_NO_ERROR)
+    {
+#endif // INET_CONFIG_ENABLE_EPOLL
         // Call the app's callback function.
         OnConnectionReceived(this, conEP, peerAddr, peerPort);
+
+#if INET_CONFIG_ENABLE_EPOLL
+        // Pick up the callbacks installed on the new endpoint by the app.
+        if (conEP->IsRetained(SystemLayer()))
+            conEP->Layer().UpdateWatchedIO(*conEP);
+#endif // INET_CONFIG_ENABLE_EPOLL
     }
 
     // Otherwise immediately close the connection, clean up and call the app's error callback.
@@ -552,6 +552,9 @@ private:
     static Weave::System::ObjectPool<TCPEndPoint, INET_CONFIG_NUM_TCP_ENDPOINTS> sPool;
 
     Weave::System::PacketBuffer *mRcvQueue;
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+    Weave::System::PacketBuffer *mRcvQueueTail;         // The last buffer in mRcvQueue; valid only when mRcvQueue is not NULL.
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
     Weave::System::PacketBuffer *mSendQueue;
 #if INET_TCP_IDLE_CHECK_INTERVAL > 0
     uint16_t mIdleTimeout;                              // in units of INET_TCP_IDLE_CHECK_INTERVAL; zero means no timeout
@@ -645,6 +648,35 @@ private:
     void ReceiveData(void);
     void HandleIncomingConnection(void);
     INET_ERROR BindSrcAddrFromIntf(IPAddressType addrType, InterfaceId intf);
+
+#if INET_CONFIG_ENABLE_TCP_SEND_GATHER
+    void ReleaseSentData(size_t aLenSent);
+#endif // INET_CONFIG_ENABLE_TCP_SEND_GATHER
+
+#if INET_CONFIG_ENABLE_TCP_SEND_ZEROCOPY
+    enum
+    {
+        kZeroCopyState_Unknown      = 0,                // SO_ZEROCOPY has not been requested on the socket yet.
+        kZeroCopyState_Enabled      = 1,                // The socket accepts MSG_ZEROCOPY sends.
+        kZeroCopyState_Unsupported  = 2                 // The kernel refused SO_ZEROCOPY; always copy.
+    };
+
+    Weave::System::PacketBuffer *mZeroCopyPending;      // Sent buffers the kernel may still be transmitting from.
+    uint32_t mZeroCopyPendingSends[INET_CONFIG_TCP_SEND_ZEROCOPY_MAX_PENDING];
+                                                        // For each pending buffer, the count of zero-copy sends that
+                                                        // must complete before it can be released.
+    uint16_t mZeroCopyPendingHead;                      // The index in mZeroCopyPendingSends of the oldest pending buffer.
+    uint16_t mZeroCopyPendingCount;                     // The number of buffers in mZeroCopyPending.
+    uint16_t mZeroCopyQueuedRefs;                       // The number of buffers at the head of mSendQueue that have been
+                                                        // passed to a zero-copy send.
+    uint32_t mZeroCopySendsIssued;                      // The number of zero-copy sends accepted by the kernel.
+    uint32_t mZeroCopySendsCompleted;                   // The number of zero-copy sends the kernel has reported complete.
+    uint8_t mZeroCopyState;
+
+    bool UseZeroCopy(size_t aLenQueued, size_t aNumBufs);
+    bool ReapZeroCopyCompletions(void);
+    void ReleaseZeroCopyPending(void);
+#endif // INET_CONFIG_ENABLE_TCP_SEND_ZEROCOPY
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
 };
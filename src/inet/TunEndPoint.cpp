@@ -112,6 +112,13 @@ INET_ERROR TunEndPoint::Open (const char *intfName)
     if (err == INET_NO_ERROR)
         mState = kState_Open;
 
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS && INET_CONFIG_ENABLE_EPOLL
+    err = Layer().WatchSocket(*this, kSocketEndPointType_Tun);
+    SuccessOrExit(err);
+
+    Layer().UpdateWatchedIO(*this);
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS && INET_CONFIG_ENABLE_EPOLL
+
 exit:
 
     return err;
@@ -716,6 +723,10 @@ void TunEndPoint::TunDevClose (void)
 {
     if (mSocket >= 0)
     {
+#if INET_CONFIG_ENABLE_EPOLL
+        Layer().UnwatchSocket(*this);
+#endif // INET_CONFIG_ENABLE_EPOLL
+
         close(mSocket);
     }
     mSocket = INET_INVALID_SOCKET_FD;
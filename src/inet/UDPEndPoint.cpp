@@ -322,6 +322,10 @@ INET_ERROR UDPEndPoint::Listen(void)
     if (res == INET_NO_ERROR)
     {
         mState = kState_Listening;
+
+#if INET_CONFIG_ENABLE_EPOLL
+        Layer().UpdateWatchedIO(*this);
+#endif // INET_CONFIG_ENABLE_EPOLL
     }
 
  exit:
@@ -370,6 +374,10 @@ void UDPEndPoint::Close(void)
             // Wake the thread calling select so that it recognizes the socket is closed.
             lSystemLayer.WakeSelect();
 
+#if INET_CONFIG_ENABLE_EPOLL
+            Layer().UnwatchSocket(*this);
+#endif // INET_CONFIG_ENABLE_EPOLL
+
             close(mSocket);
             mSocket = INET_INVALID_SOCKET_FD;
         }
@@ -377,6 +385,10 @@ void UDPEndPoint::Close(void)
         // Clear any results from select() that indicate pending I/O for the socket.
         mPendingIO.Clear();
 
+#if INET_CONFIG_ENABLE_UDP_BATCH_IO
+        ReleaseRecvBatch();
+#endif // INET_CONFIG_ENABLE_UDP_BATCH_IO
+
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
         mState = kState_Closed;
@@ -667,6 +679,68 @@ exit:
     return res;
 }
 
+#if INET_CONFIG_ENABLE_UDP_BATCH_IO
+/**
+ * @brief   Send a UDP message to several destinations.
+ *
+ * @param[in]   pktInfos    the destination information for each send
+ * @param[in]   count       the number of elements in \c pktInfos
+ * @param[in]   msg         the packet buffer containing the UDP message
+ * @param[out]  sendErrs    the outcome of each send, one element per
+ *                          element of \c pktInfos
+ *
+ * @retval  INET_NO_ERROR       success: \c msg was queued for transmit to
+ *                              every destination.
+ *
+ * @retval  other               the first error recorded in \c sendErrs.
+ *
+ * @details
+ *  Sends the same message to each destination in \c pktInfos, as if by
+ *  calling <tt>SendMsg(&pktInfos[i], msg, kSendFlag_RetainBuffer)</tt> for
+ *  each of them, but with one <tt>sendmmsg()</tt> system call per
+ *  #INET_CONFIG_UDP_BATCH_SIZE destinations. All destinations must have
+ *  the same address type.
+ *
+ *  The message is always retained; the caller remains responsible for
+ *  freeing \c msg.
+ */
+INET_ERROR UDPEndPoint::SendMsgBatch(const IPPacketInfo *pktInfos, size_t count, PacketBuffer *msg, INET_ERROR *sendErrs)
+{
+    INET_ERROR res = INET_NO_ERROR;
+
+    VerifyOrExit(count > 0, res = INET_NO_ERROR);
+
+    INET_FAULT_INJECT(FaultInjection::kFault_Send,
+            for (size_t i = 0; i < count; i++)
+                sendErrs[i] = INET_ERROR_UNKNOWN_INTERFACE;
+            return INET_ERROR_UNKNOWN_INTERFACE;
+            );
+    INET_FAULT_INJECT(FaultInjection::kFault_SendNonCritical,
+            for (size_t i = 0; i < count; i++)
+                sendErrs[i] = INET_ERROR_NO_MEMORY;
+            return INET_ERROR_NO_MEMORY;
+            );
+
+    // Make sure we have the appropriate type of socket based on the
+    // destination address.
+
+    res = GetSocket(pktInfos[0].DestAddress.Type());
+    if (res != INET_NO_ERROR)
+    {
+        for (size_t i = 0; i < count; i++)
+            sendErrs[i] = res;
+        ExitNow();
+    }
+
+    res = IPEndPointBasis::SendMsgBatch(pktInfos, count, msg, sendErrs);
+
+exit:
+    WEAVE_SYSTEM_FAULT_INJECT_ASYNC_EVENT();
+
+    return res;
+}
+#endif // INET_CONFIG_ENABLE_UDP_BATCH_IO
+
 /**
  * @brief   Bind the endpoint to a network interface.
  *
@@ -909,6 +983,11 @@ INET_ERROR UDPEndPoint::GetSocket(IPAddressType aAddressType)
     lRetval = IPEndPointBasis::GetSocket(aAddressType, lType, lProtocol);
     SuccessOrExit(lRetval);
 
+#if INET_CONFIG_ENABLE_EPOLL
+    lRetval = Layer().WatchSocket(*this, kSocketEndPointType_UDP);
+    SuccessOrExit(lRetval);
+#endif // INET_CONFIG_ENABLE_EPOLL
+
 exit:
     return (lRetval);
 }
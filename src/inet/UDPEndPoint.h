@@ -61,6 +61,9 @@ public:
     INET_ERROR SendTo(IPAddress addr, uint16_t port, Weave::System::PacketBuffer *msg, uint16_t sendFlags = 0);
     INET_ERROR SendTo(IPAddress addr, uint16_t port, InterfaceId intfId, Weave::System::PacketBuffer *msg, uint16_t sendFlags = 0);
     INET_ERROR SendMsg(const IPPacketInfo *pktInfo, Weave::System::PacketBuffer *msg, uint16_t sendFlags = 0);
+#if INET_CONFIG_ENABLE_UDP_BATCH_IO
+    INET_ERROR SendMsgBatch(const IPPacketInfo *pktInfos, size_t count, Weave::System::PacketBuffer *msg, INET_ERROR *sendErrs);
+#endif // INET_CONFIG_ENABLE_UDP_BATCH_IO
     void Close(void);
     void Free(void);
 
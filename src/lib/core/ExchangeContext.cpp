@@ -66,6 +66,7 @@ enum {
     kFlagAutoReleaseKey         = 0x0100, /// Automatically release the message encryption key when the exchange context is freed.
     kFlagAutoReleaseConnection  = 0x0200, /// Automatically release the associated WeaveConnection when the exchange context is freed.
     kFlagUseEphemeralUDPPort    = 0x0400, /// When set, use the local ephemeral UDP port as the source port for outbound messages.
+    kFlagThrottled              = 0x0800, /// When set, the peer has paused sending on this exchange until mWRMPThrottleTimeout.
 };
 
 /**
@@ -187,6 +188,21 @@ void ExchangeContext::SetMsgRcvdFromPeer(bool inMsgRcvdFromPeer)
 void ExchangeContext::SetAckPending(bool inAckPending)
 {
     SetFlag(mFlags, static_cast<uint16_t>(kFlagAckPending), inAckPending);
+
+#if WEAVE_CONFIG_WRMP_ENABLE_SEND_WINDOW
+    // Acknowledgments are only held alongside a pending one.
+    if (!inAckPending)
+        mWRMPHeldAckCount = 0;
+#endif
+
+    // Keep the exchange manager's heap of pending acks in step with the flag.
+    if (ExchangeMgr != NULL)
+    {
+        if (inAckPending)
+            ExchangeMgr->WRMPScheduleAck(this);
+        else
+            ExchangeMgr->WRMPUnscheduleAck(this);
+    }
 }
 
 /**
@@ -231,6 +247,44 @@ bool ExchangeContext::ShouldDropAck(void) const
     return GetFlag(mFlags, static_cast<uint16_t>(kFlagDropAck));
 }
 
+/**
+ *  Determine whether the peer has throttled sending on this exchange.
+ *
+ *  The throttle is lifted once its deadline has passed, so that a Throttle
+ *  Flow message that is never followed by an unthrottle does not stop the
+ *  exchange for good.
+ *
+ *  @return Returns 'true' if sending is throttled, else 'false'.
+ */
+bool ExchangeContext::IsThrottled(void)
+{
+    if (GetFlag(mFlags, static_cast<uint16_t>(kFlagThrottled)))
+    {
+        ExchangeMgr->WRMPExpireTicks();
+
+        if (ExchangeMgr->WRMPIsDeadlineDue(mWRMPThrottleTimeout))
+            SetThrottled(false);
+    }
+
+    return GetFlag(mFlags, static_cast<uint16_t>(kFlagThrottled));
+}
+
+/**
+ *  Set if the peer has throttled sending on this exchange until
+ *  mWRMPThrottleTimeout.
+ *
+ *  @param[in]  inThrottled A Boolean indicating whether (true) or not
+ *                          (false) sending is throttled.
+ *
+ */
+void ExchangeContext::SetThrottled(bool inThrottled)
+{
+    SetFlag(mFlags, static_cast<uint16_t>(kFlagThrottled), inThrottled);
+
+    if (!inThrottled)
+        mWRMPThrottleTimeout = 0;
+}
+
 static inline bool IsWRMPControlMessage(uint32_t profileId, uint8_t msgType)
 {
     return (profileId == nl::Weave::Profiles::kWeaveProfile_Common &&
@@ -452,7 +506,15 @@ WEAVE_ERROR ExchangeContext::SendMessage(uint32_t profileId, uint8_t msgType, Pa
     }
 
     // Abort early if Throttle is already set;
-    VerifyOrExit(mWRMPThrottleTimeout == 0, err = WEAVE_ERROR_SEND_THROTTLED);
+    VerifyOrExit(!IsThrottled(), err = WEAVE_ERROR_SEND_THROTTLED);
+
+#if WEAVE_CONFIG_WRMP_ENABLE_SEND_WINDOW
+    // Hold back a reliable message while the send window is full.
+    if ((sendFlags & kSendFlag_RequestAck) && mWRMPConfig.mSendWindow != 0)
+    {
+        VerifyOrExit(mWRMPInFlightCount < WRMPGetSendWindow(), err = WEAVE_ERROR_SEND_THROTTLED);
+    }
+#endif
 
 #else // WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
 
@@ -599,7 +661,7 @@ WEAVE_ERROR ExchangeContext::SendMessage(uint32_t profileId, uint8_t msgType, Pa
             SuccessOrExit(err);
 
             WEAVE_FAULT_INJECT(FaultInjection::kFault_WRMDoubleTx,
-                               entry->nextRetransTime = 0;
+                               ExchangeMgr->WRMPSetRetransTime(*entry, ExchangeMgr->mWRMPCurrentTick);
                                ExchangeMgr->WRMPStartTimer()
                                );
 
@@ -750,6 +812,14 @@ WEAVE_ERROR ExchangeContext::EncodeExchHeader(WeaveExchangeHeader *exchangeHeade
             exchangeHeader->Flags |= kWeaveExchangeFlag_AckId;
             exchangeHeader->AckMsgId = mPendingPeerAckId;
 
+#if WEAVE_CONFIG_WRMP_ENABLE_SEND_WINDOW
+            //If other acks are held, the latest becomes the pending ack, still due at the same time;
+            if (IsAckPending() && mWRMPHeldAckCount > 0)
+            {
+                mPendingPeerAckId = mWRMPHeldAckIds[--mWRMPHeldAckCount];
+            }
+            else
+#endif
             //Set AckPending flag to false after setting the Ack flag;
             SetAckPending(false);
 
@@ -903,8 +973,15 @@ void ExchangeContext::Release(void)
         }
 
         DoClose(false);
+#if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
+        // Drop any ack that could not be flushed, so that the context leaves the ack heap before it is freed.
+        SetAckPending(false);
+#endif
         mRefCount = 0;
         ExchangeMgr = NULL;
+#if WEAVE_CONFIG_ENABLE_EXCHANGE_CONTEXT_INDEX
+        em->FreeContext(this);
+#endif
 
         em->mContextsInUse--;
         em->MessageLayer->SignalMessageLayerActivityChanged();
@@ -1173,9 +1250,23 @@ bool ExchangeContext::WRMPCheckAndRemRetransTable(uint32_t ackMsgId, void **rCtx
             //Return context value
             *rCtxt = ExchangeMgr->RetransTable[i].msgCtxt;
 
+#if WEAVE_CONFIG_WRMP_ADAPTIVE_RETRANS_TIMEOUT
+            //Measure the round trip time only if the message was sent once, so that the
+            //acknowledgment cannot be for an earlier transmission (Karn's algorithm).
+            if (ExchangeMgr->RetransTable[i].sendCount == 1)
+            {
+                ExchangeMgr->FabricState->OnPeerRTTSample(PeerNodeId, static_cast<uint32_t>(System::Timer::GetCurrentEpoch()) -
+                                                                      ExchangeMgr->RetransTable[i].sentTime);
+            }
+#endif
+
             //Clear the entry from the retransmision table.
             ExchangeMgr->ClearRetransmitTable(ExchangeMgr->RetransTable[i]);
 
+#if WEAVE_CONFIG_WRMP_ENABLE_SEND_WINDOW
+            WRMPGrowSendWindow();
+#endif
+
 #if defined(DEBUG)
             WeaveLogProgress(ExchangeManager, "Rxd Ack; Removing MsgId:%08" PRIX32 " from Retrans Table",
                              ackMsgId);
@@ -1199,8 +1290,13 @@ WEAVE_ERROR ExchangeContext::WRMPFlushAcks(void)
 
     if (IsAckPending())
     {
+#if WEAVE_CONFIG_WRMP_COALESCE_ACKS || WEAVE_CONFIG_WRMP_ENABLE_SEND_WINDOW
+        //Send the acknowledgment, with any other pending acknowledgments for the peer
+        err = ExchangeMgr->WRMPSendCoalescedAcks(this);
+#else
         //Send the acknowledgment as a Common::Null message
         err = SendCommonNullMessage();
+#endif
 
         if (err == WEAVE_NO_ERROR)
         {
@@ -1217,12 +1313,22 @@ WEAVE_ERROR ExchangeContext::WRMPFlushAcks(void)
 /**
  *  Get the current retransmit timeout. It would be either the initial or
  *  the active retransmit timeout based on whether the ExchangeContext has
- *  an active message exchange going with its peer.
+ *  an active message exchange going with its peer. If
+ *  #WEAVE_CONFIG_WRMP_ADAPTIVE_RETRANS_TIMEOUT is enabled and the round
+ *  trip time to the peer has been measured, it is instead derived from the
+ *  measured round trip time.
  *
  *  @return the current retransmit time.
  */
 uint32_t ExchangeContext::GetCurrentRetransmitTimeout(void)
 {
+#if WEAVE_CONFIG_WRMP_ADAPTIVE_RETRANS_TIMEOUT
+  uint32_t timeout;
+
+  if (ExchangeMgr->FabricState->GetPeerRetransTimeout(PeerNodeId, timeout))
+      return timeout;
+#endif
+
   return (HasRcvdMsgFromPeer() ? mWRMPConfig.mActiveRetransTimeout :
                                  mWRMPConfig.mInitialRetransTimeout);
 }
@@ -1407,6 +1513,12 @@ WEAVE_ERROR ExchangeContext::WRMPHandleNeedsAck(const WeaveMessageInfo *msgInfo)
         // Temporary store currently pending ack id (even if there is none).
         uint32_t tempAckId = mPendingPeerAckId;
 
+#if WEAVE_CONFIG_WRMP_ENABLE_SEND_WINDOW
+        // Set aside any held acks, so that they are not sent in place of the pending ack.
+        uint8_t tempHeldAckCount = wasAckPending ? mWRMPHeldAckCount : 0;
+        mWRMPHeldAckCount -= tempHeldAckCount;
+#endif
+
         // Set the pending ack id.
         mPendingPeerAckId = msgInfo->MessageId;
 
@@ -1419,6 +1531,9 @@ WEAVE_ERROR ExchangeContext::WRMPHandleNeedsAck(const WeaveMessageInfo *msgInfo)
             // Restore previously pending ack id.
             mPendingPeerAckId = tempAckId;
             SetAckPending(true);
+#if WEAVE_CONFIG_WRMP_ENABLE_SEND_WINDOW
+            mWRMPHeldAckCount = tempHeldAckCount;
+#endif
         }
 
         SuccessOrExit(err);
@@ -1426,20 +1541,38 @@ WEAVE_ERROR ExchangeContext::WRMPHandleNeedsAck(const WeaveMessageInfo *msgInfo)
     // Otherwise, the message IS NOT a duplicate.
     else
     {
+#if WEAVE_CONFIG_WRMP_ENABLE_SEND_WINDOW
+        // A message arriving while the ack of an earlier one is pending shows that the peer keeps several
+        // messages in flight. If the peer accepts multi-ack messages, hold the pending ack alongside the
+        // new one, both to be sent when the earlier is due.
+        if (IsAckPending() && mWRMPHeldAckCount < WEAVE_CONFIG_WRMP_MAX_PENDING_ACKS - 1 &&
+            mMsgProtocolVersion == kWeaveMessageVersion_V2 && ExchangeMgr->WRMPPeerAcceptsMultiAck(PeerNodeId))
+        {
+            mWRMPHeldAckIds[mWRMPHeldAckCount++] = mPendingPeerAckId;
+            mPendingPeerAckId = msgInfo->MessageId;
+            ExitNow();
+        }
+#endif
+
         if (IsAckPending())
         {
 #if defined(DEBUG)
             WeaveLogProgress(ExchangeManager, "Pending ack queue full; forcing tx of solitary ack for MsgId:%08" PRIX32,
                              mPendingPeerAckId);
 #endif
+#if WEAVE_CONFIG_WRMP_ENABLE_SEND_WINDOW
+            // Send the pending and held Acks in a Common::WRMP_Multi_Ack message.
+            err = ExchangeMgr->WRMPSendCoalescedAcks(this);
+#else
             // Send the Ack for the currently pending Ack in a Common::Null message.
             err = SendCommonNullMessage();
+#endif
             SuccessOrExit(err);
         }
 
         // Replace the Pending ack id.
         mPendingPeerAckId = msgInfo->MessageId;
-        mWRMPNextAckTime = ExchangeMgr->GetTickCounterFromTimeDelta(mWRMPConfig.mAckPiggybackTimeout + System::Timer::GetCurrentEpoch(), ExchangeMgr->mWRMPTimeStampBase);
+        mWRMPNextAckTime = ExchangeMgr->WRMPDeadlineFromNow(mWRMPConfig.mAckPiggybackTimeout);
         SetAckPending(true);
     }
 
@@ -1449,6 +1582,72 @@ exit:
     return err;
 }
 
+#if WEAVE_CONFIG_WRMP_ENABLE_SEND_WINDOW
+/**
+ *  Get the number of reliable messages that may currently be awaiting acknowledgment on this exchange.
+ *
+ *  The number starts at one and grows, up to the send window in the WRMP configuration, by one message
+ *  per acknowledgment received until the first retransmission, then by one message per window of
+ *  acknowledgments. It is halved once per loss, on the retransmission of a message sent since it was
+ *  last halved, and reduced to one on receipt of a Throttle Flow message.
+ *
+ *  @return The number of messages, or 0 if the send window of the exchange is not limited.
+ */
+uint8_t ExchangeContext::WRMPGetSendWindow(void) const
+{
+    uint8_t maxWindow = (mWRMPConfig.mSendWindow < WEAVE_CONFIG_WRMP_MAX_SEND_WINDOW) ? mWRMPConfig.mSendWindow :
+                                                                                         WEAVE_CONFIG_WRMP_MAX_SEND_WINDOW;
+    uint16_t window = mWRMPCongestionWindow / kWRMPSendWindowScale;
+
+    return (window < maxWindow) ? static_cast<uint8_t>(window) : maxWindow;
+}
+
+/**
+ *  Get the number of reliable messages sent on this exchange that are awaiting acknowledgment.
+ *
+ *  @return The number of messages.
+ */
+uint8_t ExchangeContext::WRMPGetInFlightCount(void) const
+{
+    return mWRMPInFlightCount;
+}
+
+void ExchangeContext::WRMPInitSendWindow(void)
+{
+    mWRMPHeldAckCount = 0;
+    mWRMPInFlightCount = 0;
+    mWRMPCongestionWindow = kWRMPSendWindowScale;
+    mWRMPSlowStartThreshold = WEAVE_CONFIG_WRMP_MAX_SEND_WINDOW * kWRMPSendWindowScale;
+}
+
+void ExchangeContext::WRMPGrowSendWindow(void)
+{
+    uint16_t maxWindow = WEAVE_CONFIG_WRMP_MAX_SEND_WINDOW * kWRMPSendWindowScale;
+
+    if (mWRMPCongestionWindow < mWRMPSlowStartThreshold)
+    {
+        mWRMPCongestionWindow += kWRMPSendWindowScale;
+    }
+    else
+    {
+        uint16_t increment = (kWRMPSendWindowScale * kWRMPSendWindowScale) / mWRMPCongestionWindow;
+        mWRMPCongestionWindow += (increment != 0) ? increment : 1;
+    }
+
+    if (mWRMPCongestionWindow > maxWindow)
+        mWRMPCongestionWindow = maxWindow;
+}
+
+void ExchangeContext::WRMPShrinkSendWindow(bool toOneMessage)
+{
+    mWRMPSlowStartThreshold = mWRMPCongestionWindow / 2;
+    if (mWRMPSlowStartThreshold < kWRMPSendWindowScale)
+        mWRMPSlowStartThreshold = kWRMPSendWindowScale;
+
+    mWRMPCongestionWindow = toOneMessage ? kWRMPSendWindowScale : mWRMPSlowStartThreshold;
+}
+#endif // WEAVE_CONFIG_WRMP_ENABLE_SEND_WINDOW
+
 WEAVE_ERROR ExchangeContext::HandleThrottleFlow(uint32_t PauseTimeMillis)
 {
     // Expire any virtual ticks that have expired so all wakeup sources reflect the current time
@@ -1459,12 +1658,17 @@ WEAVE_ERROR ExchangeContext::HandleThrottleFlow(uint32_t PauseTimeMillis)
 
     if (0 != PauseTimeMillis)
     {
-        mWRMPThrottleTimeout = ExchangeMgr->GetTickCounterFromTimeDelta((System::Timer::GetCurrentEpoch() + PauseTimeMillis),
-                                                                        ExchangeMgr->mWRMPTimeStampBase);
+        mWRMPThrottleTimeout = ExchangeMgr->WRMPDeadlineFromNow(PauseTimeMillis);
+        SetThrottled(true);
+
+#if WEAVE_CONFIG_WRMP_ENABLE_SEND_WINDOW
+        // The peer is congested; resume with a single message in flight.
+        WRMPShrinkSendWindow(true);
+#endif
     }
     else
     {
-        mWRMPThrottleTimeout = 0;
+        SetThrottled(false);
     }
 
     // Go through the retrans table entries for that node and adjust the timer.
@@ -1478,14 +1682,17 @@ WEAVE_ERROR ExchangeContext::HandleThrottleFlow(uint32_t PauseTimeMillis)
             // Adjust the retrans timer value to account for throttling.
             if (0 != PauseTimeMillis)
             {
-                ExchangeMgr->RetransTable[i].nextRetransTime += PauseTimeMillis / ExchangeMgr->mWRMPTimerInterval;
+                ExchangeMgr->WRMPSetRetransTime(ExchangeMgr->RetransTable[i], ExchangeMgr->RetransTable[i].nextRetransTime +
+                                                PauseTimeMillis / ExchangeMgr->mWRMPTimerInterval);
             }
             // UnThrottle when PauseTimeMillis is set to 0
             else
             {
-                ExchangeMgr->RetransTable[i].nextRetransTime = 0;
+                ExchangeMgr->WRMPSetRetransTime(ExchangeMgr->RetransTable[i], ExchangeMgr->mWRMPCurrentTick);
             }
+#if !WEAVE_CONFIG_WRMP_ENABLE_SEND_WINDOW
             break;
+#endif
         }
     }
     // Call OnThrottleRcvd application callback
@@ -1590,9 +1797,10 @@ WEAVE_ERROR ExchangeContext::HandleMessage(WeaveMessageInfo *msgInfo, const Weav
         ExitNow(err = WEAVE_NO_ERROR);
 #endif
     }
-    //Return and not pass this to Application if Common::Null Msg Type
+    //Return and not pass this to Application if Common::Null or Common::WRMP_Multi_Ack Msg Type
     else if ((exchHeader->ProfileId == nl::Weave::Profiles::kWeaveProfile_Common) &&
-        (exchHeader->MessageType == nl::Weave::Profiles::Common::kMsgType_Null))
+        (exchHeader->MessageType == nl::Weave::Profiles::Common::kMsgType_Null ||
+         exchHeader->MessageType == nl::Weave::Profiles::Common::kMsgType_WRMP_Multi_Ack))
     {
         ExitNow(err = WEAVE_NO_ERROR);
     }
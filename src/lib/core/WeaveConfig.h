@@ -1013,6 +1013,66 @@
 #define WEAVE_CONFIG_MAX_PEER_NODES                         128
 #endif // WEAVE_CONFIG_MAX_PEER_NODES
 
+/**
+ *  @def WEAVE_CONFIG_ENABLE_PEER_STATE_INDEX
+ *
+ *  @brief
+ *    Enable (1) or disable (0) hash indexing of the peer state table.
+ *
+ *    When enabled, the fabric state looks up peer entries through a
+ *    hash table keyed by node id and tracks their recency on intrusive
+ *    linked lists, rather than by scanning and shifting an array of
+ *    indexes ordered by recency. Per-message lookup cost then no longer
+ *    grows with #WEAVE_CONFIG_MAX_PEER_NODES. Each peer entry costs up
+ *    to five more indexes, plus the hash bucket array.
+ *
+ */
+#ifndef WEAVE_CONFIG_ENABLE_PEER_STATE_INDEX
+#define WEAVE_CONFIG_ENABLE_PEER_STATE_INDEX                0
+#endif // WEAVE_CONFIG_ENABLE_PEER_STATE_INDEX
+
+/**
+ *  @def WEAVE_CONFIG_PEER_STATE_INDEX_BUCKETS
+ *
+ *  @brief
+ *    Number of hash buckets used to index the peer state table when
+ *    #WEAVE_CONFIG_ENABLE_PEER_STATE_INDEX is enabled.  Must be a
+ *    power of two.
+ *
+ */
+#ifndef WEAVE_CONFIG_PEER_STATE_INDEX_BUCKETS
+#define WEAVE_CONFIG_PEER_STATE_INDEX_BUCKETS               64
+#endif // WEAVE_CONFIG_PEER_STATE_INDEX_BUCKETS
+
+#if WEAVE_CONFIG_ENABLE_PEER_STATE_INDEX && ((WEAVE_CONFIG_PEER_STATE_INDEX_BUCKETS & (WEAVE_CONFIG_PEER_STATE_INDEX_BUCKETS - 1)) != 0)
+#error "WEAVE_CONFIG_PEER_STATE_INDEX_BUCKETS must be a power of two."
+#endif
+
+/**
+ *  @def WEAVE_CONFIG_MSG_ID_RCV_WINDOW_SIZE
+ *
+ *  @brief
+ *    Size, in messages, of the window of message ids tracked per peer
+ *    and per session key to detect duplicate messages.
+ *
+ *    A message with an id earlier than the largest received, but within
+ *    the window, is accepted once; anything earlier than the window is
+ *    treated as a duplicate if it is encrypted. When 0, the 15 ids
+ *    preceding the largest received are tracked in the receive flags
+ *    of the peer or session. Otherwise this must be 64, 128 or 256,
+ *    and each peer entry and session key costs this many bits more,
+ *    which lets messages reordered over multipath links through.
+ *
+ */
+#ifndef WEAVE_CONFIG_MSG_ID_RCV_WINDOW_SIZE
+#define WEAVE_CONFIG_MSG_ID_RCV_WINDOW_SIZE                 0
+#endif // WEAVE_CONFIG_MSG_ID_RCV_WINDOW_SIZE
+
+#if WEAVE_CONFIG_MSG_ID_RCV_WINDOW_SIZE != 0 && WEAVE_CONFIG_MSG_ID_RCV_WINDOW_SIZE != 64 && \
+    WEAVE_CONFIG_MSG_ID_RCV_WINDOW_SIZE != 128 && WEAVE_CONFIG_MSG_ID_RCV_WINDOW_SIZE != 256
+#error "WEAVE_CONFIG_MSG_ID_RCV_WINDOW_SIZE must be 0, 64, 128 or 256."
+#endif
+
 /**
  *  @def WEAVE_CONFIG_MAX_CONNECTIONS
  *
@@ -1055,6 +1115,66 @@
 #define WEAVE_CONFIG_MAX_INCOMING_TCP_CON_FROM_SINGLE_IP    2
 #endif // WEAVE_CONFIG_MAX_INCOMING_TCP_CON_FROM_SINGLE_IP
 
+/**
+ *  @def WEAVE_CONFIG_CONNECTION_RECEIVE_BUDGET
+ *
+ *  @brief
+ *    Maximum number of received bytes a connection may hold, waiting
+ *    for the application to accept them, before reading from the
+ *    underlying TCP connection is paused. Reading resumes when the
+ *    application calls WeaveConnection::EnableReceive().
+ *
+ *    A value of 0 disables the limit.
+ */
+#ifndef WEAVE_CONFIG_CONNECTION_RECEIVE_BUDGET
+#define WEAVE_CONFIG_CONNECTION_RECEIVE_BUDGET              0
+#endif // WEAVE_CONFIG_CONNECTION_RECEIVE_BUDGET
+
+/**
+ *  @def WEAVE_CONFIG_CONNECTION_SEND_BUDGET
+ *
+ *  @brief
+ *    Maximum number of bytes a connection may queue for sending before
+ *    further sends fail with #WEAVE_ERROR_SENDING_BLOCKED and the
+ *    connection's OnSendBackpressure callback is invoked. Sending
+ *    resumes, and the callback is invoked again, once the queue has
+ *    drained to half of the budget.
+ *
+ *    A value of 0 disables the limit.
+ */
+#ifndef WEAVE_CONFIG_CONNECTION_SEND_BUDGET
+#define WEAVE_CONFIG_CONNECTION_SEND_BUDGET                 0
+#endif // WEAVE_CONFIG_CONNECTION_SEND_BUDGET
+
+/**
+ *  @def WEAVE_CONFIG_TOTAL_CONNECTION_RECEIVE_BUDGET
+ *
+ *  @brief
+ *    As #WEAVE_CONFIG_CONNECTION_RECEIVE_BUDGET, but for the total
+ *    number of received bytes held by all the connections of a
+ *    message layer, so that a burst on one connection cannot exhaust
+ *    the packet buffers needed by the others.
+ *
+ *    A value of 0 disables the limit.
+ */
+#ifndef WEAVE_CONFIG_TOTAL_CONNECTION_RECEIVE_BUDGET
+#define WEAVE_CONFIG_TOTAL_CONNECTION_RECEIVE_BUDGET        0
+#endif // WEAVE_CONFIG_TOTAL_CONNECTION_RECEIVE_BUDGET
+
+/**
+ *  @def WEAVE_CONFIG_TOTAL_CONNECTION_SEND_BUDGET
+ *
+ *  @brief
+ *    As #WEAVE_CONFIG_CONNECTION_SEND_BUDGET, but for the total number
+ *    of bytes queued for sending by all the connections of a message
+ *    layer.
+ *
+ *    A value of 0 disables the limit.
+ */
+#ifndef WEAVE_CONFIG_TOTAL_CONNECTION_SEND_BUDGET
+#define WEAVE_CONFIG_TOTAL_CONNECTION_SEND_BUDGET           0
+#endif // WEAVE_CONFIG_TOTAL_CONNECTION_SEND_BUDGET
+
 /**
  *  @def WEAVE_CONFIG_MAX_TUNNELS
  *
@@ -1077,6 +1197,46 @@
 #define WEAVE_CONFIG_MAX_SESSION_KEYS                       WEAVE_CONFIG_MAX_CONNECTIONS
 #endif // WEAVE_CONFIG_MAX_SESSION_KEYS
 
+/**
+ *  @def WEAVE_CONFIG_ENABLE_SESSION_KEY_INDEX
+ *
+ *  @brief
+ *    Enable (1) or disable (0) hash indexing of the session key table.
+ *
+ *    When enabled, WeaveFabricState finds session keys through a hash
+ *    table keyed by key id and peer node id, and finds free entries
+ *    through a free list. Lookup cost on the message decode path then
+ *    no longer grows with #WEAVE_CONFIG_MAX_SESSION_KEYS. Lookup
+ *    hit/miss counts and table occupancy are also tracked, and are
+ *    available from WeaveFabricState::GetSessionKeyStats().
+ *
+ */
+#ifndef WEAVE_CONFIG_ENABLE_SESSION_KEY_INDEX
+#define WEAVE_CONFIG_ENABLE_SESSION_KEY_INDEX               0
+#endif // WEAVE_CONFIG_ENABLE_SESSION_KEY_INDEX
+
+/**
+ *  @def WEAVE_CONFIG_SESSION_KEY_INDEX_BUCKETS
+ *
+ *  @brief
+ *    Number of hash buckets used to index the session key table when
+ *    #WEAVE_CONFIG_ENABLE_SESSION_KEY_INDEX is enabled.  Must be a
+ *    power of two.
+ *
+ */
+#ifndef WEAVE_CONFIG_SESSION_KEY_INDEX_BUCKETS
+#define WEAVE_CONFIG_SESSION_KEY_INDEX_BUCKETS              64
+#endif // WEAVE_CONFIG_SESSION_KEY_INDEX_BUCKETS
+
+#if WEAVE_CONFIG_ENABLE_SESSION_KEY_INDEX
+#if ((WEAVE_CONFIG_SESSION_KEY_INDEX_BUCKETS & (WEAVE_CONFIG_SESSION_KEY_INDEX_BUCKETS - 1)) != 0)
+#error "WEAVE_CONFIG_SESSION_KEY_INDEX_BUCKETS must be a power of two."
+#endif
+#if WEAVE_CONFIG_MAX_SESSION_KEYS > UINT16_MAX
+#error "WEAVE_CONFIG_MAX_SESSION_KEYS must not exceed UINT16_MAX when WEAVE_CONFIG_ENABLE_SESSION_KEY_INDEX is enabled."
+#endif
+#endif // WEAVE_CONFIG_ENABLE_SESSION_KEY_INDEX
+
 /**
  *  @def WEAVE_CONFIG_MAX_APPLICATION_EPOCH_KEYS
  *
@@ -1267,6 +1427,59 @@
 #define WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS                  16
 #endif // WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS
 
+/**
+ *  @def WEAVE_CONFIG_ENABLE_EXCHANGE_CONTEXT_INDEX
+ *
+ *  @brief
+ *    Enable (1) or disable (0) indexing of active exchange contexts.
+ *
+ *    When enabled, the exchange manager keeps its free exchange
+ *    contexts on a free list, links its active contexts on a list,
+ *    and hashes active contexts by exchange identifier.  This makes
+ *    context allocation and inbound message dispatch independent of
+ *    #WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS, at a cost of three pointers
+ *    per context plus the hash bucket array.  It is intended for
+ *    builds that configure large exchange context pools.
+ *
+ */
+#ifndef WEAVE_CONFIG_ENABLE_EXCHANGE_CONTEXT_INDEX
+#define WEAVE_CONFIG_ENABLE_EXCHANGE_CONTEXT_INDEX          0
+#endif // WEAVE_CONFIG_ENABLE_EXCHANGE_CONTEXT_INDEX
+
+/**
+ *  @def WEAVE_CONFIG_EXCHANGE_CONTEXT_INDEX_BUCKETS
+ *
+ *  @brief
+ *    Number of hash buckets used to index active exchange contexts
+ *    by exchange identifier when
+ *    #WEAVE_CONFIG_ENABLE_EXCHANGE_CONTEXT_INDEX is enabled.  Must
+ *    be a power of two.
+ *
+ *    By default there is a bucket for each exchange context, rounded
+ *    up to a power of two and to no fewer than 16 buckets, so that a
+ *    lookup visits about one context when the pool is full.  The
+ *    bucket array costs one pointer per bucket; exchange identifiers
+ *    are allocated sequentially, so they spread evenly over the
+ *    buckets.
+ *
+ */
+#ifndef WEAVE_CONFIG_EXCHANGE_CONTEXT_INDEX_BUCKETS
+#define WEAVE_CONFIG_EXCHANGE_CONTEXT_INDEX_BUCKETS                  \
+    ((WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS <= 16)   ? 16   :           \
+     (WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS <= 32)   ? 32   :           \
+     (WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS <= 64)   ? 64   :           \
+     (WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS <= 128)  ? 128  :           \
+     (WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS <= 256)  ? 256  :           \
+     (WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS <= 512)  ? 512  :           \
+     (WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS <= 1024) ? 1024 :           \
+     (WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS <= 2048) ? 2048 :           \
+     (WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS <= 4096) ? 4096 : 8192)
+#endif // WEAVE_CONFIG_EXCHANGE_CONTEXT_INDEX_BUCKETS
+
+#if WEAVE_CONFIG_ENABLE_EXCHANGE_CONTEXT_INDEX && ((WEAVE_CONFIG_EXCHANGE_CONTEXT_INDEX_BUCKETS & (WEAVE_CONFIG_EXCHANGE_CONTEXT_INDEX_BUCKETS - 1)) != 0)
+#error "WEAVE_CONFIG_EXCHANGE_CONTEXT_INDEX_BUCKETS must be a power of two."
+#endif
+
 /**
  *  @def WEAVE_CONFIG_MAX_BINDINGS
  *
@@ -627,7 +627,9 @@ WEAVE_ERROR WeaveConnection::SendMessage (WeaveMessageInfo *msgInfo, PacketBuffe
         ExitNow(res = WEAVE_ERROR_INCORRECT_STATE);
     }
 
-    // TODO: implement back pressure
+    // Refuse the message while the send queue is over budget; the application is told via OnSendBackpressure
+    // when it may send again.
+    VerifyOrExit(!GetFlag(mFlags, kFlag_SendPaused), res = WEAVE_ERROR_SENDING_BLOCKED);
 
     // Set the source node identifier in the message header.
     msgInfo->SourceNodeId = MessageLayer->FabricState->LocalNodeId;
@@ -677,6 +679,8 @@ WEAVE_ERROR WeaveConnection::SendMessage (WeaveMessageInfo *msgInfo, PacketBuffe
 #endif
     {
         res = mTcpEndPoint->Send(msgBuf, true);
+        if (res == WEAVE_NO_ERROR)
+            UpdateSendBacklog();
     }
     msgBuf = NULL;
 
@@ -854,8 +858,15 @@ void WeaveConnection::EnableReceive()
     if (!ReceiveEnabled)
     {
         ReceiveEnabled = true;
-        //ProcessReceivedData();
-        // TODO: fix this
+
+        // If the receive budget paused reading, resume it and have the end point hand back the data it is holding
+        // for us. Otherwise the held data is delivered along with the next data received.
+        if (GetFlag(mFlags, kFlag_ReceivePaused))
+        {
+            ClearFlag(mFlags, kFlag_ReceivePaused);
+            if (mTcpEndPoint != NULL && StateAllowsReceive())
+                mTcpEndPoint->EnableReceive();
+        }
     }
 }
 
@@ -871,8 +882,8 @@ void WeaveConnection::EnableReceive()
  */
 void WeaveConnection::DisableReceive()
 {
+    // Data continues to be read from the TCP connection, and held, until it exceeds the receive budget.
     ReceiveEnabled = false;
-    // TODO: make this disable received in the TcpEndPoint.
 }
 
 /**
@@ -1102,6 +1113,8 @@ void WeaveConnection::DoClose(WEAVE_ERROR err, uint8_t flags)
 #endif // WEAVE_CONFIG_ENABLE_DNS_RESOLVER
         }
 
+        ClearBacklog();
+
         uint8_t oldState = State;
         State = kState_Closed;
 
@@ -1344,7 +1357,7 @@ void WeaveConnection::HandleConnectComplete(TCPEndPoint *endPoint, INET_ERROR co
 
         // Setup various callbacks on the end point.
         endPoint->OnDataReceived = HandleDataReceived;
-        endPoint->OnDataSent = NULL; // TODO: should handle flow control
+        endPoint->OnDataSent = HandleDataSent;
         endPoint->OnConnectionClosed = HandleTcpConnectionClosed;
 
         // Disable TCP Nagle buffering by setting TCP_NODELAY socket option to true
@@ -1409,11 +1422,12 @@ void WeaveConnection::HandleDataReceived(TCPEndPoint *endPoint, PacketBuffer *da
         // If the data buffer contains only part of a message...
         if (err == WEAVE_ERROR_MESSAGE_INCOMPLETE)
         {
-            // If there are more buffers in the queue, move as much data as possible into the head buffer
-            // and try again.
+            // If there are more buffers in the queue, move the rest of the message into the head buffer
+            // and try again. Data beyond the message is left in place, so that once the message has been
+            // parsed the head buffer can usually be given to the application without a copy.
             if (data->Next() != NULL)
             {
-                data->CompactHead();
+                data->EnsureContiguous(static_cast<uint16_t>(frameLen));
                 continue;
             }
 
@@ -1454,6 +1468,29 @@ void WeaveConnection::HandleDataReceived(TCPEndPoint *endPoint, PacketBuffer *da
                 payloadBuf->SetDataLength(payloadLen);
             }
 
+            // Otherwise, if the remaining data is shorter than the payload, move the remaining data into a
+            // new buffer and give the original buffer to the application.
+            else if (data->DataLength() < payloadLen)
+            {
+                PacketBuffer *remainingBuf = PacketBuffer::New(0);
+                if (remainingBuf != NULL)
+                {
+                    memcpy(remainingBuf->Start(), data->Start(), data->DataLength());
+                    remainingBuf->SetDataLength(data->DataLength());
+
+                    payloadBuf = data;
+                    data = data->DetachTail();
+                    if (data != NULL)
+                        remainingBuf->AddToEnd(data);
+                    data = remainingBuf;
+
+                    payloadBuf->SetStart(payload);
+                    payloadBuf->SetDataLength(payloadLen);
+                }
+                else
+                    err = WEAVE_ERROR_NO_MEMORY;
+            }
+
             // Otherwise we need to keep the buffer so we can parse the remaining data, so copy the
             // payload data into a new buffer and arrange to pass the new buffer to the application.
             else
@@ -1565,6 +1602,115 @@ void WeaveConnection::HandleDataReceived(TCPEndPoint *endPoint, PacketBuffer *da
         if (data != NULL)
             PacketBuffer::Free(data);
     }
+
+    if (con->StateAllowsReceive())
+        con->UpdateReceiveBacklog();
+}
+
+void WeaveConnection::HandleDataSent(TCPEndPoint *endPoint, uint16_t len)
+{
+    WeaveConnection *con = (WeaveConnection *) endPoint->AppState;
+    WeaveMessageLayer *msgLayer = con->MessageLayer;
+
+    con->UpdateSendBacklog();
+
+    // Draining this connection may bring the total back under budget, allowing other connections to resume.
+    if (WEAVE_CONFIG_TOTAL_CONNECTION_SEND_BUDGET != 0)
+    {
+        WeaveConnection *otherCon = msgLayer->mConPool;
+        for (int i = 0; i < WEAVE_CONFIG_MAX_CONNECTIONS; i++, otherCon++)
+        {
+            if (otherCon != con && otherCon->mRefCount != 0 && GetFlag(otherCon->mFlags, kFlag_SendPaused))
+                otherCon->UpdateSendBacklog();
+        }
+    }
+}
+
+static inline bool IsOverBudget(uint32_t aLength, uint32_t aBudget)
+{
+    return aBudget != 0 && aLength > aBudget;
+}
+
+static inline bool IsUnderLowWatermark(uint32_t aLength, uint32_t aBudget)
+{
+    return aBudget == 0 || aLength <= aBudget / 2;
+}
+
+// Account for the data the end point is holding for this connection after a receive, and pause reading if the
+// application cannot take the data and the connection, or all connections together, are over the receive budget.
+// Reading is never paused while the data is deliverable, since it is then part of a message still being received.
+void WeaveConnection::UpdateReceiveBacklog(void)
+{
+    WeaveMessageLayer::ConnectionBufferStats &stats = MessageLayer->mConBufferStats;
+    uint32_t buffered = (mTcpEndPoint != NULL) ? mTcpEndPoint->PendingReceiveLength() : 0;
+    bool deliverable = ReceiveEnabled && (OnMessageReceived != NULL
+#if WEAVE_CONFIG_ENABLE_TUNNELING
+                                          || OnTunneledMessageReceived != NULL
+#endif
+                                          );
+
+    stats.PendingReceiveLength = stats.PendingReceiveLength - mRcvBuffered + buffered;
+    mRcvBuffered = buffered;
+
+    if (!deliverable && mTcpEndPoint != NULL && !GetFlag(mFlags, kFlag_ReceivePaused) &&
+        (IsOverBudget(mRcvBuffered, WEAVE_CONFIG_CONNECTION_RECEIVE_BUDGET) ||
+         IsOverBudget(stats.PendingReceiveLength, WEAVE_CONFIG_TOTAL_CONNECTION_RECEIVE_BUDGET)))
+    {
+        SetFlag(mFlags, kFlag_ReceivePaused);
+        stats.ReceivePauseCount++;
+        mTcpEndPoint->DisableReceive();
+
+        WeaveLogProgress(MessageLayer, "Con rcv paused %04X %" PRIu32 " %" PRIu32, LogId(), mRcvBuffered,
+                         stats.PendingReceiveLength);
+    }
+}
+
+// Account for the data queued in the end point for sending, and pause or resume sending as the connection, or all
+// connections together, go over the send budget or drain to half of it.
+void WeaveConnection::UpdateSendBacklog(void)
+{
+    WeaveMessageLayer::ConnectionBufferStats &stats = MessageLayer->mConBufferStats;
+    uint32_t pending = (mTcpEndPoint != NULL) ? mTcpEndPoint->PendingSendLength() : 0;
+
+    stats.PendingSendLength = stats.PendingSendLength - mSendBuffered + pending;
+    mSendBuffered = pending;
+
+    if (!GetFlag(mFlags, kFlag_SendPaused))
+    {
+        if (IsOverBudget(mSendBuffered, WEAVE_CONFIG_CONNECTION_SEND_BUDGET) ||
+            IsOverBudget(stats.PendingSendLength, WEAVE_CONFIG_TOTAL_CONNECTION_SEND_BUDGET))
+        {
+            SetFlag(mFlags, kFlag_SendPaused);
+            stats.SendPauseCount++;
+
+            WeaveLogProgress(MessageLayer, "Con send paused %04X %" PRIu32 " %" PRIu32, LogId(), mSendBuffered,
+                             stats.PendingSendLength);
+
+            if (OnSendBackpressure != NULL)
+                OnSendBackpressure(this, true);
+        }
+    }
+    else if (IsUnderLowWatermark(mSendBuffered, WEAVE_CONFIG_CONNECTION_SEND_BUDGET) &&
+             IsUnderLowWatermark(stats.PendingSendLength, WEAVE_CONFIG_TOTAL_CONNECTION_SEND_BUDGET))
+    {
+        ClearFlag(mFlags, kFlag_SendPaused);
+
+        if (OnSendBackpressure != NULL)
+            OnSendBackpressure(this, false);
+    }
+}
+
+// Remove the connection's data from the message layer totals, and forget any pause, when the connection closes.
+void WeaveConnection::ClearBacklog(void)
+{
+    WeaveMessageLayer::ConnectionBufferStats &stats = MessageLayer->mConBufferStats;
+
+    stats.PendingReceiveLength -= mRcvBuffered;
+    stats.PendingSendLength -= mSendBuffered;
+    mRcvBuffered = 0;
+    mSendBuffered = 0;
+    ClearFlag(mFlags, kFlag_ReceivePaused);
+    ClearFlag(mFlags, kFlag_SendPaused);
 }
 
 void WeaveConnection::HandleTcpConnectionClosed(TCPEndPoint *endPoint, INET_ERROR err)
@@ -1621,6 +1767,7 @@ void WeaveConnection::Init(WeaveMessageLayer *msgLayer)
 #endif
     OnConnectionClosed = DefaultConnectionClosedHandler;
     OnReceiveError = NULL;
+    OnSendBackpressure = NULL;
     memset(&mPeerAddrs, 0, sizeof(mPeerAddrs));
     mTcpEndPoint = NULL;
 #if CONFIG_NETWORK_LAYER_BLE
@@ -1632,6 +1779,8 @@ void WeaveConnection::Init(WeaveMessageLayer *msgLayer)
     SendSourceNodeId = false;
     SendDestNodeId = false;
     mConnectTimeout = 0;
+    mRcvBuffered = 0;
+    mSendBuffered = 0;
 #if WEAVE_CONFIG_ENABLE_DNS_RESOLVER
     mDNSOptions = 0;
 #endif
@@ -1661,7 +1810,7 @@ void WeaveConnection::MakeConnectedTcp(TCPEndPoint *endPoint, const IPAddress &l
     NetworkType = kNetworkType_IP;
     endPoint->AppState = this;
     endPoint->OnDataReceived = HandleDataReceived;
-    endPoint->OnDataSent = NULL; // TODO: should handle flow control
+    endPoint->OnDataSent = HandleDataSent;
     endPoint->OnConnectionClosed = HandleTcpConnectionClosed;
 
     PeerNodeId = (peerAddr.IsIPv6ULA()) ? IPv6InterfaceIdToWeaveNodeId(peerAddr.InterfaceId()) : kNodeIdNotSpecified;
@@ -61,6 +61,16 @@ WEAVE_ERROR WeaveConnectionTunnel::MakeTunnelConnected(TCPEndPoint *endPointOne,
     mEPTwo->OnConnectionClosed = HandleTunnelConnectionClosed;
     mEPTwo->OnPeerClose = HandleReceiveShutdown;
 
+    // Drop the send accounting of the WeaveConnections that owned the end points, and resume reading if
+    // either paused it on reaching its receive budget.
+    mEPOne->OnDataSent = NULL;
+    mEPTwo->OnDataSent = NULL;
+
+    if (!mEPOne->ReceiveEnabled)
+        mEPOne->EnableReceive();
+    if (!mEPTwo->ReceiveEnabled)
+        mEPTwo->EnableReceive();
+
 exit:
     return err;
 }
@@ -441,6 +441,36 @@
 #define WDM_PUBLISHER_MAX_NOTIFIES_IN_FLIGHT 4
 #endif
 
+/**
+ *  @def WDM_PUBLISHER_ENABLE_DIRTY_INDEX
+ *
+ *  @brief
+ *    Enable (1) or disable (0) the publisher dirty index. When enabled, the subscription engine keeps
+ *    an index from trait data handle to the subscribed trait instances, and a count of dirty trait
+ *    instances per subscription, so that marking a trait instance dirty and evaluating notifies cost
+ *    time proportional to the affected subscriptions rather than to all subscriptions and all of their
+ *    trait instances. This is useful on publishers with a large subscriber pool.
+ *
+ */
+#ifndef WDM_PUBLISHER_ENABLE_DIRTY_INDEX
+#define WDM_PUBLISHER_ENABLE_DIRTY_INDEX 0
+#endif
+
+/**
+ *  @def WDM_PUBLISHER_DIRTY_INDEX_BUCKETS
+ *
+ *  @brief
+ *    The number of hash buckets in the publisher dirty index. Must be a power of 2.
+ *
+ */
+#ifndef WDM_PUBLISHER_DIRTY_INDEX_BUCKETS
+#define WDM_PUBLISHER_DIRTY_INDEX_BUCKETS 16
+#endif
+
+#if WDM_PUBLISHER_ENABLE_DIRTY_INDEX && ((WDM_PUBLISHER_DIRTY_INDEX_BUCKETS & (WDM_PUBLISHER_DIRTY_INDEX_BUCKETS - 1)) != 0)
+#error "WDM_PUBLISHER_DIRTY_INDEX_BUCKETS must be a power of 2"
+#endif
+
 /**
  * The auto-generated schema tables key off this define to enable/disable certain fields in the tables. Enable this for now, but remove this define
  * once it has been similarly removed from the auto-generated code since all products are expected to need dictionary support, so the savings in flash/ram
@@ -478,6 +508,18 @@
 #define TDM_VERSIONING_SUPPORT 1
 #endif
 
+/**
+ * @def TDM_SCHEMA_CHILD_INDEX_SUPPORT
+ *
+ * @brief Enable (1) or disable (0) support for an optional per-schema
+ *   index of child handles sorted by context tag. Schemas that supply
+ *   storage for the index get child lookups by tag in logarithmic
+ *   rather than linear time in the number of schema handles.
+ */
+#ifndef TDM_SCHEMA_CHILD_INDEX_SUPPORT
+#define TDM_SCHEMA_CHILD_INDEX_SUPPORT 0
+#endif
+
 /**
  *  @def WDM_PUBLISHER_ENABLE_CUSTOM_COMMANDS
  *
@@ -176,4 +176,30 @@
 #define WEAVE_CONFIG_EVENT_LOGGING_EXTERNAL_EVENT_SUPPORT 0
 #endif
 
+/**
+ * @def WEAVE_CONFIG_EVENT_LOGGING_INDEX_SIZE
+ *
+ * @brief
+ *   The number of entries in the sparse event index kept by each
+ *   event buffer.  The index records the position of selected events
+ *   in the buffer, so that fetching events since a given event ID can
+ *   start reading near that event instead of at the oldest event in
+ *   the log.  The index is stored in the memory supplied for each
+ *   buffer in LogStorageResources.  When 0, no index is kept.
+ */
+#ifndef WEAVE_CONFIG_EVENT_LOGGING_INDEX_SIZE
+#define WEAVE_CONFIG_EVENT_LOGGING_INDEX_SIZE 0
+#endif
+
+/**
+ * @def WEAVE_CONFIG_EVENT_LOGGING_INDEX_INTERVAL
+ *
+ * @brief
+ *   When the event index is enabled, one in this many events of a
+ *   given importance is recorded in the index.
+ */
+#ifndef WEAVE_CONFIG_EVENT_LOGGING_INDEX_INTERVAL
+#define WEAVE_CONFIG_EVENT_LOGGING_INDEX_INTERVAL 8
+#endif
+
 #endif /* WEAVEEVENTLOGGINGCONFIG_H */
@@ -43,6 +43,12 @@
 #include <SystemLayer/SystemTimer.h>
 #include <SystemLayer/SystemStats.h>
 
+#if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
+#if WEAVE_CONFIG_WRMP_RETRANS_TABLE_SIZE > 65535 || WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS > 65535
+#error "WRMP requires WEAVE_CONFIG_WRMP_RETRANS_TABLE_SIZE and WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS to be no more than 65535"
+#endif
+#endif // WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
+
 namespace nl {
 namespace Weave {
 
@@ -88,6 +94,9 @@ WEAVE_ERROR WeaveExchangeManager::Init(WeaveMessageLayer *msgLayer)
 
     memset(ContextPool, 0, sizeof(ContextPool));
     mContextsInUse = 0;
+#if WEAVE_CONFIG_ENABLE_EXCHANGE_CONTEXT_INDEX
+    InitContextIndex();
+#endif
 
     InitBindingPool();
 
@@ -103,7 +112,22 @@ WEAVE_ERROR WeaveExchangeManager::Init(WeaveMessageLayer *msgLayer)
 
     memset(RetransTable, 0, sizeof(RetransTable));
 
+    // Initially every entry is free.
+    for (int i = 0; i < WEAVE_CONFIG_WRMP_RETRANS_TABLE_SIZE; i++)
+    {
+        mRetransHeap[i] = i;
+        RetransTable[i].heapPos = i;
+    }
+    mRetransHeapCount = 0;
+    mAckHeapCount = 0;
+#if WEAVE_CONFIG_WRMP_COALESCE_ACKS || WEAVE_CONFIG_WRMP_ENABLE_SEND_WINDOW
+    ResetWRMPAckStats();
+    mWRMPMultiAckPeerCount = 0;
+    mWRMPNextMultiAckPeer = 0;
+#endif
+
     mWRMPTimeStampBase = System::Timer::GetCurrentEpoch();
+    mWRMPCurrentTick = 0;
 
     mWRMPCurrentTimerExpiry = 0;
 #endif
@@ -216,6 +240,9 @@ ExchangeContext *WeaveExchangeManager::NewContext(const uint64_t &peerNodeId, co
     if (ec != NULL)
     {
         ec->ExchangeId = NextExchangeId++;
+#if WEAVE_CONFIG_ENABLE_EXCHANGE_CONTEXT_INDEX
+        IndexContext(ec);
+#endif
         ec->PeerNodeId = peerNodeId;
         ec->PeerAddr = peerAddr;
         ec->PeerPort = (peerPort != 0) ? peerPort : WEAVE_PORT;
@@ -230,7 +257,10 @@ ExchangeContext *WeaveExchangeManager::NewContext(const uint64_t &peerNodeId, co
         ec->SetAckPending(false);
         ec->SetMsgRcvdFromPeer(false);
         ec->mWRMPConfig = gDefaultWRMPConfig;
-        ec->mWRMPThrottleTimeout = 0;
+        ec->SetThrottled(false);
+#if WEAVE_CONFIG_WRMP_ENABLE_SEND_WINDOW
+        ec->WRMPInitSendWindow();
+#endif
         //Internal and for Debug Only; When set, Exchange Layer does not send Ack.
         ec->SetDropAck(false);
         //Initialize the App callbacks to NULL
@@ -288,6 +318,18 @@ ExchangeContext *WeaveExchangeManager::NewContext(WeaveConnection *con, void *ap
  */
 ExchangeContext *WeaveExchangeManager::FindContext(uint64_t peerNodeId, WeaveConnection *con, void *appState, bool isInitiator)
 {
+#if WEAVE_CONFIG_ENABLE_EXCHANGE_CONTEXT_INDEX
+    // The active list is not kept in pool order; return the lowest-addressed match so that
+    // the result is the same as that of the unindexed pool search.
+    ExchangeContext *match = NULL;
+    for (ExchangeContext *ec = mActiveContexts; ec != NULL; ec = ec->mNextActive)
+        if (ec->PeerNodeId == peerNodeId &&
+            ec->Con == con && ec->AppState == appState &&
+            ec->IsInitiator() == isInitiator &&
+            (match == NULL || ec < match))
+            match = ec;
+    return match;
+#else
     ExchangeContext *ec = (ExchangeContext *) ContextPool;
     for (int i = 0; i < WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS; i++, ec++)
         if (ec->ExchangeMgr != NULL && ec->PeerNodeId == peerNodeId &&
@@ -295,6 +337,7 @@ ExchangeContext *WeaveExchangeManager::FindContext(uint64_t peerNodeId, WeaveCon
             ec->IsInitiator() == isInitiator)
             return ec;
     return NULL;
+#endif
 }
 
 /**
@@ -529,8 +572,13 @@ void WeaveExchangeManager::HandleConnectionClosed(WeaveConnection *con, WEAVE_ER
 size_t WeaveExchangeManager::ExpireExchangeTimers(void)
 {
     size_t retval = 0;
-    ExchangeContext *ec = (ExchangeContext *) ContextPool;
+    ExchangeContext *ec;
+#if WEAVE_CONFIG_ENABLE_EXCHANGE_CONTEXT_INDEX
+    for (ec = mActiveContexts; ec != NULL; ec = ec->mNextActive)
+#else
+    ec = (ExchangeContext *) ContextPool;
     for (int i = 0; i < WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS; i++, ec++)
+#endif
     {
         if (ec->ExchangeMgr != NULL)
         {
@@ -549,28 +597,141 @@ size_t WeaveExchangeManager::ExpireExchangeTimers(void)
 
 ExchangeContext *WeaveExchangeManager::AllocContext()
 {
-    ExchangeContext *ec = (ExchangeContext *) ContextPool;
+    ExchangeContext *ec = NULL;
 
     WEAVE_FAULT_INJECT(FaultInjection::kFault_AllocExchangeContext,
                        return NULL);
 
-    for (int i = 0; i < WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS; i++, ec++)
-        if (ec->ExchangeMgr == NULL)
+#if WEAVE_CONFIG_ENABLE_EXCHANGE_CONTEXT_INDEX
+    ec = mFreeContexts;
+    if (ec != NULL)
+        mFreeContexts = ec->mNextActive;
+#else
+    for (int i = 0; i < WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS; i++)
+        if (ContextPool[i].ExchangeMgr == NULL)
         {
-            *ec = ExchangeContext();
-            ec->ExchangeMgr = this;
-            ec->mRefCount = 1;
-            mContextsInUse++;
-            MessageLayer->SignalMessageLayerActivityChanged();
+            ec = &ContextPool[i];
+            break;
+        }
+#endif
+
+    if (ec == NULL)
+    {
+        WeaveLogError(ExchangeManager, "Alloc ctxt FAILED");
+        return NULL;
+    }
+
+    *ec = ExchangeContext();
+    ec->ExchangeMgr = this;
+    ec->mRefCount = 1;
+#if WEAVE_CONFIG_ENABLE_EXCHANGE_CONTEXT_INDEX
+    ec->mNextActive = mActiveContexts;
+    if (mActiveContexts != NULL)
+        mActiveContexts->mPrevActive = ec;
+    mActiveContexts = ec;
+#endif
+    mContextsInUse++;
+    MessageLayer->SignalMessageLayerActivityChanged();
 #if defined(WEAVE_EXCHANGE_CONTEXT_DETAIL_LOGGING)
-            WeaveLogProgress(ExchangeManager, "ec++ id: %d, inUse: %d, addr: 0x%x", EXCHANGE_CONTEXT_ID(ec - ContextPool), mContextsInUse, ec);
+    WeaveLogProgress(ExchangeManager, "ec++ id: %d, inUse: %d, addr: 0x%x", EXCHANGE_CONTEXT_ID(ec - ContextPool), mContextsInUse, ec);
 #endif
-            SYSTEM_STATS_INCREMENT(nl::Weave::System::Stats::kExchangeMgr_NumContexts);
+    SYSTEM_STATS_INCREMENT(nl::Weave::System::Stats::kExchangeMgr_NumContexts);
 
-            return ec;
+    return ec;
+}
+
+#if WEAVE_CONFIG_ENABLE_EXCHANGE_CONTEXT_INDEX
+
+void WeaveExchangeManager::InitContextIndex(void)
+{
+    // Thread the free list in pool order so that contexts are handed out lowest index first,
+    // as with the unindexed pool search.
+    mFreeContexts = NULL;
+    for (int i = WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS - 1; i >= 0; i--)
+    {
+        ContextPool[i].mNextActive = mFreeContexts;
+        mFreeContexts = &ContextPool[i];
+    }
+
+    mActiveContexts = NULL;
+    memset(mContextBuckets, 0, sizeof(mContextBuckets));
+}
+
+/**
+ *  Add an allocated ExchangeContext to the exchange id hash index.  Must be called once the
+ *  exchange id of the context has been assigned.
+ *
+ *  @note
+ *    Only the exchange id is hashed.  It is assigned by the exchange manager and is never
+ *    changed for the life of a context, whereas the remaining match criteria (peer node id,
+ *    connection and initiator flag) are public and may be altered by the application after
+ *    the context is created.  Those criteria are instead checked by MatchExchange() for each
+ *    context in the bucket.
+ */
+void WeaveExchangeManager::IndexContext(ExchangeContext *ec)
+{
+    ExchangeContext **bucket = &mContextBuckets[ec->ExchangeId & (WEAVE_CONFIG_EXCHANGE_CONTEXT_INDEX_BUCKETS - 1)];
+
+    ec->mNextInBucket = *bucket;
+    *bucket = ec;
+}
+
+/**
+ *  Remove a released ExchangeContext from the hash index and the active list and return it
+ *  to the free list.
+ */
+void WeaveExchangeManager::FreeContext(ExchangeContext *ec)
+{
+    ExchangeContext **link = &mContextBuckets[ec->ExchangeId & (WEAVE_CONFIG_EXCHANGE_CONTEXT_INDEX_BUCKETS - 1)];
+
+    while (*link != NULL && *link != ec)
+        link = &(*link)->mNextInBucket;
+    if (*link != NULL)
+        *link = ec->mNextInBucket;
+    ec->mNextInBucket = NULL;
+
+    if (ec->mPrevActive != NULL)
+        ec->mPrevActive->mNextActive = ec->mNextActive;
+    else
+        mActiveContexts = ec->mNextActive;
+    if (ec->mNextActive != NULL)
+        ec->mNextActive->mPrevActive = ec->mPrevActive;
+    ec->mPrevActive = NULL;
+
+    ec->mNextActive = mFreeContexts;
+    mFreeContexts = ec;
+}
+
+#endif // WEAVE_CONFIG_ENABLE_EXCHANGE_CONTEXT_INDEX
+
+/**
+ *  Find the active ExchangeContext, if any, to which an inbound message belongs.
+ *
+ *  @return   A pointer to the matching ExchangeContext, or NULL if the message does not belong to
+ *            an existing exchange.
+ */
+ExchangeContext *WeaveExchangeManager::LookupContext(WeaveConnection *msgCon, const WeaveMessageInfo *msgInfo,
+                                                     const WeaveExchangeHeader *exchangeHeader)
+{
+    ExchangeContext *match = NULL;
+
+#if WEAVE_CONFIG_ENABLE_EXCHANGE_CONTEXT_INDEX
+    // Prefer the lowest-addressed match, as the unindexed pool search would.
+    ExchangeContext *ec = mContextBuckets[exchangeHeader->ExchangeId & (WEAVE_CONFIG_EXCHANGE_CONTEXT_INDEX_BUCKETS - 1)];
+    for (; ec != NULL; ec = ec->mNextInBucket)
+        if (ec->MatchExchange(msgCon, msgInfo, exchangeHeader) && (match == NULL || ec < match))
+            match = ec;
+#else
+    ExchangeContext *ec = (ExchangeContext *) ContextPool;
+    for (int i = 0; i < WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS; i++, ec++)
+        if (ec->ExchangeMgr != NULL && ec->MatchExchange(msgCon, msgInfo, exchangeHeader))
+        {
+            match = ec;
+            break;
         }
-    WeaveLogError(ExchangeManager, "Alloc ctxt FAILED");
-    return NULL;
+#endif
+
+    return match;
 }
 
 #if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
@@ -590,7 +751,7 @@ void WeaveExchangeManager::WRMPProcessDDMessage(uint32_t PauseTimeMillis, uint64
             {
 
                 //Paustime is specified in milliseconds; Update retrans values
-                RetransTable[i].nextRetransTime += (PauseTimeMillis / mWRMPTimerInterval);
+                WRMPSetRetransTime(RetransTable[i], RetransTable[i].nextRetransTime + (PauseTimeMillis / mWRMPTimerInterval));
 
                 //Call the application callback
                 if (RetransTable[i].exchContext->OnDDRcvd)
@@ -612,6 +773,263 @@ void WeaveExchangeManager::WRMPProcessDDMessage(uint32_t PauseTimeMillis, uint64
     // Schedule next physical wakeup
     WRMPStartTimer();
 }
+
+/**
+ *  Process the acknowledgments carried in the payload of a multi-ack message. Each is applied to the
+ *  exchange it identifies, provided that exchange is with the sender and uses the key of the message.
+ *
+ *  The payload is a sequence of entries of #kMultiAckEntrySize bytes: the exchange id (16 bits), flags
+ *  (8 bits, with #kMultiAckFlag_Initiator set if the sender is the initiator of the exchange) and the
+ *  acknowledged message id (32 bits), all in little-endian order.
+ *
+ *  @retval  #WEAVE_ERROR_INVALID_MESSAGE_LENGTH  If the payload is not a whole number of entries.
+ *  @retval  #WEAVE_NO_ERROR                      On success.
+ */
+WEAVE_ERROR WeaveExchangeManager::WRMPProcessMultiAck(WeaveConnection *msgCon, const WeaveMessageInfo *msgInfo,
+                                                      const WeaveExchangeHeader *exchangeHeader, PacketBuffer *msgBuf)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    const uint8_t *p = msgBuf->Start();
+    uint16_t numEntries = msgBuf->DataLength() / kMultiAckEntrySize;
+    WeaveExchangeHeader ackHeader = *exchangeHeader;
+
+    VerifyOrExit(msgBuf->DataLength() % kMultiAckEntrySize == 0, err = WEAVE_ERROR_INVALID_MESSAGE_LENGTH);
+    VerifyOrExit(msgInfo->MessageVersion == kWeaveMessageVersion_V2, );
+
+#if WEAVE_CONFIG_WRMP_COALESCE_ACKS || WEAVE_CONFIG_WRMP_ENABLE_SEND_WINDOW
+    // The sender understands multi-ack messages, so acknowledgments to it may be coalesced too.
+    WRMPSetPeerAcceptsMultiAck(msgInfo->SourceNodeId);
+#endif
+
+    for (uint16_t i = 0; i < numEntries; i++)
+    {
+        ExchangeContext *ec;
+
+        ackHeader.ExchangeId = LittleEndian::Read16(p);
+        ackHeader.Flags = ((Read8(p) & kMultiAckFlag_Initiator) != 0) ? kWeaveExchangeFlag_Initiator : 0;
+        ackHeader.Flags |= kWeaveExchangeFlag_AckId;
+        ackHeader.AckMsgId = LittleEndian::Read32(p);
+
+        ec = LookupContext(msgCon, msgInfo, &ackHeader);
+        if (ec != NULL && ec->KeyId == msgInfo->KeyId && ec->EncryptionType == msgInfo->EncryptionType)
+        {
+            // Hold a reference across the application's OnAckRcvd callback.
+            ec->AddRef();
+            ec->WRMPHandleRcvdAck(&ackHeader, msgInfo);
+            ec->Release();
+        }
+    }
+
+exit:
+    return err;
+}
+
+#if WEAVE_CONFIG_WRMP_COALESCE_ACKS || WEAVE_CONFIG_WRMP_ENABLE_SEND_WINDOW
+/**
+ *  Write the entries of a multi-ack message for some acknowledgments of an exchange.
+ *
+ *  @return A pointer past the entries written.
+ */
+uint8_t *WeaveExchangeManager::WRMPWriteMultiAckEntries(uint8_t *p, const ExchangeContext *ec, const uint32_t *ackIds, uint8_t numAckIds)
+{
+    uint8_t flags = ec->IsInitiator() ? kMultiAckFlag_Initiator : 0;
+
+    for (uint8_t i = 0; i < numAckIds; i++)
+    {
+        LittleEndian::Write16(p, ec->ExchangeId);
+        Write8(p, flags);
+        LittleEndian::Write32(p, ackIds[i]);
+    }
+
+    return p;
+}
+
+/**
+ *  Send the pending acknowledgment of an exchange in a message of its own. When the exchange holds the
+ *  acknowledgments of several messages (#WEAVE_CONFIG_WRMP_ENABLE_SEND_WINDOW), and with the pending
+ *  acknowledgments of the other exchanges with the same peer and key (#WEAVE_CONFIG_WRMP_COALESCE_ACKS),
+ *  these are carried in a multi-ack message. With no other acknowledgment to send, a Common::Null message
+ *  is sent as usual.
+ *
+ *  @param[in]    ec    A pointer to the ExchangeContext with the acknowledgment to send.
+ *
+ *  @return #WEAVE_NO_ERROR on success, or an error from sending the message. The acknowledgments
+ *          of the other exchanges remain pending if the message could not be sent.
+ */
+WEAVE_ERROR WeaveExchangeManager::WRMPSendCoalescedAcks(ExchangeContext *ec)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    PacketBuffer *msgBuf = NULL;
+    uint16_t numEntries = 0;
+    uint8_t *p;
+#if WEAVE_CONFIG_WRMP_ENABLE_SEND_WINDOW
+    uint8_t heldAckCount = 0;
+#endif
+#if WEAVE_CONFIG_WRMP_COALESCE_ACKS
+    ExchangeContext *others[WEAVE_CONFIG_WRMP_MAX_COALESCED_ACKS];
+    uint16_t numOthers = 0;
+    uint16_t numCandidates;
+#endif
+
+    if (ec->PeerNodeId == kAnyNodeId || ec->mMsgProtocolVersion != kWeaveMessageVersion_V2)
+    {
+        return ec->SendCommonNullMessage();
+    }
+
+#if WEAVE_CONFIG_WRMP_ENABLE_SEND_WINDOW
+    numEntries += ec->mWRMPHeldAckCount;
+#endif
+
+#if WEAVE_CONFIG_WRMP_COALESCE_ACKS
+    // Gather the other exchanges with an ack pending that the peer will accept in the same message,
+    // provided the peer is known to understand multi-ack messages.
+    numCandidates = WRMPPeerAcceptsMultiAck(ec->PeerNodeId) ? mAckHeapCount : 0;
+    for (uint16_t i = 0; i < numCandidates && numOthers < WEAVE_CONFIG_WRMP_MAX_COALESCED_ACKS; i++)
+    {
+        ExchangeContext *other = &ContextPool[mAckHeap[i]];
+
+        if (other != ec && other->PeerNodeId == ec->PeerNodeId && other->Con == ec->Con &&
+            other->KeyId == ec->KeyId && other->EncryptionType == ec->EncryptionType &&
+            other->mMsgProtocolVersion == kWeaveMessageVersion_V2)
+        {
+            others[numOthers++] = other;
+            numEntries++;
+#if WEAVE_CONFIG_WRMP_ENABLE_SEND_WINDOW
+            numEntries += other->mWRMPHeldAckCount;
+#endif
+        }
+    }
+#endif
+
+    if (numEntries == 0)
+    {
+        return ec->SendCommonNullMessage();
+    }
+
+    msgBuf = PacketBuffer::NewWithAvailableSize(numEntries * kMultiAckEntrySize);
+    VerifyOrExit(msgBuf != NULL, err = WEAVE_ERROR_NO_MEMORY);
+
+    p = msgBuf->Start();
+#if WEAVE_CONFIG_WRMP_ENABLE_SEND_WINDOW
+    p = WRMPWriteMultiAckEntries(p, ec, ec->mWRMPHeldAckIds, ec->mWRMPHeldAckCount);
+#endif
+#if WEAVE_CONFIG_WRMP_COALESCE_ACKS
+    for (uint16_t i = 0; i < numOthers; i++)
+    {
+        p = WRMPWriteMultiAckEntries(p, others[i], &others[i]->mPendingPeerAckId, 1);
+#if WEAVE_CONFIG_WRMP_ENABLE_SEND_WINDOW
+        p = WRMPWriteMultiAckEntries(p, others[i], others[i]->mWRMPHeldAckIds, others[i]->mWRMPHeldAckCount);
+#endif
+    }
+#endif
+    msgBuf->SetDataLength(numEntries * kMultiAckEntrySize);
+
+#if WEAVE_CONFIG_WRMP_ENABLE_SEND_WINDOW
+    // The held acknowledgments are in the payload; keep them out of the header while sending.
+    heldAckCount = ec->mWRMPHeldAckCount;
+    ec->mWRMPHeldAckCount = 0;
+#endif
+
+    err = ec->SendMessage(nl::Weave::Profiles::kWeaveProfile_Common,
+                          nl::Weave::Profiles::Common::kMsgType_WRMP_Multi_Ack, msgBuf,
+                          ExchangeContext::kSendFlag_NoAutoRequestAck);
+    msgBuf = NULL;
+
+    if (WeaveMessageLayer::IsSendErrorNonCritical(err))
+    {
+        WeaveLogError(ExchangeManager, "Non-crit err %ld sending multi-ack", long(err));
+        err = WEAVE_NO_ERROR;
+    }
+    SuccessOrExit(err);
+
+#if WEAVE_CONFIG_WRMP_COALESCE_ACKS
+    for (uint16_t i = 0; i < numOthers; i++)
+    {
+        others[i]->SetAckPending(false);
+    }
+#endif
+
+    mWRMPAckStats.MultiAcksSent++;
+    mWRMPAckStats.AcksSaved += numEntries;
+
+exit:
+    if (err != WEAVE_NO_ERROR)
+    {
+        WeaveLogError(ExchangeManager, "Failed to send multi-ack to Peer %016" PRIX64 ":%ld", ec->PeerNodeId, (long)err);
+
+#if WEAVE_CONFIG_WRMP_ENABLE_SEND_WINDOW
+        // Keep the held acknowledgments for the next attempt.  If the pending one went out in the
+        // header, the latest held acknowledgment takes its place.
+        if (heldAckCount > 0 && !ec->IsAckPending())
+        {
+            ec->mPendingPeerAckId = ec->mWRMPHeldAckIds[--heldAckCount];
+            ec->SetAckPending(true);
+        }
+        ec->mWRMPHeldAckCount += heldAckCount;
+#endif
+    }
+
+    return err;
+}
+
+/**
+ *  Get the counters of the acknowledgments coalesced into multi-ack messages.
+ *
+ *  @param[out]   outStats   The current counters.
+ */
+void WeaveExchangeManager::GetWRMPAckStats(WRMPAckStats &outStats) const
+{
+    outStats = mWRMPAckStats;
+}
+
+/**
+ *  Reset the counters of the acknowledgments coalesced into multi-ack messages.
+ */
+void WeaveExchangeManager::ResetWRMPAckStats(void)
+{
+    memset(&mWRMPAckStats, 0, sizeof(mWRMPAckStats));
+}
+
+/**
+ *  Record that a peer accepts multi-ack messages, so that acknowledgments sent to it may be coalesced.
+ *
+ *  Peers are learned when a multi-ack message is received from them. Since a node only sends
+ *  multi-ack messages to peers it knows to accept them, an application that knows a peer runs a
+ *  release with multi-ack support declares it with this method, and the peer learns in turn from the
+ *  first multi-ack message it receives.
+ *
+ *  @param[in]    peerNodeId    The node id of the peer.
+ */
+void WeaveExchangeManager::WRMPSetPeerAcceptsMultiAck(uint64_t peerNodeId)
+{
+    if (peerNodeId == kAnyNodeId || WRMPPeerAcceptsMultiAck(peerNodeId))
+        return;
+
+    mWRMPMultiAckPeers[mWRMPNextMultiAckPeer] = peerNodeId;
+    mWRMPNextMultiAckPeer = (mWRMPNextMultiAckPeer + 1) % WEAVE_CONFIG_WRMP_MAX_MULTI_ACK_PEERS;
+    if (mWRMPMultiAckPeerCount < WEAVE_CONFIG_WRMP_MAX_MULTI_ACK_PEERS)
+        mWRMPMultiAckPeerCount++;
+}
+
+/**
+ *  Check whether a peer is known to accept multi-ack messages.
+ *
+ *  @param[in]    peerNodeId    The node id of the peer.
+ *
+ *  @return true if a multi-ack message has been received from the peer, or the application has
+ *          declared it with WRMPSetPeerAcceptsMultiAck(), and it has not since been displaced.
+ */
+bool WeaveExchangeManager::WRMPPeerAcceptsMultiAck(uint64_t peerNodeId) const
+{
+    for (uint8_t i = 0; i < mWRMPMultiAckPeerCount; i++)
+    {
+        if (mWRMPMultiAckPeers[i] == peerNodeId)
+            return true;
+    }
+
+    return false;
+}
+#endif // WEAVE_CONFIG_WRMP_COALESCE_ACKS || WEAVE_CONFIG_WRMP_ENABLE_SEND_WINDOW
 #endif // WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
 
 static void DefaultOnMessageReceived(ExchangeContext *ec, const IPPacketInfo *pktInfo, const WeaveMessageInfo *msgInfo, uint32_t profileId,
@@ -723,30 +1141,38 @@ void WeaveExchangeManager::DispatchMessage(WeaveMessageInfo *msgInfo, PacketBuff
         //Return after processing Delayed Delivery message
         ExitNow(err = WEAVE_NO_ERROR);
     }//If delayed delivery Msg
+
+    //Received Multi-Ack Message: Process the acks for the other exchanges in the payload. The
+    //exchange the message was sent on handles the ack in its header, as for a Common::Null message.
+    //A malformed payload drops the whole message.
+    if (exchangeHeader.ProfileId == nl::Weave::Profiles::kWeaveProfile_Common &&
+        exchangeHeader.MessageType == nl::Weave::Profiles::Common::kMsgType_WRMP_Multi_Ack &&
+        (msgInfo->Flags & kWeaveMessageFlag_DuplicateMessage) == 0)
+    {
+        err = WRMPProcessMultiAck(msgCon, msgInfo, &exchangeHeader, msgBuf);
+        SuccessOrExit(err);
+    }
 #endif
 
     // Search for an existing exchange that the message applies to. If a match is found...
-    ec = (ExchangeContext *) ContextPool;
-    for (int i = 0; i < WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS; i++, ec++)
+    ec = LookupContext(msgCon, msgInfo, &exchangeHeader);
+    if (ec != NULL)
     {
-        if (ec->ExchangeMgr != NULL && ec->MatchExchange(msgCon, msgInfo, &exchangeHeader))
-        {
 #if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
-            // Found a matching exchange. Set flag for correct subsequent WRM
-            // retransmission timeout selection.
-            if (!ec->HasRcvdMsgFromPeer())
-            {
-                ec->SetMsgRcvdFromPeer(true);
-            }
+        // Found a matching exchange. Set flag for correct subsequent WRM
+        // retransmission timeout selection.
+        if (!ec->HasRcvdMsgFromPeer())
+        {
+            ec->SetMsgRcvdFromPeer(true);
+        }
 #endif
 
-            //Matched ExchangeContext; send to message handler.
-            ec->HandleMessage(msgInfo, &exchangeHeader, msgBuf);
+        //Matched ExchangeContext; send to message handler.
+        ec->HandleMessage(msgInfo, &exchangeHeader, msgBuf);
 
-            msgBuf = NULL;
+        msgBuf = NULL;
 
-            ExitNow(err = WEAVE_NO_ERROR);
-        }
+        ExitNow(err = WEAVE_NO_ERROR);
     }
 
 #if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
@@ -827,6 +1253,9 @@ void WeaveExchangeManager::DispatchMessage(WeaveMessageInfo *msgInfo, PacketBuff
 
         ec->Con = msgCon;
         ec->ExchangeId = exchangeHeader.ExchangeId;
+#if WEAVE_CONFIG_ENABLE_EXCHANGE_CONTEXT_INDEX
+        IndexContext(ec);
+#endif
         ec->PeerNodeId = msgInfo->SourceNodeId;
         if (msgInfo->InPacketInfo != NULL)
         {
@@ -854,7 +1283,10 @@ void WeaveExchangeManager::DispatchMessage(WeaveMessageInfo *msgInfo, PacketBuff
         ec->SetAckPending(false);
         ec->SetMsgRcvdFromPeer(true);
         ec->mWRMPConfig = gDefaultWRMPConfig;
-        ec->mWRMPThrottleTimeout = 0;
+        ec->SetThrottled(false);
+#if WEAVE_CONFIG_WRMP_ENABLE_SEND_WINDOW
+        ec->WRMPInitSendWindow();
+#endif
         //Internal and for Debug Only; When set, Exchange Layer does not send Ack.
         ec->SetDropAck(false);
 #endif
@@ -1246,6 +1678,179 @@ uint32_t WeaveExchangeManager::GetTickCounterFromTimeDelta (uint64_t newTime,
     return (timeDelta / mWRMPTimerInterval);
 }
 
+/**
+* Return the absolute WRMP tick at which a delay starting now expires. Virtual
+* ticks must have been expired (see WRMPExpireTicks) beforehand.
+*
+* @param[in]  delayMillis    The delay in milliseconds.
+*
+* @return The absolute tick of the deadline.
+*/
+uint32_t WeaveExchangeManager::WRMPDeadlineFromNow(uint32_t delayMillis)
+{
+    return mWRMPCurrentTick + GetTickCounterFromTimeDelta(System::Timer::GetCurrentEpoch() + delayMillis, mWRMPTimeStampBase);
+}
+
+/**
+* Determine whether an absolute WRMP tick has been reached.
+*/
+bool WeaveExchangeManager::WRMPIsDeadlineDue(uint32_t deadline) const
+{
+    return !IsEarlierWRMPDeadline(mWRMPCurrentTick, deadline);
+}
+
+/**
+* Compare two absolute WRMP ticks, allowing for the tick counter wrapping.
+*
+* @return true if t1 is before t2.
+*/
+bool WeaveExchangeManager::IsEarlierWRMPDeadline(uint32_t t1, uint32_t t2)
+{
+    return static_cast<int32_t>(t1 - t2) < 0;
+}
+
+/**
+* Change the retransmission time of an entry and restore its place in the
+* retransmission heap.
+*
+* @param[in]  entry      A reference to the RetransTableEntry object.
+* @param[in]  deadline   The absolute tick of the next retransmission.
+*/
+void WeaveExchangeManager::WRMPSetRetransTime(RetransTableEntry &entry, uint32_t deadline)
+{
+    entry.nextRetransTime = deadline;
+
+    if (entry.exchContext != NULL)
+    {
+        WRMPSiftRetransEntry(entry.heapPos);
+    }
+}
+
+/**
+* Move the entry at a position of the retransmission heap up or down until
+* it is ordered with respect to its parent and children.
+*/
+void WeaveExchangeManager::WRMPSiftRetransEntry(size_t pos)
+{
+    while (pos > 0 && IsEarlierWRMPDeadline(RetransTable[mRetransHeap[pos]].nextRetransTime,
+                                            RetransTable[mRetransHeap[(pos - 1) / 2]].nextRetransTime))
+    {
+        WRMPSwapRetransEntries(pos, (pos - 1) / 2);
+        pos = (pos - 1) / 2;
+    }
+
+    for (;;)
+    {
+        size_t earliest = pos;
+
+        for (size_t child = 2 * pos + 1; child <= 2 * pos + 2 && child < mRetransHeapCount; child++)
+        {
+            if (IsEarlierWRMPDeadline(RetransTable[mRetransHeap[child]].nextRetransTime,
+                                      RetransTable[mRetransHeap[earliest]].nextRetransTime))
+            {
+                earliest = child;
+            }
+        }
+
+        if (earliest == pos)
+            break;
+
+        WRMPSwapRetransEntries(pos, earliest);
+        pos = earliest;
+    }
+}
+
+void WeaveExchangeManager::WRMPSwapRetransEntries(size_t pos1, size_t pos2)
+{
+    uint16_t index = mRetransHeap[pos1];
+
+    mRetransHeap[pos1] = mRetransHeap[pos2];
+    mRetransHeap[pos2] = index;
+    RetransTable[mRetransHeap[pos1]].heapPos = static_cast<uint16_t>(pos1);
+    RetransTable[mRetransHeap[pos2]].heapPos = static_cast<uint16_t>(pos2);
+}
+
+/**
+* Add an ExchangeContext to the heap of pending acks, or restore its place
+* in the heap after its mWRMPNextAckTime has changed.
+*/
+void WeaveExchangeManager::WRMPScheduleAck(ExchangeContext *ec)
+{
+    if (ec->mWRMPAckHeapPos == 0)
+    {
+        mAckHeap[mAckHeapCount] = static_cast<uint16_t>(ec - ContextPool);
+        ec->mWRMPAckHeapPos = ++mAckHeapCount;
+    }
+
+    WRMPSiftAck(ec->mWRMPAckHeapPos - 1);
+}
+
+/**
+* Remove an ExchangeContext, if present, from the heap of pending acks.
+*/
+void WeaveExchangeManager::WRMPUnscheduleAck(ExchangeContext *ec)
+{
+    size_t pos = ec->mWRMPAckHeapPos;
+
+    if (pos != 0)
+    {
+        pos--;
+        mAckHeapCount--;
+
+        WRMPSwapAcks(pos, mAckHeapCount);
+        ec->mWRMPAckHeapPos = 0;
+
+        if (pos < mAckHeapCount)
+        {
+            WRMPSiftAck(pos);
+        }
+    }
+}
+
+/**
+* Move the context at a position of the pending ack heap up or down until
+* it is ordered with respect to its parent and children.
+*/
+void WeaveExchangeManager::WRMPSiftAck(size_t pos)
+{
+    while (pos > 0 && IsEarlierWRMPDeadline(ContextPool[mAckHeap[pos]].mWRMPNextAckTime,
+                                            ContextPool[mAckHeap[(pos - 1) / 2]].mWRMPNextAckTime))
+    {
+        WRMPSwapAcks(pos, (pos - 1) / 2);
+        pos = (pos - 1) / 2;
+    }
+
+    for (;;)
+    {
+        size_t earliest = pos;
+
+        for (size_t child = 2 * pos + 1; child <= 2 * pos + 2 && child < mAckHeapCount; child++)
+        {
+            if (IsEarlierWRMPDeadline(ContextPool[mAckHeap[child]].mWRMPNextAckTime,
+                                      ContextPool[mAckHeap[earliest]].mWRMPNextAckTime))
+            {
+                earliest = child;
+            }
+        }
+
+        if (earliest == pos)
+            break;
+
+        WRMPSwapAcks(pos, earliest);
+        pos = earliest;
+    }
+}
+
+void WeaveExchangeManager::WRMPSwapAcks(size_t pos1, size_t pos2)
+{
+    uint16_t index = mAckHeap[pos1];
+
+    mAckHeap[pos1] = mAckHeap[pos2];
+    mAckHeap[pos2] = index;
+    ContextPool[mAckHeap[pos1]].mWRMPAckHeapPos = static_cast<uint16_t>(pos1 + 1);
+    ContextPool[mAckHeap[pos2]].mWRMPAckHeapPos = static_cast<uint16_t>(pos2 + 1);
+}
+
 #if defined(WRMP_TICKLESS_DEBUG)
 void WeaveExchangeManager::TicklessDebugDumpRetransTable(const char *log)
 {
@@ -1255,10 +1860,10 @@ void WeaveExchangeManager::TicklessDebugDumpRetransTable(const char *log)
      {
          if (RetransTable[i].exchContext)
          {
-             WeaveLogProgress(ExchangeManager, "EC:%04" PRIX16 " MsgId:%08" PRIX32 " NextRetransTimeCtr:%04" PRIX16,
+             WeaveLogProgress(ExchangeManager, "EC:%04" PRIX16 " MsgId:%08" PRIX32 " NextRetransTimeCtr:%08" PRIX32,
                               RetransTable[i].exchContext,
                               RetransTable[i].msgId,
-                              RetransTable[i].nextRetransTime);
+                              RetransTable[i].nextRetransTime - mWRMPCurrentTick);
          }
      }
 }
@@ -1267,89 +1872,111 @@ void WeaveExchangeManager::TicklessDebugDumpRetransTable(const char *log) { retu
 #endif // WRMP_TICKLESS_DEBUG
 
 /**
-* Iterate through active exchange contexts and retrans table entries.
-* If an action needs to be triggered by WRMP time facilities, execute
-* that action.
+* Execute the WRMP actions that are due: send the acks whose piggyback
+* timeout has expired and retransmit, or give up on, the messages whose
+* retransmission timeout has expired. The pending acks and the
+* retransmission table entries are each kept in a heap ordered by deadline,
+* so only the due items are visited.
 *
 */
 void WeaveExchangeManager::WRMPExecuteActions(void)
 {
     ExchangeContext *ec               = NULL;
 
-    //Process Ack Tables for all ExchangeContexts
-    ec = (ExchangeContext *)ContextPool;
-
 #if defined(WRMP_TICKLESS_DEBUG)
     WeaveLogProgress(ExchangeManager, "WRMPExecuteActions");
 #endif
 
-    for (int i = 0; i < WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS; i++, ec++)
+    //Process the pending acks, earliest first
+    while (mAckHeapCount > 0)
     {
-        if (ec->ExchangeMgr != NULL && ec->IsAckPending())
-        {
-            if (0 == ec->mWRMPNextAckTime)
-            {
+        ec = &ContextPool[mAckHeap[0]];
+
+        if (!WRMPIsDeadlineDue(ec->mWRMPNextAckTime))
+            break;
+
 #if defined(WRMP_TICKLESS_DEBUG)
-                WeaveLogProgress(ExchangeManager, "WRMPExecuteActions sending ACK");
+        WeaveLogProgress(ExchangeManager, "WRMPExecuteActions sending ACK");
 #endif
-                //Send the Ack in a Common::Null message
-                ec->SendCommonNullMessage();
-                ec->SetAckPending(false);
-            }
-        }
+#if WEAVE_CONFIG_WRMP_COALESCE_ACKS || WEAVE_CONFIG_WRMP_ENABLE_SEND_WINDOW
+        //Send the Ack, with any other pending Acks for the peer
+        WRMPSendCoalescedAcks(ec);
+#else
+        //Send the Ack in a Common::Null message
+        ec->SendCommonNullMessage();
+#endif
+        ec->SetAckPending(false);
     }
 
     TicklessDebugDumpRetransTable("WRMPExecuteActions Dumping RetransTable entries before processing");
 
     // Retransmit / cancel anything in the retrans table whose retrans timeout
     // has expired
-    for (int i = 0; i < WEAVE_CONFIG_WRMP_RETRANS_TABLE_SIZE; i++)
+    while (mRetransHeapCount > 0)
     {
-        ec = RetransTable[i].exchContext;
-        if (ec)
+        RetransTableEntry &entry = RetransTable[mRetransHeap[0]];
+        WEAVE_ERROR err = WEAVE_NO_ERROR;
+        uint8_t sendCount = entry.sendCount;
+        void * msgCtxt = entry.msgCtxt;
+
+        if (!WRMPIsDeadlineDue(entry.nextRetransTime))
+            break;
+
+        ec = entry.exchContext;
+
+        if (sendCount > ec->mWRMPConfig.mMaxRetrans)
         {
-            WEAVE_ERROR err = WEAVE_NO_ERROR;
+            err = WEAVE_ERROR_MESSAGE_NOT_ACKNOWLEDGED;
+
+            WeaveLogError(ExchangeManager, "Failed to Send Weave MsgId:%08" PRIX32 " sendCount: %" PRIu8 " max retries: %" PRIu8,
+                          entry.msgId, sendCount, ec->mWRMPConfig.mMaxRetrans);
+
+            // Remove from Table
+            ClearRetransmitTable(entry);
+        }
 
-            if (0 == RetransTable[i].nextRetransTime)
+        if (err == WEAVE_NO_ERROR)
+        {
+#if WEAVE_CONFIG_WRMP_ENABLE_SEND_WINDOW
+            // A message unacknowledged within the retransmission timeout is taken as a sign of congestion.
+            // The other messages of the exchange already in flight were likely lost to the same congestion,
+            // so their retransmissions do not shrink the window again.
+            if (!entry.windowShrunk)
             {
-                uint8_t sendCount = RetransTable[i].sendCount;
-                void * msgCtxt = RetransTable[i].msgCtxt;
+                ec->WRMPShrinkSendWindow(false);
 
-                if (sendCount > ec->mWRMPConfig.mMaxRetrans)
+                for (uint16_t i = 0; i < mRetransHeapCount; i++)
                 {
-                    err = WEAVE_ERROR_MESSAGE_NOT_ACKNOWLEDGED;
-
-                    WeaveLogError(ExchangeManager, "Failed to Send Weave MsgId:%08" PRIX32 " sendCount: %" PRIu8 " max retries: %" PRIu8,
-                                  RetransTable[i].msgId, sendCount, ec->mWRMPConfig.mMaxRetrans);
+                    RetransTableEntry &other = RetransTable[mRetransHeap[i]];
 
-                    // Remove from Table
-                    ClearRetransmitTable(RetransTable[i]);
+                    if (other.exchContext == ec)
+                        other.windowShrunk = true;
                 }
+            }
+#endif
+            // Resend from Table (if the operation fails, the entry is cleared)
+            err = SendFromRetransTable(&entry);
+        }
 
-                if (err == WEAVE_NO_ERROR)
-                {
-                    // Resend from Table (if the operation fails, the entry is cleared)
-                    err = SendFromRetransTable(&(RetransTable[i]));
-                }
+        if (err == WEAVE_NO_ERROR)
+        {
+            uint32_t retransTicks = ec->GetCurrentRetransmitTimeout() / mWRMPTimerInterval;
 
-                if (err == WEAVE_NO_ERROR)
-                {
-                    // If the retransmission was successful, update the passive timer
-                    RetransTable[i].nextRetransTime = ec->GetCurrentRetransmitTimeout() / mWRMPTimerInterval;
+            // If the retransmission was successful, update the passive timer. The entry
+            // is always moved past the current tick so that it is sent at most once per call.
+            WRMPSetRetransTime(entry, mWRMPCurrentTick + ((retransTicks != 0) ? retransTicks : 1));
 #if defined(DEBUG)
-                    WeaveLogProgress(ExchangeManager, "Retransmit MsgId:%08" PRIX32 " Send Cnt %d",
-                            RetransTable[i].msgId, RetransTable[i].sendCount);
+            WeaveLogProgress(ExchangeManager, "Retransmit MsgId:%08" PRIX32 " Send Cnt %d",
+                    entry.msgId, entry.sendCount);
 #endif
-                }
+        }
 
-                if (err != WEAVE_NO_ERROR)
-                {
-                    if (ec->OnSendError)
-                    {
-                        ec->OnSendError(ec, err, msgCtxt);
-                    }
-                }
-            } //nextRetransTime = 0
+        if (err != WEAVE_NO_ERROR)
+        {
+            if (ec->OnSendError)
+            {
+                ec->OnSendError(ec, err, msgCtxt);
+            }
         }
     }
 
@@ -1358,22 +1985,17 @@ void WeaveExchangeManager::WRMPExecuteActions(void)
 
 /**
 * Calculate number of virtual WRMP ticks that have expired since we last
-* called this function. Iterate through active exchange contexts and
-* retrans table entries, subtracting expired virtual ticks to synchronize
-* wakeup times with the current system time. Do not perform any actions
-* beyond updating tick counts, actions will be performed by the physical
-* WRMP timer tick expiry.
+* called this function and advance the current tick by that count. Since all
+* wakeup times are kept as absolute ticks, this synchronizes them with the
+* current system time without visiting any of them. Do not perform any
+* actions, actions will be performed by the physical WRMP timer tick expiry.
 *
 */
 void WeaveExchangeManager::WRMPExpireTicks(void)
 {
     uint64_t            now         = 0;
-    ExchangeContext*    ec          = NULL;
     uint32_t            deltaTicks;
 
-    //Process Ack Tables for all ExchangeContexts
-    ec = (ExchangeContext *)ContextPool;
-
     now = System::Timer::GetCurrentEpoch();
 
     // Number of full ticks elapsed since last timer processing.  We always round down
@@ -1383,69 +2005,11 @@ void WeaveExchangeManager::WRMPExpireTicks(void)
 
     deltaTicks = GetTickCounterFromTimeDelta(now, mWRMPTimeStampBase);
 
-    // Note on math involving deltaTicks: in the code below, deltaTicks, a
-    // 32-bit value, is being subtracted from 16-bit expiration times.  In each
-    // case, we compare the expiration time prior to subtraction to guard
-    // against underflow.
-
 #if defined(WRMP_TICKLESS_DEBUG)
     WeaveLogProgress(ExchangeManager, "WRMPExpireTicks at %" PRIu64 ", %" PRIu64 ", %u", now, mWRMPTimeStampBase, deltaTicks);
 #endif
 
-    for (int i = 0; i < WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS; i++, ec++)
-    {
-        if (ec->ExchangeMgr != NULL && ec->IsAckPending())
-        {
-            //Decrement counter of Ack timestamp by the elapsed timer ticks
-            if (ec->mWRMPNextAckTime >= deltaTicks)
-            {
-                ec->mWRMPNextAckTime -= deltaTicks;
-            }
-            else
-            {
-                ec->mWRMPNextAckTime = 0;
-            }
-#if defined(WRMP_TICKLESS_DEBUG)
-            WeaveLogProgress(ExchangeManager, "WRMPExpireTicks set mWRMPNextAckTime to %u", ec->mWRMPNextAckTime);
-#endif
-        }
-    }
-
-    //Process Throttle Time
-    //Check Throttle timeout stored in EC to set/unset Throttle flag
-    for (int i = 0; i < WEAVE_CONFIG_WRMP_RETRANS_TABLE_SIZE; i++)
-    {
-        ec = RetransTable[i].exchContext;
-        if (ec)
-        {
-            //Process Retransmit Table
-            //Decrement Throttle timeout by elapsed timeticks
-            if (ec->mWRMPThrottleTimeout >= deltaTicks)
-            {
-                ec->mWRMPThrottleTimeout -= deltaTicks;
-            }
-            else
-            {
-                ec->mWRMPThrottleTimeout = 0;
-            }
-#if defined(WRMP_TICKLESS_DEBUG)
-            WeaveLogProgress(ExchangeManager, "WRMPExpireTicks set mWRMPThrottleTimeout to %u", RetransTable[i].nextRetransTime);
-#endif
-
-            //Decrement Retransmit timeout by elapsed timeticks
-            if (RetransTable[i].nextRetransTime >= deltaTicks)
-            {
-                RetransTable[i].nextRetransTime -= deltaTicks;
-            }
-            else
-            {
-                RetransTable[i].nextRetransTime = 0;
-            }
-#if defined(WRMP_TICKLESS_DEBUG)
-            WeaveLogProgress(ExchangeManager, "WRMPExpireTicks set nextRetransTime to %u", RetransTable[i].nextRetransTime);
-#endif
-        } //ec entry is allocated
-    }
+    mWRMPCurrentTick += deltaTicks;
 
     // Re-Adjust the base time stamp to the most recent tick boundary
 
@@ -1507,41 +2071,41 @@ void WeaveExchangeManager::WRMPTimeout(System::Layer* aSystemLayer, void* aAppSt
  */
 WEAVE_ERROR WeaveExchangeManager::AddToRetransTable(ExchangeContext *ec, PacketBuffer *msgBuf, uint32_t messageId, void *msgCtxt, RetransTableEntry **rEntry)
 {
-    bool added      = false;
     WEAVE_ERROR err = WEAVE_NO_ERROR;
+    RetransTableEntry *entry = NULL;
 
-    for (int i = 0; i < WEAVE_CONFIG_WRMP_RETRANS_TABLE_SIZE; i++)
-    {
-        //Check the exchContext pointer for finding an empty slot in Table
-        if (!RetransTable[i].exchContext)
-        {
-            // Expire any virtual ticks that have expired so all wakeup sources reflect the current time
-            WRMPExpireTicks();
-
-            RetransTable[i].exchContext = ec;
-            RetransTable[i].msgId = messageId;
-            RetransTable[i].msgBuf = msgBuf;
-            RetransTable[i].sendCount = 0;
-            RetransTable[i].nextRetransTime = GetTickCounterFromTimeDelta(ec->GetCurrentRetransmitTimeout() + System::Timer::GetCurrentEpoch(), mWRMPTimeStampBase);
-
-            RetransTable[i].msgCtxt = msgCtxt;
-            *rEntry = &RetransTable[i];
-            //Increment the reference count
-            ec->AddRef();
-            added = true;
-
-            //Check if the timer needs to be started and start it.
-            WRMPStartTimer();
-            break;
-        }
-    }
-
-    if (!added)
+    //The free entries follow the in-use entries in the retransmission heap
+    if (mRetransHeapCount == WEAVE_CONFIG_WRMP_RETRANS_TABLE_SIZE)
     {
         WeaveLogError(ExchangeManager, "RetransTable Already Full");
-        err = WEAVE_ERROR_RETRANS_TABLE_FULL;
+        ExitNow(err = WEAVE_ERROR_RETRANS_TABLE_FULL);
     }
 
+    // Expire any virtual ticks that have expired so all wakeup sources reflect the current time
+    WRMPExpireTicks();
+
+    entry = &RetransTable[mRetransHeap[mRetransHeapCount]];
+    mRetransHeapCount++;
+
+    entry->exchContext = ec;
+    entry->msgId = messageId;
+    entry->msgBuf = msgBuf;
+    entry->sendCount = 0;
+    entry->msgCtxt = msgCtxt;
+    WRMPSetRetransTime(*entry, WRMPDeadlineFromNow(ec->GetCurrentRetransmitTimeout()));
+
+    *rEntry = entry;
+    //Increment the reference count
+    ec->AddRef();
+#if WEAVE_CONFIG_WRMP_ENABLE_SEND_WINDOW
+    entry->windowShrunk = false;
+    ec->mWRMPInFlightCount++;
+#endif
+
+    //Check if the timer needs to be started and start it.
+    WRMPStartTimer();
+
+exit:
     return err;
 }
 
@@ -1567,7 +2131,7 @@ WEAVE_ERROR WeaveExchangeManager::SendFromRetransTable(RetransTableEntry *entry)
 
     WEAVE_FAULT_INJECT(FaultInjection::kFault_WRMSendError,
                        entry->sendCount = (ec->mWRMPConfig.mMaxRetrans + 1);
-                       entry->nextRetransTime = 0;
+                       WRMPSetRetransTime(*entry, mWRMPCurrentTick);
                        WRMPStartTimer();
                        ExitNow());
 
@@ -1591,6 +2155,15 @@ WEAVE_ERROR WeaveExchangeManager::SendFromRetransTable(RetransTableEntry *entry)
         entry->msgBuf->SetStart(p);
         entry->msgBuf->SetDataLength(len);
 
+#if WEAVE_CONFIG_WRMP_ADAPTIVE_RETRANS_TIMEOUT
+        //Time the first transmission, from which the round trip time is measured when it is acknowledged
+        if (entry->sendCount == 0)
+        {
+            entry->sentTime = static_cast<uint32_t>(System::Timer::GetCurrentEpoch());
+        }
+        FabricState->OnReliableMessageSent(ec->PeerNodeId, entry->sendCount != 0);
+#endif
+
         //Update the counters
         entry->sendCount++;
     }
@@ -1651,9 +2224,14 @@ void WeaveExchangeManager::ClearRetransmitTable(RetransTableEntry &rEntry)
 {
     if (rEntry.exchContext)
     {
+        uint16_t heapPos;
+
         // Expire any virtual ticks that have expired so all wakeup sources reflect the current time
         WRMPExpireTicks();
 
+#if WEAVE_CONFIG_WRMP_ENABLE_SEND_WINDOW
+        rEntry.exchContext->mWRMPInFlightCount--;
+#endif
         rEntry.exchContext->Release();
         rEntry.exchContext = NULL;
 
@@ -1664,8 +2242,17 @@ void WeaveExchangeManager::ClearRetransmitTable(RetransTableEntry &rEntry)
         }
 
         // Clear all other fields
+        heapPos = rEntry.heapPos;
         memset(&rEntry, 0, sizeof(rEntry));
 
+        // Move the entry to the start of the free entries and reorder the one that took its place
+        mRetransHeapCount--;
+        WRMPSwapRetransEntries(heapPos, mRetransHeapCount);
+        if (heapPos < mRetransHeapCount)
+        {
+            WRMPSiftRetransEntry(heapPos);
+        }
+
         // Schedule next physical wakeup
         WRMPStartTimer();
 
@@ -1699,56 +2286,47 @@ void WeaveExchangeManager::FailRetransmitTableEntries(ExchangeContext *ec, WEAVE
 }
 
 /**
-* Iterate through active exchange contexts and retrans table entries.
 * Determine how many WRMP ticks we need to sleep before we need to physically
-* wake the CPU to perform an action.  Set a timer to go off when we
-* next need to wake the system.
+* wake the CPU to perform an action, from the earliest pending ack and the
+* earliest retransmission.  Set a timer to go off when we next need to wake
+* the system.
+*
+* @note
+*   No wakeup is scheduled for the end of a throttle period: throttling is
+*   applied by deferring the retransmission times of the throttled exchange.
 *
 */
 void WeaveExchangeManager::WRMPStartTimer()
 {
     WEAVE_ERROR res                   = WEAVE_NO_ERROR;
-    uint32_t nextWakeTime             = UINT32_MAX;
+    uint32_t nextWakeTime             = 0;
     bool foundWake                    = false;
-    ExchangeContext *ec               = NULL;
 
     // When do we need to next wake up to send an ACK?
-    ec = (ExchangeContext *)ContextPool;
-
-    for (int i = 0; i < WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS; i++, ec++)
+    if (mAckHeapCount > 0)
     {
-        if (ec->ExchangeMgr != NULL && ec->IsAckPending() && ec->mWRMPNextAckTime < nextWakeTime) {
-            nextWakeTime = ec->mWRMPNextAckTime;
-            foundWake = true;
+        nextWakeTime = ContextPool[mAckHeap[0]].mWRMPNextAckTime;
+        foundWake = true;
 #if defined(WRMP_TICKLESS_DEBUG)
-            WeaveLogProgress(ExchangeManager, "WRMPStartTimer next ACK time %u", nextWakeTime);
+        WeaveLogProgress(ExchangeManager, "WRMPStartTimer next ACK time %u", nextWakeTime);
 #endif
-        }
     }
 
-    for (int i = 0; i < WEAVE_CONFIG_WRMP_RETRANS_TABLE_SIZE; i++)
+    // When do we need to next wake up for WRMP retransmit?
+    if (mRetransHeapCount > 0 &&
+        (!foundWake || IsEarlierWRMPDeadline(RetransTable[mRetransHeap[0]].nextRetransTime, nextWakeTime)))
     {
-        ec = RetransTable[i].exchContext;
-        if (ec)
-        {
-            // When do we need to next wake up for throttle retransmission?
-            if (ec->mWRMPThrottleTimeout != 0 && ec->mWRMPThrottleTimeout < nextWakeTime) {
-                nextWakeTime = ec->mWRMPThrottleTimeout;
-                foundWake = true;
+        nextWakeTime = RetransTable[mRetransHeap[0]].nextRetransTime;
+        foundWake = true;
 #if defined(WRMP_TICKLESS_DEBUG)
-                WeaveLogProgress(ExchangeManager, "WRMPStartTimer throttle timeout %u", nextWakeTime);
+        WeaveLogProgress(ExchangeManager, "WRMPStartTimer RetransTime %u", nextWakeTime);
 #endif
-            }
+    }
 
-            // When do we need to next wake up for WRMP retransmit?
-            if (RetransTable[i].nextRetransTime < nextWakeTime) {
-                nextWakeTime = RetransTable[i].nextRetransTime;
-                foundWake = true;
-#if defined(WRMP_TICKLESS_DEBUG)
-                WeaveLogProgress(ExchangeManager, "WRMPStartTimer RetransTime %u", nextWakeTime);
-#endif
-            }
-        }
+    // Convert the absolute tick to a count of ticks from the current tick
+    if (foundWake)
+    {
+        nextWakeTime = WRMPIsDeadlineDue(nextWakeTime) ? 0 : nextWakeTime - mWRMPCurrentTick;
     }
 
     if (foundWake) {
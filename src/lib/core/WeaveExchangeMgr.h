@@ -43,6 +43,7 @@ using System::PacketBuffer;
 
 struct WeaveMessageInfo;
 class WeaveExchangeManager;
+class WeaveExchangeManagerTestObject;
 class WeaveMessageLayer;
 class WeaveConnection;
 class Binding;
@@ -179,6 +180,10 @@ public:
     void SetMsgRcvdFromPeer(bool inMsgRcvdFromPeer);
     WEAVE_ERROR WRMPFlushAcks(void);
     uint32_t GetCurrentRetransmitTimeout(void);
+#endif
+#if WEAVE_CONFIG_WRMP_ENABLE_SEND_WINDOW
+    uint8_t WRMPGetSendWindow(void) const;
+    uint8_t WRMPGetInFlightCount(void) const;
 #endif
     void SetResponseExpected(bool inResponseExpected);
     bool AutoRequestAck() const;
@@ -366,8 +371,21 @@ private:
 
     uint32_t mPendingPeerAckId;
 #if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
-    uint16_t mWRMPNextAckTime;                  //Next time for triggering Solo Ack
-    uint16_t mWRMPThrottleTimeout;              //Timeout until when Throttle is On when WRMPThrottleEnabled is set
+    uint32_t mWRMPNextAckTime;                  //Next time for triggering Solo Ack, as an absolute WRMP tick
+    uint32_t mWRMPThrottleTimeout;              //Timeout until when Throttle is On when kFlagThrottled is set, as an absolute WRMP tick
+    uint16_t mWRMPAckHeapPos;                   //Position + 1 of this context in the pending ack heap, 0 when no ack is scheduled
+#endif
+#if WEAVE_CONFIG_WRMP_ENABLE_SEND_WINDOW
+    enum
+    {
+        kWRMPSendWindowScale = 16               //Scale of mWRMPCongestionWindow and mWRMPSlowStartThreshold
+    };
+
+    uint32_t mWRMPHeldAckIds[WEAVE_CONFIG_WRMP_MAX_PENDING_ACKS - 1]; //Pending acks held in addition to mPendingPeerAckId
+    uint8_t mWRMPHeldAckCount;                  //Number of entries in mWRMPHeldAckIds; 0 unless an ack is pending
+    uint8_t mWRMPInFlightCount;                 //Number of messages of this context in the retransmission table
+    uint16_t mWRMPCongestionWindow;             //Number of messages allowed in flight, scaled
+    uint16_t mWRMPSlowStartThreshold;           //Window below which it grows by a message per ack, scaled
 #endif
     void DoClose(bool clearRetransTable);
     WEAVE_ERROR HandleMessage(WeaveMessageInfo *msgInfo, const WeaveExchangeHeader *exchHeader, PacketBuffer *msgBuf);
@@ -380,9 +398,22 @@ private:
     WEAVE_ERROR WRMPHandleRcvdAck(const WeaveExchangeHeader *exchHeader, const WeaveMessageInfo *msgInfo);
     WEAVE_ERROR WRMPHandleNeedsAck(const WeaveMessageInfo *msgInfo);
     WEAVE_ERROR HandleThrottleFlow(uint32_t PauseTimeMillis);
+    bool IsThrottled(void);
+    void SetThrottled(bool inThrottled);
+#endif
+#if WEAVE_CONFIG_WRMP_ENABLE_SEND_WINDOW
+    void WRMPInitSendWindow(void);
+    void WRMPGrowSendWindow(void);
+    void WRMPShrinkSendWindow(bool toOneMessage);
 #endif
 
     uint8_t mRefCount;
+
+#if WEAVE_CONFIG_ENABLE_EXCHANGE_CONTEXT_INDEX
+    ExchangeContext *mNextInBucket;             // Next context in the same exchange id hash bucket
+    ExchangeContext *mNextActive;               // Next context on the active list, or on the free list when free
+    ExchangeContext *mPrevActive;               // Previous context on the active list
+#endif
 };
 
 /**
@@ -396,6 +427,7 @@ private:
  */
 class NL_DLL_EXPORT WeaveExchangeManager
 {
+    friend class WeaveExchangeManagerTestObject;
     friend class Binding;
     friend class ExchangeContext;
     friend class WeaveMessageLayer;
@@ -454,10 +486,29 @@ public:
     void ClearMsgCounterSyncReq(uint64_t peerNodeId);
 #endif
 
+#if WEAVE_CONFIG_WRMP_COALESCE_ACKS || WEAVE_CONFIG_WRMP_ENABLE_SEND_WINDOW
+    /**
+     * Counters of the acknowledgments coalesced into multi-ack messages.
+     */
+    struct WRMPAckStats
+    {
+        uint32_t MultiAcksSent;                 /**< Number of multi-ack messages sent. */
+        uint32_t AcksSaved;                     /**< Number of acknowledgments carried in the payload of a multi-ack
+                                                     message, each of which would otherwise have been sent alone. */
+    };
+
+    void GetWRMPAckStats(WRMPAckStats &outStats) const;
+    void ResetWRMPAckStats(void);
+
+    void WRMPSetPeerAcceptsMultiAck(uint64_t peerNodeId);
+    bool WRMPPeerAcceptsMultiAck(uint64_t peerNodeId) const;
+#endif
+
 private:
     uint16_t NextExchangeId;
 #if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
     uint64_t mWRMPTimeStampBase;    //WRMP timer base value to add offsets to evaluate timeouts
+    uint32_t mWRMPCurrentTick;      //Number of WRMP ticks from Init() up to mWRMPTimeStampBase
     System::Timer::Epoch mWRMPCurrentTimerExpiry; //Tracks when the WRM timer will next expire
     uint16_t mWRMPTimerInterval;    //WRMP Timer tick period
     /**
@@ -477,16 +528,47 @@ private:
        ExchangeContext      *exchContext;       /**< The ExchangeContext for the stored Weave message. */
        PacketBuffer         *msgBuf;            /**< A pointer to the PacketBuffer object holding the Weave message. */
        void                 *msgCtxt;           /**< A pointer to an application level context object associated with the message. */
-       uint16_t             nextRetransTime;    /**< A counter representing the next retransmission time for the message. */
+       uint32_t             nextRetransTime;    /**< The absolute WRMP tick at which the message is next retransmitted. */
+       uint16_t             heapPos;            /**< The position of the entry in mRetransHeap. */
+#if WEAVE_CONFIG_WRMP_ADAPTIVE_RETRANS_TIMEOUT
+       uint32_t             sentTime;           /**< The low 32 bits of the time, in milliseconds, of the first transmission. */
+#endif
+#if WEAVE_CONFIG_WRMP_ENABLE_SEND_WINDOW
+       bool                 windowShrunk;       /**< Set once the send window of the exchange has been shrunk for a loss
+                                                     after the message was first sent. */
+#endif
        uint8_t              sendCount;          /**< A counter representing the number of times the message has been sent. */
     };
+
+    enum
+    {
+        kMultiAckEntrySize          = 7,        /**< The size of an entry in a multi-ack message payload. */
+        kMultiAckFlag_Initiator     = 0x01      /**< Set in an entry if the sender is the initiator of the exchange. */
+    };
+
     void     WRMPExecuteActions(void);
     void     WRMPExpireTicks(void);
     void     WRMPStartTimer(void);
     void     WRMPStopTimer(void);
     void     WRMPProcessDDMessage(uint32_t PauseTimeMillis, uint64_t DelayedNodeId);
+    WEAVE_ERROR WRMPProcessMultiAck(WeaveConnection *msgCon, const WeaveMessageInfo *msgInfo,
+                                    const WeaveExchangeHeader *exchangeHeader, PacketBuffer *msgBuf);
+#if WEAVE_CONFIG_WRMP_COALESCE_ACKS || WEAVE_CONFIG_WRMP_ENABLE_SEND_WINDOW
+    WEAVE_ERROR WRMPSendCoalescedAcks(ExchangeContext *ec);
+    static uint8_t *WRMPWriteMultiAckEntries(uint8_t *p, const ExchangeContext *ec, const uint32_t *ackIds, uint8_t numAckIds);
+#endif
     uint32_t GetTickCounterFromTimeDelta (uint64_t newTime,
                                           uint64_t oldTime);
+    uint32_t WRMPDeadlineFromNow(uint32_t delayMillis);
+    bool     WRMPIsDeadlineDue(uint32_t deadline) const;
+    static bool IsEarlierWRMPDeadline(uint32_t t1, uint32_t t2);
+    void     WRMPSetRetransTime(RetransTableEntry &entry, uint32_t deadline);
+    void     WRMPSiftRetransEntry(size_t pos);
+    void     WRMPSwapRetransEntries(size_t pos1, size_t pos2);
+    void     WRMPScheduleAck(ExchangeContext *ec);
+    void     WRMPUnscheduleAck(ExchangeContext *ec);
+    void     WRMPSiftAck(size_t pos);
+    void     WRMPSwapAcks(size_t pos1, size_t pos2);
     static void WRMPTimeout(System::Layer* aSystemLayer, void* aAppState, System::Error aError);
     static bool isLaterInWRMP(uint64_t t2, uint64_t t1);
     bool IsSendErrorCritical(WEAVE_ERROR err) const;
@@ -501,6 +583,25 @@ private:
 
     //WRMP Global tables for timer context
     RetransTableEntry RetransTable[WEAVE_CONFIG_WRMP_RETRANS_TABLE_SIZE];
+
+    //Indices of the RetransTable entries. The first mRetransHeapCount form a min-heap of the
+    //entries in use, ordered by nextRetransTime; the remainder are the free entries.
+    uint16_t mRetransHeap[WEAVE_CONFIG_WRMP_RETRANS_TABLE_SIZE];
+    uint16_t mRetransHeapCount;
+
+    //Indices into ContextPool of the contexts with an ack pending, as a min-heap ordered by mWRMPNextAckTime.
+    uint16_t mAckHeap[WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS];
+    uint16_t mAckHeapCount;
+
+#if WEAVE_CONFIG_WRMP_COALESCE_ACKS || WEAVE_CONFIG_WRMP_ENABLE_SEND_WINDOW
+    WRMPAckStats mWRMPAckStats;
+
+    //Node ids of the peers known to accept multi-ack messages. Once all entries are used, each
+    //newly learned peer replaces the entry at mWRMPNextMultiAckPeer.
+    uint64_t mWRMPMultiAckPeers[WEAVE_CONFIG_WRMP_MAX_MULTI_ACK_PEERS];
+    uint8_t mWRMPMultiAckPeerCount;
+    uint8_t mWRMPNextMultiAckPeer;
+#endif
 #endif // WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
 
     class UnsolicitedMessageHandler
@@ -526,6 +627,17 @@ private:
 
     ExchangeContext *AllocContext(void);
 
+#if WEAVE_CONFIG_ENABLE_EXCHANGE_CONTEXT_INDEX
+    ExchangeContext *mActiveContexts;
+    ExchangeContext *mFreeContexts;
+    ExchangeContext *mContextBuckets[WEAVE_CONFIG_EXCHANGE_CONTEXT_INDEX_BUCKETS];
+
+    void InitContextIndex(void);
+    void IndexContext(ExchangeContext *ec);
+    void FreeContext(ExchangeContext *ec);
+#endif
+    ExchangeContext *LookupContext(WeaveConnection *msgCon, const WeaveMessageInfo *msgInfo, const WeaveExchangeHeader *exchangeHeader);
+
     void HandleConnectionReceived(WeaveConnection *con);
     void HandleConnectionClosed(WeaveConnection *con, WEAVE_ERROR conErr);
     void DispatchMessage(WeaveMessageInfo *msgInfo, PacketBuffer *msgBuf);
@@ -115,6 +115,9 @@ void WeaveSessionKey::Init(void)
     MaxRcvdMsgId = 0;
     BoundCon = NULL;
     RcvFlags = 0;
+#if WEAVE_CONFIG_MSG_ID_RCV_WINDOW_SIZE
+    RcvWindow.Clear();
+#endif
     AuthMode = kWeaveAuthMode_NotSpecified;
     memset(&MsgEncKey, 0, sizeof(MsgEncKey));
     ReserveCount = 0;
@@ -240,6 +243,9 @@ WEAVE_ERROR WeaveFabricState::Init(GroupKeyStoreBase *groupKeyStore)
     NextUnencTCPMsgId.Init(0);
     for (int i = 0; i < WEAVE_CONFIG_MAX_SESSION_KEYS; i++)
         SessionKeys[i].Init();
+#if WEAVE_CONFIG_ENABLE_SESSION_KEY_INDEX
+    InitSessionKeyIndex();
+#endif
 #if WEAVE_CONFIG_USE_APP_GROUP_KEYS_FOR_MSG_ENC
     WEAVE_ERROR err = NextGroupKeyMsgId.Init(WEAVE_CONFIG_PERSISTED_STORAGE_ENC_MSG_CNTR_ID, WEAVE_CONFIG_PERSISTED_STORAGE_ENC_MSG_CNTR_EPOCH);
     if (err != WEAVE_NO_ERROR)
@@ -250,6 +256,9 @@ WEAVE_ERROR WeaveFabricState::Init(GroupKeyStoreBase *groupKeyStore)
     AppKeyCache.Init();
 #endif
     memset(&PeerStates, 0, sizeof(PeerStates));
+#if WEAVE_CONFIG_ENABLE_PEER_STATE_INDEX
+    InitPeerStateIndex();
+#endif
     Delegate = NULL;
     memset(SharedSessionsNodes, 0, sizeof(SharedSessionsNodes));
 
@@ -314,11 +323,17 @@ WEAVE_ERROR WeaveFabricState::AllocSessionKey(uint64_t peerNodeId, uint16_t keyI
 
     sessionKey->MsgEncKey.KeyId = keyId;
     sessionKey->NodeId = peerNodeId;
+#if WEAVE_CONFIG_ENABLE_SESSION_KEY_INDEX
+    IndexSessionKey(sessionKey);
+#endif
     sessionKey->MsgEncKey.EncType = kWeaveEncryptionType_None;
     sessionKey->NextMsgId.Init(UINT32_MAX);
     sessionKey->MaxRcvdMsgId = UINT32_MAX;
     sessionKey->BoundCon = boundCon;
     sessionKey->RcvFlags = 0;
+#if WEAVE_CONFIG_MSG_ID_RCV_WINDOW_SIZE
+    sessionKey->RcvWindow.Clear();
+#endif
     sessionKey->Flags = WeaveSessionKey::kFlag_RecentlyActive;
     sessionKey->ReserveCount = 1;
 
@@ -356,6 +371,9 @@ WEAVE_ERROR WeaveFabricState::SetSessionKey(WeaveSessionKey *sessionKey, uint8_t
     sessionKey->NextMsgId.Init(msgId);
     sessionKey->MaxRcvdMsgId = 0;
     sessionKey->RcvFlags = 0;
+#if WEAVE_CONFIG_MSG_ID_RCV_WINDOW_SIZE
+    sessionKey->RcvWindow.Clear();
+#endif
     sessionKey->AuthMode = authMode;
 
 #if WEAVE_CONFIG_SECURITY_TEST_MODE && WEAVE_DETAIL_LOGGING
@@ -392,6 +410,10 @@ void WeaveFabricState::RemoveSessionKey(WeaveSessionKey *sessionKey, bool wasIdl
             (wasIdle) ? "idle " : "", sessionKey->MsgEncKey.KeyId, sessionKey->NodeId);
 
     RemoveSharedSessionEndNodes(sessionKey);
+#if WEAVE_CONFIG_ENABLE_SESSION_KEY_INDEX
+    if (sessionKey->IsAllocated())
+        UnindexSessionKey(sessionKey);
+#endif
     sessionKey->Clear();
 }
 
@@ -651,8 +673,18 @@ WEAVE_ERROR WeaveFabricState::SuspendSession(uint16_t keyId, uint64_t peerNodeId
         SuccessOrExit(err);
         err = writer.Put(ContextTag(kTag_SerializedSession_MaxRcvdMessageId), sessionKey->MaxRcvdMsgId);
         SuccessOrExit(err);
+#if WEAVE_CONFIG_MSG_ID_RCV_WINDOW_SIZE
+        // Encode the most recent part of the receive window as message id flags, as without the window.
+        {
+            WeaveSessionState::ReceiveFlagsType rcvFlags = sessionKey->RcvFlags & ~WeaveSessionState::kReceiveFlags_MessageIdFlagsMask;
+            rcvFlags |= sessionKey->RcvWindow.ToReceiveFlags(sessionKey->MaxRcvdMsgId);
+            err = writer.Put(ContextTag(kTag_SerializedSession_MessageRcvdFlags), rcvFlags);
+            SuccessOrExit(err);
+        }
+#else
         err = writer.Put(ContextTag(kTag_SerializedSession_MessageRcvdFlags), sessionKey->RcvFlags);
         SuccessOrExit(err);
+#endif
         err = writer.PutBoolean(ContextTag(kTag_SerializedSession_IsLocallyInitiated), sessionKey->IsLocallyInitiated());
         SuccessOrExit(err);
         err = writer.PutBoolean(ContextTag(kTag_SerializedSession_IsShared), sessionKey->IsSharedSession());
@@ -769,6 +801,9 @@ WEAVE_ERROR WeaveFabricState::RestoreSession(uint8_t * serializedSession, uint16
     {
         sessionKey->MsgEncKey.KeyId = keyId;
         sessionKey->NodeId = peerNodeId;
+#if WEAVE_CONFIG_ENABLE_SESSION_KEY_INDEX
+        IndexSessionKey(sessionKey);
+#endif
         sessionKey->BoundCon = NULL;
         sessionKey->ReserveCount = 0;
         sessionKey->Flags = 0;
@@ -808,6 +843,10 @@ WEAVE_ERROR WeaveFabricState::RestoreSession(uint8_t * serializedSession, uint16
     SuccessOrExit(err);
     err = reader.Get(sessionKey->RcvFlags);
     SuccessOrExit(err);
+#if WEAVE_CONFIG_MSG_ID_RCV_WINDOW_SIZE
+    sessionKey->RcvWindow.FromReceiveFlags(sessionKey->MaxRcvdMsgId, sessionKey->RcvFlags);
+    sessionKey->RcvFlags &= ~WeaveSessionState::kReceiveFlags_MessageIdFlagsMask;
+#endif
     {
         bool b;
         err = reader.Next(kTLVType_Boolean, ContextTag(kTag_SerializedSession_IsLocallyInitiated));
@@ -917,8 +956,14 @@ WEAVE_ERROR WeaveFabricState::GetSessionState(uint64_t remoteNodeId,
         if (con == NULL)
         {
             FindOrAllocPeerEntry(remoteNodeId, true, peerIndex);
+#if WEAVE_CONFIG_MSG_ID_RCV_WINDOW_SIZE
+            outSessionState = WeaveSessionState(NULL, kWeaveAuthMode_Unauthenticated, &NextUnencUDPMsgId,
+                                                &PeerStates.MaxUnencUDPMsgIdRcvd[peerIndex], &PeerStates.UnencRcvFlags[peerIndex],
+                                                &PeerStates.UnencRcvWindow[peerIndex]);
+#else
             outSessionState = WeaveSessionState(NULL, kWeaveAuthMode_Unauthenticated, &NextUnencUDPMsgId,
                                                 &PeerStates.MaxUnencUDPMsgIdRcvd[peerIndex], &PeerStates.UnencRcvFlags[peerIndex]);
+#endif
         }
         else
             outSessionState = WeaveSessionState(NULL, kWeaveAuthMode_Unauthenticated, &NextUnencTCPMsgId, NULL, NULL);
@@ -935,7 +980,12 @@ WEAVE_ERROR WeaveFabricState::GetSessionState(uint64_t remoteNodeId,
             return (sessionKey->MsgEncKey.EncType == kWeaveEncryptionType_None) ? WEAVE_ERROR_KEY_NOT_FOUND : WEAVE_ERROR_WRONG_ENCRYPTION_TYPE;
         if (sessionKey->BoundCon != NULL && sessionKey->BoundCon != con)
             return WEAVE_ERROR_INVALID_USE_OF_SESSION_KEY;
+#if WEAVE_CONFIG_MSG_ID_RCV_WINDOW_SIZE
+        outSessionState = WeaveSessionState(&sessionKey->MsgEncKey, sessionKey->AuthMode, &sessionKey->NextMsgId, &sessionKey->MaxRcvdMsgId, &sessionKey->RcvFlags,
+                                            &sessionKey->RcvWindow);
+#else
         outSessionState = WeaveSessionState(&sessionKey->MsgEncKey, sessionKey->AuthMode, &sessionKey->NextMsgId, &sessionKey->MaxRcvdMsgId, &sessionKey->RcvFlags);
+#endif
         break;
 
 #if WEAVE_CONFIG_USE_APP_GROUP_KEYS_FOR_MSG_ENC
@@ -949,7 +999,12 @@ WEAVE_ERROR WeaveFabricState::GetSessionState(uint64_t remoteNodeId,
         WeaveAuthMode authMode = GroupKeyAuthMode(keyId);
 
         if (FindOrAllocPeerEntry(remoteNodeId, false, peerIndex))
+#if WEAVE_CONFIG_MSG_ID_RCV_WINDOW_SIZE
+            outSessionState = WeaveSessionState(applicationKey, authMode, &NextGroupKeyMsgId, &PeerStates.MaxGroupKeyMsgIdRcvd[peerIndex], &PeerStates.GroupKeyRcvFlags[peerIndex],
+                                                &PeerStates.GroupKeyRcvWindow[peerIndex]);
+#else
             outSessionState = WeaveSessionState(applicationKey, authMode, &NextGroupKeyMsgId, &PeerStates.MaxGroupKeyMsgIdRcvd[peerIndex], &PeerStates.GroupKeyRcvFlags[peerIndex]);
+#endif
         else
             outSessionState = WeaveSessionState(applicationKey, authMode, &NextGroupKeyMsgId, NULL, NULL);
         break;
@@ -964,6 +1019,138 @@ exit:
     return err;
 }
 
+#if WEAVE_CONFIG_WRMP_ADAPTIVE_RETRANS_TIMEOUT
+/**
+ * Get the round trip time statistics for a peer.
+ *
+ * @param[in]  peerNodeId         The node identifier of the peer.
+ * @param[out] outStats           The statistics for the peer.
+ *
+ * @retval true                   If the peer has an entry in the peer state table.
+ * @retval false                  Otherwise; \c outStats is not modified.
+ *
+ */
+bool WeaveFabricState::GetPeerRTTStats(uint64_t peerNodeId, PeerRTTStats& outStats)
+{
+    PeerIndexType peerIndex;
+
+    if (!FindPeerEntry(peerNodeId, peerIndex))
+        return false;
+
+    outStats.SmoothedRTT = PeerStates.SmoothedRTT[peerIndex] >> 3;
+    outStats.RTTVariation = PeerStates.RTTVariation[peerIndex] >> 2;
+    outStats.RetransTimeout = 0;
+    outStats.MessagesSent = PeerStates.ReliableMsgsSent[peerIndex];
+    outStats.Retransmissions = PeerStates.ReliableMsgRetrans[peerIndex];
+    GetPeerRetransTimeout(peerNodeId, outStats.RetransTimeout);
+
+    return true;
+}
+
+/**
+ * Get the WRMP retransmission timeout for a peer whose round trip time has
+ * been measured.
+ *
+ * The timeout is the smoothed round trip time plus four times its mean
+ * deviation, or plus one WRMP timer tick if that is larger, bounded by
+ * #WEAVE_CONFIG_WRMP_MIN_ADAPTIVE_RETRANS_TIMEOUT and
+ * #WEAVE_CONFIG_WRMP_MAX_ADAPTIVE_RETRANS_TIMEOUT.
+ *
+ * @param[in]  peerNodeId         The node identifier of the peer.
+ * @param[out] outTimeoutMillis   The retransmission timeout in milliseconds.
+ *
+ * @retval true                   If the round trip time to the peer has been measured.
+ * @retval false                  Otherwise; \c outTimeoutMillis is not modified.
+ *
+ */
+bool WeaveFabricState::GetPeerRetransTimeout(uint64_t peerNodeId, uint32_t& outTimeoutMillis)
+{
+    PeerIndexType peerIndex;
+    uint32_t timeout;
+
+    if (!FindPeerEntry(peerNodeId, peerIndex) || PeerStates.SmoothedRTT[peerIndex] == 0)
+        return false;
+
+    // RTTVariation is scaled by 4, so it is already four times the mean deviation.
+    timeout = (PeerStates.SmoothedRTT[peerIndex] >> 3) +
+              ((PeerStates.RTTVariation[peerIndex] > WEAVE_CONFIG_WRMP_TIMER_DEFAULT_PERIOD) ?
+                    PeerStates.RTTVariation[peerIndex] : WEAVE_CONFIG_WRMP_TIMER_DEFAULT_PERIOD);
+
+    if (timeout < WEAVE_CONFIG_WRMP_MIN_ADAPTIVE_RETRANS_TIMEOUT)
+        timeout = WEAVE_CONFIG_WRMP_MIN_ADAPTIVE_RETRANS_TIMEOUT;
+    else if (timeout > WEAVE_CONFIG_WRMP_MAX_ADAPTIVE_RETRANS_TIMEOUT)
+        timeout = WEAVE_CONFIG_WRMP_MAX_ADAPTIVE_RETRANS_TIMEOUT;
+
+    outTimeoutMillis = timeout;
+
+    return true;
+}
+
+/**
+ * Record a measurement of the round trip time to a peer. This is called by
+ * WRMP when a message that was sent only once is acknowledged; messages that
+ * were retransmitted are not measured, as the acknowledgment may be for any of
+ * the transmissions (Karn's algorithm).
+ *
+ * The measurement is kept only if the peer already has an entry in the peer
+ * state table, as it does once a message has been received from it; an entry
+ * is never allocated or moved in the table for it.
+ *
+ * @param[in] peerNodeId          The node identifier of the peer.
+ * @param[in] rttMillis           The measured round trip time in milliseconds.
+ *
+ */
+void WeaveFabricState::OnPeerRTTSample(uint64_t peerNodeId, uint32_t rttMillis)
+{
+    PeerIndexType peerIndex;
+
+    if (!FindPeerEntry(peerNodeId, peerIndex))
+        return;
+
+    // A zero SmoothedRTT marks a peer that has not been measured.
+    if (rttMillis == 0)
+        rttMillis = 1;
+
+    if (PeerStates.SmoothedRTT[peerIndex] == 0)
+    {
+        // First measurement: SRTT = R, RTTVAR = R / 2.
+        PeerStates.SmoothedRTT[peerIndex] = rttMillis << 3;
+        PeerStates.RTTVariation[peerIndex] = rttMillis << 1;
+    }
+    else
+    {
+        // SRTT += (R - SRTT) / 8 and RTTVAR += (|R - SRTT| - RTTVAR) / 4, in scaled form.
+        int32_t delta = static_cast<int32_t>(rttMillis) - static_cast<int32_t>(PeerStates.SmoothedRTT[peerIndex] >> 3);
+
+        PeerStates.SmoothedRTT[peerIndex] += delta;
+        if (delta < 0)
+            delta = -delta;
+        PeerStates.RTTVariation[peerIndex] += delta - static_cast<int32_t>(PeerStates.RTTVariation[peerIndex] >> 2);
+    }
+}
+
+/**
+ * Count a reliable message sent to a peer that has an entry in the peer state
+ * table.
+ *
+ * @param[in] peerNodeId          The node identifier of the peer.
+ * @param[in] isRetransmission    Whether the message had been sent before.
+ *
+ */
+void WeaveFabricState::OnReliableMessageSent(uint64_t peerNodeId, bool isRetransmission)
+{
+    PeerIndexType peerIndex;
+
+    if (!FindPeerEntry(peerNodeId, peerIndex))
+        return;
+
+    if (isRetransmission)
+        PeerStates.ReliableMsgRetrans[peerIndex]++;
+    else
+        PeerStates.ReliableMsgsSent[peerIndex]++;
+}
+#endif // WEAVE_CONFIG_WRMP_ADAPTIVE_RETRANS_TIMEOUT
+
 /**
  * Returns an IPAddress containing a Weave ULA for a specified node.
  *
@@ -1050,6 +1237,9 @@ void WeaveFabricState::OnMsgCounterSyncRespRcvd(uint64_t peerNodeId, uint32_t pe
             // Initialize group key entry in the peer state table.
             PeerStates.GroupKeyRcvFlags[peerIndex] = WeaveSessionState::kReceiveFlags_MessageIdSynchronized;
             PeerStates.MaxGroupKeyMsgIdRcvd[peerIndex] = peerMsgId;
+#if WEAVE_CONFIG_MSG_ID_RCV_WINDOW_SIZE
+            PeerStates.GroupKeyRcvWindow[peerIndex].Clear();
+#endif
 
 #if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
             // Clear MsgCounterSyncReq flag for all pending messages to that peer.
@@ -1222,6 +1412,40 @@ exit:
 
 #endif // WEAVE_CONFIG_USE_APP_GROUP_KEYS_FOR_MSG_ENC
 
+/**
+ * This method finds and returns index to the peer entry in the peer state table, without
+ * changing the order in which entries are replaced.
+ *
+ * @param[in]  peerNodeId       The node identifier of the peer.
+ * @param[out] retPeerIndex     Index to the specified peer entry in the peer state table.
+ *
+ * @retval bool                 Whether or not peer's entry found in the peer state table.
+ *
+ */
+bool WeaveFabricState::FindPeerEntry(uint64_t peerNodeId, PeerIndexType& retPeerIndex)
+{
+    if (peerNodeId == kAnyNodeId)
+        return false;
+
+#if WEAVE_CONFIG_ENABLE_PEER_STATE_INDEX
+    for (retPeerIndex = *GetPeerHashBucket(PeerStates.HashBuckets, peerNodeId); retPeerIndex != kPeerIndex_None;
+         retPeerIndex = PeerStates.HashNext[retPeerIndex])
+    {
+        if (PeerStates.NodeId[retPeerIndex] == peerNodeId)
+            return true;
+    }
+#else
+    for (uint16_t i = 0; i < PeerCount; i++)
+    {
+        retPeerIndex = PeerStates.MostRecentlyUsedIndexes[i];
+        if (PeerStates.NodeId[retPeerIndex] == peerNodeId)
+            return true;
+    }
+#endif
+
+    return false;
+}
+
 /**
  * This method finds, allocates (optional), and returns index to the peer entry in the peer state table.
  *
@@ -1237,6 +1461,109 @@ exit:
  */
 bool WeaveFabricState::FindOrAllocPeerEntry(uint64_t peerNodeId, bool allocEntry, PeerIndexType& retPeerIndex)
 {
+#if WEAVE_CONFIG_ENABLE_PEER_STATE_INDEX
+    PeerIndexType *bucket = GetPeerHashBucket(PeerStates.HashBuckets, peerNodeId);
+    bool retVal = false;
+
+    // Find peer entry in the peer state table.
+    for (retPeerIndex = *bucket; retPeerIndex != kPeerIndex_None; retPeerIndex = PeerStates.HashNext[retPeerIndex])
+    {
+        if (PeerStates.NodeId[retPeerIndex] == peerNodeId)
+        {
+            retVal = true;
+            break;
+        }
+    }
+
+    // If peer entry is not found in the peer state table and allocation was requested.
+    if (!retVal && allocEntry)
+    {
+        // If PeerStates table is full then the least recently used entry is discarded
+        // and allocated for the new peer node. The replacement algorithms tries to find
+        // least recently used entry that didn't use encryption to avoid future
+        // complexity associated with encrypted message counter synchronization.
+        if (PeerCount == WEAVE_CONFIG_MAX_PEER_NODES)
+        {
+            PeerIndexType *link;
+
+            // Choose the least recently used peer entry by default.
+            retPeerIndex = PeerStates.MostRecentlyUsed.Tail;
+
+#if WEAVE_CONFIG_USE_APP_GROUP_KEYS_FOR_MSG_ENC
+            // Try to find the least recently used peer entry that didn't use encryption.
+            // Entries on the unsynchronized list may have been synchronized since they
+            // were last used; as the flag is never cleared for a live entry, such entries
+            // are dropped from the list as they are found.
+            while (PeerStates.Unsynchronized.Tail != kPeerIndex_None)
+            {
+                PeerIndexType peerInd = PeerStates.Unsynchronized.Tail;
+                if ((PeerStates.GroupKeyRcvFlags[peerInd] & WeaveSessionState::kReceiveFlags_MessageIdSynchronized) == 0)
+                {
+                    retPeerIndex = peerInd;
+                    break;
+                }
+                PeerListRemove(PeerStates.Unsynchronized, PeerStates.UnsynchronizedNext, PeerStates.UnsynchronizedPrev, peerInd);
+            }
+#endif
+
+            // Remove the entry chosen for replacement from its hash chain.
+            link = GetPeerHashBucket(PeerStates.HashBuckets, PeerStates.NodeId[retPeerIndex]);
+            while (*link != retPeerIndex)
+                link = &PeerStates.HashNext[*link];
+            *link = PeerStates.HashNext[retPeerIndex];
+        }
+
+        // If PeerStates table is not full then the next available entry is the
+        // next unused index. Entries in the table are allocated sequentially and
+        // never discarded until the table is full.
+        else
+        {
+            retPeerIndex = PeerCount++;
+        }
+
+        PeerStates.NodeId[retPeerIndex] = peerNodeId;
+        PeerStates.MaxUnencUDPMsgIdRcvd[retPeerIndex] = 0;
+#if WEAVE_CONFIG_USE_APP_GROUP_KEYS_FOR_MSG_ENC
+        PeerStates.MaxGroupKeyMsgIdRcvd[retPeerIndex] = 0;
+        PeerStates.GroupKeyRcvFlags[retPeerIndex] = 0;
+#endif
+        PeerStates.UnencRcvFlags[retPeerIndex] = 0;
+#if WEAVE_CONFIG_MSG_ID_RCV_WINDOW_SIZE
+        PeerStates.UnencRcvWindow[retPeerIndex].Clear();
+#if WEAVE_CONFIG_USE_APP_GROUP_KEYS_FOR_MSG_ENC
+        PeerStates.GroupKeyRcvWindow[retPeerIndex].Clear();
+#endif
+#endif
+#if WEAVE_CONFIG_WRMP_ADAPTIVE_RETRANS_TIMEOUT
+        PeerStates.SmoothedRTT[retPeerIndex] = 0;
+        PeerStates.RTTVariation[retPeerIndex] = 0;
+        PeerStates.ReliableMsgsSent[retPeerIndex] = 0;
+        PeerStates.ReliableMsgRetrans[retPeerIndex] = 0;
+#endif
+
+        PeerStates.HashNext[retPeerIndex] = *bucket;
+        *bucket = retPeerIndex;
+
+        retVal = true;
+    }
+
+    // Move the requested entry to the head of the most recently used lists.
+    if (retVal)
+    {
+        if (PeerListContains(PeerStates.MostRecentlyUsed, PeerStates.MostRecentlyUsedPrev, retPeerIndex))
+            PeerListRemove(PeerStates.MostRecentlyUsed, PeerStates.MostRecentlyUsedNext, PeerStates.MostRecentlyUsedPrev, retPeerIndex);
+        PeerListPushFront(PeerStates.MostRecentlyUsed, PeerStates.MostRecentlyUsedNext, PeerStates.MostRecentlyUsedPrev, retPeerIndex);
+
+#if WEAVE_CONFIG_USE_APP_GROUP_KEYS_FOR_MSG_ENC
+        if (PeerListContains(PeerStates.Unsynchronized, PeerStates.UnsynchronizedPrev, retPeerIndex))
+            PeerListRemove(PeerStates.Unsynchronized, PeerStates.UnsynchronizedNext, PeerStates.UnsynchronizedPrev, retPeerIndex);
+        if ((PeerStates.GroupKeyRcvFlags[retPeerIndex] & WeaveSessionState::kReceiveFlags_MessageIdSynchronized) == 0)
+            PeerListPushFront(PeerStates.Unsynchronized, PeerStates.UnsynchronizedNext, PeerStates.UnsynchronizedPrev, retPeerIndex);
+#endif
+    }
+
+    return retVal;
+#else // !WEAVE_CONFIG_ENABLE_PEER_STATE_INDEX
     uint16_t i;
     bool retVal = false;
 
@@ -1297,6 +1624,18 @@ bool WeaveFabricState::FindOrAllocPeerEntry(uint64_t peerNodeId, bool allocEntry
         PeerStates.GroupKeyRcvFlags[retPeerIndex] = 0;
 #endif
         PeerStates.UnencRcvFlags[retPeerIndex] = 0;
+#if WEAVE_CONFIG_MSG_ID_RCV_WINDOW_SIZE
+        PeerStates.UnencRcvWindow[retPeerIndex].Clear();
+#if WEAVE_CONFIG_USE_APP_GROUP_KEYS_FOR_MSG_ENC
+        PeerStates.GroupKeyRcvWindow[retPeerIndex].Clear();
+#endif
+#endif
+#if WEAVE_CONFIG_WRMP_ADAPTIVE_RETRANS_TIMEOUT
+        PeerStates.SmoothedRTT[retPeerIndex] = 0;
+        PeerStates.RTTVariation[retPeerIndex] = 0;
+        PeerStates.ReliableMsgsSent[retPeerIndex] = 0;
+        PeerStates.ReliableMsgRetrans[retPeerIndex] = 0;
+#endif
         retVal = true;
     }
 
@@ -1310,8 +1649,79 @@ bool WeaveFabricState::FindOrAllocPeerEntry(uint64_t peerNodeId, bool allocEntry
     }
 
     return retVal;
+#endif // WEAVE_CONFIG_ENABLE_PEER_STATE_INDEX
+}
+
+#if WEAVE_CONFIG_ENABLE_PEER_STATE_INDEX
+
+void WeaveFabricState::InitPeerStateIndex(void)
+{
+    for (int i = 0; i < WEAVE_CONFIG_PEER_STATE_INDEX_BUCKETS; i++)
+        PeerStates.HashBuckets[i] = kPeerIndex_None;
+
+    for (int i = 0; i < WEAVE_CONFIG_MAX_PEER_NODES; i++)
+    {
+        PeerStates.HashNext[i] = kPeerIndex_None;
+        PeerStates.MostRecentlyUsedNext[i] = kPeerIndex_None;
+        PeerStates.MostRecentlyUsedPrev[i] = kPeerIndex_None;
+#if WEAVE_CONFIG_USE_APP_GROUP_KEYS_FOR_MSG_ENC
+        PeerStates.UnsynchronizedNext[i] = kPeerIndex_None;
+        PeerStates.UnsynchronizedPrev[i] = kPeerIndex_None;
+#endif
+    }
+
+    PeerStates.MostRecentlyUsed.Head = PeerStates.MostRecentlyUsed.Tail = kPeerIndex_None;
+#if WEAVE_CONFIG_USE_APP_GROUP_KEYS_FOR_MSG_ENC
+    PeerStates.Unsynchronized.Head = PeerStates.Unsynchronized.Tail = kPeerIndex_None;
+#endif
+}
+
+WeaveFabricState::PeerIndexType *WeaveFabricState::GetPeerHashBucket(PeerIndexType *buckets, uint64_t peerNodeId)
+{
+    uint32_t hash = static_cast<uint32_t>(peerNodeId ^ (peerNodeId >> 32));
+
+    hash ^= hash >> 16;
+    hash ^= hash >> 8;
+
+    return &buckets[hash & (WEAVE_CONFIG_PEER_STATE_INDEX_BUCKETS - 1)];
+}
+
+void WeaveFabricState::PeerListRemove(PeerIndexList& list, PeerIndexType *next, PeerIndexType *prev, PeerIndexType peerIndex)
+{
+    if (prev[peerIndex] != kPeerIndex_None)
+        next[prev[peerIndex]] = next[peerIndex];
+    else
+        list.Head = next[peerIndex];
+
+    if (next[peerIndex] != kPeerIndex_None)
+        prev[next[peerIndex]] = prev[peerIndex];
+    else
+        list.Tail = prev[peerIndex];
+
+    next[peerIndex] = kPeerIndex_None;
+    prev[peerIndex] = kPeerIndex_None;
+}
+
+void WeaveFabricState::PeerListPushFront(PeerIndexList& list, PeerIndexType *next, PeerIndexType *prev, PeerIndexType peerIndex)
+{
+    next[peerIndex] = list.Head;
+    prev[peerIndex] = kPeerIndex_None;
+
+    if (list.Head != kPeerIndex_None)
+        prev[list.Head] = peerIndex;
+    else
+        list.Tail = peerIndex;
+
+    list.Head = peerIndex;
 }
 
+bool WeaveFabricState::PeerListContains(const PeerIndexList& list, const PeerIndexType *prev, PeerIndexType peerIndex)
+{
+    return list.Head == peerIndex || prev[peerIndex] != kPeerIndex_None;
+}
+
+#endif // WEAVE_CONFIG_ENABLE_PEER_STATE_INDEX
+
 WEAVE_ERROR WeaveFabricState::GetPassword(uint8_t pwSrc, const char *& ps, uint16_t& pwLen)
 {
     switch (pwSrc)
@@ -1620,6 +2030,9 @@ WeaveSessionState::WeaveSessionState(void)
     NextMsgId = NULL;
     MaxMsgIdRcvd = NULL;
     RcvFlags = NULL;
+#if WEAVE_CONFIG_MSG_ID_RCV_WINDOW_SIZE
+    RcvWindow = NULL;
+#endif
 }
 
 WeaveSessionState::WeaveSessionState(WeaveMsgEncryptionKey *msgEncKey, WeaveAuthMode authMode,
@@ -1630,7 +2043,24 @@ WeaveSessionState::WeaveSessionState(WeaveMsgEncryptionKey *msgEncKey, WeaveAuth
     NextMsgId = nextMsgId;
     MaxMsgIdRcvd = maxMsgIdRcvd;
     RcvFlags = rcvFlags;
+#if WEAVE_CONFIG_MSG_ID_RCV_WINDOW_SIZE
+    RcvWindow = NULL;
+#endif
+}
+
+#if WEAVE_CONFIG_MSG_ID_RCV_WINDOW_SIZE
+WeaveSessionState::WeaveSessionState(WeaveMsgEncryptionKey *msgEncKey, WeaveAuthMode authMode,
+                                     MonotonicallyIncreasingCounter *nextMsgId, uint32_t *maxMsgIdRcvd, ReceiveFlagsType *rcvFlags,
+                                     ReceiveWindow *rcvWindow)
+{
+    MsgEncKey = msgEncKey;
+    AuthMode = authMode;
+    NextMsgId = nextMsgId;
+    MaxMsgIdRcvd = maxMsgIdRcvd;
+    RcvFlags = rcvFlags;
+    RcvWindow = rcvWindow;
 }
+#endif
 
 uint32_t WeaveSessionState::NewMessageId(void)
 {
@@ -1691,10 +2121,61 @@ bool WeaveSessionState::IsDuplicateMessage(uint32_t msgId)
         {
             *RcvFlags = kReceiveFlags_MessageIdSynchronized;
             *MaxMsgIdRcvd = msgId;
+#if WEAVE_CONFIG_MSG_ID_RCV_WINDOW_SIZE
+            if (RcvWindow != NULL)
+                RcvWindow->Clear();
+#endif
             ExitNow();
         }
     }
 
+#if WEAVE_CONFIG_MSG_ID_RCV_WINDOW_SIZE
+    // If a receive window is in use, it takes the place of the message id flags, the same algorithm
+    // applying over the larger number of message ids.
+    if (RcvWindow != NULL)
+    {
+        delta = (int32_t) (msgId - *MaxMsgIdRcvd);
+
+        // If the new message was sent after the max id message, advance the window.
+        if (delta > 0)
+        {
+            RcvWindow->Advance(*MaxMsgIdRcvd, msgId);
+            *MaxMsgIdRcvd = msgId;
+        }
+
+        // If the new id is the same as the max id message, the message is a duplicate.
+        else if (delta == 0)
+        {
+            ExitNow(isDup = true);
+        }
+
+        // If the new message is earlier but within the window, check and record its reception.
+        else if ((uint32_t) (*MaxMsgIdRcvd - msgId) < WEAVE_CONFIG_MSG_ID_RCV_WINDOW_SIZE)
+        {
+            if (RcvWindow->IsSet(msgId))
+            {
+                ExitNow(isDup = true);
+            }
+            RcvWindow->Set(msgId);
+        }
+
+        // If the message is earlier than the window, assume it is a duplicate if it was encrypted...
+        else if (MsgEncKey != NULL)
+        {
+            ExitNow(isDup = true);
+        }
+
+        // ... otherwise reset the received state, as described below.
+        else
+        {
+            RcvWindow->Clear();
+            *MaxMsgIdRcvd = msgId;
+        }
+
+        ExitNow();
+    }
+#endif
+
     // Extract the message id flags from the receive flags field.
     msgIdFlags = (*RcvFlags) & kReceiveFlags_MessageIdFlagsMask;
 
@@ -1777,6 +2258,117 @@ exit:
     return isDup;
 }
 
+#if WEAVE_CONFIG_MSG_ID_RCV_WINDOW_SIZE
+
+/**
+ * Mark all the message ids in the window as not received.
+ */
+void WeaveSessionState::ReceiveWindow::Clear(void)
+{
+    memset(Bits, 0, sizeof(Bits));
+}
+
+/**
+ * Determine whether a message id in the window has been received.
+ *
+ * @param[in] msgId     A message id earlier than the maximum received, by less than the window size.
+ */
+bool WeaveSessionState::ReceiveWindow::IsSet(uint32_t msgId) const
+{
+    msgId %= WEAVE_CONFIG_MSG_ID_RCV_WINDOW_SIZE;
+
+    return (Bits[msgId / 32] & (1UL << (msgId % 32))) != 0;
+}
+
+/**
+ * Mark a message id in the window as received.
+ *
+ * @param[in] msgId     A message id earlier than the maximum received, by less than the window size.
+ */
+void WeaveSessionState::ReceiveWindow::Set(uint32_t msgId)
+{
+    msgId %= WEAVE_CONFIG_MSG_ID_RCV_WINDOW_SIZE;
+
+    Bits[msgId / 32] |= (1UL << (msgId % 32));
+}
+
+/**
+ * Advance the window on the reception of a message later than the maximum received so far. The old
+ * maximum is marked as received and the ids between the two as not received, one word at a time.
+ *
+ * @param[in] maxMsgId      The maximum message id received so far.
+ * @param[in] newMaxMsgId   The newly received message id, later than \c maxMsgId.
+ */
+void WeaveSessionState::ReceiveWindow::Advance(uint32_t maxMsgId, uint32_t newMaxMsgId)
+{
+    uint32_t delta = newMaxMsgId - maxMsgId;
+    uint32_t msgId = maxMsgId + 1;
+    uint32_t count = delta - 1;
+
+    if (delta >= WEAVE_CONFIG_MSG_ID_RCV_WINDOW_SIZE)
+    {
+        Clear();
+        return;
+    }
+
+    while (count > 0)
+    {
+        uint32_t bit = msgId % 32;
+        uint32_t n = (count < 32 - bit) ? count : 32 - bit;
+        uint32_t mask = (n == 32) ? UINT32_MAX : ((1UL << n) - 1) << bit;
+
+        Bits[(msgId % WEAVE_CONFIG_MSG_ID_RCV_WINDOW_SIZE) / 32] &= ~mask;
+
+        msgId += n;
+        count -= n;
+    }
+
+    Set(maxMsgId);
+}
+
+/**
+ * Express the most recent part of the window as the message id flags of the receive flags.
+ *
+ * @param[in] maxMsgId  The maximum message id received.
+ *
+ * @return The message id flags.
+ */
+WeaveSessionState::ReceiveFlagsType WeaveSessionState::ReceiveWindow::ToReceiveFlags(uint32_t maxMsgId) const
+{
+    ReceiveFlagsType flags = 0;
+
+    for (uint8_t i = 0; i < kReceiveFlags_NumMessageIdFlags; i++)
+    {
+        if (IsSet(maxMsgId - 1 - i))
+            flags |= (1 << i);
+    }
+
+    return flags;
+}
+
+/**
+ * Initialize the window from the message id flags of the receive flags. The ids earlier than the flags
+ * cover are marked as received, so that messages with those ids remain rejected as duplicates.
+ *
+ * @param[in] maxMsgId  The maximum message id received.
+ * @param[in] rcvFlags  The receive flags.
+ */
+void WeaveSessionState::ReceiveWindow::FromReceiveFlags(uint32_t maxMsgId, ReceiveFlagsType rcvFlags)
+{
+    memset(Bits, 0xFF, sizeof(Bits));
+
+    for (uint8_t i = 0; i < kReceiveFlags_NumMessageIdFlags; i++)
+    {
+        if ((rcvFlags & (1 << i)) == 0)
+        {
+            uint32_t msgId = (maxMsgId - 1 - i) % WEAVE_CONFIG_MSG_ID_RCV_WINDOW_SIZE;
+            Bits[msgId / 32] &= ~(1UL << (msgId % 32));
+        }
+    }
+}
+
+#endif // WEAVE_CONFIG_MSG_ID_RCV_WINDOW_SIZE
+
 /**
  * This method finds session key entry.
  *
@@ -1795,6 +2387,54 @@ exit:
  */
 WEAVE_ERROR WeaveFabricState::FindSessionKey(uint16_t keyId, uint64_t peerNodeId, bool create, WeaveSessionKey *& retRec)
 {
+#if WEAVE_CONFIG_ENABLE_SESSION_KEY_INDEX
+    SessionKeyIndexType keyIndex;
+    SharedSessionEndNode *endNode;
+
+    if (!WeaveKeyId::IsSessionKey(keyId))
+        return WEAVE_ERROR_WRONG_KEY_TYPE;
+
+    if (peerNodeId == kNodeIdNotSpecified || peerNodeId == kAnyNodeId)
+        return WEAVE_ERROR_INVALID_ARGUMENT;
+
+    for (keyIndex = *GetSessionKeyHashBucket(keyId, peerNodeId); keyIndex != kSessionKeyIndex_None;
+         keyIndex = SessionKeyIndex.HashNext[keyIndex])
+    {
+        if (SessionKeys[keyIndex].MsgEncKey.KeyId == keyId && SessionKeys[keyIndex].NodeId == peerNodeId)
+        {
+            SessionKeyStatistics.LookupHits++;
+            retRec = &SessionKeys[keyIndex];
+            return WEAVE_NO_ERROR;
+        }
+    }
+
+    // A shared session key is also used by each of the end nodes recorded for it,
+    // which are not reflected in the hash index.
+    endNode = SharedSessionsNodes;
+    for (int i = 0; i < WEAVE_CONFIG_MAX_SHARED_SESSIONS_END_NODES; i++, endNode++)
+    {
+        if (endNode->SessionKey != NULL && endNode->EndNodeId == peerNodeId &&
+            endNode->SessionKey->IsAllocated() && endNode->SessionKey->MsgEncKey.KeyId == keyId &&
+            endNode->SessionKey->IsSharedSession())
+        {
+            SessionKeyStatistics.LookupHits++;
+            retRec = endNode->SessionKey;
+            return WEAVE_NO_ERROR;
+        }
+    }
+
+    SessionKeyStatistics.LookupMisses++;
+
+    if (!create)
+        return WEAVE_ERROR_KEY_NOT_FOUND;
+
+    if (SessionKeyIndex.FreeHead == kSessionKeyIndex_None)
+        return WEAVE_ERROR_TOO_MANY_KEYS;
+
+    retRec = &SessionKeys[SessionKeyIndex.FreeHead];
+
+    return WEAVE_NO_ERROR;
+#else // !WEAVE_CONFIG_ENABLE_SESSION_KEY_INDEX
     WeaveSessionKey *curRec = SessionKeys;
     WeaveSessionKey *freeRec = NULL;
 
@@ -1829,8 +2469,116 @@ WEAVE_ERROR WeaveFabricState::FindSessionKey(uint16_t keyId, uint64_t peerNodeId
     retRec = freeRec;
 
     return WEAVE_NO_ERROR;
+#endif // WEAVE_CONFIG_ENABLE_SESSION_KEY_INDEX
+}
+
+#if WEAVE_CONFIG_ENABLE_SESSION_KEY_INDEX
+
+/**
+ * Get statistics describing the use of the session key table.
+ *
+ * @param[out] outStats           The current session key table statistics.
+ *
+ */
+void WeaveFabricState::GetSessionKeyStats(SessionKeyStats& outStats) const
+{
+    outStats = SessionKeyStatistics;
+}
+
+/**
+ * Reset the session key lookup counters and restart the high watermark of
+ * allocated session keys from the current number of keys.
+ *
+ */
+void WeaveFabricState::ResetSessionKeyStats(void)
+{
+    SessionKeyStatistics.LookupHits = 0;
+    SessionKeyStatistics.LookupMisses = 0;
+    SessionKeyStatistics.MaxKeys = SessionKeyStatistics.NumKeys;
+}
+
+void WeaveFabricState::InitSessionKeyIndex(void)
+{
+    for (int i = 0; i < WEAVE_CONFIG_SESSION_KEY_INDEX_BUCKETS; i++)
+        SessionKeyIndex.HashBuckets[i] = kSessionKeyIndex_None;
+
+    // Thread the free list in table order so that entries are handed out lowest
+    // index first, as with the unindexed search.
+    for (int i = 0; i < WEAVE_CONFIG_MAX_SESSION_KEYS; i++)
+    {
+        SessionKeyIndex.HashNext[i] = kSessionKeyIndex_None;
+        SessionKeyIndex.FreeNext[i] = (i + 1 < WEAVE_CONFIG_MAX_SESSION_KEYS) ? i + 1 : kSessionKeyIndex_None;
+    }
+    SessionKeyIndex.FreeHead = (WEAVE_CONFIG_MAX_SESSION_KEYS > 0) ? 0 : kSessionKeyIndex_None;
+
+    memset(&SessionKeyStatistics, 0, sizeof(SessionKeyStatistics));
 }
 
+/**
+ * Move a newly allocated session key entry from the free list to the hash index.
+ * Must be called once the key id and peer node id of the entry have been set.
+ *
+ */
+void WeaveFabricState::IndexSessionKey(WeaveSessionKey *sessionKey)
+{
+    SessionKeyIndexType keyIndex = static_cast<SessionKeyIndexType>(sessionKey - SessionKeys);
+    SessionKeyIndexType *link = &SessionKeyIndex.FreeHead;
+    SessionKeyIndexType *bucket;
+
+    // The entry is normally at the head of the free list, having just been returned by FindSessionKey().
+    while (*link != keyIndex && *link != kSessionKeyIndex_None)
+        link = &SessionKeyIndex.FreeNext[*link];
+    if (*link == keyIndex)
+        *link = SessionKeyIndex.FreeNext[keyIndex];
+    SessionKeyIndex.FreeNext[keyIndex] = kSessionKeyIndex_None;
+
+    bucket = GetSessionKeyHashBucket(sessionKey->MsgEncKey.KeyId, sessionKey->NodeId);
+    SessionKeyIndex.HashNext[keyIndex] = *bucket;
+    *bucket = keyIndex;
+
+    SessionKeyStatistics.NumKeys++;
+    if (SessionKeyStatistics.MaxKeys < SessionKeyStatistics.NumKeys)
+        SessionKeyStatistics.MaxKeys = SessionKeyStatistics.NumKeys;
+}
+
+/**
+ * Move a session key entry that is about to be cleared from the hash index to
+ * the free list.
+ *
+ */
+void WeaveFabricState::UnindexSessionKey(WeaveSessionKey *sessionKey)
+{
+    SessionKeyIndexType keyIndex = static_cast<SessionKeyIndexType>(sessionKey - SessionKeys);
+    SessionKeyIndexType *link = GetSessionKeyHashBucket(sessionKey->MsgEncKey.KeyId, sessionKey->NodeId);
+
+    while (*link != keyIndex && *link != kSessionKeyIndex_None)
+        link = &SessionKeyIndex.HashNext[*link];
+    VerifyOrExit(*link == keyIndex, /* no-op */);
+    *link = SessionKeyIndex.HashNext[keyIndex];
+    SessionKeyIndex.HashNext[keyIndex] = kSessionKeyIndex_None;
+
+    SessionKeyIndex.FreeNext[keyIndex] = SessionKeyIndex.FreeHead;
+    SessionKeyIndex.FreeHead = keyIndex;
+
+    SessionKeyStatistics.NumKeys--;
+
+exit:
+    return;
+}
+
+WeaveFabricState::SessionKeyIndexType *WeaveFabricState::GetSessionKeyHashBucket(uint16_t keyId, uint64_t peerNodeId)
+{
+    uint32_t hash = static_cast<uint32_t>(peerNodeId ^ (peerNodeId >> 32)) ^ ((static_cast<uint32_t>(keyId) << 16) | keyId);
+
+    hash ^= hash >> 16;
+    hash *= 0x45D9F3B;
+    hash ^= hash >> 16;
+
+    return &SessionKeyIndex.HashBuckets[hash & (WEAVE_CONFIG_SESSION_KEY_INDEX_BUCKETS - 1)];
+}
+
+#endif // WEAVE_CONFIG_ENABLE_SESSION_KEY_INDEX
+
 #if WEAVE_CONFIG_USE_APP_GROUP_KEYS_FOR_MSG_ENC
 WEAVE_ERROR WeaveFabricState::FindMsgEncAppKey(uint16_t keyId, uint8_t encType, WeaveMsgEncryptionKey *& retRec)
 {
@@ -55,6 +55,7 @@ namespace Weave {
 class NL_DLL_EXPORT WeaveConnection;
 class NL_DLL_EXPORT WeaveMessageLayer;
 class NL_DLL_EXPORT WeaveExchangeManager;
+class WeaveFabricStateTestObject;
 struct WeaveMessageInfo;
 
 // Special node id values.
@@ -328,9 +329,38 @@ public:
         kReceiveFlags_MessageIdFlagsMask                = ~kReceiveFlags_MessageIdSynchronized
     };
 
+#if WEAVE_CONFIG_MSG_ID_RCV_WINDOW_SIZE
+    /**
+     *  Bitmap of the message ids received before the maximum id received. The bit for an id is found
+     *  from the id modulo #WEAVE_CONFIG_MSG_ID_RCV_WINDOW_SIZE, so the window advances without shifting.
+     *  When in use, the message id flags in the receive flags are not.
+     */
+    struct ReceiveWindow
+    {
+        enum
+        {
+            kNumWords = WEAVE_CONFIG_MSG_ID_RCV_WINDOW_SIZE / 32
+        };
+
+        uint32_t Bits[kNumWords];
+
+        void Clear(void);
+        bool IsSet(uint32_t msgId) const;
+        void Set(uint32_t msgId);
+        void Advance(uint32_t maxMsgId, uint32_t newMaxMsgId);
+        ReceiveFlagsType ToReceiveFlags(uint32_t maxMsgId) const;
+        void FromReceiveFlags(uint32_t maxMsgId, ReceiveFlagsType rcvFlags);
+    };
+#endif
+
     WeaveSessionState(void);
     WeaveSessionState(WeaveMsgEncryptionKey *msgEncKey, WeaveAuthMode authMode,
                       MonotonicallyIncreasingCounter *nextMsgId, uint32_t *maxRcvdMsgId, ReceiveFlagsType *rcvFlags);
+#if WEAVE_CONFIG_MSG_ID_RCV_WINDOW_SIZE
+    WeaveSessionState(WeaveMsgEncryptionKey *msgEncKey, WeaveAuthMode authMode,
+                      MonotonicallyIncreasingCounter *nextMsgId, uint32_t *maxRcvdMsgId, ReceiveFlagsType *rcvFlags,
+                      ReceiveWindow *rcvWindow);
+#endif
 
     WeaveMsgEncryptionKey *MsgEncKey;
     WeaveAuthMode AuthMode;
@@ -343,6 +373,9 @@ private:
     MonotonicallyIncreasingCounter *NextMsgId;
     uint32_t *MaxMsgIdRcvd;
     ReceiveFlagsType *RcvFlags;
+#if WEAVE_CONFIG_MSG_ID_RCV_WINDOW_SIZE
+    ReceiveWindow *RcvWindow;
+#endif
 };
 
 /**
@@ -369,6 +402,9 @@ public:
     uint32_t MaxRcvdMsgId;                              /**< The maximum message id received under the session key. */
     WeaveConnection *BoundCon;                          /**< The connection to which the key is bound. */
     WeaveSessionState::ReceiveFlagsType RcvFlags;       /**< Flags tracking messages received under the key. */
+#if WEAVE_CONFIG_MSG_ID_RCV_WINDOW_SIZE
+    WeaveSessionState::ReceiveWindow RcvWindow;         /**< The message ids received under the key before the maximum. */
+#endif
     WeaveAuthMode AuthMode;                             /**< The means by which the peer node was authenticated during session establishment. */
     WeaveMsgEncryptionKey MsgEncKey;                    /**< The Weave message encryption key. */
     uint8_t ReserveCount;                               /**< Number of times the session key has been reserved. */
@@ -471,6 +507,8 @@ public:
 
 class NL_DLL_EXPORT WeaveFabricState
 {
+    friend class WeaveFabricStateTestObject;
+
 public:
 
 #if WEAVE_CONFIG_MAX_PEER_NODES <= UINT8_MAX
@@ -533,6 +571,43 @@ public:
 
     WEAVE_ERROR GetSessionState(uint64_t remoteNodeId, uint16_t keyId, uint8_t encType, WeaveConnection *con, WeaveSessionState& outSessionState);
 
+#if WEAVE_CONFIG_ENABLE_SESSION_KEY_INDEX
+    /**
+     * Statistics describing the use of the session key table.
+     */
+    struct SessionKeyStats
+    {
+        uint32_t LookupHits;                            /**< Number of session key lookups that found a key. */
+        uint32_t LookupMisses;                          /**< Number of session key lookups that did not find a key. */
+        uint16_t NumKeys;                               /**< Number of session keys currently allocated. */
+        uint16_t MaxKeys;                               /**< Largest number of session keys allocated at once. */
+    };
+
+    void GetSessionKeyStats(SessionKeyStats& outStats) const;
+    void ResetSessionKeyStats(void);
+#endif // WEAVE_CONFIG_ENABLE_SESSION_KEY_INDEX
+
+#if WEAVE_CONFIG_WRMP_ADAPTIVE_RETRANS_TIMEOUT
+    /**
+     * Round trip time statistics for a peer, measured from the acknowledgment
+     * of WRMP messages.
+     */
+    struct PeerRTTStats
+    {
+        uint32_t SmoothedRTT;                           /**< Smoothed round trip time in milliseconds, 0 until measured. */
+        uint32_t RTTVariation;                          /**< Mean deviation of the round trip time in milliseconds. */
+        uint32_t RetransTimeout;                        /**< Retransmission timeout in milliseconds, 0 until measured. */
+        uint32_t MessagesSent;                          /**< Number of reliable messages sent to the peer, excluding retransmissions. */
+        uint32_t Retransmissions;                       /**< Number of retransmissions to the peer; the retransmit ratio is
+                                                             Retransmissions / MessagesSent. */
+    };
+
+    bool GetPeerRTTStats(uint64_t peerNodeId, PeerRTTStats& outStats);
+    bool GetPeerRetransTimeout(uint64_t peerNodeId, uint32_t& outTimeoutMillis);
+    void OnPeerRTTSample(uint64_t peerNodeId, uint32_t rttMillis);
+    void OnReliableMessageSent(uint64_t peerNodeId, bool isRetransmission);
+#endif // WEAVE_CONFIG_WRMP_ADAPTIVE_RETRANS_TIMEOUT
+
     IPAddress SelectNodeAddress(uint64_t nodeId, uint16_t subnet) const;
     IPAddress SelectNodeAddress(uint64_t nodeId) const;
     bool IsFabricAddress(const IPAddress &addr) const;
@@ -596,6 +671,17 @@ private:
 
     WeaveMsgEncryptionKeyCache AppKeyCache;
 #endif // WEAVE_CONFIG_USE_APP_GROUP_KEYS_FOR_MSG_ENC
+#if WEAVE_CONFIG_ENABLE_PEER_STATE_INDEX
+    enum
+    {
+        kPeerIndex_None                                 = WEAVE_CONFIG_MAX_PEER_NODES
+    };
+    struct PeerIndexList
+    {
+        PeerIndexType Head;
+        PeerIndexType Tail;
+    };
+#endif
     struct
     {
         uint64_t NodeId[WEAVE_CONFIG_MAX_PEER_NODES];
@@ -605,8 +691,39 @@ private:
         WeaveSessionState::ReceiveFlagsType GroupKeyRcvFlags[WEAVE_CONFIG_MAX_PEER_NODES];
 #endif
         WeaveSessionState::ReceiveFlagsType UnencRcvFlags[WEAVE_CONFIG_MAX_PEER_NODES];
+#if WEAVE_CONFIG_MSG_ID_RCV_WINDOW_SIZE
+        WeaveSessionState::ReceiveWindow UnencRcvWindow[WEAVE_CONFIG_MAX_PEER_NODES];
+#if WEAVE_CONFIG_USE_APP_GROUP_KEYS_FOR_MSG_ENC
+        WeaveSessionState::ReceiveWindow GroupKeyRcvWindow[WEAVE_CONFIG_MAX_PEER_NODES];
+#endif
+#endif
+#if WEAVE_CONFIG_WRMP_ADAPTIVE_RETRANS_TIMEOUT
+        // Smoothed round trip time, scaled by 8, and its mean deviation, scaled by 4, in milliseconds.
+        // Both are 0 until the first measurement.
+        uint32_t SmoothedRTT[WEAVE_CONFIG_MAX_PEER_NODES];
+        uint32_t RTTVariation[WEAVE_CONFIG_MAX_PEER_NODES];
+        uint32_t ReliableMsgsSent[WEAVE_CONFIG_MAX_PEER_NODES];
+        uint32_t ReliableMsgRetrans[WEAVE_CONFIG_MAX_PEER_NODES];
+#endif
+#if WEAVE_CONFIG_ENABLE_PEER_STATE_INDEX
+        // Hash chains of peer entries, keyed by node id.
+        PeerIndexType HashBuckets[WEAVE_CONFIG_PEER_STATE_INDEX_BUCKETS];
+        PeerIndexType HashNext[WEAVE_CONFIG_MAX_PEER_NODES];
+        // List of all peer entries in order from most- to least- recently used.
+        PeerIndexList MostRecentlyUsed;
+        PeerIndexType MostRecentlyUsedNext[WEAVE_CONFIG_MAX_PEER_NODES];
+        PeerIndexType MostRecentlyUsedPrev[WEAVE_CONFIG_MAX_PEER_NODES];
+#if WEAVE_CONFIG_USE_APP_GROUP_KEYS_FOR_MSG_ENC
+        // List, in the same order, of the peer entries whose group key message counter
+        // was not synchronized when they were last used.
+        PeerIndexList Unsynchronized;
+        PeerIndexType UnsynchronizedNext[WEAVE_CONFIG_MAX_PEER_NODES];
+        PeerIndexType UnsynchronizedPrev[WEAVE_CONFIG_MAX_PEER_NODES];
+#endif
+#else
         // Array of peer indexes in sorted order from most- to least- recently used.
         PeerIndexType MostRecentlyUsedIndexes[WEAVE_CONFIG_MAX_PEER_NODES];
+#endif
     } PeerStates;
     FabricStateDelegate *Delegate;
 
@@ -621,12 +738,47 @@ private:
 
     bool FindSharedSessionEndNode(uint64_t endNodeId, const WeaveSessionKey *sessionKey);
 
+#if WEAVE_CONFIG_ENABLE_SESSION_KEY_INDEX
+#if WEAVE_CONFIG_MAX_SESSION_KEYS < UINT8_MAX
+    typedef uint8_t SessionKeyIndexType;
+#else
+    typedef uint16_t SessionKeyIndexType;
+#endif
+    enum
+    {
+        kSessionKeyIndex_None                           = WEAVE_CONFIG_MAX_SESSION_KEYS
+    };
+    struct
+    {
+        // Hash chains of allocated session keys, keyed by key id and peer node id.
+        SessionKeyIndexType HashBuckets[WEAVE_CONFIG_SESSION_KEY_INDEX_BUCKETS];
+        SessionKeyIndexType HashNext[WEAVE_CONFIG_MAX_SESSION_KEYS];
+        // List of free session key entries.
+        SessionKeyIndexType FreeHead;
+        SessionKeyIndexType FreeNext[WEAVE_CONFIG_MAX_SESSION_KEYS];
+    } SessionKeyIndex;
+    SessionKeyStats SessionKeyStatistics;
+
+    void InitSessionKeyIndex(void);
+    void IndexSessionKey(WeaveSessionKey *sessionKey);
+    void UnindexSessionKey(WeaveSessionKey *sessionKey);
+    SessionKeyIndexType *GetSessionKeyHashBucket(uint16_t keyId, uint64_t peerNodeId);
+#endif // WEAVE_CONFIG_ENABLE_SESSION_KEY_INDEX
+
 #if WEAVE_CONFIG_USE_APP_GROUP_KEYS_FOR_MSG_ENC
     void StartMsgCounterSyncTimer(void);
     static void OnMsgCounterSyncRespTimeout(System::Layer* aSystemLayer, void* aAppState, System::Error aError);
 #endif
 
+    bool FindPeerEntry(uint64_t peerNodeId, PeerIndexType& retPeerIndex);
     bool FindOrAllocPeerEntry(uint64_t peerNodeId, bool allocEntry, PeerIndexType& retPeerIndex);
+#if WEAVE_CONFIG_ENABLE_PEER_STATE_INDEX
+    void InitPeerStateIndex(void);
+    static PeerIndexType *GetPeerHashBucket(PeerIndexType *buckets, uint64_t peerNodeId);
+    static void PeerListRemove(PeerIndexList& list, PeerIndexType *next, PeerIndexType *prev, PeerIndexType peerIndex);
+    static void PeerListPushFront(PeerIndexList& list, PeerIndexType *next, PeerIndexType *prev, PeerIndexType peerIndex);
+    static bool PeerListContains(const PeerIndexList& list, const PeerIndexType *prev, PeerIndexType peerIndex);
+#endif
     WEAVE_ERROR FindMsgEncAppKey(uint16_t keyId, uint8_t encType, WeaveMsgEncryptionKey *& retRec);
     WEAVE_ERROR DeriveMsgEncAppKey(uint32_t keyId, uint8_t encType, WeaveMsgEncryptionKey & appKey, uint32_t& appGroupGlobalId);
 };
@@ -148,6 +148,7 @@ WEAVE_ERROR WeaveMessageLayer::Init(InitContext *context)
     OnMessageLayerActivityChange = NULL;
     memset(mConPool, 0, sizeof(mConPool));
     memset(mTunnelPool, 0, sizeof(mTunnelPool));
+    memset(&mConBufferStats, 0, sizeof(mConBufferStats));
     AppState = NULL;
     ExchangeMgr = NULL;
     SecurityMgr = NULL;
@@ -560,6 +561,10 @@ WEAVE_ERROR WeaveMessageLayer::SendMessage(const IPAddress & destAddr, uint16_t
         kMulticast_AllFabricAddrs,
     } sendAction;
     uint16_t udpSendFlags;
+#if INET_CONFIG_ENABLE_UDP_BATCH_IO
+    IPPacketInfo batchPktInfo[INET_CONFIG_UDP_BATCH_SIZE];
+    size_t batchCount = 0;
+#endif // INET_CONFIG_ENABLE_UDP_BATCH_IO
 
     IPPacketInfo pktInfo;
     pktInfo.Clear();
@@ -648,15 +653,28 @@ WEAVE_ERROR WeaveMessageLayer::SendMessage(const IPAddress & destAddr, uint16_t
             if (intfIter.SupportsMulticast())
             {
                 pktInfo.Interface = intfIter.GetInterface();
+#if INET_CONFIG_ENABLE_UDP_BATCH_IO
+                batchPktInfo[batchCount++] = pktInfo;
+                if (batchCount == INET_CONFIG_UDP_BATCH_SIZE)
+                {
+                    SendMulticastBatch(ep, batchPktInfo, batchCount, payload, err);
+                    batchCount = 0;
+                }
+#else // !INET_CONFIG_ENABLE_UDP_BATCH_IO
                 WEAVE_ERROR sendErr = ep->SendMsg(&pktInfo, payload, UDPEndPoint::kSendFlag_RetainBuffer);
                 CheckForceRefreshUDPEndPointsNeeded(sendErr);
                 if (err == WEAVE_NO_ERROR)
                 {
                     err = FilterUDPSendError(sendErr, true);
                 }
+#endif // !INET_CONFIG_ENABLE_UDP_BATCH_IO
             }
         }
 
+#if INET_CONFIG_ENABLE_UDP_BATCH_IO
+        SendMulticastBatch(ep, batchPktInfo, batchCount, payload, err);
+#endif // INET_CONFIG_ENABLE_UDP_BATCH_IO
+
         break;
 
     case kMulticast_AllFabricAddrs:
@@ -672,15 +690,28 @@ WEAVE_ERROR WeaveMessageLayer::SendMessage(const IPAddress & destAddr, uint16_t
                 FabricState->IsLocalFabricAddress(pktInfo.SrcAddress) &&
                 (sendIntfId == INET_NULL_INTERFACEID || pktInfo.Interface == sendIntfId))
             {
+#if INET_CONFIG_ENABLE_UDP_BATCH_IO
+                batchPktInfo[batchCount++] = pktInfo;
+                if (batchCount == INET_CONFIG_UDP_BATCH_SIZE)
+                {
+                    SendMulticastBatch(ep, batchPktInfo, batchCount, payload, err);
+                    batchCount = 0;
+                }
+#else // !INET_CONFIG_ENABLE_UDP_BATCH_IO
                 WEAVE_ERROR sendErr = ep->SendMsg(&pktInfo, payload, UDPEndPoint::kSendFlag_RetainBuffer);
                 CheckForceRefreshUDPEndPointsNeeded(sendErr);
                 if (err == WEAVE_NO_ERROR)
                 {
                     err = FilterUDPSendError(sendErr, true);
                 }
+#endif // !INET_CONFIG_ENABLE_UDP_BATCH_IO
             }
         }
 
+#if INET_CONFIG_ENABLE_UDP_BATCH_IO
+        SendMulticastBatch(ep, batchPktInfo, batchCount, payload, err);
+#endif // INET_CONFIG_ENABLE_UDP_BATCH_IO
+
         break;
     }
 
@@ -690,6 +721,32 @@ exit:
     return err;
 }
 
+#if INET_CONFIG_ENABLE_UDP_BATCH_IO
+/**
+ *  Send a multicast Weave message to each of the given destinations with a single batched endpoint send, updating
+ *  \c err, as the unbatched multicast send loop does, with the first send error that is not ignored for multicast.
+ */
+void WeaveMessageLayer::SendMulticastBatch(UDPEndPoint * ep, const IPPacketInfo * pktInfos, size_t count, PacketBuffer * payload,
+                                           WEAVE_ERROR & err)
+{
+    INET_ERROR sendErrs[INET_CONFIG_UDP_BATCH_SIZE];
+
+    if (count == 0)
+        return;
+
+    ep->SendMsgBatch(pktInfos, count, payload, sendErrs);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        CheckForceRefreshUDPEndPointsNeeded(sendErrs[i]);
+        if (err == WEAVE_NO_ERROR)
+        {
+            err = FilterUDPSendError(sendErrs[i], true);
+        }
+    }
+}
+#endif // INET_CONFIG_ENABLE_UDP_BATCH_IO
+
 /**
  *  Select an appropriate UDP endpoint for sending a Weave message.
  */
@@ -874,6 +931,19 @@ void WeaveMessageLayer::GetConnectionPoolStats(nl::Weave::System::Stats::count_t
     }
 }
 
+/**
+ *  Get the buffering and backpressure counters for the connections of this message layer.
+ *
+ *  @param[out] aOutStats   The counters: the bytes held for and queued by all connections, and the number
+ *                          of times a connection paused reading or sending on reaching its budget.
+ *
+ *  @sa #WEAVE_CONFIG_CONNECTION_RECEIVE_BUDGET, #WEAVE_CONFIG_CONNECTION_SEND_BUDGET
+ */
+void WeaveMessageLayer::GetConnectionBufferStats(ConnectionBufferStats &aOutStats) const
+{
+    aOutStats = mConBufferStats;
+}
+
 /**
  *  Create a new WeaveConnection object from a pool.
  *
@@ -1430,15 +1500,13 @@ WEAVE_ERROR WeaveMessageLayer::EncodeMessage(WeaveMessageInfo *msgInfo, PacketBu
         // so skip over the payload data.
         p += payloadLen;
 
-        // Compute the integrity check value and store it immediately after the payload data.
-        ComputeIntegrityCheck_AES128CTRSHA1(msgInfo, sessionState.MsgEncKey->EncKey.AES128CTRSHA1.IntegrityKey,
-                                            payloadStart, payloadLen, p);
+        // Compute the integrity check value, store it immediately after the payload data, and encrypt the
+        // payload and the integrity check value, in place, in the message buffer.
+        EncryptAndComputeIntegrityCheck_AES128CTRSHA1(msgInfo, sessionState.MsgEncKey->EncKey.AES128CTRSHA1.DataKey,
+                                                      sessionState.MsgEncKey->EncKey.AES128CTRSHA1.IntegrityKey,
+                                                      payloadStart, payloadLen);
         p += HMACSHA1::kDigestLength;
 
-        // Encrypt the message payload and the integrity check value that follows it, in place, in the message buffer.
-        Encrypt_AES128CTRSHA1(msgInfo, sessionState.MsgEncKey->EncKey.AES128CTRSHA1.DataKey,
-                              payloadStart, payloadLen + HMACSHA1::kDigestLength, payloadStart);
-
         break;
     }
 
@@ -1499,15 +1567,10 @@ WEAVE_ERROR WeaveMessageLayer::DecodeMessage(PacketBuffer *msgBuf, uint64_t sour
         *rPayload = p;
 
         // Decrypt the message payload and the integrity check value that follows it, in place, in the message buffer.
-        Encrypt_AES128CTRSHA1(msgInfo, sessionState.MsgEncKey->EncKey.AES128CTRSHA1.DataKey,
-                              p, payloadLen + HMACSHA1::kDigestLength, p);
-
-        // Compute the expected integrity check value from the decrypted payload.
-        uint8_t expectedIntegrityCheck[HMACSHA1::kDigestLength];
-        ComputeIntegrityCheck_AES128CTRSHA1(msgInfo, sessionState.MsgEncKey->EncKey.AES128CTRSHA1.IntegrityKey,
-                                            p, payloadLen, expectedIntegrityCheck);
-        // Error if the expected integrity check doesn't match the integrity check in the message.
-        if (!ConstantTimeCompare(p + payloadLen, expectedIntegrityCheck, HMACSHA1::kDigestLength))
+        // Error if the integrity check value computed from the decrypted payload doesn't match the one in the message.
+        if (!DecryptAndVerifyIntegrityCheck_AES128CTRSHA1(msgInfo, sessionState.MsgEncKey->EncKey.AES128CTRSHA1.DataKey,
+                                                          sessionState.MsgEncKey->EncKey.AES128CTRSHA1.IntegrityKey,
+                                                          p, payloadLen))
             return WEAVE_ERROR_INTEGRITY_CHECK_FAILED;
         // Skip past the payload and the integrity check value.
         p += payloadLen + HMACSHA1::kDigestLength;
@@ -2201,19 +2264,8 @@ exit:
     return err;
 }
 
-void WeaveMessageLayer::Encrypt_AES128CTRSHA1(const WeaveMessageInfo *msgInfo, const uint8_t *key,
-                                              const uint8_t *inData, uint16_t inLen, uint8_t *outBuf)
+static void BeginIntegrityCheck_AES128CTRSHA1(const WeaveMessageInfo *msgInfo, const uint8_t *key, HMACSHA1 &hmacSHA1)
 {
-    AES128CTRMode aes128CTR;
-    aes128CTR.SetKey(key);
-    aes128CTR.SetWeaveMessageCounter(msgInfo->SourceNodeId, msgInfo->MessageId);
-    aes128CTR.EncryptData(inData, inLen, outBuf);
-}
-
-void WeaveMessageLayer::ComputeIntegrityCheck_AES128CTRSHA1(const WeaveMessageInfo *msgInfo, const uint8_t *key,
-                                                            const uint8_t *inData, uint16_t inLen, uint8_t *outBuf)
-{
-    HMACSHA1 hmacSHA1;
     uint8_t encodedBuf[2 * sizeof(uint64_t) + sizeof(uint16_t) + sizeof(uint32_t)];
     uint8_t *p = encodedBuf;
 
@@ -2240,12 +2292,76 @@ void WeaveMessageLayer::ComputeIntegrityCheck_AES128CTRSHA1(const WeaveMessageIn
 
     // Hash encoded message header fields.
     hmacSHA1.AddData(encodedBuf, p - encodedBuf);
+}
+
+/**
+ *  Compute the integrity check value for a message payload, store it immediately after the payload,
+ *  and encrypt the payload and integrity check value in place.
+ *
+ *  The payload is hashed and encrypted in a single pass, so that each chunk of the payload is
+ *  brought into cache only once.
+ *
+ *  @param[in]    msgInfo       The message information, used to form the counter and the hashed header fields.
+ *  @param[in]    dataKey       The AES-128 data encryption key.
+ *  @param[in]    integrityKey  The HMAC-SHA1 integrity key.
+ *  @param[inout] payload       The payload, followed by room for the integrity check value.
+ *  @param[in]    payloadLen    The length of the payload.
+ */
+void WeaveMessageLayer::EncryptAndComputeIntegrityCheck_AES128CTRSHA1(const WeaveMessageInfo *msgInfo, const uint8_t *dataKey,
+                                                                      const uint8_t *integrityKey, uint8_t *payload,
+                                                                      uint16_t payloadLen)
+{
+    AES128CTRMode aes128CTR;
+    HMACSHA1 hmacSHA1;
+    uint8_t *integrityCheck = payload + payloadLen;
+
+    aes128CTR.SetKey(dataKey);
+    aes128CTR.SetWeaveMessageCounter(msgInfo->SourceNodeId, msgInfo->MessageId);
+
+    BeginIntegrityCheck_AES128CTRSHA1(msgInfo, integrityKey, hmacSHA1);
+
+    // Hash and encrypt the payload data.
+    aes128CTR.EncryptDataWithMAC(payload, payloadLen, payload, hmacSHA1);
+
+    // Generate the MAC and encrypt it using the continuation of the payload key stream.
+    hmacSHA1.Finish(integrityCheck);
+    aes128CTR.EncryptData(integrityCheck, HMACSHA1::kDigestLength, integrityCheck);
+}
+
+/**
+ *  Decrypt a message payload and the integrity check value that follows it in place, and verify
+ *  the integrity check value against the decrypted payload.
+ *
+ *  @param[in]    msgInfo       The message information, used to form the counter and the hashed header fields.
+ *  @param[in]    dataKey       The AES-128 data encryption key.
+ *  @param[in]    integrityKey  The HMAC-SHA1 integrity key.
+ *  @param[inout] payload       The encrypted payload, followed by the encrypted integrity check value.
+ *  @param[in]    payloadLen    The length of the payload.
+ *
+ *  @return true if the integrity check value matched, false otherwise.
+ */
+bool WeaveMessageLayer::DecryptAndVerifyIntegrityCheck_AES128CTRSHA1(const WeaveMessageInfo *msgInfo, const uint8_t *dataKey,
+                                                                     const uint8_t *integrityKey, uint8_t *payload,
+                                                                     uint16_t payloadLen)
+{
+    AES128CTRMode aes128CTR;
+    HMACSHA1 hmacSHA1;
+    uint8_t *integrityCheck = payload + payloadLen;
+    uint8_t expectedIntegrityCheck[HMACSHA1::kDigestLength];
+
+    aes128CTR.SetKey(dataKey);
+    aes128CTR.SetWeaveMessageCounter(msgInfo->SourceNodeId, msgInfo->MessageId);
+
+    BeginIntegrityCheck_AES128CTRSHA1(msgInfo, integrityKey, hmacSHA1);
+
+    // Decrypt and hash the payload data.
+    aes128CTR.DecryptDataWithMAC(payload, payloadLen, payload, hmacSHA1);
 
-    // Handle payload data.
-    hmacSHA1.AddData(inData, inLen);
+    // Decrypt the integrity check value in the message and compute the expected value.
+    aes128CTR.EncryptData(integrityCheck, HMACSHA1::kDigestLength, integrityCheck);
+    hmacSHA1.Finish(expectedIntegrityCheck);
 
-    // Generate the MAC.
-    hmacSHA1.Finish(outBuf);
+    return ConstantTimeCompare(integrityCheck, expectedIntegrityCheck, HMACSHA1::kDigestLength);
 }
 
 /**
@@ -307,6 +307,10 @@ public:
 
     TCPEndPoint * GetTCPEndPoint(void) const { return mTcpEndPoint; }
 
+    uint32_t PendingReceiveLength(void) const { return mRcvBuffered; }
+    uint32_t PendingSendLength(void) const { return mSendBuffered; }
+    bool IsSendPaused(void) const { return GetFlag(mFlags, kFlag_SendPaused); }
+
     /**
      *  This function is the application callback that is invoked when a connection setup is complete.
      *
@@ -371,6 +375,21 @@ public:
     typedef void (*ReceiveErrorFunct)(WeaveConnection *con, WEAVE_ERROR err);
     ReceiveErrorFunct OnReceiveError;
 
+    /**
+     *  This function is the application callback invoked when the connection stops or resumes accepting
+     *  messages for sending because its send queue, or the send queues of all connections, went over or
+     *  drained back under the configured send budget.
+     *
+     *  @param[in]     con            A pointer to the WeaveConnection object.
+     *
+     *  @param[in]     paused         True if SendMessage() now fails with WEAVE_ERROR_SENDING_BLOCKED,
+     *                                false if sending may resume.
+     *
+     *  @sa #WEAVE_CONFIG_CONNECTION_SEND_BUDGET, #WEAVE_CONFIG_TOTAL_CONNECTION_SEND_BUDGET
+     */
+    typedef void (*SendBackpressureFunct)(WeaveConnection *con, bool paused);
+    SendBackpressureFunct OnSendBackpressure;
+
     bool IsIncoming(void) const { return GetFlag(mFlags, kFlag_IsIncoming); }
     void SetIncoming(bool val)  { SetFlag(mFlags, kFlag_IsIncoming, val); }
 
@@ -386,6 +405,8 @@ private:
     HostPortList mPeerHostPortList;
     InterfaceId mTargetInterface;
     uint32_t mConnectTimeout;
+    uint32_t mRcvBuffered;                              /**< Received bytes held by the end point for this connection. */
+    uint32_t mSendBuffered;                             /**< Bytes queued in the end point for sending. */
     uint8_t mRefCount;
 #if WEAVE_CONFIG_ENABLE_DNS_RESOLVER
     uint8_t mDNSOptions;
@@ -394,6 +415,8 @@ private:
     enum FlagsEnum
     {
         kFlag_IsIncoming              = 0x01,           /**< The connection was initiated by external node. */
+        kFlag_ReceivePaused           = 0x02,           /**< Reading was paused because of the receive budget. */
+        kFlag_SendPaused              = 0x04,           /**< Sending was paused because of the send budget. */
     };
 
     uint8_t mFlags;                                     /**< Various flags associated with the connection. */
@@ -411,7 +434,12 @@ private:
 
     static void HandleResolveComplete(void *appState, INET_ERROR err, uint8_t addrCount, IPAddress *addrArray);
     static void HandleConnectComplete(TCPEndPoint *endPoint, INET_ERROR conRes);
+    void UpdateReceiveBacklog(void);
+    void UpdateSendBacklog(void);
+    void ClearBacklog(void);
+
     static void HandleDataReceived(TCPEndPoint *endPoint, PacketBuffer *data);
+    static void HandleDataSent(TCPEndPoint *endPoint, uint16_t len);
     static void HandleTcpConnectionClosed(TCPEndPoint *endPoint, INET_ERROR err);
     static void HandleSecureSessionEstablished(WeaveSecurityManager *sm, WeaveConnection *con, void *reqState, uint16_t sessionKeyId, uint64_t peerNodeId, uint8_t encType);
     static void HandleSecureSessionError(WeaveSecurityManager *sm, WeaveConnection *con, void *reqState, WEAVE_ERROR localErr, uint64_t peerNodeId,
@@ -590,6 +618,19 @@ public:
 
     void GetConnectionPoolStats(nl::Weave::System::Stats::count_t &aOutInUse) const;
 
+    /**
+     *  Buffering and backpressure counters for the connections of a message layer.
+     */
+    struct ConnectionBufferStats
+    {
+        uint32_t PendingReceiveLength;                  /**< Received bytes held for all connections. */
+        uint32_t PendingSendLength;                     /**< Bytes queued for sending by all connections. */
+        uint32_t ReceivePauseCount;                     /**< Times a connection paused reading. */
+        uint32_t SendPauseCount;                        /**< Times a connection paused sending. */
+    };
+
+    void GetConnectionBufferStats(ConnectionBufferStats &aOutStats) const;
+
     WEAVE_ERROR CreateTunnel(WeaveConnectionTunnel **tunPtr, WeaveConnection &conOne, WeaveConnection &conTwo,
             uint32_t inactivityTimeoutMS);
 
@@ -730,6 +771,7 @@ private:
     UDPEndPoint *mIPv6UDP;
     WeaveConnection mConPool[WEAVE_CONFIG_MAX_CONNECTIONS];
     WeaveConnectionTunnel mTunnelPool[WEAVE_CONFIG_MAX_TUNNELS];
+    ConnectionBufferStats mConBufferStats;
     uint8_t mFlags;
 
 #if WEAVE_CONFIG_ENABLE_TARGETED_LISTEN
@@ -782,16 +824,19 @@ private:
             WeaveMessageInfo *msgInfo, uint8_t **rPayload, uint16_t *rPayloadLen, uint32_t *rFrameLen);
     void GetIncomingTCPConCount(const IPAddress &peerAddr, uint16_t &count, uint16_t &countFromIP);
     void CheckForceRefreshUDPEndPointsNeeded(WEAVE_ERROR udpSendErr);
+#if INET_CONFIG_ENABLE_UDP_BATCH_IO
+    void SendMulticastBatch(UDPEndPoint *ep, const IPPacketInfo *pktInfos, size_t count, PacketBuffer *payload, WEAVE_ERROR &err);
+#endif // INET_CONFIG_ENABLE_UDP_BATCH_IO
 
     static void HandleUDPMessage(UDPEndPoint *endPoint, PacketBuffer *msg, const IPPacketInfo *pktInfo);
     static void HandleUDPReceiveError(UDPEndPoint *endPoint, INET_ERROR err, const IPPacketInfo *pktInfo);
     static void HandleIncomingTcpConnection(TCPEndPoint *listeningEndPoint, TCPEndPoint *conEndPoint, const IPAddress &peerAddr,
             uint16_t peerPort);
     static void HandleAcceptError(TCPEndPoint *endPoint, INET_ERROR err);
-    static void Encrypt_AES128CTRSHA1(const WeaveMessageInfo *msgInfo, const uint8_t *key,
-                                      const uint8_t *inData, uint16_t inLen, uint8_t *outBuf);
-    static void ComputeIntegrityCheck_AES128CTRSHA1(const WeaveMessageInfo *msgInfo, const uint8_t *key,
-                                                    const uint8_t *inData, uint16_t inLen, uint8_t *outBuf);
+    static void EncryptAndComputeIntegrityCheck_AES128CTRSHA1(const WeaveMessageInfo *msgInfo, const uint8_t *dataKey,
+                                                              const uint8_t *integrityKey, uint8_t *payload, uint16_t payloadLen);
+    static bool DecryptAndVerifyIntegrityCheck_AES128CTRSHA1(const WeaveMessageInfo *msgInfo, const uint8_t *dataKey,
+                                                             const uint8_t *integrityKey, uint8_t *payload, uint16_t payloadLen);
     static WEAVE_ERROR FilterUDPSendError(WEAVE_ERROR err, bool isMulticast);
     static bool IsIgnoredMulticastSendError(WEAVE_ERROR err);
 
@@ -113,6 +113,170 @@ namespace Weave {
 #define WEAVE_CONFIG_WRMP_DEFAULT_MAX_RETRANS               (3)
 #endif // WEAVE_CONFIG_WRMP_DEFAULT_MAX_RETRANS
 
+/**
+ *  @def WEAVE_CONFIG_WRMP_ADAPTIVE_RETRANS_TIMEOUT
+ *
+ *  @brief
+ *    If set to (1), WRMP measures the round trip time of the messages
+ *    acknowledged by each peer and, once a peer has been measured, derives
+ *    the retransmission timeout for it from the smoothed round trip time
+ *    and its variation rather than from the initial and active
+ *    retransmission timeouts of the exchange. Default value is (0) or
+ *    disabled.
+ *
+ */
+#ifndef WEAVE_CONFIG_WRMP_ADAPTIVE_RETRANS_TIMEOUT
+#define WEAVE_CONFIG_WRMP_ADAPTIVE_RETRANS_TIMEOUT          0
+#endif // WEAVE_CONFIG_WRMP_ADAPTIVE_RETRANS_TIMEOUT
+
+#if WEAVE_CONFIG_WRMP_ADAPTIVE_RETRANS_TIMEOUT && !WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
+#error "Please assert WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING when WEAVE_CONFIG_WRMP_ADAPTIVE_RETRANS_TIMEOUT is asserted"
+#endif
+
+/**
+ *  @def WEAVE_CONFIG_WRMP_MIN_ADAPTIVE_RETRANS_TIMEOUT
+ *
+ *  @brief
+ *    The lower bound, in milliseconds, of a retransmission timeout
+ *    derived from the measured round trip time.
+ *
+ */
+#ifndef WEAVE_CONFIG_WRMP_MIN_ADAPTIVE_RETRANS_TIMEOUT
+#define WEAVE_CONFIG_WRMP_MIN_ADAPTIVE_RETRANS_TIMEOUT      (2 * WEAVE_CONFIG_WRMP_TIMER_DEFAULT_PERIOD)
+#endif // WEAVE_CONFIG_WRMP_MIN_ADAPTIVE_RETRANS_TIMEOUT
+
+/**
+ *  @def WEAVE_CONFIG_WRMP_MAX_ADAPTIVE_RETRANS_TIMEOUT
+ *
+ *  @brief
+ *    The upper bound, in milliseconds, of a retransmission timeout
+ *    derived from the measured round trip time.
+ *
+ */
+#ifndef WEAVE_CONFIG_WRMP_MAX_ADAPTIVE_RETRANS_TIMEOUT
+#define WEAVE_CONFIG_WRMP_MAX_ADAPTIVE_RETRANS_TIMEOUT      (4 * WEAVE_CONFIG_WRMP_DEFAULT_INITIAL_RETRANS_TIMEOUT)
+#endif // WEAVE_CONFIG_WRMP_MAX_ADAPTIVE_RETRANS_TIMEOUT
+
+/**
+ *  @def WEAVE_CONFIG_WRMP_COALESCE_ACKS
+ *
+ *  @brief
+ *    If set to (1), an acknowledgment that has to be sent on its own also
+ *    carries the pending acknowledgments of the other exchanges with the
+ *    same peer and key, in a single Common:WRMP_Multi_Ack message, instead
+ *    of one Common:Null message per exchange. Multi-ack messages are always
+ *    accepted, but earlier releases do not understand them, so they are only
+ *    sent to peers known to accept them: those a multi-ack has been received
+ *    from, and those declared by the application with
+ *    WeaveExchangeManager::WRMPSetPeerAcceptsMultiAck(). Default value is
+ *    (0) or disabled.
+ *
+ */
+#ifndef WEAVE_CONFIG_WRMP_COALESCE_ACKS
+#define WEAVE_CONFIG_WRMP_COALESCE_ACKS                     0
+#endif // WEAVE_CONFIG_WRMP_COALESCE_ACKS
+
+#if WEAVE_CONFIG_WRMP_COALESCE_ACKS && !WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
+#error "Please assert WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING when WEAVE_CONFIG_WRMP_COALESCE_ACKS is asserted"
+#endif
+
+/**
+ *  @def WEAVE_CONFIG_WRMP_MAX_COALESCED_ACKS
+ *
+ *  @brief
+ *    The maximum number of other exchanges' acknowledgments carried by
+ *    one multi-ack message.
+ *
+ */
+#ifndef WEAVE_CONFIG_WRMP_MAX_COALESCED_ACKS
+#define WEAVE_CONFIG_WRMP_MAX_COALESCED_ACKS                16
+#endif // WEAVE_CONFIG_WRMP_MAX_COALESCED_ACKS
+
+/**
+ *  @def WEAVE_CONFIG_WRMP_MAX_MULTI_ACK_PEERS
+ *
+ *  @brief
+ *    The number of peers remembered as accepting multi-ack messages. When
+ *    the table is full, a newly learned peer replaces the one learned
+ *    longest ago.
+ *
+ */
+#ifndef WEAVE_CONFIG_WRMP_MAX_MULTI_ACK_PEERS
+#define WEAVE_CONFIG_WRMP_MAX_MULTI_ACK_PEERS               8
+#endif // WEAVE_CONFIG_WRMP_MAX_MULTI_ACK_PEERS
+
+#if WEAVE_CONFIG_WRMP_MAX_MULTI_ACK_PEERS < 1 || WEAVE_CONFIG_WRMP_MAX_MULTI_ACK_PEERS > 255
+#error "WEAVE_CONFIG_WRMP_MAX_MULTI_ACK_PEERS must be between 1 and 255."
+#endif
+
+/**
+ *  @def WEAVE_CONFIG_WRMP_ENABLE_SEND_WINDOW
+ *
+ *  @brief
+ *    If set to (1), an exchange may have several reliable messages awaiting
+ *    acknowledgment, up to the send window set in its WRMP configuration.
+ *    The number allowed in flight grows as acknowledgments arrive and
+ *    shrinks once per loss and on receipt of a Throttle Flow message. When
+ *    a message arrives while the acknowledgment of an earlier one is
+ *    pending, the acknowledgments are held together and sent in a
+ *    Common:WRMP_Multi_Ack message, if the peer is known to accept one (see
+ *    #WEAVE_CONFIG_WRMP_COALESCE_ACKS). Default value is (0) or disabled.
+ *
+ */
+#ifndef WEAVE_CONFIG_WRMP_ENABLE_SEND_WINDOW
+#define WEAVE_CONFIG_WRMP_ENABLE_SEND_WINDOW                0
+#endif // WEAVE_CONFIG_WRMP_ENABLE_SEND_WINDOW
+
+#if WEAVE_CONFIG_WRMP_ENABLE_SEND_WINDOW && !WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
+#error "Please assert WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING when WEAVE_CONFIG_WRMP_ENABLE_SEND_WINDOW is asserted"
+#endif
+
+/**
+ *  @def WEAVE_CONFIG_WRMP_DEFAULT_SEND_WINDOW
+ *
+ *  @brief
+ *    The default send window, in messages, of an exchange. (0) leaves the
+ *    number of messages in flight up to the application, as without
+ *    #WEAVE_CONFIG_WRMP_ENABLE_SEND_WINDOW.
+ *
+ */
+#ifndef WEAVE_CONFIG_WRMP_DEFAULT_SEND_WINDOW
+#define WEAVE_CONFIG_WRMP_DEFAULT_SEND_WINDOW               0
+#endif // WEAVE_CONFIG_WRMP_DEFAULT_SEND_WINDOW
+
+/**
+ *  @def WEAVE_CONFIG_WRMP_MAX_SEND_WINDOW
+ *
+ *  @brief
+ *    The largest send window, in messages, of an exchange. Larger
+ *    configured windows are reduced to this.
+ *
+ */
+#ifndef WEAVE_CONFIG_WRMP_MAX_SEND_WINDOW
+#define WEAVE_CONFIG_WRMP_MAX_SEND_WINDOW                   16
+#endif // WEAVE_CONFIG_WRMP_MAX_SEND_WINDOW
+
+#if WEAVE_CONFIG_WRMP_MAX_SEND_WINDOW < 1 || WEAVE_CONFIG_WRMP_MAX_SEND_WINDOW > 255
+#error "WEAVE_CONFIG_WRMP_MAX_SEND_WINDOW must be between 1 and 255."
+#endif
+
+/**
+ *  @def WEAVE_CONFIG_WRMP_MAX_PENDING_ACKS
+ *
+ *  @brief
+ *    The number of acknowledgments an exchange holds, when
+ *    #WEAVE_CONFIG_WRMP_ENABLE_SEND_WINDOW is enabled, before sending
+ *    them without waiting for the acknowledgment timeout.
+ *
+ */
+#ifndef WEAVE_CONFIG_WRMP_MAX_PENDING_ACKS
+#define WEAVE_CONFIG_WRMP_MAX_PENDING_ACKS                  4
+#endif // WEAVE_CONFIG_WRMP_MAX_PENDING_ACKS
+
+#if WEAVE_CONFIG_WRMP_MAX_PENDING_ACKS < 2 || WEAVE_CONFIG_WRMP_MAX_PENDING_ACKS > 255
+#error "WEAVE_CONFIG_WRMP_MAX_PENDING_ACKS must be between 2 and 255."
+#endif
+
 /**
  *  @brief
  *    The WRMP configuration.
@@ -123,12 +287,20 @@ struct WRMPConfig
     uint32_t mActiveRetransTimeout;             /**< Configurable timeout in msec for retransmission of all subsequent messages. */
     uint16_t mAckPiggybackTimeout;              /**< Configurable timeout in msec for transmission of a solitary Ack message. */
     uint8_t  mMaxRetrans;                       /**< Configurable max value for retransmissions in the ExchangeContext. */
+#if WEAVE_CONFIG_WRMP_ENABLE_SEND_WINDOW
+    uint8_t  mSendWindow;                       /**< Configurable max number of messages awaiting acknowledgment in the ExchangeContext;
+                                                     0 for no limit. */
+#endif
 };
 
 const WRMPConfig gDefaultWRMPConfig = { WEAVE_CONFIG_WRMP_DEFAULT_INITIAL_RETRANS_TIMEOUT,
                                         WEAVE_CONFIG_WRMP_DEFAULT_ACTIVE_RETRANS_TIMEOUT,
                                         WEAVE_CONFIG_WRMP_DEFAULT_ACK_TIMEOUT,
-                                        WEAVE_CONFIG_WRMP_DEFAULT_MAX_RETRANS };
+                                        WEAVE_CONFIG_WRMP_DEFAULT_MAX_RETRANS
+#if WEAVE_CONFIG_WRMP_ENABLE_SEND_WINDOW
+                                        , WEAVE_CONFIG_WRMP_DEFAULT_SEND_WINDOW
+#endif
+                                      };
 
 // clang-format on
 
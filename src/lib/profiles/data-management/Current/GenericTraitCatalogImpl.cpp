@@ -17,7 +17,7 @@
  */
 
 #if WEAVE_CONFIG_DATA_MANAGEMENT_CLIENT_EXPERIMENTAL
-#include <map>
+#include <vector>
 #include <limits>
 #include <Weave/Profiles/data-management/Current/WdmManagedNamespace.h>
 #include <Weave/Profiles/data-management/Current/GenericTraitCatalogImpl.h>
@@ -27,9 +27,10 @@
 #ifndef _WEAVE_DATA_MANAGEMENT_GENERIC_TRAIT_CATALOG_IMPL_CURRENT_H
 #define _WEAVE_DATA_MANAGEMENT_GENERIC_TRAIT_CATALOG_IMPL_CURRENT_H
 
-#include <map>
 #include <queue>
 #include <limits>
+#include <unordered_map>
+#include <vector>
 #include <Weave/Profiles/data-management/Current/WdmManagedNamespace.h>
 #include <Weave/Profiles/data-management/TraitCatalog.h>
 
@@ -41,7 +42,8 @@ namespace WeaveMakeManagedNamespaceIdentifier(DataManagement, kWeaveManagedNames
  *  @class GenericTraitCatalogImpl
  *
  *  @brief A Weave provided implementation of the TraitCatalogBase interface for a collection of trait data instances
- *         that all refer to the same resource. It provides a c++ map-backed storage for these instances.
+ *         that all refer to the same resource. It provides a c++ vector-backed storage for these instances, indexed by
+ *         handle, with hash indexes to locate an instance by path or by pointer.
  */
 template <typename T>
 class GenericTraitCatalogImpl : public TraitCatalogBase<T>
@@ -93,10 +95,31 @@ private:
         PropertyPathHandle mBasePathHandle;
     };
 
+    struct PathKey
+    {
+        uint32_t mProfileId;
+        uint64_t mInstanceId;
+        ResourceIdentifier mResourceId;
+
+        bool operator==(const PathKey & aOther) const
+        {
+            return mProfileId == aOther.mProfileId && mInstanceId == aOther.mInstanceId && mResourceId == aOther.mResourceId;
+        }
+    };
+
+    struct PathKeyHash
+    {
+        size_t operator()(const PathKey & aKey) const;
+    };
+
     TraitDataHandle GetNextHandle();
+    CatalogItem * GetItem(TraitDataHandle aHandle) const;
 
     uint64_t mNodeId;
-    std::map<TraitDataHandle, CatalogItem *> mItemStore;
+    uint32_t mNumItems;
+    std::vector<CatalogItem *> mItemStore; // indexed by handle, NULL for unused handles
+    std::unordered_map<PathKey, TraitDataHandle, PathKeyHash> mPathIndex;
+    std::unordered_multimap<const T *, TraitDataHandle> mInstanceIndex;
     std::queue<TraitDataHandle> mRecycledHandles;
 };
 
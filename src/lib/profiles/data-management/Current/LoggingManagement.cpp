@@ -123,6 +123,9 @@ WEAVE_ERROR LoggingManagement::EnsureSpace(size_t inRequiredSpace)
     CircularEventBuffer * eventBuffer = mEventBuffer;
     WeaveCircularTLVBuffer * circularBuffer;
     ReclaimEventCtx ctx;
+#if WEAVE_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
+    uint32_t destOffset;
+#endif
 
     // check whether we actually need to do anything, exit if we don't
     VerifyOrExit(requiredSpace > eventBuffer->mBuffer.AvailableDataLength(), err = WEAVE_NO_ERROR);
@@ -141,6 +144,9 @@ WEAVE_ERROR LoggingManagement::EnsureSpace(size_t inRequiredSpace)
             circularBuffer->mProcessEvictedElement = EvictEvent;
             circularBuffer->mAppData               = &ctx;
             err                                    = circularBuffer->EvictHead();
+#if WEAVE_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
+            eventBuffer->PruneIndexEntries();
+#endif
 
             // one of two things happened: either the element was evicted,
             // or we figured out how much space we need to evict it into
@@ -157,12 +163,23 @@ WEAVE_ERROR LoggingManagement::EnsureSpace(size_t inRequiredSpace)
                     // Since we're calling CopyElement and we've checked
                     // that there is space in the next buffer, we don't expect
                     // this to fail.
+#if WEAVE_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
+                    destOffset = eventBuffer->mNext->GetTailOffset();
+#endif
                     err = CopyToNextBuffer(eventBuffer);
                     SuccessOrExit(err);
 
+#if WEAVE_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
+                    // the event, and its index entry if it has one, now live in the next buffer
+                    eventBuffer->MoveHeadIndexEntry(eventBuffer->mNext, destOffset);
+#endif
+
                     // success; evict head unconditionally
                     circularBuffer->mProcessEvictedElement = NULL;
                     err                                    = circularBuffer->EvictHead();
+#if WEAVE_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
+                    eventBuffer->PruneIndexEntries();
+#endif
                     // if unconditional eviction failed, this
                     // means that we have no way of further
                     // clearing the buffer.  fail out and let the
@@ -1233,6 +1250,25 @@ exit:
     {
         event_id = GetImportanceBuffer(inSchema.mImportance)->VendEventID();
 
+#if WEAVE_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
+        if ((event_id % WEAVE_CONFIG_EVENT_LOGGING_INDEX_INTERVAL) == 0)
+        {
+            CircularEventBuffer::IndexEntry entry;
+
+            // The event was just appended to the tail of the first buffer, and its delta time is relative to the last
+            // timestamp of its importance buffer, which has not been updated yet.
+            entry.mOffset     = (mEventBuffer->GetTailOffset() + mEventBuffer->mBuffer.GetQueueSize() - writer.GetLengthWritten()) %
+                mEventBuffer->mBuffer.GetQueueSize();
+            entry.mEventID    = event_id;
+            entry.mImportance = inSchema.mImportance;
+            entry.mTimestamp  = GetImportanceBuffer(inSchema.mImportance)->mLastEventTimestamp;
+#if WEAVE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
+            entry.mUTCTimestamp = GetImportanceBuffer(inSchema.mImportance)->mLastEventUTCTimestamp;
+#endif // WEAVE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
+            mEventBuffer->AddIndexEntry(entry);
+        }
+#endif // WEAVE_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
+
 #if WEAVE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
         if (opts.timestampType == kTimestampType_UTC)
         {
@@ -1510,8 +1546,47 @@ WEAVE_ERROR LoggingManagement::FetchEventsSince(TLVWriter & ioWriter, Importance
     aContext.mCurrentUTCTime = buf->mFirstEventUTCTimestamp;
 #endif // WEAVE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
     aContext.mCurrentEventID = buf->mFirstEventID;
-    err                      = GetEventReader(reader, inImportance);
+
+#if WEAVE_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
+    {
+        const CircularEventBuffer::IndexEntry * entry = NULL;
+        CircularEventBuffer * entryBuf;
+
+        // Events of this importance are read starting at the buffer
+        // that is their final destination and continuing towards the
+        // first buffer, so the newest events are in the buffers
+        // nearest the first one.  Find the closest indexed event at
+        // or before the starting event, starting with the newest.
+        for (entryBuf = mEventBuffer; entryBuf != NULL; entryBuf = entryBuf->mNext)
+        {
+            entry = entryBuf->FindIndexEntry(inImportance, ioEventID);
+            if (entry != NULL || entryBuf == buf)
+                break;
+        }
+
+        if (entry != NULL && entry->mEventID >= buf->mFirstEventID)
+        {
+            CircularEventReader eventReader;
+
+            aContext.mCurrentTime = entry->mTimestamp;
+#if WEAVE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
+            aContext.mCurrentUTCTime = entry->mUTCTimestamp;
+#endif // WEAVE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
+            aContext.mCurrentEventID = entry->mEventID;
+
+            eventReader.Init(entryBuf, entry->mOffset);
+            reader.Init(eventReader);
+        }
+        else
+        {
+            err = GetEventReader(reader, inImportance);
+            SuccessOrExit(err);
+        }
+    }
+#else
+    err = GetEventReader(reader, inImportance);
     SuccessOrExit(err);
+#endif // WEAVE_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
 
     err = nl::Weave::TLV::Utilities::Iterate(reader, CopyEventsSince, &aContext, recurse);
 
@@ -2057,6 +2132,9 @@ CircularEventBuffer::CircularEventBuffer(uint8_t * inBuffer, size_t inBufferLeng
     mFirstEventUTCTimestamp(0), mLastEventUTCTimestamp(0), mUTCInitialized(false),
 #endif // WEAVE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
     mEventIdCounter(NULL)
+#if WEAVE_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
+    , mIndexHead(0), mIndexCount(0)
+#endif // WEAVE_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
 {
     // TODO: hook up the platform-specific persistent event ID.
 }
@@ -2120,6 +2198,102 @@ void CircularEventBuffer::RemoveEvent(size_t aNumEvents)
     mFirstEventID += aNumEvents;
 }
 
+#if WEAVE_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
+/**
+ * @brief
+ *   Add an entry to the sparse index of events stored in this buffer.
+ *
+ * Entries must be added in the order that the events are stored in
+ * the buffer.  When the index is full, the oldest entry is discarded.
+ *
+ * @param[in] inEntry  The entry to add.
+ */
+void CircularEventBuffer::AddIndexEntry(const IndexEntry & inEntry)
+{
+    if (mIndexCount == WEAVE_CONFIG_EVENT_LOGGING_INDEX_SIZE)
+    {
+        mIndexHead = (mIndexHead + 1) % WEAVE_CONFIG_EVENT_LOGGING_INDEX_SIZE;
+        mIndexCount--;
+    }
+
+    mIndex[(mIndexHead + mIndexCount) % WEAVE_CONFIG_EVENT_LOGGING_INDEX_SIZE] = inEntry;
+    mIndexCount++;
+}
+
+/**
+ * @brief
+ *   Move the index entry for the event at the head of this buffer, if
+ *   there is one, to another buffer the event has been copied to.
+ *
+ * @param[in] inDest        The buffer the head event was copied to.
+ *
+ * @param[in] inDestOffset  The offset of the copied event in \c inDest.
+ */
+void CircularEventBuffer::MoveHeadIndexEntry(CircularEventBuffer * inDest, uint32_t inDestOffset)
+{
+    IndexEntry entry;
+
+    VerifyOrExit(mIndexCount > 0 && mIndex[mIndexHead].mOffset == GetHeadOffset(), /* no-op */);
+
+    entry         = mIndex[mIndexHead];
+    entry.mOffset = inDestOffset;
+    inDest->AddIndexEntry(entry);
+
+    mIndexHead = (mIndexHead + 1) % WEAVE_CONFIG_EVENT_LOGGING_INDEX_SIZE;
+    mIndexCount--;
+
+exit:
+    return;
+}
+
+/**
+ * @brief
+ *   Discard the index entries of events that have been evicted from
+ *   the head of this buffer.
+ *
+ * Must be called after every eviction, before anything new is
+ * written to the buffer.
+ */
+void CircularEventBuffer::PruneIndexEntries(void)
+{
+    const uint32_t headOffset = GetHeadOffset();
+    const uint32_t queueSize  = static_cast<uint32_t>(mBuffer.GetQueueSize());
+
+    // Entries are kept in the order of the events in the buffer, so
+    // the evicted ones are at the front.
+    while (mIndexCount > 0 && (mIndex[mIndexHead].mOffset + queueSize - headOffset) % queueSize >= mBuffer.DataLength())
+    {
+        mIndexHead = (mIndexHead + 1) % WEAVE_CONFIG_EVENT_LOGGING_INDEX_SIZE;
+        mIndexCount--;
+    }
+}
+
+/**
+ * @brief
+ *   Find the newest index entry for an event of the given importance
+ *   whose ID is not greater than the given ID.
+ *
+ * @param[in] inImportance  The importance of the event.
+ *
+ * @param[in] inEventID     The event ID.
+ *
+ * @return A pointer to the index entry, or NULL if there is none.
+ */
+const CircularEventBuffer::IndexEntry * CircularEventBuffer::FindIndexEntry(ImportanceType inImportance,
+                                                                            event_id_t inEventID) const
+{
+    for (uint16_t i = mIndexCount; i > 0; i--)
+    {
+        const IndexEntry & entry = mIndex[(mIndexHead + i - 1) % WEAVE_CONFIG_EVENT_LOGGING_INDEX_SIZE];
+
+        if (entry.mImportance == inImportance && entry.mEventID <= inEventID)
+            return &entry;
+    }
+
+    return NULL;
+}
+#endif // WEAVE_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
+
 /**
  * @brief
  *   Initializes a TLVReader object backed by CircularEventBuffer
@@ -2146,6 +2320,46 @@ void CircularEventReader::Init(CircularEventBuffer * inBuf)
     }
 }
 
+#if WEAVE_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
+/**
+ * @brief
+ *   Initializes a TLVReader object backed by CircularEventBuffer,
+ *   positioned at an event within the buffer
+ *
+ * Reading begins at the event at \c inOffset in the
+ * CircularTLVBuffer belonging to this CircularEventBuffer, and
+ * continues as described above.
+ *
+ * @param[in] inBuf    A pointer to a fully initialized CircularEventBuffer
+ *
+ * @param[in] inOffset The position of an event stored in \c inBuf,
+ *                     as recorded in its index.
+ *
+ */
+void CircularEventReader::Init(CircularEventBuffer * inBuf, uint32_t inOffset)
+{
+    const uint32_t queueSize = static_cast<uint32_t>(inBuf->mBuffer.GetQueueSize());
+    const uint32_t skip      = (inOffset + queueSize - inBuf->GetHeadOffset()) % queueSize;
+    uint32_t firstLen;
+
+    Init(inBuf);
+
+    // The stored data may wrap around the end of the queue, in which
+    // case the reader starts out with the part up to the end.
+    firstLen = static_cast<uint32_t>(mBufEnd - mReadPoint);
+    if (skip < firstLen)
+    {
+        mReadPoint += skip;
+    }
+    else
+    {
+        mReadPoint = inBuf->mBuffer.GetQueue() + (skip - firstLen);
+        mBufEnd    = inBuf->mBuffer.QueueTail();
+    }
+    mMaxLen -= skip;
+}
+#endif // WEAVE_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
+
 WEAVE_ERROR CircularEventBuffer::GetNextBufferFunct(TLVReader & ioReader, uintptr_t & inBufHandle, const uint8_t *& outBufStart,
                                                     uint32_t & outBufLen)
 {
@@ -92,6 +92,51 @@ struct CircularEventBuffer
 
     static WEAVE_ERROR GetNextBufferFunct(nl::Weave::TLV::TLVReader & ioReader, uintptr_t & inBufHandle,
                                           const uint8_t *& outBufStart, uint32_t & outBufLen);
+
+#if WEAVE_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
+    /**
+     * @brief
+     *   An entry in the sparse index of events stored in a buffer.
+     *
+     * The entry captures the state of an event scan immediately before
+     * the indexed event, so that a scan may begin at that event.
+     */
+    struct IndexEntry
+    {
+        uint32_t mOffset;        ///< The offset of the event within the queue storage of the buffer
+        event_id_t mEventID;     ///< The ID of the event
+        timestamp_t mTimestamp;  ///< The system timestamp preceding the event, i.e., the one its delta time is relative to
+#if WEAVE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
+        utc_timestamp_t mUTCTimestamp; ///< The UTC timestamp preceding the event
+#endif
+        ImportanceType mImportance; ///< The importance of the event
+    };
+
+    /**
+     * @brief
+     *   The offset within the queue storage of the first stored event.
+     */
+    uint32_t GetHeadOffset(void) const
+    {
+        return static_cast<uint32_t>((mBuffer.QueueHead() - mBuffer.GetQueue()) % mBuffer.GetQueueSize());
+    };
+
+    /**
+     * @brief
+     *   The offset within the queue storage at which the next event will be stored.
+     */
+    uint32_t GetTailOffset(void) const { return static_cast<uint32_t>(mBuffer.QueueTail() - mBuffer.GetQueue()); };
+
+    // for doxygen, see the CPP file
+    void AddIndexEntry(const IndexEntry & inEntry);
+    void MoveHeadIndexEntry(CircularEventBuffer * inDest, uint32_t inDestOffset);
+    void PruneIndexEntries(void);
+    const IndexEntry * FindIndexEntry(ImportanceType inImportance, event_id_t inEventID) const;
+
+    IndexEntry mIndex[WEAVE_CONFIG_EVENT_LOGGING_INDEX_SIZE]; ///< Index entries, ordered by offset, stored circularly
+    uint16_t mIndexHead;  ///< The position in mIndex of the oldest entry
+    uint16_t mIndexCount; ///< The number of entries in mIndex
+#endif // WEAVE_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
 };
 
 /**
@@ -104,6 +149,9 @@ class CircularEventReader : public nl::Weave::TLV::TLVReader
 
 public:
     void Init(CircularEventBuffer * inBuf);
+#if WEAVE_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
+    void Init(CircularEventBuffer * inBuf, uint32_t inOffset);
+#endif
 };
 
 /**
@@ -78,6 +78,29 @@ WEAVE_ERROR NotificationEngine::BasicGraphSolver::SetDirty(TraitDataHandle aData
 {
     SubscriptionEngine * subEngine = SubscriptionEngine::GetInstance();
 
+#if WDM_PUBLISHER_ENABLE_DIRTY_INDEX
+    // Only visit the trait instances subscribed to this data handle
+    uint16_t poolIdx = subEngine->TraitInfoIndexBucket(aDataHandle);
+
+    while (poolIdx != SubscriptionEngine::kTraitInfoIndexNone)
+    {
+        SubscriptionHandler::TraitInstanceInfo * traitInstance = subEngine->mTraitInfoPool + poolIdx;
+
+        if (traitInstance->mTraitDataHandle == aDataHandle)
+        {
+            SubscriptionHandler * subHandler = &subEngine->mHandlers[traitInstance->mHandlerId];
+
+            if (subHandler->IsActive())
+            {
+                WeaveLogDetail(DataManagement, "<BSolver:SetD> Set S%u:T%u dirty", traitInstance->mHandlerId,
+                               static_cast<unsigned int>(traitInstance - subHandler->GetTraitInstanceInfoList()));
+                subHandler->SetTraitInstanceDirty(traitInstance);
+            }
+        }
+
+        poolIdx = traitInstance->mNextWithHandle;
+    }
+#else
     // Iterate over all subscriptions and their trait instance info lists and mark them dirty as appropriate
     for (int i = 0; i < SubscriptionEngine::kMaxNumSubscriptionHandlers; ++i)
     {
@@ -92,11 +115,12 @@ WEAVE_ERROR NotificationEngine::BasicGraphSolver::SetDirty(TraitDataHandle aData
                 if (traitInstance[j].mTraitDataHandle == aDataHandle)
                 {
                     WeaveLogDetail(DataManagement, "<BSolver:SetD> Set S%u:T%u dirty", i, j);
-                    traitInstance[j].SetDirty();
+                    subHandler->SetTraitInstanceDirty(&traitInstance[j]);
                 }
             }
         }
     }
+#endif // WDM_PUBLISHER_ENABLE_DIRTY_INDEX
 
     return WEAVE_NO_ERROR;
 }
@@ -1106,7 +1130,7 @@ WEAVE_ERROR NotificationEngine::RetrieveTraitInstanceData(SubscriptionHandler *
     SuccessOrExit(err);
 
     // Clear out the dirty bit since we're done processing this trait instance.
-    aTraitInfo->ClearDirty();
+    aSubHandler->ClearTraitInstanceDirty(aTraitInfo);
 
 exit:
     if ((err == WEAVE_ERROR_BUFFER_TOO_SMALL) || (err == WEAVE_ERROR_NO_MEMORY))
@@ -1406,6 +1430,15 @@ WEAVE_ERROR NotificationEngine::BuildSingleNotifyRequestDataList(SubscriptionHan
     SubscriptionHandler::TraitInstanceInfo * traitInfo =
         aSubHandler->GetTraitInstanceInfoList() + aSubHandler->mCurProcessingTraitInstanceIdx;
 
+#if WDM_PUBLISHER_ENABLE_DIRTY_INDEX
+    // Nothing to walk if none of this subscription's trait instances are dirty
+    if (!aSubHandler->HasDirtyTraitInstances())
+    {
+        aSubHandler->mCurProcessingTraitInstanceIdx = 0;
+        ExitNow();
+    }
+#endif
+
     while (aSubHandler->mCurProcessingTraitInstanceIdx < aSubHandler->GetNumTraitInstances())
     {
         if (traitInfo->IsDirty())
@@ -1436,7 +1469,7 @@ WEAVE_ERROR NotificationEngine::BuildSingleNotifyRequestDataList(SubscriptionHan
                 if (!aNeWriteInProgress)
                 {
                     WeaveLogDetail(DataManagement, "<NE:Run> trait property is too big so that it fails to fit in the packet");
-                    traitInfo->ClearDirty();
+                    aSubHandler->ClearTraitInstanceDirty(traitInfo);
                 }
                 else
                 {
@@ -1779,6 +1812,21 @@ void NotificationEngine::Run()
     subHandler = subEngine->mHandlers;
     isClean    = true;
 
+#if WDM_PUBLISHER_ENABLE_DIRTY_INDEX
+    // We only wipe our granular dirty stores if all the subscriptions are clean. Each subscription
+    // keeps a count of its dirty trait instances, so there is no need to visit the instances.
+    for (int i = 0; i < SubscriptionEngine::kMaxNumSubscriptionHandlers; i++)
+    {
+        if (subHandler->IsActive() && subHandler->HasDirtyTraitInstances())
+        {
+            WeaveLogDetail(DataManagement, "<NE:Run> S%u: %u trait instances still dirty", i, subHandler->mNumDirtyTraitInstances);
+            isClean = false;
+            break;
+        }
+
+        subHandler++;
+    }
+#else
     // We only wipe our granular dirty stores if all the subscriptions are clean. To do so, we iterate over
     // all of them and check each of their dirty flags.
     for (int i = 0; i < SubscriptionEngine::kMaxNumSubscriptionHandlers; i++)
@@ -1801,6 +1849,7 @@ void NotificationEngine::Run()
 
         subHandler++;
     }
+#endif // WDM_PUBLISHER_ENABLE_DIRTY_INDEX
 
     if (isClean)
     {
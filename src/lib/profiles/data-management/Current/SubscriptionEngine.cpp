@@ -105,6 +105,10 @@ WEAVE_ERROR SubscriptionEngine::Init(nl::Weave::WeaveExchangeManager * const apE
 
     mNumTraitInfosInPool = 0;
 
+#if WDM_ENABLE_SUBSCRIPTION_PUBLISHER && WDM_PUBLISHER_ENABLE_DIRTY_INDEX
+    RebuildTraitInfoIndex();
+#endif
+
 exit:
     WeaveLogFunctError(err);
 
@@ -949,6 +953,10 @@ void SubscriptionEngine::ReclaimTraitInfo(SubscriptionHandler * const aHandlerTo
     aHandlerToBeReclaimed->mTraitInstanceList = NULL;
     aHandlerToBeReclaimed->mNumTraitInstances = 0;
 
+#if WDM_PUBLISHER_ENABLE_DIRTY_INDEX
+    aHandlerToBeReclaimed->mNumDirtyTraitInstances = 0;
+#endif
+
     if (!numTraitInstances)
     {
         WeaveLogDetail(DataManagement, "No trait instances allocated for this subscription");
@@ -991,9 +999,38 @@ void SubscriptionEngine::ReclaimTraitInfo(SubscriptionHandler * const aHandlerTo
     }
 
 exit:
+#if WDM_PUBLISHER_ENABLE_DIRTY_INDEX
+    // Pool indices of the remaining trait instances may have changed
+    RebuildTraitInfoIndex();
+#endif
+
     WeaveLogDetail(DataManagement, "Number of allocated trait instances: %u", mNumTraitInfosInPool);
 }
 
+#if WDM_PUBLISHER_ENABLE_DIRTY_INDEX
+void SubscriptionEngine::IndexTraitInfo(SubscriptionHandler::TraitInstanceInfo * const aTraitInstance)
+{
+    uint16_t & bucket = TraitInfoIndexBucket(aTraitInstance->mTraitDataHandle);
+
+    aTraitInstance->mNextWithHandle = bucket;
+    bucket                          = static_cast<uint16_t>(aTraitInstance - mTraitInfoPool);
+}
+
+void SubscriptionEngine::RebuildTraitInfoIndex(void)
+{
+    for (size_t i = 0; i < WDM_PUBLISHER_DIRTY_INDEX_BUCKETS; ++i)
+    {
+        mTraitInfoIndex[i] = kTraitInfoIndexNone;
+    }
+
+    // Walk the pool backwards so that each chain stays in pool order
+    for (size_t i = mNumTraitInfosInPool; i > 0; --i)
+    {
+        IndexTraitInfo(mTraitInfoPool + i - 1);
+    }
+}
+#endif // WDM_PUBLISHER_ENABLE_DIRTY_INDEX
+
 WEAVE_ERROR SubscriptionEngine::EnablePublisher(IWeavePublisherLock * aLock,
                                                 TraitCatalogBase<TraitDataSource> * const aPublisherCatalog)
 {
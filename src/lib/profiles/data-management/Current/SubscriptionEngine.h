@@ -514,12 +514,33 @@ private:
     uint16_t mNumTraitInfosInPool;
     SubscriptionHandler::TraitInstanceInfo mTraitInfoPool[kMaxNumPathGroups];
 
+#if WDM_PUBLISHER_ENABLE_DIRTY_INDEX
+    // Index from trait data handle to the trait instances in mTraitInfoPool subscribed to it.
+    // Each bucket holds the pool index of the first trait instance in a chain linked through
+    // TraitInstanceInfo::mNextWithHandle, or kTraitInfoIndexNone.
+    enum
+    {
+        kTraitInfoIndexNone = 0xFFFF,
+    };
+
+    uint16_t mTraitInfoIndex[WDM_PUBLISHER_DIRTY_INDEX_BUCKETS];
+#endif // WDM_PUBLISHER_ENABLE_DIRTY_INDEX
+
     uint16_t mNumOfPropertyPathHandlesAllocated;
     // PropertyPathHandle mPropertyPathHandlePool[kMaxNumPropertyPathHandles];
     // ******************* end protected by lock   **************************
 
     void ReclaimTraitInfo(SubscriptionHandler * const aHandlerToBeReclaimed);
 
+#if WDM_PUBLISHER_ENABLE_DIRTY_INDEX
+    void IndexTraitInfo(SubscriptionHandler::TraitInstanceInfo * const aTraitInstance);
+    void RebuildTraitInfoIndex(void);
+    uint16_t & TraitInfoIndexBucket(const TraitDataHandle aDataHandle)
+    {
+        return mTraitInfoIndex[aDataHandle & (WDM_PUBLISHER_DIRTY_INDEX_BUCKETS - 1)];
+    }
+#endif // WDM_PUBLISHER_ENABLE_DIRTY_INDEX
+
     static void OnSubscribeRequest(nl::Weave::ExchangeContext * aEC, const nl::Inet::IPPacketInfo * aPktInfo,
                                    const nl::Weave::WeaveMessageInfo * aMsgInfo, uint32_t aProfileId, uint8_t aMsgType,
                                    PacketBuffer * aPayload);
@@ -67,6 +67,9 @@ void SubscriptionHandler::InitAsFree()
     mIsInitiator                   = false;
     mTraitInstanceList             = NULL;
     mNumTraitInstances             = 0;
+#if WDM_PUBLISHER_ENABLE_DIRTY_INDEX
+    mNumDirtyTraitInstances        = 0;
+#endif
     mMaxNotificationSize           = 0;
     mSubscribeToAllEvents          = false;
     mCurProcessingTraitInstanceIdx = 0;
@@ -365,6 +368,11 @@ WEAVE_ERROR SubscriptionHandler::ParsePathVersionEventLists(SubscribeRequest::Pa
                 SYSTEM_STATS_INCREMENT(nl::Weave::System::Stats::kWDM_NumTraits);
 
                 traitInstance->Init();
+#if WDM_PUBLISHER_ENABLE_DIRTY_INDEX
+                traitInstance->mHandlerId       = SubscriptionEngine::GetInstance()->GetHandlerId(this);
+                traitInstance->mTraitDataHandle = traitDataHandle;
+                SubscriptionEngine::GetInstance()->IndexTraitInfo(traitInstance);
+#endif
             }
             else
             {
@@ -392,7 +400,7 @@ WEAVE_ERROR SubscriptionHandler::ParsePathVersionEventLists(SubscribeRequest::Pa
             WeaveLogDetail(DataManagement, "Handler[%u] Syncing is requested for trait[%u].path[%u]",
                            SubscriptionEngine::GetInstance()->GetHandlerId(this), traitDataHandle, propertyPathHandle);
 
-            traitInstance->SetDirty();
+            SetTraitInstanceDirty(traitInstance);
         }
         else
         {
@@ -403,7 +411,7 @@ WEAVE_ERROR SubscriptionHandler::ParsePathVersionEventLists(SubscribeRequest::Pa
                 WeaveLogDetail(DataManagement, "Handler[%u] Syncing is requested for trait[%u].path[%u]",
                                SubscriptionEngine::GetInstance()->GetHandlerId(this), traitDataHandle, propertyPathHandle);
 
-                traitInstance->SetDirty();
+                SetTraitInstanceDirty(traitInstance);
             }
             else
             {
@@ -418,7 +426,7 @@ WEAVE_ERROR SubscriptionHandler::ParsePathVersionEventLists(SubscribeRequest::Pa
                                    SubscriptionEngine::GetInstance()->GetHandlerId(this), traitDataHandle, propertyPathHandle);
 
                     WeaveLogIfFalse(existingVersion < datasourceVersion);
-                    traitInstance->SetDirty();
+                    SetTraitInstanceDirty(traitInstance);
                 }
                 else
                 {
@@ -1745,6 +1753,30 @@ exit:
     pHandler->_Release();
 }
 
+void SubscriptionHandler::SetTraitInstanceDirty(TraitInstanceInfo * aTraitInstance)
+{
+#if WDM_PUBLISHER_ENABLE_DIRTY_INDEX
+    if (!aTraitInstance->IsDirty())
+    {
+        ++mNumDirtyTraitInstances;
+    }
+#endif
+
+    aTraitInstance->SetDirty();
+}
+
+void SubscriptionHandler::ClearTraitInstanceDirty(TraitInstanceInfo * aTraitInstance)
+{
+#if WDM_PUBLISHER_ENABLE_DIRTY_INDEX
+    if (aTraitInstance->IsDirty())
+    {
+        --mNumDirtyTraitInstances;
+    }
+#endif
+
+    aTraitInstance->ClearDirty();
+}
+
 void SubscriptionHandler::SetMaxNotificationSize(const uint32_t aMaxSize)
 {
     if (aMaxSize > UINT16_MAX)
@@ -63,6 +63,10 @@ public:
         TraitDataHandle mTraitDataHandle;
         uint16_t mRequestedVersion;
         bool mDirty;
+#if WDM_PUBLISHER_ENABLE_DIRTY_INDEX
+        uint16_t mHandlerId;       ///< Id of the subscription handler this trait instance belongs to
+        uint16_t mNextWithHandle;  ///< Pool index of the next trait instance in the same dirty index bucket
+#endif
     };
 
     enum EventID
@@ -253,6 +257,16 @@ private:
     TraitInstanceInfo * GetTraitInstanceInfoList(void) { return mTraitInstanceList; }
     uint32_t GetNumTraitInstances(void) { return mNumTraitInstances; }
 
+    void SetTraitInstanceDirty(TraitInstanceInfo * aTraitInstance);
+    void ClearTraitInstanceDirty(TraitInstanceInfo * aTraitInstance);
+
+#if WDM_PUBLISHER_ENABLE_DIRTY_INDEX
+    // Number of trait instances in mTraitInstanceList that are dirty
+    uint16_t mNumDirtyTraitInstances;
+
+    bool HasDirtyTraitInstances(void) const { return (mNumDirtyTraitInstances != 0); }
+#endif
+
     void OnNotifyProcessingComplete(const bool aPossibleLossOfEvent, const LastVendedEvent aLastVendedEventList[],
                                     const size_t aLastVendedEventListSize);
 
@@ -735,6 +735,49 @@ PropertyPathHandle TraitSchemaEngine::GetChildHandle(PropertyPathHandle aParentH
 
 PropertyPathHandle TraitSchemaEngine::_GetChildHandle(PropertyPathHandle aParentHandle, uint8_t aContextTag) const
 {
+#if (TDM_SCHEMA_CHILD_INDEX_SUPPORT)
+    const PropertySchemaHandle * childIndex = GetChildIndex();
+
+    if (childIndex != NULL)
+    {
+        const uint32_t numHandles               = mSchema.mNumSchemaHandleEntries + kHandleTableOffset;
+        const PropertySchemaHandle * children   = childIndex + numHandles + 1;
+        PropertySchemaHandle parentSchemaHandle = GetPropertySchemaHandle(aParentHandle);
+        uint32_t low, high;
+
+        if (parentSchemaHandle >= numHandles)
+        {
+            return kNullPropertyPathHandle;
+        }
+
+        // The children of each handle are sorted by context tag; find the first one with a tag no lower than aContextTag.
+        low  = childIndex[parentSchemaHandle];
+        high = childIndex[parentSchemaHandle + 1];
+
+        while (low < high)
+        {
+            uint32_t mid = (low + high) / 2;
+
+            if (mSchema.mSchemaHandleTbl[children[mid] - kHandleTableOffset].mContextTag < aContextTag)
+            {
+                low = mid + 1;
+            }
+            else
+            {
+                high = mid;
+            }
+        }
+
+        if (low < childIndex[parentSchemaHandle + 1] &&
+            mSchema.mSchemaHandleTbl[children[low] - kHandleTableOffset].mContextTag == aContextTag)
+        {
+            return CreatePropertyPathHandle(children[low], GetPropertyDictionaryKey(aParentHandle));
+        }
+
+        return kNullPropertyPathHandle;
+    }
+#endif // TDM_SCHEMA_CHILD_INDEX_SUPPORT
+
     for (PropertyPathHandle childProperty = GetFirstChild(aParentHandle); !IsNullPropertyPathHandle(childProperty);
          childProperty                    = GetNextChild(aParentHandle, childProperty))
     {
@@ -747,6 +790,103 @@ PropertyPathHandle TraitSchemaEngine::_GetChildHandle(PropertyPathHandle aParent
     return kNullPropertyPathHandle;
 }
 
+#if (TDM_SCHEMA_CHILD_INDEX_SUPPORT)
+const PropertySchemaHandle * TraitSchemaEngine::GetChildIndex(void) const
+{
+    const uint32_t numHandles = mSchema.mNumSchemaHandleEntries + kHandleTableOffset;
+
+    if (mSchema.mChildIndex == NULL || mSchema.mNumSchemaHandleEntries == 0)
+    {
+        return NULL;
+    }
+
+    // The end marker, the total number of children, is written last and is zero until the index is built.
+    if (mSchema.mChildIndex[numHandles] == 0)
+    {
+        BuildChildIndex();
+    }
+
+    return mSchema.mChildIndex;
+}
+
+void TraitSchemaEngine::BuildChildIndex(void) const
+{
+    const uint32_t numHandles       = mSchema.mNumSchemaHandleEntries + kHandleTableOffset;
+    PropertySchemaHandle * offsets  = mSchema.mChildIndex;
+    PropertySchemaHandle * children = mSchema.mChildIndex + numHandles + 1;
+    uint32_t i, sum;
+
+    VerifyOrExit(mSchema.mChildIndex != NULL, /* no-op */);
+
+    memset(offsets, 0, (numHandles + 1) * sizeof(PropertySchemaHandle));
+
+    // Count the children of each handle, then turn the counts into start offsets.
+    for (i = 0; i < mSchema.mNumSchemaHandleEntries; i++)
+    {
+        PropertySchemaHandle parentHandle = mSchema.mSchemaHandleTbl[i].mParentHandle;
+
+        if (parentHandle < numHandles)
+        {
+            offsets[parentHandle]++;
+        }
+    }
+
+    for (i = 0, sum = 0; i < numHandles; i++)
+    {
+        PropertySchemaHandle count = offsets[i];
+
+        offsets[i] = sum;
+        sum += count;
+    }
+
+    // Place the children in handle order. This leaves offsets[i] holding the end of the children of handle i.
+    for (i = 0; i < mSchema.mNumSchemaHandleEntries; i++)
+    {
+        PropertySchemaHandle parentHandle = mSchema.mSchemaHandleTbl[i].mParentHandle;
+
+        if (parentHandle < numHandles)
+        {
+            children[offsets[parentHandle]++] = static_cast<PropertySchemaHandle>(i + kHandleTableOffset);
+        }
+    }
+
+    // Shift the end offsets back into start offsets.
+    for (i = numHandles - 1; i > 0; i--)
+    {
+        offsets[i] = offsets[i - 1];
+    }
+
+    offsets[0] = 0;
+
+    // Sort the children of each handle by context tag, keeping handle order among equal tags.
+    for (i = 0; i < numHandles; i++)
+    {
+        uint32_t end = (i + 1 < numHandles) ? offsets[i + 1] : sum;
+
+        for (uint32_t j = offsets[i] + 1; j < end; j++)
+        {
+            PropertySchemaHandle child = children[j];
+            uint8_t contextTag         = mSchema.mSchemaHandleTbl[child - kHandleTableOffset].mContextTag;
+            uint32_t pos               = j;
+
+            while (pos > offsets[i] && mSchema.mSchemaHandleTbl[children[pos - 1] - kHandleTableOffset].mContextTag > contextTag)
+            {
+                children[pos] = children[pos - 1];
+                pos--;
+            }
+
+            children[pos] = child;
+        }
+    }
+
+    // Writing the end marker last marks the index as built.
+    offsets[numHandles] = static_cast<PropertySchemaHandle>(sum);
+
+exit:
+    return;
+}
+#endif // TDM_SCHEMA_CHILD_INDEX_SUPPORT
+
 PropertyPathHandle TraitSchemaEngine::GetDictionaryItemHandle(PropertyPathHandle aParentHandle, uint16_t aDictionaryKey) const
 {
     if (!IsDictionary(aParentHandle))
@@ -769,6 +909,20 @@ bool TraitSchemaEngine::IsLeaf(PropertyPathHandle aHandle) const
     }
     else
     {
+#if (TDM_SCHEMA_CHILD_INDEX_SUPPORT)
+        const PropertySchemaHandle * childIndex = GetChildIndex();
+
+        if (childIndex != NULL)
+        {
+            if (schemaHandle >= mSchema.mNumSchemaHandleEntries + kHandleTableOffset)
+            {
+                return true;
+            }
+
+            return (childIndex[schemaHandle] == childIndex[schemaHandle + 1]);
+        }
+#endif // TDM_SCHEMA_CHILD_INDEX_SUPPORT
+
         for (unsigned int i = 0; i < mSchema.mNumSchemaHandleEntries; i++)
         {
             if (mSchema.mSchemaHandleTbl[i].mParentHandle == schemaHandle)
@@ -79,6 +79,14 @@ enum
     kRootPropertyPathHandle = 1
 };
 
+#if (TDM_SCHEMA_CHILD_INDEX_SUPPORT)
+/* Number of PropertySchemaHandle elements of storage needed for the child index of a schema with aNumSchemaHandleEntries
+ * entries: one start offset per schema handle (including the null and root handles) plus an end marker, followed by the
+ * children of every handle.
+ */
+#define TDM_SCHEMA_CHILD_INDEX_SIZE(aNumSchemaHandleEntries) ((2 * (aNumSchemaHandleEntries)) + 3)
+#endif
+
 inline PropertyPathHandle CreatePropertyPathHandle(PropertySchemaHandle aPropertyPathSchemaId,
                                                    PropertyDictionaryKey aPropertyPathDictionaryKey = 0)
 {
@@ -198,6 +206,10 @@ public:
 #endif
 #if (TDM_VERSIONING_SUPPORT)
         const ConstSchemaVersionRange * mVersionRange; ///< Range of versions supported by this trait
+#endif
+#if (TDM_SCHEMA_CHILD_INDEX_SUPPORT)
+        PropertySchemaHandle * mChildIndex; ///< Optional storage of TDM_SCHEMA_CHILD_INDEX_SIZE(mNumSchemaHandleEntries)
+                                            ///< handles for the child index, built on first use. NULL if not indexed.
 #endif
     };
 
@@ -396,6 +408,14 @@ public:
      */
     PropertyPathHandle GetChildHandle(PropertyPathHandle aParentHandle, uint8_t aContextTag) const;
 
+#if (TDM_SCHEMA_CHILD_INDEX_SUPPORT)
+    /**
+     * Builds the child index in the storage supplied by the schema, if any. This happens on first use otherwise;
+     * schemas shared between threads should call this during initialization.
+     */
+    void BuildChildIndex(void) const;
+#endif
+
     /* Returns the property path handle of the dictionary item given its parent dictionary handle and an item
      * key.
      */
@@ -537,6 +557,9 @@ public:
 
 private:
     PropertyPathHandle _GetChildHandle(PropertyPathHandle aParentHandle, uint8_t aContextTag) const;
+#if (TDM_SCHEMA_CHILD_INDEX_SUPPORT)
+    const PropertySchemaHandle * GetChildIndex(void) const;
+#endif
     bool GetBitFromPathHandleBitfield(uint8_t * aBitfield, PropertyPathHandle aPathHandle) const;
 
     /*
@@ -40,6 +40,52 @@ namespace Security {
 
 using namespace nl::Weave::Crypto;
 
+// Encrypt multiple independent blocks using an expanded key. The aesenc instruction has a latency
+// of several cycles but can issue every cycle, so running four blocks through the rounds together
+// keeps the AES unit busy rather than waiting on the result of each round in turn.
+static void EncryptBlocksInterleaved(const __m128i *keys, int roundCount, const uint8_t *inBlocks, uint8_t *outBlocks,
+        uint16_t numBlocks)
+{
+    __m128i block0, block1, block2, block3;
+
+    for (; numBlocks >= 4; numBlocks -= 4, inBlocks += 64, outBlocks += 64)
+    {
+        block0 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(inBlocks)), keys[0]);
+        block1 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(inBlocks + 16)), keys[0]);
+        block2 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(inBlocks + 32)), keys[0]);
+        block3 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(inBlocks + 48)), keys[0]);
+        for (int round = 1; round < roundCount; round++)
+        {
+            block0 = _mm_aesenc_si128(block0, keys[round]);
+            block1 = _mm_aesenc_si128(block1, keys[round]);
+            block2 = _mm_aesenc_si128(block2, keys[round]);
+            block3 = _mm_aesenc_si128(block3, keys[round]);
+        }
+        block0 = _mm_aesenclast_si128(block0, keys[roundCount]);
+        block1 = _mm_aesenclast_si128(block1, keys[roundCount]);
+        block2 = _mm_aesenclast_si128(block2, keys[roundCount]);
+        block3 = _mm_aesenclast_si128(block3, keys[roundCount]);
+        _mm_storeu_si128((__m128i *)(outBlocks), block0);
+        _mm_storeu_si128((__m128i *)(outBlocks + 16), block1);
+        _mm_storeu_si128((__m128i *)(outBlocks + 32), block2);
+        _mm_storeu_si128((__m128i *)(outBlocks + 48), block3);
+    }
+
+    for (; numBlocks > 0; numBlocks--, inBlocks += 16, outBlocks += 16)
+    {
+        block0 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)inBlocks), keys[0]);
+        for (int round = 1; round < roundCount; round++)
+            block0 = _mm_aesenc_si128(block0, keys[round]);
+        block0 = _mm_aesenclast_si128(block0, keys[roundCount]);
+        _mm_storeu_si128((__m128i *)outBlocks, block0);
+    }
+
+    ClearSecretData((uint8_t *)&block0, sizeof(block0));
+    ClearSecretData((uint8_t *)&block1, sizeof(block1));
+    ClearSecretData((uint8_t *)&block2, sizeof(block2));
+    ClearSecretData((uint8_t *)&block3, sizeof(block3));
+}
+
 AES128BlockCipher::AES128BlockCipher()
 {
     memset(&mKey, 0, sizeof(mKey));
@@ -108,6 +154,11 @@ void AES128BlockCipherEnc::EncryptBlock(const uint8_t *inBlock, uint8_t *outBloc
     ClearSecretData((uint8_t *)&block, sizeof(block));
 }
 
+void AES128BlockCipherEnc::EncryptBlocks(const uint8_t *inBlocks, uint8_t *outBlocks, uint16_t numBlocks)
+{
+    EncryptBlocksInterleaved(mKey, kRoundCount, inBlocks, outBlocks, numBlocks);
+}
+
 void AES128BlockCipherDec::SetKey(const uint8_t *key)
 {
     __m128i tmp;
@@ -234,6 +285,11 @@ void AES256BlockCipherEnc::EncryptBlock(const uint8_t *inBlock, uint8_t *outBloc
     ClearSecretData((uint8_t *)&block, sizeof(block));
 }
 
+void AES256BlockCipherEnc::EncryptBlocks(const uint8_t *inBlocks, uint8_t *outBlocks, uint16_t numBlocks)
+{
+    EncryptBlocksInterleaved(mKey, kRoundCount, inBlocks, outBlocks, numBlocks);
+}
+
 void AES256BlockCipherDec::SetKey(const uint8_t *key)
 {
     __m128i tmp;
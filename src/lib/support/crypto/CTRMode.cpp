@@ -94,39 +94,81 @@ void CTRMode<BlockCipher>::EncryptData(const uint8_t *inData, uint16_t dataLen,
     // Index to next byte of encrypted counter to be used.
     uint32_t encryptedCounterIndex = mMsgIndex % kCounterLength;
 
-    // For each byte of input data...
-    for (uint16_t dataIndex = 0; dataIndex < dataLen && mMsgIndex < UINT32_MAX; dataIndex++, mMsgIndex++)
+    // The total message size is limited to UINT32_MAX bytes.
+    if (dataLen > UINT32_MAX - mMsgIndex)
+        dataLen = static_cast<uint16_t>(UINT32_MAX - mMsgIndex);
+
+    // Use up any encrypted counter bytes left over from the previous call.
+    if (encryptedCounterIndex != 0)
+    {
+        for (; dataLen > 0 && encryptedCounterIndex < kCounterLength; dataLen--, encryptedCounterIndex++, mMsgIndex++)
+            *outData++ = *inData++ ^ mEncryptedCounter[encryptedCounterIndex];
+    }
+
+    // Encrypt whole blocks of data, handing the block cipher a batch of counter values at a time.
+    if (dataLen >= kCounterLength)
     {
-        // If we need more encrypted counter bytes...
-        if (encryptedCounterIndex == 0)
+        uint8_t counterBlocks[kBatchBlocks * kCounterLength];
+        uint8_t encryptedCounterBlocks[kBatchBlocks * kCounterLength];
+
+        while (dataLen >= kCounterLength)
         {
-            // Encrypt the next counter value.
-            mBlockCipher.EncryptBlock(Counter, mEncryptedCounter);
+            uint16_t numBlocks = dataLen / kCounterLength;
+            uint16_t batchLen;
+
+            if (numBlocks > kBatchBlocks)
+                numBlocks = kBatchBlocks;
+            batchLen = numBlocks * kCounterLength;
 
-            // Bump the counter. Since the message size is at most UINT32_MAX (and the counter counts blocks)
-            // we will never need to update more than the four least-significant bytes.
-            Counter[kCounterLength-1]++;
-            if (Counter[kCounterLength-1] == 0)
+            for (uint16_t i = 0; i < numBlocks; i++)
             {
-                Counter[kCounterLength-2]++;
-                if (Counter[kCounterLength-2] == 0)
-                {
-                    Counter[kCounterLength-3]++;
-                    if (Counter[kCounterLength-3] == 0)
-                    {
-                        Counter[kCounterLength-4]++;
-                    }
-                }
+                memcpy(counterBlocks + i * kCounterLength, Counter, kCounterLength);
+                IncrementCounter();
             }
+
+            mBlockCipher.EncryptBlocks(counterBlocks, encryptedCounterBlocks, numBlocks);
+
+            // XOR the data with the encrypted counter blocks.
+            for (uint16_t i = 0; i < batchLen; i++)
+                outData[i] = inData[i] ^ encryptedCounterBlocks[i];
+
+            inData += batchLen;
+            outData += batchLen;
+            dataLen -= batchLen;
+            mMsgIndex += batchLen;
         }
 
-        // XOR the data with the corresponding byte of the encrypted counter.
-        outData[dataIndex] = inData[dataIndex] ^ mEncryptedCounter[encryptedCounterIndex];
+        ClearSecretData(encryptedCounterBlocks, sizeof(encryptedCounterBlocks));
+    }
+
+    // Encrypt any remaining partial block, keeping the rest of the encrypted counter for the next call.
+    if (dataLen > 0)
+    {
+        mBlockCipher.EncryptBlock(Counter, mEncryptedCounter);
+        IncrementCounter();
+
+        for (encryptedCounterIndex = 0; encryptedCounterIndex < dataLen; encryptedCounterIndex++, mMsgIndex++)
+            outData[encryptedCounterIndex] = inData[encryptedCounterIndex] ^ mEncryptedCounter[encryptedCounterIndex];
+    }
+}
 
-        // Bump the counter index.
-        encryptedCounterIndex++;
-        if (encryptedCounterIndex == kCounterLength)
-            encryptedCounterIndex = 0;
+template <class BlockCipher>
+void CTRMode<BlockCipher>::IncrementCounter()
+{
+    // Bump the counter. Since the message size is at most UINT32_MAX (and the counter counts blocks)
+    // we will never need to update more than the four least-significant bytes.
+    Counter[kCounterLength-1]++;
+    if (Counter[kCounterLength-1] == 0)
+    {
+        Counter[kCounterLength-2]++;
+        if (Counter[kCounterLength-2] == 0)
+        {
+            Counter[kCounterLength-3]++;
+            if (Counter[kCounterLength-3] == 0)
+            {
+                Counter[kCounterLength-4]++;
+            }
+        }
     }
 }
 
@@ -57,14 +57,91 @@ public:
     void SetWeaveMessageCounter(uint64_t sendingNodeId, uint32_t msgId);
     void EncryptData(const uint8_t *inData, uint16_t dataLen, uint8_t *outData);
 
+    template <class MAC>
+    void EncryptDataWithMAC(const uint8_t *inData, uint16_t dataLen, uint8_t *outData, MAC& mac);
+    template <class MAC>
+    void DecryptDataWithMAC(const uint8_t *inData, uint16_t dataLen, uint8_t *outData, MAC& mac);
+
     void Reset(void);
 
 private:
+    enum
+    {
+        // Number of counter blocks handed to the block cipher at once. Block ciphers that can
+        // pipeline several blocks (e.g. AES-NI) encrypt such a batch faster than one block at a time.
+        kBatchBlocks    = 8,
+
+        // Amount of data processed per step by the combined encrypt and MAC operations. This is
+        // small enough that the data is still in cache when the second operation reads it.
+        kMACChunkLength = kBatchBlocks * kCounterLength
+    };
+
     BlockCipher mBlockCipher;
     uint32_t mMsgIndex;
     uint8_t mEncryptedCounter[kCounterLength];
+
+    void IncrementCounter(void);
 };
 
+/**
+ * Encrypt data and compute a MAC over the plain text in a single pass over the data.
+ *
+ * The data is processed in small chunks, each of which is added to the MAC and then
+ * encrypted while it is still in cache. The result is the same as calling
+ * mac.AddData() over the whole input followed by EncryptData().
+ *
+ * @param[in]    inData     The plain text. May be the same as outData.
+ * @param[in]    dataLen    The length of the data.
+ * @param[out]   outData    A buffer to receive the cipher text.
+ * @param[inout] mac        The MAC object (e.g. HMACSHA1) to which the plain text is added.
+ *                          The caller is responsible for calling Begin() and Finish().
+ */
+template <class BlockCipher>
+template <class MAC>
+inline void CTRMode<BlockCipher>::EncryptDataWithMAC(const uint8_t *inData, uint16_t dataLen, uint8_t *outData, MAC& mac)
+{
+    while (dataLen > 0)
+    {
+        uint16_t chunkLen = (dataLen > kMACChunkLength) ? static_cast<uint16_t>(kMACChunkLength) : dataLen;
+
+        mac.AddData(inData, chunkLen);
+        EncryptData(inData, chunkLen, outData);
+
+        inData += chunkLen;
+        outData += chunkLen;
+        dataLen -= chunkLen;
+    }
+}
+
+/**
+ * Decrypt data and compute a MAC over the resulting plain text in a single pass over the data.
+ *
+ * The result is the same as calling EncryptData() over the whole input followed by
+ * mac.AddData() over the output.
+ *
+ * @param[in]    inData     The cipher text. May be the same as outData.
+ * @param[in]    dataLen    The length of the data.
+ * @param[out]   outData    A buffer to receive the plain text.
+ * @param[inout] mac        The MAC object (e.g. HMACSHA1) to which the plain text is added.
+ *                          The caller is responsible for calling Begin() and Finish().
+ */
+template <class BlockCipher>
+template <class MAC>
+inline void CTRMode<BlockCipher>::DecryptDataWithMAC(const uint8_t *inData, uint16_t dataLen, uint8_t *outData, MAC& mac)
+{
+    while (dataLen > 0)
+    {
+        uint16_t chunkLen = (dataLen > kMACChunkLength) ? static_cast<uint16_t>(kMACChunkLength) : dataLen;
+
+        EncryptData(inData, chunkLen, outData);
+        mac.AddData(outData, chunkLen);
+
+        inData += chunkLen;
+        outData += chunkLen;
+        dataLen -= chunkLen;
+    }
+}
+
 typedef CTRMode<Platform::Security::AES128BlockCipherEnc> AES128CTRMode;
 typedef CTRMode<Platform::Security::AES256BlockCipherEnc> AES256CTRMode;
 
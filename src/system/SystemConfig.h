@@ -333,6 +333,47 @@
 #define WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC 15
 #endif /* WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC */
 
+/**
+ *  @def WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE
+ *
+ *  @brief
+ *      Defines whether (1) or not (0) each thread keeps a small cache of free packet buffers in front of the shared pool.
+ *
+ *  @details
+ *      When enabled, \c PacketBuffer::New and \c PacketBuffer::Free are served from a per-thread cache without taking the
+ *      pool lock. A thread refills its empty cache from, and drains its full cache to, the shared pool in batches of half the
+ *      cache size, and returns any cached buffers to the shared pool when it exits. Buffers held in one thread's cache are
+ *      not available to other threads, so the pool should be sized with #WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE_SIZE
+ *      buffers of headroom per allocating thread.
+ *
+ *      This option is only available with the pool-based allocator (a non-zero #WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC)
+ *      and POSIX locking.
+ */
+#ifndef WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE
+#define WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE 0
+#endif /* WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE */
+
+#if WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE && (WEAVE_SYSTEM_CONFIG_USE_LWIP || !WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC || !WEAVE_SYSTEM_CONFIG_POSIX_LOCKING)
+#error "WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE requires the pool-based PacketBuffer allocator and WEAVE_SYSTEM_CONFIG_POSIX_LOCKING"
+#endif /* WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE && (WEAVE_SYSTEM_CONFIG_USE_LWIP || !WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC || !WEAVE_SYSTEM_CONFIG_POSIX_LOCKING) */
+
+/**
+ *  @def WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE_SIZE
+ *
+ *  @brief
+ *      The maximum number of free packet buffers held in each thread's cache.
+ *
+ *  @details
+ *      This option is only meaningful when #WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE is enabled.
+ */
+#ifndef WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE_SIZE
+#define WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE_SIZE 8
+#endif /* WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE_SIZE */
+
+#if WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE && WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE_SIZE < 2
+#error "WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE_SIZE must be at least 2"
+#endif /* WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE && WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE_SIZE < 2 */
+
 /**
  *  @def WEAVE_SYSTEM_CONFIG_PACKETBUFFER_CAPACITY_MAX
  *
@@ -375,6 +416,97 @@
 #endif /* WEAVE_SYSTEM_CONFIG_PACKETBUFFER_CAPACITY_MAX */
 #endif /* !WEAVE_SYSTEM_CONFIG_USE_LWIP */
 
+/**
+ *  @def WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES
+ *
+ *  @brief
+ *      Defines whether (1) or not (0) the pool-based \c PacketBuffer allocator keeps separate pools of small, medium and
+ *      full-size buffers.
+ *
+ *  @details
+ *      When enabled, \c PacketBuffer::NewWithAvailableSize serves each request from the smallest size class whose capacity
+ *      covers the requested reserved and available space, falling back to the next larger class when that pool is empty, and
+ *      \c PacketBuffer::RightSize copies an unshared single buffer into a smaller class when its contents fit. The full-size
+ *      pool holds #WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC buffers of #WEAVE_SYSTEM_CONFIG_PACKETBUFFER_CAPACITY_MAX bytes;
+ *      the small and medium pools are sized by the options below.
+ *
+ *      This option is only available with the pool-based allocator (a non-zero #WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC).
+ */
+#ifndef WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES
+#define WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES 0
+#endif /* WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES */
+
+#if WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES && (WEAVE_SYSTEM_CONFIG_USE_LWIP || !WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC)
+#error "WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES requires the pool-based PacketBuffer allocator"
+#endif /* WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES && (WEAVE_SYSTEM_CONFIG_USE_LWIP || !WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC) */
+
+/**
+ *  @def WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SMALL_CAPACITY
+ *
+ *  @brief
+ *      The capacity, in bytes, of a buffer in the small size class. The default covers the default header reserve plus a
+ *      short payload, such as a standalone acknowledgment, a status report or a heartbeat.
+ *
+ *  @details
+ *      This option is only meaningful when #WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES is enabled.
+ */
+#ifndef WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SMALL_CAPACITY
+#define WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SMALL_CAPACITY 128
+#endif /* WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SMALL_CAPACITY */
+
+/**
+ *  @def WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SMALL_MAXALLOC
+ *
+ *  @brief
+ *      The number of buffers in the small size class pool.
+ *
+ *  @details
+ *      This option is only meaningful when #WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES is enabled. The default, half of
+ *      #WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC rounded up, adds roughly a twentieth of the full-size pool's memory.
+ */
+#ifndef WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SMALL_MAXALLOC
+#define WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SMALL_MAXALLOC ((WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC + 1) / 2)
+#endif /* WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SMALL_MAXALLOC */
+
+/**
+ *  @def WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MEDIUM_CAPACITY
+ *
+ *  @brief
+ *      The capacity, in bytes, of a buffer in the medium size class.
+ *
+ *  @details
+ *      This option is only meaningful when #WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES is enabled.
+ */
+#ifndef WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MEDIUM_CAPACITY
+#define WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MEDIUM_CAPACITY 512
+#endif /* WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MEDIUM_CAPACITY */
+
+/**
+ *  @def WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MEDIUM_MAXALLOC
+ *
+ *  @brief
+ *      The number of buffers in the medium size class pool.
+ *
+ *  @details
+ *      This option is only meaningful when #WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES is enabled. The default, a quarter
+ *      of #WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC rounded up, adds roughly a twelfth of the full-size pool's memory.
+ */
+#ifndef WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MEDIUM_MAXALLOC
+#define WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MEDIUM_MAXALLOC ((WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC + 3) / 4)
+#endif /* WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MEDIUM_MAXALLOC */
+
+#if WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES && \
+    !(0 < WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SMALL_CAPACITY && \
+      WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SMALL_CAPACITY < WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MEDIUM_CAPACITY && \
+      WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MEDIUM_CAPACITY < WEAVE_SYSTEM_CONFIG_PACKETBUFFER_CAPACITY_MAX)
+#error "PacketBuffer size class capacities must increase from small to medium to WEAVE_SYSTEM_CONFIG_PACKETBUFFER_CAPACITY_MAX"
+#endif /* WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES && ... */
+
+#if WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES && \
+    (WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SMALL_MAXALLOC <= 0 || WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MEDIUM_MAXALLOC <= 0)
+#error "WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SMALL_MAXALLOC and WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MEDIUM_MAXALLOC must be positive"
+#endif /* WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES && ... */
+
 #if WEAVE_SYSTEM_CONFIG_USE_LWIP
 
 /**
@@ -498,6 +630,133 @@ struct LwIPEvent;
 #define WEAVE_SYSTEM_CONFIG_NUM_TIMERS 32
 #endif /* WEAVE_SYSTEM_CONFIG_NUM_TIMERS */
 
+/**
+ *  @def WEAVE_SYSTEM_CONFIG_USE_OBJECT_POOL_FREE_LIST
+ *
+ *  @brief
+ *      This defines whether (1) or not (0) object pools, such as the pools of timers and end points, keep their free objects on a
+ *      lock-free list and track their live objects in a bitmap.
+ *
+ *  @details
+ *      With the free list, allocating and recycling an object take constant time instead of a scan of the pool, and iterating
+ *      over a pool with ObjectPool::NextIndex skips unused objects a word of the bitmap at a time. Each object grows by two
+ *      pointers.
+ */
+#ifndef WEAVE_SYSTEM_CONFIG_USE_OBJECT_POOL_FREE_LIST
+#define WEAVE_SYSTEM_CONFIG_USE_OBJECT_POOL_FREE_LIST 0
+#endif /* WEAVE_SYSTEM_CONFIG_USE_OBJECT_POOL_FREE_LIST */
+
+/**
+ *  @def WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+ *
+ *  @brief
+ *      This defines whether (1) or not (0) armed timers are tracked in a hashed timing wheel.
+ *
+ *  @details
+ *      With the timing wheel, starting and cancelling a timer, including the implicit cancellation performed by
+ *      Layer::StartTimer, are constant-time operations, and expiry processing only visits the wheel slots that have come due
+ *      since the previous pass. Without it, timers are located by scanning the timer pool (sockets) or kept in a sorted linked
+ *      list (LwIP), both of which cost time linear in the number of armed timers.
+ *
+ *      Timers that expire in the same pass are not guaranteed to be completed in order of their expiration time.
+ */
+#ifndef WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+#define WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL 0
+#endif /* WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL */
+
+/**
+ *  @def WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_SLOTS
+ *
+ *  @brief
+ *      This is the number of slots in the timing wheel, and the number of buckets in its callback index. It must be a power of two.
+ *
+ *  @details
+ *      Together with #WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_TICK_MS this determines the span of one revolution of the wheel. Timers
+ *      further in the future than one revolution share slots with nearer timers and are skipped over until they come due.
+ */
+#ifndef WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_SLOTS
+#define WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_SLOTS 256
+#endif /* WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_SLOTS */
+
+#if (WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_SLOTS & (WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_SLOTS - 1)) != 0
+#error "WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_SLOTS must be a power of two."
+#endif
+
+/**
+ *  @def WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_TICK_MS
+ *
+ *  @brief
+ *      This is the span, in milliseconds, of a single timing wheel slot.
+ *
+ *  @details
+ *      The tick only affects how timers are distributed over the wheel; expiration is always evaluated against the millisecond
+ *      expiration time of each timer.
+ */
+#ifndef WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_TICK_MS
+#define WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_TICK_MS 16
+#endif /* WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_TICK_MS */
+
+/**
+ *  @def WEAVE_SYSTEM_CONFIG_USE_WORK_QUEUE
+ *
+ *  @brief
+ *      This defines whether (1) or not (0) Layer::ScheduleWork posts work to a bounded, lock-free, multi-producer,
+ *      single-consumer queue rather than allocating a timer for each item.
+ *
+ *  @details
+ *      The queue is drained in a batch by Layer::HandleSelectResult. Producers only wake the select loop when no wake-up is
+ *      already pending, so a burst of posts costs a single write to the wake file descriptor. When the queue is full,
+ *      ScheduleWork falls back to allocating a timer. Work posted to the queue cannot be cancelled with Layer::CancelTimer.
+ *
+ *      Work runs in the order it was posted only while the queue does not overflow. Queued work is run before expired timers,
+ *      so work that fell back to a timer can run after work posted later, once the queue has room again.
+ *
+ *      This option is only available with #WEAVE_SYSTEM_CONFIG_USE_SOCKETS.
+ */
+#ifndef WEAVE_SYSTEM_CONFIG_USE_WORK_QUEUE
+#define WEAVE_SYSTEM_CONFIG_USE_WORK_QUEUE 0
+#endif /* WEAVE_SYSTEM_CONFIG_USE_WORK_QUEUE */
+
+#if WEAVE_SYSTEM_CONFIG_USE_WORK_QUEUE && !WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+#error "WEAVE_SYSTEM_CONFIG_USE_WORK_QUEUE requires WEAVE_SYSTEM_CONFIG_USE_SOCKETS."
+#endif
+
+/**
+ *  @def WEAVE_SYSTEM_CONFIG_WORK_QUEUE_SIZE
+ *
+ *  @brief
+ *      This is the number of entries in the work queue of each layer. It must be a power of two.
+ *
+ *  @details
+ *      This option is only meaningful when #WEAVE_SYSTEM_CONFIG_USE_WORK_QUEUE is enabled.
+ */
+#ifndef WEAVE_SYSTEM_CONFIG_WORK_QUEUE_SIZE
+#define WEAVE_SYSTEM_CONFIG_WORK_QUEUE_SIZE 64
+#endif /* WEAVE_SYSTEM_CONFIG_WORK_QUEUE_SIZE */
+
+#if (WEAVE_SYSTEM_CONFIG_WORK_QUEUE_SIZE & (WEAVE_SYSTEM_CONFIG_WORK_QUEUE_SIZE - 1)) != 0
+#error "WEAVE_SYSTEM_CONFIG_WORK_QUEUE_SIZE must be a power of two."
+#endif
+
+/**
+ *  @def WEAVE_SYSTEM_CONFIG_USE_EVENTFD
+ *
+ *  @brief
+ *      This defines whether (1) or not (0) the select loop is woken through a Linux eventfd rather than a pipe.
+ *
+ *  @details
+ *      An eventfd uses a single file descriptor and is drained with a single read, however many times it was signalled.
+ *
+ *      This option is only available with #WEAVE_SYSTEM_CONFIG_USE_SOCKETS on Linux.
+ */
+#ifndef WEAVE_SYSTEM_CONFIG_USE_EVENTFD
+#define WEAVE_SYSTEM_CONFIG_USE_EVENTFD 0
+#endif /* WEAVE_SYSTEM_CONFIG_USE_EVENTFD */
+
+#if WEAVE_SYSTEM_CONFIG_USE_EVENTFD && !WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+#error "WEAVE_SYSTEM_CONFIG_USE_EVENTFD requires WEAVE_SYSTEM_CONFIG_USE_SOCKETS."
+#endif
+
 /**
  *  @def WEAVE_SYSTEM_CONFIG_PROVIDE_STATISTICS
  *
@@ -47,6 +47,10 @@
 #include <errno.h>
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
+#if WEAVE_SYSTEM_CONFIG_USE_EVENTFD
+#include <sys/eventfd.h>
+#endif // WEAVE_SYSTEM_CONFIG_USE_EVENTFD
+
 #if WEAVE_SYSTEM_CONFIG_USE_LWIP
 #if !WEAVE_SYSTEM_CONFIG_PLATFORM_PROVIDES_EVENT_FUNCTIONS
 #include <lwip/err.h>
@@ -106,15 +110,33 @@ Layer::Layer()
 #if WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
     this->mHandleSelectThread = PTHREAD_NULL;
 #endif // WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
+
+#if WEAVE_SYSTEM_CONFIG_USE_WORK_QUEUE
+    this->mWorkQueueTail = 0;
+    this->mWorkQueueHead = 0;
+    this->mWakePending = false;
+#endif // WEAVE_SYSTEM_CONFIG_USE_WORK_QUEUE
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+
+#if WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+    this->mCompletingTimers = NULL;
+
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+    this->mScheduledWork = NULL;
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+#endif // WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
 }
 
 Error Layer::Init(void* aContext)
 {
     Error lReturn;
 #if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+#if WEAVE_SYSTEM_CONFIG_USE_EVENTFD
+    int lEventFD;
+#else // !WEAVE_SYSTEM_CONFIG_USE_EVENTFD
     int lPipeFDs[2];
     int lOSReturn, lFlags;
+#endif // !WEAVE_SYSTEM_CONFIG_USE_EVENTFD
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
     RegisterSystemLayerErrorFormatter();
@@ -136,6 +158,14 @@ Error Layer::Init(void* aContext)
 #endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
 
 #if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+#if WEAVE_SYSTEM_CONFIG_USE_EVENTFD
+    // Create an eventfd to allow an arbitrary thread to wake the thread in the select loop. It serves as both ends of the "pipe".
+    lEventFD = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    VerifyOrExit(lEventFD >= 0, lReturn = nl::Weave::System::MapErrorPOSIX(errno));
+
+    this->mWakePipeIn = lEventFD;
+    this->mWakePipeOut = lEventFD;
+#else // !WEAVE_SYSTEM_CONFIG_USE_EVENTFD
     // Create a Unix pipe to allow an arbitrary thread to wake the thread in the select loop.
     lOSReturn = ::pipe(lPipeFDs);
     VerifyOrExit(lOSReturn == 0, lReturn = nl::Weave::System::MapErrorPOSIX(errno));
@@ -151,8 +181,23 @@ Error Layer::Init(void* aContext)
     lFlags = ::fcntl(this->mWakePipeOut, F_GETFL, 0);
     lOSReturn = ::fcntl(this->mWakePipeOut, F_SETFL, lFlags | O_NONBLOCK);
     VerifyOrExit(lOSReturn == 0, lReturn = nl::Weave::System::MapErrorPOSIX(errno));
+#endif // !WEAVE_SYSTEM_CONFIG_USE_EVENTFD
+
+#if WEAVE_SYSTEM_CONFIG_USE_WORK_QUEUE
+    // Each entry's sequence number tells producers and the consumer whose turn it is; see PostWork().
+    for (size_t i = 0; i < WEAVE_SYSTEM_CONFIG_WORK_QUEUE_SIZE; i++)
+        this->mWorkQueue[i].mSequence = i;
+
+    this->mWorkQueueTail = 0;
+    this->mWorkQueueHead = 0;
+    this->mWakePending = false;
+#endif // WEAVE_SYSTEM_CONFIG_USE_WORK_QUEUE
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
+#if WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+    this->mTimerWheel.Init(Timer::GetCurrentEpoch());
+#endif // WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+
     this->mLayerState = kLayerState_Initialized;
     this->mContext = aContext;
 
@@ -182,7 +227,7 @@ Error Layer::Shutdown()
     }
 #endif
 
-    for (size_t i = 0; i < Timer::sPool.Size(); ++i)
+    for (size_t i = Timer::sPool.NextIndex(0); i < Timer::sPool.Size(); i = Timer::sPool.NextIndex(i + 1))
     {
         Timer* lTimer = Timer::sPool.Get(*this, i);
 
@@ -192,6 +237,11 @@ Error Layer::Shutdown()
         }
     }
 
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS && WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+    // Release the cancelled scheduled work still awaiting completion.
+    Timer::CompleteTimers(*this, this->TakeScheduledWork());
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS && WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+
     this->mContext = NULL;
     this->mLayerState = kLayerState_NotInitialized;
 
@@ -296,7 +346,30 @@ void Layer::CancelTimer(Layer::TimerCompleteFunct aOnComplete, void* aAppState)
     if (this->State() != kLayerState_Initialized)
         return;
 
-    for (size_t i = 0; i < Timer::sPool.Size(); ++i)
+#if WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+    Timer* lTimer = this->mTimerWheel.Find(aOnComplete, aAppState);
+
+    // Scheduled work is not indexed; look for it among the timers being completed and those not yet collected.
+    for (lTimer = (lTimer != NULL) ? lTimer : this->mCompletingTimers; lTimer != NULL; lTimer = lTimer->mNextTimer)
+    {
+        if (lTimer->OnComplete == aOnComplete && lTimer->AppState == aAppState)
+            break;
+    }
+
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+    for (lTimer = (lTimer != NULL) ? lTimer : this->mScheduledWork; lTimer != NULL; lTimer = lTimer->mNextTimer)
+    {
+        if (lTimer->OnComplete == aOnComplete && lTimer->AppState == aAppState)
+            break;
+    }
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+
+    if (lTimer != NULL)
+    {
+        lTimer->Cancel();
+    }
+#else // !WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+    for (size_t i = Timer::sPool.NextIndex(0); i < Timer::sPool.Size(); i = Timer::sPool.NextIndex(i + 1))
     {
         Timer* lTimer = Timer::sPool.Get(*this, i);
 
@@ -306,12 +379,13 @@ void Layer::CancelTimer(Layer::TimerCompleteFunct aOnComplete, void* aAppState)
             break;
         }
     }
+#endif // !WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
 }
 
 #if WEAVE_SYSTEM_CONFIG_PROVIDE_OBSOLESCENT_INTERFACES
 void Layer::CancelAllMatchingInetTimers(nl::Inet::InetLayer& aInetLayer, void* aOnCompleteInetLayer, void* aAppState)
 {
-    for (size_t i = 0; i < Timer::sPool.Size(); ++i)
+    for (size_t i = Timer::sPool.NextIndex(0); i < Timer::sPool.Size(); i = Timer::sPool.NextIndex(i + 1))
     {
         Timer* lTimer = Timer::sPool.Get(*this, i);
 
@@ -343,6 +417,10 @@ void Layer::CancelAllMatchingInetTimers(nl::Inet::InetLayer& aInetLayer, void* a
  *   `ScheduleWork` guarantees that the handler function will be
  *   called only after the current Weave event completes.
  *
+ *   With `WEAVE_SYSTEM_CONFIG_USE_WORK_QUEUE`, work is run in the
+ *   order it was scheduled only while the work queue does not
+ *   overflow; see the description of that option.
+ *
  * @param[in] aComplete A pointer to a callback function to be called
  *                      when this timer fires.
  *
@@ -362,6 +440,18 @@ Error Layer::ScheduleWork(TimerCompleteFunct aComplete, void* aAppState)
     Error lReturn;
     Timer* lTimer;
 
+#if WEAVE_SYSTEM_CONFIG_USE_WORK_QUEUE
+    VerifyOrExit(this->State() == kLayerState_Initialized, lReturn = WEAVE_SYSTEM_ERROR_UNEXPECTED_STATE);
+
+    if (this->PostWork(aComplete, aAppState))
+    {
+        this->WakeSelect();
+        ExitNow(lReturn = WEAVE_SYSTEM_NO_ERROR);
+    }
+
+    // The queue is full; fall back to scheduling the work with a timer.
+#endif // WEAVE_SYSTEM_CONFIG_USE_WORK_QUEUE
+
     lReturn = this->NewTimer(lTimer);
     SuccessOrExit(lReturn);
 
@@ -571,10 +661,35 @@ void Layer::PrepareSelect(int& aSetSize, fd_set* aReadSet, fd_set* aWriteSet, fd
 
     FD_SET(this->mWakePipeIn, aReadSet);
 
+#if WEAVE_SYSTEM_CONFIG_USE_WORK_QUEUE
+    // Work left over from a previous batch, or posted from this thread without a wake-up, must not wait for the sleep time.
+    if (this->HasPostedWork())
+    {
+        aSleepTime.tv_sec = 0;
+        aSleepTime.tv_usec = 0;
+        return;
+    }
+#endif // WEAVE_SYSTEM_CONFIG_USE_WORK_QUEUE
+
     const Timer::Epoch kCurrentEpoch = Timer::GetCurrentEpoch();
     Timer::Epoch lAwakenEpoch = kCurrentEpoch + static_cast<Timer::Epoch>(aSleepTime.tv_sec) * 1000 + aSleepTime.tv_usec / 1000;
 
-    for (size_t i = 0; i < Timer::sPool.Size(); i++)
+#if WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+    Timer::Epoch lNextEpoch;
+
+    if (this->mScheduledWork != NULL)
+    {
+        lAwakenEpoch = kCurrentEpoch;
+    }
+    else if (this->mTimerWheel.GetNextEpoch(lNextEpoch))
+    {
+        if (!Timer::IsEarlierEpoch(kCurrentEpoch, lNextEpoch))
+            lAwakenEpoch = kCurrentEpoch;
+        else if (Timer::IsEarlierEpoch(lNextEpoch, lAwakenEpoch))
+            lAwakenEpoch = lNextEpoch;
+    }
+#else // !WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+    for (size_t i = Timer::sPool.NextIndex(0); i < Timer::sPool.Size(); i = Timer::sPool.NextIndex(i + 1))
     {
         Timer* lTimer = Timer::sPool.Get(*this, i);
 
@@ -590,6 +705,7 @@ void Layer::PrepareSelect(int& aSetSize, fd_set* aReadSet, fd_set* aWriteSet, fd
                 lAwakenEpoch = lTimer->mAwakenEpoch;
         }
     }
+#endif // !WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
 
     const Timer::Epoch kSleepTime = lAwakenEpoch - kCurrentEpoch;
     aSleepTime.tv_sec = kSleepTime / 1000;
@@ -632,6 +748,11 @@ void Layer::HandleSelectResult(int aSetSize, fd_set* aReadSet, fd_set* aWriteSet
         // If we woke because of someone writing to the wake pipe, clear the contents of the pipe before returning.
         if (FD_ISSET(this->mWakePipeIn, aReadSet))
         {
+#if WEAVE_SYSTEM_CONFIG_USE_EVENTFD
+            uint64_t lCount;
+            const ssize_t kIOResult = ::read(this->mWakePipeIn, &lCount, sizeof(lCount));
+            static_cast<void>(kIOResult);
+#else // !WEAVE_SYSTEM_CONFIG_USE_EVENTFD
             while (true)
             {
                 uint8_t lBytes[128];
@@ -639,6 +760,7 @@ void Layer::HandleSelectResult(int aSetSize, fd_set* aReadSet, fd_set* aWriteSet
                 if (lTmp < static_cast<int>(sizeof(lBytes)))
                     break;
             }
+#endif // !WEAVE_SYSTEM_CONFIG_USE_EVENTFD
         }
     }
 
@@ -648,7 +770,20 @@ void Layer::HandleSelectResult(int aSetSize, fd_set* aReadSet, fd_set* aWriteSet
     this->mHandleSelectThread = lThreadSelf;
 #endif // WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
 
-    for (size_t i = 0; i < Timer::sPool.Size(); i++)
+#if WEAVE_SYSTEM_CONFIG_USE_WORK_QUEUE
+    // The wake pipe has been drained, so from here on a producer must wake the select loop again. If the flag were cleared before
+    // the drain, a producer posting in between would have its write drained but leave the flag set, and every later producer would
+    // skip its write. Anything posted before this point is run below.
+    __atomic_store_n(&this->mWakePending, false, __ATOMIC_SEQ_CST);
+
+    this->RunPostedWork();
+#endif // WEAVE_SYSTEM_CONFIG_USE_WORK_QUEUE
+
+#if WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+    Timer::CompleteTimers(*this, this->TakeScheduledWork());
+    Timer::CompleteTimers(*this, this->mTimerWheel.CollectExpired(kCurrentEpoch));
+#else // !WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+    for (size_t i = Timer::sPool.NextIndex(0); i < Timer::sPool.Size(); i = Timer::sPool.NextIndex(i + 1))
     {
         Timer* lTimer = Timer::sPool.Get(*this, i);
 
@@ -657,6 +792,7 @@ void Layer::HandleSelectResult(int aSetSize, fd_set* aReadSet, fd_set* aWriteSet
             lTimer->HandleComplete();
         }
     }
+#endif // !WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
 
 #if WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
     this->mHandleSelectThread = PTHREAD_NULL;
@@ -672,6 +808,9 @@ void Layer::HandleSelectResult(int aSetSize, fd_set* aReadSet, fd_set* aWriteSet
  *
  *      Furthermore, we don't care if this write fails as the only reasonably likely failure is that the pipe is full, in which
  *      case the select calling thread is going to wake up anyway.
+ *
+ *      With #WEAVE_SYSTEM_CONFIG_USE_WORK_QUEUE, the write is also skipped while an earlier wake-up has not yet been seen by
+ *      @p HandleSelectResult().
  */
 void Layer::WakeSelect()
 {
@@ -685,12 +824,140 @@ void Layer::WakeSelect()
     }
 #endif // WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
 
+#if WEAVE_SYSTEM_CONFIG_USE_WORK_QUEUE
+    // A wake-up not yet seen by HandleSelectResult() will wake the select call for this caller too.
+    if (__atomic_exchange_n(&this->mWakePending, true, __ATOMIC_SEQ_CST))
+        return;
+#endif // WEAVE_SYSTEM_CONFIG_USE_WORK_QUEUE
+
+#if WEAVE_SYSTEM_CONFIG_USE_EVENTFD
+    // Increment the eventfd counter to wake up the select call.
+    const uint64_t kCount = 1;
+    const ssize_t kIOResult = ::write(this->mWakePipeOut, &kCount, sizeof(kCount));
+#else // !WEAVE_SYSTEM_CONFIG_USE_EVENTFD
     // Write a single byte to the wake pipe to wake up the select call.
     const uint8_t kByte = 0;
     const ssize_t kIOResult = ::write(this->mWakePipeOut, &kByte, 1);
+#endif // !WEAVE_SYSTEM_CONFIG_USE_EVENTFD
     static_cast<void>(kIOResult);
 }
 
+#if WEAVE_SYSTEM_CONFIG_USE_WORK_QUEUE
+/**
+ * Post a function to the work queue. This may be called from any thread.
+ *
+ *  @note
+ *      The queue is a bounded array of entries, each carrying a sequence number. An entry is free for the producer that claims
+ *      position \c n when its sequence number equals \c n, and holds work for the consumer once the producer has set it to
+ *      <tt>n + 1</tt>. Producers claim positions by advancing the tail with compare-and-swap; the consumer, which is always the
+ *      select thread, hands the entry back by setting its sequence number to <tt>n + size</tt>.
+ *
+ *  @param[in] aComplete    The function to call.
+ *  @param[in] aAppState    The application state passed to \c aComplete.
+ *
+ *  @return \c true if the work was posted, or \c false if the queue is full.
+ */
+bool Layer::PostWork(TimerCompleteFunct aComplete, void* aAppState)
+{
+    size_t lPosition = __atomic_load_n(&this->mWorkQueueTail, __ATOMIC_RELAXED);
+    WorkItem* lItem;
+
+    while (true)
+    {
+        lItem = &this->mWorkQueue[lPosition & (WEAVE_SYSTEM_CONFIG_WORK_QUEUE_SIZE - 1)];
+
+        const size_t kSequence = __atomic_load_n(&lItem->mSequence, __ATOMIC_ACQUIRE);
+        const intptr_t kDifference = static_cast<intptr_t>(kSequence) - static_cast<intptr_t>(lPosition);
+
+        if (kDifference == 0)
+        {
+            // The entry is free; claim it, or retry from the position another producer moved the tail to.
+            if (__atomic_compare_exchange_n(&this->mWorkQueueTail, &lPosition, lPosition + 1, true, __ATOMIC_RELAXED,
+                                            __ATOMIC_RELAXED))
+                break;
+        }
+        else if (kDifference < 0)
+        {
+            // The entry still holds work from the previous lap of the queue.
+            return false;
+        }
+        else
+        {
+            lPosition = __atomic_load_n(&this->mWorkQueueTail, __ATOMIC_RELAXED);
+        }
+    }
+
+    lItem->mComplete = aComplete;
+    lItem->mAppState = aAppState;
+    __atomic_store_n(&lItem->mSequence, lPosition + 1, __ATOMIC_RELEASE);
+
+    return true;
+}
+
+/**
+ * Test whether the work queue holds work ready to run. This may only be called from the select thread.
+ */
+bool Layer::HasPostedWork(void) const
+{
+    const WorkItem& lItem = this->mWorkQueue[this->mWorkQueueHead & (WEAVE_SYSTEM_CONFIG_WORK_QUEUE_SIZE - 1)];
+
+    return __atomic_load_n(&lItem.mSequence, __ATOMIC_ACQUIRE) == this->mWorkQueueHead + 1;
+}
+
+/**
+ * Run the work in the queue. At most one queue's worth is run, so that producers posting continuously cannot starve I/O and
+ * timers; PrepareSelect() does not sleep while work remains.
+ */
+void Layer::RunPostedWork(void)
+{
+    for (size_t i = 0; i < WEAVE_SYSTEM_CONFIG_WORK_QUEUE_SIZE && this->HasPostedWork(); i++)
+    {
+        WorkItem& lItem = this->mWorkQueue[this->mWorkQueueHead & (WEAVE_SYSTEM_CONFIG_WORK_QUEUE_SIZE - 1)];
+        const TimerCompleteFunct kComplete = lItem.mComplete;
+        void* const kAppState = lItem.mAppState;
+
+        // Hand the entry back to producers before running the work, which may itself post more.
+        __atomic_store_n(&lItem.mSequence, this->mWorkQueueHead + WEAVE_SYSTEM_CONFIG_WORK_QUEUE_SIZE, __ATOMIC_RELEASE);
+        this->mWorkQueueHead++;
+
+        kComplete(this, kAppState, WEAVE_SYSTEM_NO_ERROR);
+
+        if (this->State() != kLayerState_Initialized)
+            break;
+    }
+}
+#endif // WEAVE_SYSTEM_CONFIG_USE_WORK_QUEUE
+
+#if WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+/**
+ * Atomically take the list of work posted by ScheduleWork() since the previous call.
+ *
+ *  @return The scheduled timers, linked through Timer::mNextTimer in the order they were scheduled, or NULL.
+ */
+Timer* Layer::TakeScheduledWork(void)
+{
+    Timer* lList;
+    Timer* lOrdered = NULL;
+
+    do
+    {
+        lList = this->mScheduledWork;
+    } while (lList != NULL && !__sync_bool_compare_and_swap(&this->mScheduledWork, lList, NULL));
+
+    // The list is pushed last-in first-out; reverse it so that work is completed in the order it was scheduled.
+    while (lList != NULL)
+    {
+        Timer* lNext = lList->mNextTimer;
+
+        lList->mNextTimer = lOrdered;
+        lOrdered = lList;
+        lList = lNext;
+    }
+
+    return lOrdered;
+}
+#endif // WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
 #if WEAVE_SYSTEM_CONFIG_USE_LWIP
@@ -44,6 +44,10 @@
 #include <SystemLayer/SystemObject.h>
 #include <SystemLayer/SystemEvent.h>
 
+#if WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+#include <SystemLayer/SystemTimer.h>
+#endif // WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+
 #if WEAVE_SYSTEM_CONFIG_PROVIDE_OBSOLESCENT_INTERFACES
 
 namespace nl {
@@ -202,7 +206,36 @@ private:
 #if WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
     pthread_t mHandleSelectThread;
 #endif // WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
+
+#if WEAVE_SYSTEM_CONFIG_USE_WORK_QUEUE
+    struct WorkItem
+    {
+        volatile size_t mSequence;
+        TimerCompleteFunct mComplete;
+        void* mAppState;
+    };
+
+    WorkItem mWorkQueue[WEAVE_SYSTEM_CONFIG_WORK_QUEUE_SIZE];
+    volatile size_t mWorkQueueTail;     // Next position to post at; advanced by any thread.
+    size_t mWorkQueueHead;              // Next position to run; only advanced by the select thread.
+    volatile bool mWakePending;
+
+    bool PostWork(TimerCompleteFunct aComplete, void* aAppState);
+    bool HasPostedWork(void) const;
+    void RunPostedWork(void);
+#endif // WEAVE_SYSTEM_CONFIG_USE_WORK_QUEUE
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+
+#if WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+    TimerWheel mTimerWheel;
+    Timer* mCompletingTimers;
+
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+    Timer* volatile mScheduledWork;
+
+    Timer* TakeScheduledWork(void);
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+#endif // WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
 
 #if WEAVE_SYSTEM_CONFIG_USE_LWIP
     static Error HandleSystemLayerEvent(Object& aTarget, EventType aEventType, uintptr_t aArgument);
@@ -69,6 +69,7 @@ public:
 
     void Lock(void);    /**< Acquire the mutual exclusion lock, blocking the current thread indefinitely if necessary. */
     void Unlock(void);  /**< Release the mutual exclusion lock (can block on some systems until scheduler completes). */
+    bool TryLock(void); /**< Acquire the mutual exclusion lock if it is immediately available; return whether it was acquired. */
 
 private:
 #if WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
@@ -105,6 +106,11 @@ inline void Mutex::Unlock(void)
 {
     pthread_mutex_unlock(&this->mPOSIXMutex);
 }
+
+inline bool Mutex::TryLock(void)
+{
+    return pthread_mutex_trylock(&this->mPOSIXMutex) == 0;
+}
 #endif // WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
 
 #if WEAVE_SYSTEM_CONFIG_FREERTOS_LOCKING
@@ -112,6 +118,11 @@ inline void Mutex::Unlock(void)
 {
     xSemaphoreGive(this->mFreeRTOSSemaphore);
 }
+
+inline bool Mutex::TryLock(void)
+{
+    return xSemaphoreTake(this->mFreeRTOSSemaphore, 0) == pdTRUE;
+}
 #endif // WEAVE_SYSTEM_CONFIG_FREERTOS_LOCKING
 
 } // namespace System
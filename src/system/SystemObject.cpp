@@ -51,8 +51,19 @@ NL_DLL_EXPORT void Object::Release(void)
 
     if (oldCount == 1)
     {
+#if WEAVE_SYSTEM_CONFIG_USE_OBJECT_POOL_FREE_LIST
+        // The object cannot be allocated again until it is recycled, so these are stable.
+        void* const lPool = this->mPool;
+        void (* const lRecycle)(void*, Object&) = this->mRecycle;
+#endif // WEAVE_SYSTEM_CONFIG_USE_OBJECT_POOL_FREE_LIST
+
         this->mSystemLayer = NULL;
         __sync_synchronize();
+
+#if WEAVE_SYSTEM_CONFIG_USE_OBJECT_POOL_FREE_LIST
+        if (lRecycle != NULL)
+            lRecycle(lPool, *this);
+#endif // WEAVE_SYSTEM_CONFIG_USE_OBJECT_POOL_FREE_LIST
     }
     else if (oldCount == 0)
     {
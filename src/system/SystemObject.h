@@ -104,6 +104,12 @@ private:
     Layer* volatile mSystemLayer;   /**< Pointer to the layer object that owns this object. */
     unsigned int mRefCount;         /**< Count of remaining calls to Release before object is dead. */
 
+#if WEAVE_SYSTEM_CONFIG_USE_OBJECT_POOL_FREE_LIST
+    uint32_t mNextFree;                                 /**< While free, one more than the index of the next free object. */
+    void* mPool;                                        /**< The pool from which the object was allocated. */
+    void (*mRecycle)(void* aPool, Object& aObject);     /**< Returns the object to \c mPool once it is released. */
+#endif // WEAVE_SYSTEM_CONFIG_USE_OBJECT_POOL_FREE_LIST
+
     /** If not already retained, attempt initial retention of this object for \c aLayer and zero up to \c aOctets. */
     bool TryCreate(Layer& aLayer, size_t aOctets);
 
@@ -181,6 +187,7 @@ public:
     static size_t Size(void);
 
     T* Get(const Layer& aLayer, size_t aIndex);
+    size_t NextIndex(size_t aIndex) const;
     T* TryCreate(Layer& aLayer);
     void GetStatistics(nl::Weave::System::Stats::count_t& aNumInUse, nl::Weave::System::Stats::count_t& aHighWatermark);
 
@@ -189,6 +196,18 @@ private:
 
     ObjectArena<void*, N * sizeof(T)> mArena;
 
+#if WEAVE_SYSTEM_CONFIG_USE_OBJECT_POOL_FREE_LIST
+    enum { kLiveWords = (N + 31) / 32 };
+
+    // All of these are valid when zero-initialized, so that pools need no constructor.
+    volatile uint64_t mFreeHead;        /**< Modification count in the upper 32 bits; one more than the first free index below. */
+    volatile unsigned int mNumCarved;   /**< Objects below this index have been allocated at least once. */
+    volatile uint32_t mLive[kLiveWords];
+
+    T* TakeFree(void);
+    static void Recycle(void* aPool, Object& aObject);
+#endif // WEAVE_SYSTEM_CONFIG_USE_OBJECT_POOL_FREE_LIST
+
 #if WEAVE_SYSTEM_CONFIG_PROVIDE_STATISTICS
     void GetNumObjectsInUse(unsigned int aStartIndex, unsigned int& aNumInUse);
     void UpdateHighWatermark(const unsigned int& aCandidate);
@@ -223,6 +242,101 @@ inline T* ObjectPool<T, N>::Get(const Layer& aLayer, size_t aIndex)
     return (lReturn != NULL) && lReturn->IsRetained(aLayer) ? lReturn : NULL;
 }
 
+/**
+ *  @brief
+ *      Returns the first index, not less than \c aIndex, at which an object may be retained, or Size() if there is none.
+ *
+ *  @details
+ *      Iterate over the objects of a pool with:
+ *
+ *          for (size_t i = pool.NextIndex(0); i < pool.Size(); i = pool.NextIndex(i + 1))
+ *
+ *      and Get() each object. Without #WEAVE_SYSTEM_CONFIG_USE_OBJECT_POOL_FREE_LIST this visits every index.
+ */
+template<class T, unsigned int N>
+inline size_t ObjectPool<T, N>::NextIndex(size_t aIndex) const
+{
+#if WEAVE_SYSTEM_CONFIG_USE_OBJECT_POOL_FREE_LIST
+    size_t lWord = aIndex / 32;
+    uint32_t lBits;
+
+    if (aIndex >= N)
+        return N;
+
+    lBits = __atomic_load_n(&mLive[lWord], __ATOMIC_RELAXED) & (~static_cast<uint32_t>(0) << (aIndex % 32));
+
+    while (lBits == 0)
+    {
+        if (++lWord >= kLiveWords)
+            return N;
+
+        lBits = __atomic_load_n(&mLive[lWord], __ATOMIC_RELAXED);
+    }
+
+    return lWord * 32 + static_cast<size_t>(__builtin_ctz(lBits));
+#else // !WEAVE_SYSTEM_CONFIG_USE_OBJECT_POOL_FREE_LIST
+    return aIndex;
+#endif // !WEAVE_SYSTEM_CONFIG_USE_OBJECT_POOL_FREE_LIST
+}
+
+#if WEAVE_SYSTEM_CONFIG_USE_OBJECT_POOL_FREE_LIST
+/**
+ *  @brief
+ *      Takes an object off the free list or, failing that, one that has never been allocated. Returns NULL if there is none.
+ *
+ *  @note
+ *      The free list is a lock-free stack. The modification count in the head makes a compare-and-swap fail if the head was
+ *      popped and pushed back by other threads in the meantime, even if the index is unchanged.
+ */
+template<class T, unsigned int N>
+inline T* ObjectPool<T, N>::TakeFree(void)
+{
+    T* const lObjects = reinterpret_cast<T*>(mArena.uMemory);
+    uint64_t lHead = __atomic_load_n(&mFreeHead, __ATOMIC_ACQUIRE);
+    unsigned int lCarved;
+
+    while (static_cast<uint32_t>(lHead) != 0)
+    {
+        const uint32_t kIndex = static_cast<uint32_t>(lHead) - 1;
+        const uint32_t kNext = __atomic_load_n(&lObjects[kIndex].mNextFree, __ATOMIC_RELAXED);
+        const uint64_t kNewHead = (((lHead >> 32) + 1) << 32) | kNext;
+
+        if (__atomic_compare_exchange_n(&mFreeHead, &lHead, kNewHead, true, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE))
+            return &lObjects[kIndex];
+    }
+
+    lCarved = __atomic_load_n(&mNumCarved, __ATOMIC_RELAXED);
+
+    while (lCarved < N)
+    {
+        if (__atomic_compare_exchange_n(&mNumCarved, &lCarved, lCarved + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            return &lObjects[lCarved];
+    }
+
+    return NULL;
+}
+
+/**
+ *  @brief
+ *      Returns a released object to the free list of \c aPool. Called by Object::Release.
+ */
+template<class T, unsigned int N>
+void ObjectPool<T, N>::Recycle(void* aPool, Object& aObject)
+{
+    ObjectPool<T, N>& lPool = *static_cast<ObjectPool<T, N>*>(aPool);
+    const uint32_t kIndex = static_cast<uint32_t>(static_cast<T*>(&aObject) - reinterpret_cast<T*>(lPool.mArena.uMemory));
+    uint64_t lHead = __atomic_load_n(&lPool.mFreeHead, __ATOMIC_RELAXED);
+
+    __atomic_and_fetch(&lPool.mLive[kIndex / 32], ~(static_cast<uint32_t>(1) << (kIndex % 32)), __ATOMIC_RELAXED);
+
+    do
+    {
+        __atomic_store_n(&aObject.mNextFree, static_cast<uint32_t>(lHead), __ATOMIC_RELAXED);
+    } while (!__atomic_compare_exchange_n(&lPool.mFreeHead, &lHead, (((lHead >> 32) + 1) << 32) | (kIndex + 1), true,
+                                          __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+#endif // WEAVE_SYSTEM_CONFIG_USE_OBJECT_POOL_FREE_LIST
+
 /**
  *  @brief
  *      Tries to initially retain the first object in the pool that is not retained by any layer.
@@ -236,6 +350,36 @@ inline T* ObjectPool<T, N>::TryCreate(Layer& aLayer)
     unsigned int lNumInUse = 0;
 #endif
 
+#if WEAVE_SYSTEM_CONFIG_USE_OBJECT_POOL_FREE_LIST
+    lReturn = TakeFree();
+
+    // An object on the free list is retained by no layer, so this only fails if the object was released without Release().
+    if (lReturn != NULL && lReturn->TryCreate(aLayer, sizeof(T)))
+    {
+        lIndex = static_cast<unsigned int>(lReturn - reinterpret_cast<T*>(mArena.uMemory));
+        lReturn->mPool = this;
+        lReturn->mRecycle = Recycle;
+        __atomic_or_fetch(&mLive[lIndex / 32], static_cast<uint32_t>(1) << (lIndex % 32), __ATOMIC_RELAXED);
+    }
+    else
+    {
+        lReturn = NULL;
+    }
+
+#if WEAVE_SYSTEM_CONFIG_PROVIDE_STATISTICS
+    if (lReturn != NULL)
+    {
+        for (unsigned int lWord = 0; lWord < kLiveWords; lWord++)
+            lNumInUse += static_cast<unsigned int>(__builtin_popcount(__atomic_load_n(&mLive[lWord], __ATOMIC_RELAXED)));
+    }
+    else
+    {
+        lNumInUse = N;
+    }
+
+    UpdateHighWatermark(lNumInUse);
+#endif
+#else // !WEAVE_SYSTEM_CONFIG_USE_OBJECT_POOL_FREE_LIST
     for (lIndex = 0; lIndex < N; ++lIndex)
     {
         T& lObject = reinterpret_cast<T*>(mArena.uMemory)[lIndex];
@@ -262,6 +406,7 @@ inline T* ObjectPool<T, N>::TryCreate(Layer& aLayer)
 
     UpdateHighWatermark(lNumInUse);
 #endif
+#endif // !WEAVE_SYSTEM_CONFIG_USE_OBJECT_POOL_FREE_LIST
 
     return lReturn;
 }
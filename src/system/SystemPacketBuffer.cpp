@@ -67,7 +67,62 @@ namespace System {
 
 static BufferPoolElement sBufferPool[WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC];
 
-PacketBuffer* PacketBuffer::sFreeList = PacketBuffer::BuildFreeList();
+#if WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES
+
+typedef union
+{
+    PacketBuffer Header;
+    uint8_t Block[WEAVE_SYSTEM_PACKETBUFFER_HEADER_SIZE + WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SMALL_CAPACITY];
+} SmallBufferPoolElement;
+
+typedef union
+{
+    PacketBuffer Header;
+    uint8_t Block[WEAVE_SYSTEM_PACKETBUFFER_HEADER_SIZE + WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MEDIUM_CAPACITY];
+} MediumBufferPoolElement;
+
+static SmallBufferPoolElement sSmallBufferPool[WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SMALL_MAXALLOC];
+static MediumBufferPoolElement sMediumBufferPool[WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MEDIUM_MAXALLOC];
+
+/**
+ *  The backing storage of a packet buffer size class.
+ */
+struct BufferPoolClass
+{
+    uint8_t* mStorage;      /**< The first element of the pool. */
+    size_t mElementSize;    /**< The distance between consecutive elements. */
+    size_t mNumElements;    /**< The number of elements in the pool. */
+    uint16_t mCapacity;     /**< The allocation size of each buffer, not including the PacketBuffer header. */
+};
+
+#define BUFFER_POOL_CLASS(aPool, aNumElements) \
+    { aPool[0].Block, sizeof(aPool[0]), aNumElements, sizeof(aPool[0].Block) - WEAVE_SYSTEM_PACKETBUFFER_HEADER_SIZE }
+
+static const BufferPoolClass sBufferPoolClasses[] =
+{
+    BUFFER_POOL_CLASS(sSmallBufferPool,  WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SMALL_MAXALLOC),
+    BUFFER_POOL_CLASS(sMediumBufferPool, WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MEDIUM_MAXALLOC),
+    BUFFER_POOL_CLASS(sBufferPool,       WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC)
+};
+
+// Number of the statistics entry that counts the buffers of a size class in use.
+#define PACKETBUFFER_SIZE_CLASS_STATS_ENTRY(aSizeClass) (nl::Weave::System::Stats::kSystemLayer_NumSmallPacketBufs + (aSizeClass))
+
+PacketBuffer* PacketBuffer::sFreeList[PacketBuffer::kNumSizeClasses] =
+{
+    PacketBuffer::BuildFreeList(PacketBuffer::kSizeClass_Small),
+    PacketBuffer::BuildFreeList(PacketBuffer::kSizeClass_Medium),
+    PacketBuffer::BuildFreeList(PacketBuffer::kSizeClass_Full)
+};
+
+#else // !WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES
+
+PacketBuffer* PacketBuffer::sFreeList[PacketBuffer::kNumSizeClasses] =
+{
+    PacketBuffer::BuildFreeList(PacketBuffer::kSizeClass_Full)
+};
+
+#endif // !WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES
 
 #if !WEAVE_SYSTEM_CONFIG_NO_LOCKING
 static Mutex sBufferPoolMutex;
@@ -86,6 +141,190 @@ static Mutex sBufferPoolMutex;
 #define UNLOCK_BUF_POOL()   do { } while (0)
 #endif // !defined(UNLOCK_BUF_POOL)
 
+#if WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE
+
+/**
+ *  A thread's cache of free packet buffers.
+ *
+ *  The cache is only accessed by its owning thread, so allocations and frees served by it take no lock. Buffers move
+ *  between the cache and the shared free lists in batches, under the pool lock, when the cache for a size class runs empty
+ *  or full, and all cached buffers are returned to the free lists when the owning thread exits.
+ */
+struct PacketBufferThreadCache
+{
+    PacketBuffer* mBuffers[PacketBuffer::kNumSizeClasses][WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE_SIZE];
+    uint16_t mCount[PacketBuffer::kNumSizeClasses];
+    bool mRegistered;
+
+    PacketBuffer* Get(unsigned int aSizeClass);
+    void Put(unsigned int aSizeClass, PacketBuffer* aPacket);
+
+private:
+    enum
+    {
+        kTransferBatchSize = WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE_SIZE / 2
+    };
+
+    void Refill(unsigned int aSizeClass);
+    void Drain(unsigned int aSizeClass, uint16_t aCount);
+    void Register(void);
+
+    static void LockPool(void);
+    static void CreateThreadExitKey(void);
+    static void HandleThreadExit(void* aCache);
+};
+
+static __thread PacketBufferThreadCache sThreadCache;
+
+static pthread_key_t sThreadCacheExitKey;
+static pthread_once_t sThreadCacheExitKeyOnce = PTHREAD_ONCE_INIT;
+
+static Stats::PacketBufferCacheCounters sThreadCacheCounters;
+
+#if WEAVE_SYSTEM_CONFIG_PROVIDE_STATISTICS
+// Buffers are handed out and taken back by the thread caches without holding the pool lock, so the packet buffer
+// statistics are updated atomically.
+#define PACKETBUFFER_STATS_INCREMENT(entry) \
+    do { \
+        nl::Weave::System::Stats::count_t new_value = __sync_add_and_fetch(&nl::Weave::System::Stats::GetResourcesInUse()[entry], 1); \
+        nl::Weave::System::Stats::count_t *high_value = &nl::Weave::System::Stats::GetHighWatermarks()[entry]; \
+        nl::Weave::System::Stats::count_t old_value = __atomic_load_n(high_value, __ATOMIC_RELAXED); \
+        while (old_value < new_value && \
+               !__atomic_compare_exchange_n(high_value, &old_value, new_value, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) \
+        { \
+        } \
+    } while (0)
+
+#define PACKETBUFFER_STATS_DECREMENT(entry) \
+    do { \
+        __sync_sub_and_fetch(&nl::Weave::System::Stats::GetResourcesInUse()[entry], 1); \
+    } while (0)
+#else // !WEAVE_SYSTEM_CONFIG_PROVIDE_STATISTICS
+#define PACKETBUFFER_STATS_INCREMENT(entry)
+#define PACKETBUFFER_STATS_DECREMENT(entry)
+#endif // !WEAVE_SYSTEM_CONFIG_PROVIDE_STATISTICS
+
+/**
+ *  Take a free buffer of a size class from the cache, refilling the cache from the shared free list if it is empty.
+ *
+ *  @return A free buffer, or \c NULL if both the cache and the shared free list of the size class are empty.
+ */
+PacketBuffer* PacketBufferThreadCache::Get(unsigned int aSizeClass)
+{
+    PacketBuffer* lPacket = NULL;
+
+    if (mCount[aSizeClass] == 0)
+        Refill(aSizeClass);
+
+    if (mCount[aSizeClass] > 0)
+    {
+        lPacket = mBuffers[aSizeClass][--mCount[aSizeClass]];
+        PACKETBUFFER_STATS_DECREMENT(nl::Weave::System::Stats::kSystemLayer_NumPacketBufsInThreadCaches);
+    }
+
+    return lPacket;
+}
+
+/**
+ *  Return a free buffer of a size class to the cache, first draining part of the cache to the shared free list if it is full.
+ */
+void PacketBufferThreadCache::Put(unsigned int aSizeClass, PacketBuffer* aPacket)
+{
+    if (!mRegistered)
+        Register();
+
+    if (mCount[aSizeClass] == WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE_SIZE)
+        Drain(aSizeClass, kTransferBatchSize);
+
+    mBuffers[aSizeClass][mCount[aSizeClass]++] = aPacket;
+    PACKETBUFFER_STATS_INCREMENT(nl::Weave::System::Stats::kSystemLayer_NumPacketBufsInThreadCaches);
+}
+
+void PacketBufferThreadCache::Refill(unsigned int aSizeClass)
+{
+    PacketBuffer*& lFreeList = PacketBuffer::sFreeList[aSizeClass];
+
+    if (!mRegistered)
+        Register();
+
+    LockPool();
+
+    while (mCount[aSizeClass] < kTransferBatchSize && lFreeList != NULL)
+    {
+        PacketBuffer* lPacket = lFreeList;
+
+        lFreeList = static_cast<PacketBuffer*>(lPacket->next);
+        mBuffers[aSizeClass][mCount[aSizeClass]++] = lPacket;
+        PACKETBUFFER_STATS_INCREMENT(nl::Weave::System::Stats::kSystemLayer_NumPacketBufsInThreadCaches);
+    }
+
+    sThreadCacheCounters.mRefills++;
+
+    UNLOCK_BUF_POOL();
+}
+
+void PacketBufferThreadCache::Drain(unsigned int aSizeClass, uint16_t aCount)
+{
+    PacketBuffer*& lFreeList = PacketBuffer::sFreeList[aSizeClass];
+
+    LockPool();
+
+    while (aCount-- > 0 && mCount[aSizeClass] > 0)
+    {
+        PacketBuffer* lPacket = mBuffers[aSizeClass][--mCount[aSizeClass]];
+
+        lPacket->next = lFreeList;
+        lFreeList = lPacket;
+        PACKETBUFFER_STATS_DECREMENT(nl::Weave::System::Stats::kSystemLayer_NumPacketBufsInThreadCaches);
+    }
+
+    sThreadCacheCounters.mDrains++;
+
+    UNLOCK_BUF_POOL();
+}
+
+/**
+ *  Arrange for the cache to be drained when its owning thread exits.
+ */
+void PacketBufferThreadCache::Register(void)
+{
+    pthread_once(&sThreadCacheExitKeyOnce, CreateThreadExitKey);
+    pthread_setspecific(sThreadCacheExitKey, this);
+    mRegistered = true;
+}
+
+/**
+ *  Acquire the pool lock, counting the acquisitions that had to wait for another thread.
+ */
+void PacketBufferThreadCache::LockPool(void)
+{
+    if (!sBufferPoolMutex.TryLock())
+    {
+        sBufferPoolMutex.Lock();
+        sThreadCacheCounters.mPoolContentions++;
+    }
+}
+
+void PacketBufferThreadCache::CreateThreadExitKey(void)
+{
+    pthread_key_create(&sThreadCacheExitKey, HandleThreadExit);
+}
+
+void PacketBufferThreadCache::HandleThreadExit(void* aCache)
+{
+    PacketBufferThreadCache* lCache = static_cast<PacketBufferThreadCache*>(aCache);
+
+    for (unsigned int lSizeClass = 0; lSizeClass < PacketBuffer::kNumSizeClasses; lSizeClass++)
+    {
+        if (lCache->mCount[lSizeClass] > 0)
+            lCache->Drain(lSizeClass, WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE_SIZE);
+    }
+
+    lCache->mRegistered = false;
+}
+
+#endif // WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE
+
 #endif // !WEAVE_SYSTEM_CONFIG_USE_LWIP
 
 /**
@@ -301,6 +540,57 @@ void PacketBuffer::CompactHead()
     }
 }
 
+/**
+ * Move just enough data from subsequent buffers in the chain into the current buffer for it to hold the given length.
+ *
+ *  Unlike CompactHead(), data beyond the requested length is left where it is, and the data within the current buffer is moved
+ *  to the front of the buffer only when the space after it is too small. Subsequent buffers that are emptied are removed from the
+ *  chain and freed. The current buffer must be the head of the chain.
+ *
+ *  @param[in] aLength - the number of bytes of data the current buffer must hold.
+ *
+ *  @return \c true if the current buffer holds at least \c aLength bytes of data, \c false if the chain holds fewer bytes or
+ *      they do not fit in the current buffer.
+ */
+bool PacketBuffer::EnsureContiguous(uint16_t aLength)
+{
+    uint8_t* const kStart = reinterpret_cast<uint8_t*>(this) + WEAVE_SYSTEM_PACKETBUFFER_HEADER_SIZE;
+
+    if (this->len >= aLength)
+        return true;
+
+    if (aLength > this->AllocSize())
+        return false;
+
+    if (static_cast<uint16_t>(aLength - this->len) > this->AvailableDataLength())
+    {
+        memmove(kStart, this->payload, this->len);
+        this->payload = kStart;
+    }
+
+    while (this->len < aLength && this->next != NULL)
+    {
+        PacketBuffer& lNextPacket = *static_cast<PacketBuffer*>(this->next);
+        VerifyOrDieWithMsg(lNextPacket.ref == 1, WeaveSystemLayer, "next buffer %p is not exclusive to this chain", &lNextPacket);
+
+        uint16_t lMoveLength = lNextPacket.len;
+        if (lMoveLength > aLength - this->len)
+            lMoveLength = aLength - this->len;
+
+        memcpy(static_cast<uint8_t*>(this->payload) + this->len, lNextPacket.payload, lMoveLength);
+
+        lNextPacket.payload = (uint8_t *) lNextPacket.payload + lMoveLength;
+        this->len += lMoveLength;
+        lNextPacket.len -= lMoveLength;
+        lNextPacket.tot_len -= lMoveLength;
+
+        if (lNextPacket.len == 0)
+            this->next = this->FreeHead(&lNextPacket);
+    }
+
+    return this->len >= aLength;
+}
+
 /**
  * Adjust the current buffer to indicate the amount of data consumed.
  *
@@ -419,11 +709,13 @@ void PacketBuffer::AddRef()
 {
 #if WEAVE_SYSTEM_CONFIG_USE_LWIP
     pbuf_ref(this);
-#else // !WEAVE_SYSTEM_CONFIG_USE_LWIP
+#elif WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE
+    __sync_add_and_fetch(&this->ref, 1);
+#else // !WEAVE_SYSTEM_CONFIG_USE_LWIP && !WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE
     LOCK_BUF_POOL();
     ++this->ref;
     UNLOCK_BUF_POOL();
-#endif // !WEAVE_SYSTEM_CONFIG_USE_LWIP
+#endif // !WEAVE_SYSTEM_CONFIG_USE_LWIP && !WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE
 }
 
 /**
@@ -461,17 +753,46 @@ PacketBuffer* PacketBuffer::NewWithAvailableSize(uint16_t aReservedSize, size_t
 
     static_cast<void>(lBlockSize);
 
+    // Take a buffer of the smallest size class that fits, falling back to larger classes when its pool is exhausted.
+    lPacket = NULL;
+
+#if WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE
+
+    for (unsigned int lSizeClass = SizeClassFor(lAllocSize); lSizeClass < kNumSizeClasses; lSizeClass++)
+    {
+        lPacket = sThreadCache.Get(lSizeClass);
+        if (lPacket != NULL)
+        {
+            PACKETBUFFER_STATS_INCREMENT(nl::Weave::System::Stats::kSystemLayer_NumPacketBufs);
+#if WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES
+            PACKETBUFFER_STATS_INCREMENT(PACKETBUFFER_SIZE_CLASS_STATS_ENTRY(lSizeClass));
+#endif // WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES
+            break;
+        }
+    }
+
+#else // !WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE
+
     LOCK_BUF_POOL();
 
-    lPacket = sFreeList;
-    if (lPacket != NULL)
+    for (unsigned int lSizeClass = SizeClassFor(lAllocSize); lSizeClass < kNumSizeClasses; lSizeClass++)
     {
-        sFreeList = static_cast<PacketBuffer*>(lPacket->next);
-        SYSTEM_STATS_INCREMENT(nl::Weave::System::Stats::kSystemLayer_NumPacketBufs);
+        lPacket = sFreeList[lSizeClass];
+        if (lPacket != NULL)
+        {
+            sFreeList[lSizeClass] = static_cast<PacketBuffer*>(lPacket->next);
+            SYSTEM_STATS_INCREMENT(nl::Weave::System::Stats::kSystemLayer_NumPacketBufs);
+#if WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES
+            SYSTEM_STATS_INCREMENT(PACKETBUFFER_SIZE_CLASS_STATS_ENTRY(lSizeClass));
+#endif // WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES
+            break;
+        }
     }
 
     UNLOCK_BUF_POOL();
 
+#endif // !WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE
+
 #else // !WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC
 
     lPacket = reinterpret_cast<PacketBuffer*>(malloc(lBlockSize));
@@ -570,7 +891,34 @@ void PacketBuffer::Free(PacketBuffer* aPacket)
         SYSTEM_STATS_UPDATE_LWIP_PBUF_COUNTS();
     }
 
-#else // !WEAVE_SYSTEM_CONFIG_USE_LWIP
+#elif WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE
+
+    while (aPacket != NULL)
+    {
+        PacketBuffer* lNextPacket = static_cast<PacketBuffer*>(aPacket->next);
+        const uint16_t lOldRef = __sync_fetch_and_sub(&aPacket->ref, 1);
+
+        VerifyOrDieWithMsg(lOldRef > 0, WeaveSystemLayer, "SystemPacketBuffer::Free: aPacket->ref = 0");
+
+        if (lOldRef == 1)
+        {
+            const unsigned int lSizeClass = SizeClassFor(aPacket->AllocSize());
+
+            PACKETBUFFER_STATS_DECREMENT(nl::Weave::System::Stats::kSystemLayer_NumPacketBufs);
+#if WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES
+            PACKETBUFFER_STATS_DECREMENT(PACKETBUFFER_SIZE_CLASS_STATS_ENTRY(lSizeClass));
+#endif // WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES
+            aPacket->Clear();
+            sThreadCache.Put(lSizeClass, aPacket);
+            aPacket = lNextPacket;
+        }
+        else
+        {
+            aPacket = NULL;
+        }
+    }
+
+#else // !WEAVE_SYSTEM_CONFIG_USE_LWIP && !WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE
 
     LOCK_BUF_POOL();
 
@@ -584,11 +932,17 @@ void PacketBuffer::Free(PacketBuffer* aPacket)
         if (aPacket->ref == 0)
         {
             SYSTEM_STATS_DECREMENT(nl::Weave::System::Stats::kSystemLayer_NumPacketBufs);
-            aPacket->Clear();
 #if WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC
-            aPacket->next = sFreeList;
-            sFreeList = aPacket;
+            const unsigned int lSizeClass = SizeClassFor(aPacket->AllocSize());
+
+#if WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES
+            SYSTEM_STATS_DECREMENT(PACKETBUFFER_SIZE_CLASS_STATS_ENTRY(lSizeClass));
+#endif // WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES
+            aPacket->Clear();
+            aPacket->next = sFreeList[lSizeClass];
+            sFreeList[lSizeClass] = aPacket;
 #else // !WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC
+            aPacket->Clear();
             free(aPacket);
 #endif // !WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC
             aPacket = lNextPacket;
@@ -601,7 +955,7 @@ void PacketBuffer::Free(PacketBuffer* aPacket)
 
     UNLOCK_BUF_POOL();
 
-#endif // !WEAVE_SYSTEM_CONFIG_USE_LWIP
+#endif // !WEAVE_SYSTEM_CONFIG_USE_LWIP && !WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE
 }
 
 /**
@@ -639,7 +993,8 @@ PacketBuffer* PacketBuffer::FreeHead(PacketBuffer* aPacket)
 
 /**
  * Copy the given buffer to a right-sized buffer if applicable.
- * This function is a no-op for sockets.
+ * On sockets, this function is a no-op unless #WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES is enabled, in which case a single,
+ * unshared buffer is copied into the smallest size class that holds its reserved space and data.
  *
  *  @param[in] aPacket - buffer or buffer chain.
  *
@@ -656,16 +1011,54 @@ PacketBuffer* PacketBuffer::RightSize(PacketBuffer *aPacket)
 
         WeaveLogProgress(WeaveSystemLayer, "PacketBuffer: RightSize Copied");
     }
+#elif WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES
+    if (aPacket != NULL && aPacket->next == NULL && aPacket->ref == 1)
+    {
+        const uint16_t lReservedSize = aPacket->ReservedSize();
+        const uint16_t lDataLength = aPacket->DataLength();
+
+        if (SizeClassFor(lReservedSize + lDataLength) < SizeClassFor(aPacket->AllocSize()))
+        {
+            lNewPacket = PacketBuffer::NewWithAvailableSize(lReservedSize, lDataLength);
+
+            if (lNewPacket != NULL && lNewPacket->AllocSize() < aPacket->AllocSize())
+            {
+                memcpy(lNewPacket->Start(), aPacket->Start(), lDataLength);
+                lNewPacket->SetDataLength(lDataLength);
+                PacketBuffer::Free(aPacket);
+
+                WeaveLogProgress(WeaveSystemLayer, "PacketBuffer: RightSize Copied");
+            }
+            else
+            {
+                // Only larger buffers are available; keep the original.
+                PacketBuffer::Free(lNewPacket);
+                lNewPacket = aPacket;
+            }
+        }
+    }
 #endif
     return lNewPacket;
 }
 
 #if !WEAVE_SYSTEM_CONFIG_USE_LWIP && WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC
 
-PacketBuffer* PacketBuffer::BuildFreeList()
+PacketBuffer* PacketBuffer::BuildFreeList(unsigned int aSizeClass)
 {
     PacketBuffer* lHead = NULL;
 
+#if WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES
+    const BufferPoolClass& lPool = sBufferPoolClasses[aSizeClass];
+
+    for (size_t i = 0; i < lPool.mNumElements; i++)
+    {
+        PacketBuffer* lCursor = reinterpret_cast<PacketBuffer*>(lPool.mStorage + i * lPool.mElementSize);
+        lCursor->next = lHead;
+        lCursor->ref = 0;
+        lCursor->alloc_size = lPool.mCapacity;
+        lHead = lCursor;
+    }
+#else // !WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES
     for (int i = 0; i < WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC; i++)
     {
         PacketBuffer* lCursor = &sBufferPool[i].Header;
@@ -673,12 +1066,60 @@ PacketBuffer* PacketBuffer::BuildFreeList()
         lCursor->ref = 0;
         lHead = lCursor;
     }
+#endif // !WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES
 
-    Mutex::Init(sBufferPoolMutex);
+    // The free lists are built in size class order, so initialize the pool lock with the first one.
+    if (aSizeClass == 0)
+    {
+        Mutex::Init(sBufferPoolMutex);
+    }
 
     return lHead;
 }
 
+/**
+ *  Get the smallest size class whose buffers can hold \c aAllocSize bytes of reserved and available space.
+ *
+ *  @note The caller must ensure that \c aAllocSize does not exceed #WEAVE_SYSTEM_CONFIG_PACKETBUFFER_CAPACITY_MAX.
+ */
+unsigned int PacketBuffer::SizeClassFor(size_t aAllocSize)
+{
+#if WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES
+    unsigned int lSizeClass = kSizeClass_Small;
+
+    while (lSizeClass < kSizeClass_Full &&
+           aAllocSize > sBufferPoolClasses[lSizeClass].mCapacity)
+    {
+        lSizeClass++;
+    }
+
+    return lSizeClass;
+#else // !WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES
+    static_cast<void>(aAllocSize);
+    return kSizeClass_Full;
+#endif // !WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES
+}
+
+#if WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE
+
+namespace Stats {
+
+/**
+ *  Get the cumulative counts of transfers between the per-thread packet buffer caches and the shared pool.
+ *
+ *  @param[out] aCounters   The current counts.
+ */
+void GetPacketBufferCacheCounters(PacketBufferCacheCounters &aCounters)
+{
+    LOCK_BUF_POOL();
+    aCounters = sThreadCacheCounters;
+    UNLOCK_BUF_POOL();
+}
+
+} // namespace Stats
+
+#endif // WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE
+
 #endif //  !WEAVE_SYSTEM_CONFIG_USE_LWIP && WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC
 
 } // namespace System
@@ -55,9 +55,9 @@ struct pbuf
     uint16_t tot_len;
     uint16_t len;
     uint16_t ref;
-#if WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC == 0
+#if WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC == 0 || WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES
     uint16_t alloc_size;
-#endif // WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC == 0
+#endif // WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC == 0 || WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES
 };
 #endif // !WEAVE_SYSTEM_CONFIG_USE_LWIP
 
@@ -115,6 +115,7 @@ public:
     void AddToEnd(PacketBuffer* aPacket);
     PacketBuffer* DetachTail(void);
     void CompactHead(void);
+    bool EnsureContiguous(uint16_t aLength);
     PacketBuffer* Consume(uint16_t aConsumeLength);
     void ConsumeHead(uint16_t aConsumeLength);
     bool EnsureReservedSize(uint16_t aReservedSize);
@@ -135,9 +136,25 @@ public:
 
 private:
 #if !WEAVE_SYSTEM_CONFIG_USE_LWIP && WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC
-    static PacketBuffer* sFreeList;
+    enum
+    {
+#if WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES
+        kSizeClass_Small,
+        kSizeClass_Medium,
+#endif // WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES
+        kSizeClass_Full,
 
-    static PacketBuffer* BuildFreeList(void);
+        kNumSizeClasses
+    };
+
+    static PacketBuffer* sFreeList[kNumSizeClasses];
+
+    static PacketBuffer* BuildFreeList(unsigned int aSizeClass);
+    static unsigned int SizeClassFor(size_t aAllocSize);
+
+#if WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE
+    friend struct PacketBufferThreadCache;
+#endif // WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE
 #endif // !WEAVE_SYSTEM_CONFIG_USE_LWIP && WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC
 
     void Clear(void);
@@ -225,12 +242,12 @@ inline size_t PacketBuffer::AllocSize(void) const
     return LWIP_MEM_ALIGN_SIZE(PBUF_POOL_BUFSIZE) - WEAVE_SYSTEM_PACKETBUFFER_HEADER_SIZE;
 #endif // !LWIP_PBUF_FROM_CUSTOM_POOLS
 #else // !WEAVE_SYSTEM_CONFIG_USE_LWIP
-#if WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC == 0
+#if WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC == 0 || WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES
     return static_cast<size_t>(this->alloc_size);
-#else // WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC != 0
+#else // WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC != 0 && !WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES
     extern BufferPoolElement gDummyBufferPoolElement;
     return sizeof(gDummyBufferPoolElement.Block) - WEAVE_SYSTEM_PACKETBUFFER_HEADER_SIZE;
-#endif // WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC != 0
+#endif // WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC != 0 && !WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES
 #endif // !WEAVE_SYSTEM_CONFIG_USE_LWIP
 }
 
@@ -46,6 +46,14 @@ static const Label sStatsStrings[nl::Weave::System::Stats::kNumEntries] =
 #undef LWIP_PBUF_MEMPOOL
 #else
     "SystemLayer_NumPacketBufs",
+#if WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES
+    "SystemLayer_NumSmallPacketBufs",
+    "SystemLayer_NumMediumPacketBufs",
+    "SystemLayer_NumFullPacketBufs",
+#endif
+#if WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE
+    "SystemLayer_NumPacketBufsInThreadCaches",
+#endif
 #endif
     "SystemLayer_NumTimersInUse",
 #if INET_CONFIG_NUM_RAW_ENDPOINTS
@@ -55,6 +55,14 @@ enum
 #undef LWIP_PBUF_MEMPOOL
 #else
     kSystemLayer_NumPacketBufs,
+#if WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES
+    kSystemLayer_NumSmallPacketBufs,
+    kSystemLayer_NumMediumPacketBufs,
+    kSystemLayer_NumFullPacketBufs,
+#endif
+#if WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE
+    kSystemLayer_NumPacketBufsInThreadCaches,
+#endif
 #endif
     kSystemLayer_NumTimers,
 #if INET_CONFIG_NUM_RAW_ENDPOINTS
@@ -131,6 +139,20 @@ count_t *GetHighWatermarks(void);
 void UpdateLwipPbufCounts(void);
 #endif
 
+#if WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE
+/**
+ *  Cumulative counts of the transfers between the per-thread packet buffer caches and the shared pool.
+ */
+struct PacketBufferCacheCounters
+{
+    uint32_t mRefills;          /**< Number of refills of an empty thread cache from the shared pool. */
+    uint32_t mDrains;           /**< Number of drains of a full, or exiting, thread cache to the shared pool. */
+    uint32_t mPoolContentions;  /**< Number of refills and drains that found the pool lock held by another thread. */
+};
+
+void GetPacketBufferCacheCounters(PacketBufferCacheCounters &aCounters);
+#endif
+
 typedef const char *Label;
 const Label *GetStrings(void);
 
@@ -125,9 +125,9 @@ bool Timer::IsEarlierEpoch(const Timer::Epoch &inFirst, const Timer::Epoch &inSe
  */
 Error Timer::Start(uint32_t aDelayMilliseconds, OnCompleteFunct aOnComplete, void* aAppState)
 {
-#if WEAVE_SYSTEM_CONFIG_USE_LWIP
+#if WEAVE_SYSTEM_CONFIG_USE_LWIP || WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
     Layer& lLayer = this->SystemLayer();
-#endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
+#endif // WEAVE_SYSTEM_CONFIG_USE_LWIP || WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
 
     WEAVE_SYSTEM_FAULT_INJECT(FaultInjection::kFault_TimeoutImmediate, aDelayMilliseconds = 0);
 
@@ -138,7 +138,25 @@ Error Timer::Start(uint32_t aDelayMilliseconds, OnCompleteFunct aOnComplete, voi
         WeaveDie();
     }
 
+#if WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+#if WEAVE_SYSTEM_CONFIG_USE_LWIP
+    Epoch lNextEpoch;
+    const bool lIsEarliest = !lLayer.mTimerWheel.GetNextEpoch(lNextEpoch) ||
+        this->IsEarlierEpoch(this->mAwakenEpoch, lNextEpoch);
+#endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
+
+    lLayer.mTimerWheel.Insert(*this);
+
 #if WEAVE_SYSTEM_CONFIG_USE_LWIP
+    // As with the sorted list below, (re-)start the platform timer if this is the new earliest timer, unless expired timers are
+    // being processed, in which case HandleExpiredTimers() re-starts it.
+    if (lIsEarliest && !lLayer.mTimerComplete)
+    {
+        lLayer.StartPlatformTimer(aDelayMilliseconds);
+    }
+#endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
+
+#elif WEAVE_SYSTEM_CONFIG_USE_LWIP
     // add to the sorted list of timers. Earliest timer appears first.
     if (lLayer.mTimerList == NULL ||
         this->IsEarlierEpoch(this->mAwakenEpoch, lLayer.mTimerList->mAwakenEpoch))
@@ -172,7 +190,7 @@ Error Timer::Start(uint32_t aDelayMilliseconds, OnCompleteFunct aOnComplete, voi
         this->mNextTimer = lTimer->mNextTimer;
         lTimer->mNextTimer = this;
     }
-#endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
+#endif // WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL || WEAVE_SYSTEM_CONFIG_USE_LWIP
 
     return WEAVE_SYSTEM_NO_ERROR;
 }
@@ -184,6 +202,9 @@ Error Timer::ScheduleWork(OnCompleteFunct aOnComplete, void* aAppState)
 
     this->AppState = aAppState;
     this->mAwakenEpoch = Timer::GetCurrentEpoch();
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS && WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+    this->mLinkState = kLinkState_Detached;
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS && WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
     if (!__sync_bool_compare_and_swap(&this->OnComplete, NULL, aOnComplete))
     {
         WeaveDie();
@@ -193,6 +214,18 @@ Error Timer::ScheduleWork(OnCompleteFunct aOnComplete, void* aAppState)
     err = lLayer.PostEvent(*this, Weave::System::kEvent_ScheduleWork, 0);
 #endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
 #if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+#if WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+    // ScheduleWork may be called from any thread, so the timer is pushed onto the layer's scheduled work list rather than into the
+    // timing wheel. The list is drained by HandleSelectResult().
+    Timer* lHead;
+
+    do
+    {
+        lHead = lLayer.mScheduledWork;
+        this->mNextTimer = lHead;
+    } while (!__sync_bool_compare_and_swap(&lLayer.mScheduledWork, lHead, this));
+#endif // WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+
     lLayer.WakeSelect();
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
@@ -206,9 +239,9 @@ Error Timer::ScheduleWork(OnCompleteFunct aOnComplete, void* aAppState)
  */
 Error Timer::Cancel()
 {
-#if WEAVE_SYSTEM_CONFIG_USE_LWIP
+#if WEAVE_SYSTEM_CONFIG_USE_LWIP || WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
     Layer& lLayer = this->SystemLayer();
-#endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
+#endif // WEAVE_SYSTEM_CONFIG_USE_LWIP || WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
     OnCompleteFunct lOnComplete = this->OnComplete;
 
     // Check if the timer is armed
@@ -219,7 +252,26 @@ Error Timer::Cancel()
     // Since this thread changed the state of OnComplete, release the timer.
     this->AppState = NULL;
 
-#if WEAVE_SYSTEM_CONFIG_USE_LWIP
+#if WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+    switch (this->mLinkState)
+    {
+    case kLinkState_Wheel:
+        lLayer.mTimerWheel.Remove(*this);
+        break;
+
+    case kLinkState_Expired:
+        lLayer.mTimerWheel.RemoveMatch(*this);
+        this->mLinkState = kLinkState_Detached;
+        // Fall through
+
+    case kLinkState_Detached:
+        // The timer is still linked into a batch of timers awaiting completion, which releases it. See CompleteTimers().
+        ExitNow();
+
+    default:
+        break;
+    }
+#elif WEAVE_SYSTEM_CONFIG_USE_LWIP
     if (lLayer.mTimerList)
     {
         if (this == lLayer.mTimerList)
@@ -244,7 +296,7 @@ Error Timer::Cancel()
 
         this->mNextTimer = NULL;
     }
-#endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
+#endif // WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL || WEAVE_SYSTEM_CONFIG_USE_LWIP
 
     this->Release();
 exit:
@@ -295,6 +347,35 @@ exit:
  */
 Error Timer::HandleExpiredTimers(Layer& aLayer)
 {
+#if WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+    Epoch currentEpoch = Timer::GetCurrentEpoch();
+    Epoch nextEpoch;
+
+    // Collect all timers expired as of now in one batch; timers started by the completion callbacks are left in the wheel for the
+    // next expiration window. The platform timer API has MSEC resolution so expire any timer with less than 1 msec remaining.
+    aLayer.mTimerComplete = true;
+    CompleteTimers(aLayer, aLayer.mTimerWheel.CollectExpired(currentEpoch + 1));
+    aLayer.mTimerComplete = false;
+
+    if (aLayer.mTimerWheel.GetNextEpoch(nextEpoch))
+    {
+        // timers still exist so restart the platform timer.
+        uint64_t delayMilliseconds = 0ULL;
+
+        currentEpoch = Timer::GetCurrentEpoch();
+
+        if (currentEpoch < nextEpoch)
+        {
+            delayMilliseconds = nextEpoch - currentEpoch;
+        }
+
+        VerifyOrDie(delayMilliseconds <= UINT32_MAX);
+
+        aLayer.StartPlatformTimer(static_cast<uint32_t>(delayMilliseconds));
+    }
+
+    return WEAVE_SYSTEM_NO_ERROR;
+#else // !WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
     size_t timersHandled = 0;
 
     // Expire each timer in turn until an unexpired timer is reached or the timerlist is emptied.  We set the current expiration
@@ -346,9 +427,314 @@ Error Timer::HandleExpiredTimers(Layer& aLayer)
     }
 
     return WEAVE_SYSTEM_NO_ERROR;
+#endif // !WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
 }
 #endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
 
+#if WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+/**
+ *  Completes a batch of timers that are no longer in the timing wheel.
+ *
+ *  @brief
+ *      Each timer in the list, linked through mNextTimer, is either completed or, if it was cancelled while awaiting completion,
+ *      released. The remainder of the batch is kept in Layer::mCompletingTimers while callbacks run, so that Layer::CancelTimer()
+ *      can still find scheduled work that has not been completed yet.
+ *
+ *  @param[in]  aLayer      The layer owning the timers.
+ *  @param[in]  aTimerList  The first timer of the batch, or NULL.
+ */
+void Timer::CompleteTimers(Layer& aLayer, Timer* aTimerList)
+{
+    aLayer.mCompletingTimers = aTimerList;
+
+    while (aLayer.mCompletingTimers != NULL)
+    {
+        Timer& lTimer = *aLayer.mCompletingTimers;
+
+        aLayer.mCompletingTimers = lTimer.mNextTimer;
+        lTimer.mNextTimer = NULL;
+
+        if (lTimer.mLinkState == kLinkState_Expired)
+        {
+            aLayer.mTimerWheel.RemoveMatch(lTimer);
+        }
+
+        lTimer.mLinkState = kLinkState_None;
+
+        if (lTimer.OnComplete == NULL)
+        {
+            lTimer.Release();
+        }
+        else
+        {
+            lTimer.HandleComplete();
+        }
+    }
+}
+
+/**
+ *  Resets the timing wheel to an empty state.
+ *
+ *  @param[in]  aCurrentEpoch   The current epoch, from which the wheel starts turning.
+ */
+void TimerWheel::Init(Timer::Epoch aCurrentEpoch)
+{
+    memset(mSlots, 0, sizeof(mSlots));
+    memset(mMatches, 0, sizeof(mMatches));
+
+    mCurrentTick = TickOf(aCurrentEpoch);
+    mNextEpoch = 0;
+    mCount = 0;
+    mNextEpochValid = false;
+}
+
+size_t TimerWheel::MatchIndex(Timer::OnCompleteFunct aOnComplete, void* aAppState)
+{
+    uintptr_t lHash = reinterpret_cast<uintptr_t>(aOnComplete) ^ reinterpret_cast<uintptr_t>(aAppState);
+
+    // Mix the pointer bits so that aligned, closely allocated application state objects spread over the buckets.
+    lHash ^= lHash >> 16;
+    lHash *= 0x45d9f3bU;
+    lHash ^= lHash >> 16;
+
+    return static_cast<size_t>(lHash & kSlotMask);
+}
+
+/**
+ *  Links an armed timer into the slot covering its expiration time and into the callback index.
+ *
+ *  @param[in]  aTimer  The timer, whose expiration time, completion function and application state are set.
+ */
+void TimerWheel::Insert(Timer& aTimer)
+{
+    Timer::Epoch lTick = TickOf(aTimer.mAwakenEpoch);
+
+    // A timer due before the tick the wheel has already turned to, e.g. one started with no delay by a completion callback, goes
+    // into the current slot; otherwise the next pass would not reach its slot until a full revolution later.
+    if (lTick < mCurrentTick)
+        lTick = mCurrentTick;
+
+    aTimer.mSlotIndex = static_cast<uint32_t>(lTick & kSlotMask);
+    Timer*& lSlot = mSlots[aTimer.mSlotIndex];
+
+    aTimer.mMatchIndex = static_cast<uint32_t>(MatchIndex(aTimer.OnComplete, aTimer.AppState));
+    Timer*& lMatch = mMatches[aTimer.mMatchIndex];
+
+    aTimer.mPrevTimer = NULL;
+    aTimer.mNextTimer = lSlot;
+    if (lSlot != NULL)
+        lSlot->mPrevTimer = &aTimer;
+    lSlot = &aTimer;
+
+    aTimer.mPrevMatch = NULL;
+    aTimer.mNextMatch = lMatch;
+    if (lMatch != NULL)
+        lMatch->mPrevMatch = &aTimer;
+    lMatch = &aTimer;
+
+    aTimer.mLinkState = Timer::kLinkState_Wheel;
+
+    if (mCount == 0)
+    {
+        mNextEpoch = aTimer.mAwakenEpoch;
+        mNextEpochValid = true;
+    }
+    else if (mNextEpochValid && Timer::IsEarlierEpoch(aTimer.mAwakenEpoch, mNextEpoch))
+    {
+        mNextEpoch = aTimer.mAwakenEpoch;
+    }
+
+    mCount++;
+}
+
+/**
+ *  Unlinks an armed timer from its slot and from the callback index.
+ */
+void TimerWheel::Remove(Timer& aTimer)
+{
+    Timer*& lSlot = mSlots[aTimer.mSlotIndex];
+
+    if (aTimer.mPrevTimer != NULL)
+        aTimer.mPrevTimer->mNextTimer = aTimer.mNextTimer;
+    else
+        lSlot = aTimer.mNextTimer;
+
+    if (aTimer.mNextTimer != NULL)
+        aTimer.mNextTimer->mPrevTimer = aTimer.mPrevTimer;
+
+    aTimer.mNextTimer = NULL;
+    aTimer.mPrevTimer = NULL;
+
+    RemoveMatch(aTimer);
+    aTimer.mLinkState = Timer::kLinkState_None;
+
+    // The cached next epoch remains a valid lower bound, so it is only discarded once the wheel is empty.
+    if (--mCount == 0)
+        mNextEpochValid = false;
+}
+
+/**
+ *  Unlinks a timer from the callback index only.
+ */
+void TimerWheel::RemoveMatch(Timer& aTimer)
+{
+    if (aTimer.mPrevMatch != NULL)
+        aTimer.mPrevMatch->mNextMatch = aTimer.mNextMatch;
+    else
+        mMatches[aTimer.mMatchIndex] = aTimer.mNextMatch;
+
+    if (aTimer.mNextMatch != NULL)
+        aTimer.mNextMatch->mPrevMatch = aTimer.mPrevMatch;
+
+    aTimer.mNextMatch = NULL;
+    aTimer.mPrevMatch = NULL;
+}
+
+/**
+ *  Finds an armed timer, in the wheel or expired but not yet completed, by its completion function and application state.
+ *
+ *  @return The timer, or NULL if no such timer is armed.
+ */
+Timer* TimerWheel::Find(Timer::OnCompleteFunct aOnComplete, void* aAppState) const
+{
+    Timer* lTimer = mMatches[MatchIndex(aOnComplete, aAppState)];
+
+    while (lTimer != NULL && !(lTimer->OnComplete == aOnComplete && lTimer->AppState == aAppState))
+        lTimer = lTimer->mNextMatch;
+
+    return lTimer;
+}
+
+/**
+ *  Removes every timer expiring at or before the given epoch from the wheel.
+ *
+ *  @brief
+ *      Only the slots between the previous pass and the given epoch are visited; if more than one revolution has elapsed each slot
+ *      is visited once. The expired timers remain in the callback index until they are completed.
+ *
+ *  @param[in]  aCurrentEpoch   The current epoch.
+ *
+ *  @return A list of expired timers linked through mNextTimer, to be passed to Timer::CompleteTimers(), or NULL.
+ */
+Timer* TimerWheel::CollectExpired(Timer::Epoch aCurrentEpoch)
+{
+    const Timer::Epoch lCurrentTick = TickOf(aCurrentEpoch);
+    Timer* lExpired = NULL;
+    Timer** lTail = &lExpired;
+
+    if (mCount > 0 && lCurrentTick >= mCurrentTick)
+    {
+        Timer::Epoch lLastTick = lCurrentTick;
+
+        if (lCurrentTick - mCurrentTick >= kNumSlots)
+            lLastTick = mCurrentTick + kNumSlots - 1;
+
+        for (Timer::Epoch lTick = mCurrentTick; lTick <= lLastTick && mCount > 0; lTick++)
+        {
+            Timer*& lSlot = mSlots[lTick & kSlotMask];
+            Timer* lTimer = lSlot;
+
+            while (lTimer != NULL)
+            {
+                Timer* lNext = lTimer->mNextTimer;
+
+                if (!Timer::IsEarlierEpoch(aCurrentEpoch, lTimer->mAwakenEpoch))
+                {
+                    if (lTimer->mPrevTimer != NULL)
+                        lTimer->mPrevTimer->mNextTimer = lNext;
+                    else
+                        lSlot = lNext;
+
+                    if (lNext != NULL)
+                        lNext->mPrevTimer = lTimer->mPrevTimer;
+
+                    lTimer->mPrevTimer = NULL;
+                    lTimer->mNextTimer = NULL;
+                    lTimer->mLinkState = Timer::kLinkState_Expired;
+
+                    *lTail = lTimer;
+                    lTail = &lTimer->mNextTimer;
+
+                    mCount--;
+                }
+
+                lTimer = lNext;
+            }
+        }
+    }
+
+    if (lCurrentTick > mCurrentTick)
+        mCurrentTick = lCurrentTick;
+
+    mNextEpochValid = false;
+
+    return lExpired;
+}
+
+/**
+ *  Returns the expiration time of the earliest timer in the wheel.
+ *
+ *  @note
+ *      After a timer is cancelled the returned epoch may be earlier than that of any remaining timer.
+ *
+ *  @param[out] aEpoch  The expiration time of the earliest timer.
+ *
+ *  @return true if the wheel holds any timer, false otherwise.
+ */
+bool TimerWheel::GetNextEpoch(Timer::Epoch& aEpoch)
+{
+    if (mCount == 0)
+        return false;
+
+    if (!mNextEpochValid)
+        UpdateNextEpoch();
+
+    aEpoch = mNextEpoch;
+    return true;
+}
+
+void TimerWheel::UpdateNextEpoch(void)
+{
+    Timer::Epoch lNextEpoch = 0;
+    bool lFound = false;
+
+    // Walking forward from the current tick, the first slot holding a timer due within the current revolution holds the earliest
+    // timer.
+    for (size_t i = 0; i < kNumSlots && !lFound; i++)
+    {
+        const Timer::Epoch lTick = mCurrentTick + i;
+
+        for (Timer* lTimer = mSlots[lTick & kSlotMask]; lTimer != NULL; lTimer = lTimer->mNextTimer)
+        {
+            if (TickOf(lTimer->mAwakenEpoch) <= lTick && (!lFound || Timer::IsEarlierEpoch(lTimer->mAwakenEpoch, lNextEpoch)))
+            {
+                lNextEpoch = lTimer->mAwakenEpoch;
+                lFound = true;
+            }
+        }
+    }
+
+    // Otherwise every timer is at least one revolution away, so all of them have to be examined.
+    if (!lFound)
+    {
+        for (size_t i = 0; i < kNumSlots; i++)
+        {
+            for (Timer* lTimer = mSlots[i]; lTimer != NULL; lTimer = lTimer->mNextTimer)
+            {
+                if (!lFound || Timer::IsEarlierEpoch(lTimer->mAwakenEpoch, lNextEpoch))
+                {
+                    lNextEpoch = lTimer->mAwakenEpoch;
+                    lFound = true;
+                }
+            }
+        }
+    }
+
+    mNextEpoch = lNextEpoch;
+    mNextEpochValid = true;
+}
+#endif // WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+
 } // namespace System
 } // namespace Weave
 } // namespace nl
@@ -55,6 +55,10 @@ namespace System {
 
 class Layer;
 
+#if WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+class TimerWheel;
+#endif // WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+
 /**
  * @class Timer
  *
@@ -67,6 +71,9 @@ class Layer;
 class NL_DLL_EXPORT Timer : public Object
 {
     friend class Layer;
+#if WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+    friend class TimerWheel;
+#endif // WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
 
 public:
     /**
@@ -109,18 +116,97 @@ private:
 
     Error ScheduleWork(OnCompleteFunct aOnComplete, void* aAppState);
 
-#if WEAVE_SYSTEM_CONFIG_USE_LWIP
+#if WEAVE_SYSTEM_CONFIG_USE_LWIP || WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
     Timer *mNextTimer;
+#endif // WEAVE_SYSTEM_CONFIG_USE_LWIP || WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
 
+#if WEAVE_SYSTEM_CONFIG_USE_LWIP
     static Error HandleExpiredTimers(Layer& aLayer);
 #endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
 
+#if WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+    /** Where the timer is linked while it is armed. */
+    enum
+    {
+        kLinkState_None         = 0,    /**< Not linked; an armed timer in this state is completed by an event (LwIP). */
+        kLinkState_Wheel        = 1,    /**< In a timing wheel slot and in the callback index. */
+        kLinkState_Expired      = 2,    /**< In a batch of expired timers and in the callback index. */
+        kLinkState_Detached     = 3     /**< In a batch of expired timers or the scheduled work list only. */
+    };
+
+    Timer *mPrevTimer;
+    Timer *mNextMatch;
+    Timer *mPrevMatch;
+    uint32_t mSlotIndex;
+    uint32_t mMatchIndex;
+    uint8_t mLinkState;
+
+    static void CompleteTimers(Layer& aLayer, Timer* aTimerList);
+#endif // WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+
     // Not defined
     Timer(const Timer&);
     Timer& operator =(const Timer&);
 };
 
 
+#if WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+/**
+ * @class TimerWheel
+ *
+ * @brief
+ *  This is an internal class to Weave System Layer, used to track armed timers in a hashed timing wheel. Timers are placed in the
+ *  slot covering their expiration time and in a hash index keyed by their completion function and application state, so that
+ *  starting, cancelling and finding a timer take constant time, and expiry processing only visits the slots that have come due.
+ *
+ *  A TimerWheel is not thread-safe; it may only be used from the thread owning its Layer.
+ */
+class TimerWheel
+{
+public:
+    void Init(Timer::Epoch aCurrentEpoch);
+
+    void Insert(Timer& aTimer);
+    void Remove(Timer& aTimer);
+    void RemoveMatch(Timer& aTimer);
+    Timer* Find(Timer::OnCompleteFunct aOnComplete, void* aAppState) const;
+
+    Timer* CollectExpired(Timer::Epoch aCurrentEpoch);
+    bool GetNextEpoch(Timer::Epoch& aEpoch);
+
+    size_t Count(void) const;
+
+private:
+    enum
+    {
+        kNumSlots = WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_SLOTS,
+        kSlotMask = WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_SLOTS - 1
+    };
+
+    Timer* mSlots[kNumSlots];
+    Timer* mMatches[kNumSlots];
+    Timer::Epoch mCurrentTick;
+    Timer::Epoch mNextEpoch;
+    size_t mCount;
+    bool mNextEpochValid;
+
+    static Timer::Epoch TickOf(Timer::Epoch aEpoch);
+    static size_t MatchIndex(Timer::OnCompleteFunct aOnComplete, void* aAppState);
+
+    void UpdateNextEpoch(void);
+};
+
+inline size_t TimerWheel::Count(void) const
+{
+    return mCount;
+}
+
+inline Timer::Epoch TimerWheel::TickOf(Timer::Epoch aEpoch)
+{
+    return aEpoch / WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_TICK_MS;
+}
+#endif // WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+
 inline void Timer::GetStatistics(nl::Weave::System::Stats::count_t& aNumInUse,
                                  nl::Weave::System::Stats::count_t& aHighWatermark)
 {
@@ -1446,6 +1446,66 @@ static void CheckFetchEvents(nlTestSuite * inSuite, void * inContext)
     }
 }
 
+static void CheckFetchEventsSinceAfterEviction(nlTestSuite * inSuite, void * inContext)
+{
+    TestLoggingContext * context = static_cast<TestLoggingContext *>(inContext);
+    const int k_num_events       = 400;
+    const ImportanceType importances[] = { nl::Weave::Profiles::DataManagement::Production,
+                                           nl::Weave::Profiles::DataManagement::Info };
+    timestamp_t timestamps[2][k_num_events + 1];
+    timestamp_t now;
+    event_id_t eid;
+    WEAVE_ERROR err;
+    InitializeEventLogging(context);
+
+    nl::Weave::Profiles::DataManagement::LoggingManagement & logMgmt =
+        nl::Weave::Profiles::DataManagement::LoggingManagement::GetInstance();
+
+    // Interleave production and info events so that both buffers
+    // wrap, evicting and promoting events between them.
+    now = static_cast<timestamp_t>(1000);
+    for (int counter = 0; counter < k_num_events; counter++)
+    {
+        int i = (counter % 3 == 0) ? 0 : 1;
+
+        eid = FastLogFreeform(importances[i], now, "Freeform entry %d", counter);
+        NL_TEST_ASSERT(inSuite, eid > 0 && eid <= k_num_events);
+        timestamps[i][eid] = now;
+        now += 1 + (counter % 7);
+    }
+
+    // Fetching from any event still in the log must start exactly at
+    // that event, with the correct timestamp, and run to the end.
+    for (int i = 0; i < 2; i++)
+    {
+        event_id_t first = logMgmt.GetFirstEventID(importances[i]);
+        event_id_t last  = logMgmt.GetLastEventID(importances[i]);
+
+        NL_TEST_ASSERT(inSuite, first > 1);
+
+        for (event_id_t start = first; start <= last; start++)
+        {
+            TLVReader testReader;
+            TLVWriter testWriter;
+            utc_timestamp_t testUtcTimestamp = 0;
+            timestamp_t testTimestamp        = 0;
+            event_id_t testEventID           = 0;
+            event_id_t eventId               = start;
+
+            testWriter.Init(gLargeMemoryBackingStore, sizeof(gLargeMemoryBackingStore));
+            err = logMgmt.FetchEventsSince(testWriter, importances[i], eventId);
+            NL_TEST_ASSERT(inSuite, err == WEAVE_END_OF_TLV);
+            NL_TEST_ASSERT(inSuite, eventId == last + 1);
+
+            testReader.Init(gLargeMemoryBackingStore, testWriter.GetLengthWritten());
+            err = ReadFirstEventHeader(testReader, testTimestamp, testUtcTimestamp, testEventID);
+            NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+            NL_TEST_ASSERT(inSuite, testEventID == start);
+            NL_TEST_ASSERT(inSuite, testTimestamp == timestamps[i][start]);
+        }
+    }
+}
+
 static void CheckBasicEventDeserialization(nlTestSuite * inSuite, void * inContext)
 {
     TestLoggingContext * context = static_cast<TestLoggingContext *>(inContext);
@@ -3769,6 +3829,7 @@ static const nlTest sTests[] = {
     NL_TEST_DEF("Check Byte String Array", CheckByteStringArray),
     NL_TEST_DEF("Check Log eviction", CheckEvict),
     NL_TEST_DEF("Check Fetch Events", CheckFetchEvents),
+    NL_TEST_DEF("Check Fetch Events Since After Eviction", CheckFetchEventsSinceAfterEviction),
     NL_TEST_DEF("Check Large Events", CheckLargeEvents),
     NL_TEST_DEF("Check Fetch Event Timestamps", CheckFetchTimestamps),
     NL_TEST_DEF("Basic Deserialization Test", CheckBasicEventDeserialization),
@@ -0,0 +1,355 @@
+/*
+ *
+ *    Copyright (c) 2018 Google LLC.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements a unit test suite for the allocation and
+ *      lookup of exchange contexts by the Weave exchange manager.
+ *
+ */
+
+#ifndef __STDC_FORMAT_MACROS
+#define __STDC_FORMAT_MACROS
+#endif
+
+#ifndef __STDC_LIMIT_MACROS
+#define __STDC_LIMIT_MACROS
+#endif
+
+#include <stdint.h>
+#include <string.h>
+
+#include <nlunit-test.h>
+
+#include "ToolCommon.h"
+
+#define TOOL_NAME "TestExchangeMgr"
+
+namespace nl {
+namespace Weave {
+
+class NL_DLL_EXPORT WeaveExchangeManagerTestObject
+{
+public:
+    static void SetNextExchangeId(WeaveExchangeManager &exchangeMgr, uint16_t exchangeId)
+    {
+        exchangeMgr.NextExchangeId = exchangeId;
+    }
+
+    static ExchangeContext *ContextPool(WeaveExchangeManager &exchangeMgr)
+    {
+        return exchangeMgr.ContextPool;
+    }
+
+    static size_t ContextsInUse(const WeaveExchangeManager &exchangeMgr)
+    {
+        return exchangeMgr.mContextsInUse;
+    }
+
+    static ExchangeContext *LookupContext(WeaveExchangeManager &exchangeMgr, WeaveConnection *msgCon,
+            const WeaveMessageInfo *msgInfo, const WeaveExchangeHeader *exchangeHeader)
+    {
+        return exchangeMgr.LookupContext(msgCon, msgInfo, exchangeHeader);
+    }
+};
+
+} // namespace Weave
+} // namespace nl
+
+static HelpOptions gHelpOptions(
+    TOOL_NAME,
+    "Usage: " TOOL_NAME " [<options...>]\n",
+    WEAVE_VERSION_STRING "\n" WEAVE_TOOL_COPYRIGHT
+);
+
+static OptionSet *gToolOptionSets[] =
+{
+    &gNetworkOptions,
+    &gWeaveNodeOptions,
+    &gFaultInjectionOptions,
+    &gHelpOptions,
+    NULL
+};
+
+#define NUM_CONTEXTS WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS
+
+static const uint64_t kTestPeerNodeId = 0x18B4300000000042ULL;
+
+// Distinct application state for each context, used to tell them apart with FindContext().
+static uint8_t sAppStates[NUM_CONTEXTS];
+static ExchangeContext *sContexts[NUM_CONTEXTS];
+
+// Find the context to which a message from the test peer, answering an exchange the node initiated, would be dispatched.
+static ExchangeContext *LookupInbound(uint16_t exchangeId)
+{
+    WeaveMessageInfo msgInfo;
+    WeaveExchangeHeader exchangeHeader;
+
+    msgInfo.Clear();
+    msgInfo.SourceNodeId = kTestPeerNodeId;
+    msgInfo.DestNodeId = FabricState.LocalNodeId;
+
+    memset(&exchangeHeader, 0, sizeof(exchangeHeader));
+    exchangeHeader.ExchangeId = exchangeId;
+
+    return WeaveExchangeManagerTestObject::LookupContext(ExchangeMgr, NULL, &msgInfo, &exchangeHeader);
+}
+
+static bool IsPoolContext(ExchangeContext *ec)
+{
+    ExchangeContext *pool = WeaveExchangeManagerTestObject::ContextPool(ExchangeMgr);
+
+    return ec >= pool && ec < pool + NUM_CONTEXTS;
+}
+
+// Check that every context in sContexts can be found, both by the application and by inbound dispatch.
+static void CheckContextsFound(nlTestSuite *inSuite)
+{
+    size_t inUse = 0;
+
+    for (size_t i = 0; i < NUM_CONTEXTS; i++)
+    {
+        ExchangeContext *ec = sContexts[i];
+
+        if (ec == NULL)
+        {
+            NL_TEST_ASSERT(inSuite, ExchangeMgr.FindContext(kTestPeerNodeId, NULL, &sAppStates[i], true) == NULL);
+            continue;
+        }
+
+        inUse++;
+
+        NL_TEST_ASSERT(inSuite, ExchangeMgr.FindContext(kTestPeerNodeId, NULL, &sAppStates[i], true) == ec);
+        NL_TEST_ASSERT(inSuite, ExchangeMgr.FindContext(kTestPeerNodeId, NULL, &sAppStates[i], false) == NULL);
+        NL_TEST_ASSERT(inSuite, LookupInbound(ec->ExchangeId) == ec);
+    }
+
+    NL_TEST_ASSERT(inSuite, WeaveExchangeManagerTestObject::ContextsInUse(ExchangeMgr) == inUse);
+}
+
+static void FreeContext(size_t i)
+{
+    sContexts[i]->Close();
+    sContexts[i] = NULL;
+}
+
+// Allocate contexts until the pool is exhausted, recording them in the free slots of sContexts.
+static size_t AllocContexts(nlTestSuite *inSuite)
+{
+    size_t allocated = 0;
+
+    for (size_t i = 0; i < NUM_CONTEXTS; i++)
+    {
+        if (sContexts[i] != NULL)
+            continue;
+
+        sContexts[i] = ExchangeMgr.NewContext(kTestPeerNodeId, &sAppStates[i]);
+        NL_TEST_ASSERT(inSuite, sContexts[i] != NULL);
+        NL_TEST_ASSERT(inSuite, IsPoolContext(sContexts[i]));
+        if (sContexts[i] != NULL)
+            allocated++;
+    }
+
+    // Every context is now in use.
+    NL_TEST_ASSERT(inSuite, ExchangeMgr.NewContext(kTestPeerNodeId, NULL) == NULL);
+
+    return allocated;
+}
+
+static void FreeAllContexts(void)
+{
+    for (size_t i = 0; i < NUM_CONTEXTS; i++)
+        if (sContexts[i] != NULL)
+            FreeContext(i);
+}
+
+// Contexts freed in an order other than that of their allocation are reused, and the remaining ones are still found.
+static void CheckAllocFreeOutOfOrder(nlTestSuite *inSuite, void *inContext)
+{
+    ExchangeContext *freed[NUM_CONTEXTS];
+    size_t numFreed = 0;
+
+    NL_TEST_ASSERT(inSuite, AllocContexts(inSuite) == NUM_CONTEXTS);
+
+    // Every context is distinct.
+    for (size_t i = 0; i < NUM_CONTEXTS; i++)
+        for (size_t j = i + 1; j < NUM_CONTEXTS; j++)
+            NL_TEST_ASSERT(inSuite, sContexts[i] != sContexts[j]);
+
+    CheckContextsFound(inSuite);
+
+    // Free every third context from the end, then every other remaining context from the start.
+    for (size_t i = NUM_CONTEXTS; i-- > 0; )
+        if (i % 3 == 1)
+        {
+            uint16_t exchangeId = sContexts[i]->ExchangeId;
+
+            freed[numFreed++] = sContexts[i];
+            FreeContext(i);
+            NL_TEST_ASSERT(inSuite, LookupInbound(exchangeId) == NULL);
+        }
+
+    CheckContextsFound(inSuite);
+
+    for (size_t i = 0; i < NUM_CONTEXTS; i += 2)
+        if (sContexts[i] != NULL)
+        {
+            uint16_t exchangeId = sContexts[i]->ExchangeId;
+
+            freed[numFreed++] = sContexts[i];
+            FreeContext(i);
+            NL_TEST_ASSERT(inSuite, LookupInbound(exchangeId) == NULL);
+        }
+
+    CheckContextsFound(inSuite);
+
+    // Exactly the freed contexts are handed out again.
+    NL_TEST_ASSERT(inSuite, AllocContexts(inSuite) == numFreed);
+
+    for (size_t i = 0; i < NUM_CONTEXTS; i++)
+    {
+        bool found = false;
+
+        for (size_t j = 0; j < NUM_CONTEXTS && !found; j++)
+            found = (sContexts[j] == WeaveExchangeManagerTestObject::ContextPool(ExchangeMgr) + i);
+
+        NL_TEST_ASSERT(inSuite, found);
+    }
+
+    for (size_t i = 0; i < numFreed; i++)
+    {
+        bool reused = false;
+
+        for (size_t j = 0; j < NUM_CONTEXTS && !reused; j++)
+            reused = (sContexts[j] == freed[i]);
+
+        NL_TEST_ASSERT(inSuite, reused);
+    }
+
+    CheckContextsFound(inSuite);
+
+    // Free the rest in reverse order of their position in the pool.
+    for (size_t i = NUM_CONTEXTS; i-- > 0; )
+    {
+        for (size_t j = 0; j < NUM_CONTEXTS; j++)
+            if (sContexts[j] == WeaveExchangeManagerTestObject::ContextPool(ExchangeMgr) + i)
+            {
+                FreeContext(j);
+                break;
+            }
+    }
+
+    CheckContextsFound(inSuite);
+    NL_TEST_ASSERT(inSuite, AllocContexts(inSuite) == NUM_CONTEXTS);
+    CheckContextsFound(inSuite);
+
+    FreeAllContexts();
+    NL_TEST_ASSERT(inSuite, WeaveExchangeManagerTestObject::ContextsInUse(ExchangeMgr) == 0);
+}
+
+// Contexts whose exchange ids share a hash bucket are told apart, including after a context in the middle of the bucket is
+// freed.
+static void CheckExchangeIdCollisions(nlTestSuite *inSuite, void *inContext)
+{
+    const uint16_t kBaseExchangeId = 0x1234;
+
+    for (size_t i = 0; i < NUM_CONTEXTS; i++)
+    {
+        WeaveExchangeManagerTestObject::SetNextExchangeId(ExchangeMgr,
+                static_cast<uint16_t>(kBaseExchangeId + i * WEAVE_CONFIG_EXCHANGE_CONTEXT_INDEX_BUCKETS));
+
+        sContexts[i] = ExchangeMgr.NewContext(kTestPeerNodeId, &sAppStates[i]);
+        NL_TEST_ASSERT(inSuite, sContexts[i] != NULL);
+    }
+
+    CheckContextsFound(inSuite);
+
+    // An exchange id in the same bucket that belongs to no context is not matched.
+    NL_TEST_ASSERT(inSuite, LookupInbound(static_cast<uint16_t>(kBaseExchangeId + NUM_CONTEXTS * WEAVE_CONFIG_EXCHANGE_CONTEXT_INDEX_BUCKETS)) == NULL);
+
+    FreeContext(NUM_CONTEXTS / 2);
+    CheckContextsFound(inSuite);
+
+    FreeContext(0);
+    FreeContext(NUM_CONTEXTS - 1);
+    CheckContextsFound(inSuite);
+
+    // A context allocated with an exchange id in the same bucket joins it.
+    WeaveExchangeManagerTestObject::SetNextExchangeId(ExchangeMgr, kBaseExchangeId);
+    sContexts[0] = ExchangeMgr.NewContext(kTestPeerNodeId, &sAppStates[0]);
+    NL_TEST_ASSERT(inSuite, sContexts[0] != NULL);
+    CheckContextsFound(inSuite);
+
+    FreeAllContexts();
+    NL_TEST_ASSERT(inSuite, WeaveExchangeManagerTestObject::ContextsInUse(ExchangeMgr) == 0);
+}
+
+static const nlTest sTests[] = {
+    NL_TEST_DEF("ExchangeMgr::AllocFreeOutOfOrder",   CheckAllocFreeOutOfOrder),
+    NL_TEST_DEF("ExchangeMgr::ExchangeIdCollisions",  CheckExchangeIdCollisions),
+    NL_TEST_SENTINEL()
+};
+
+/**
+ *  Set up the test suite.
+ */
+static int TestSetup(void *inContext)
+{
+    InitSystemLayer();
+    InitNetwork();
+    InitWeaveStack(false, true);
+
+    return (SUCCESS);
+}
+
+/**
+ *  Tear down the test suite.
+ */
+static int TestTeardown(void *inContext)
+{
+    ShutdownWeaveStack();
+    ShutdownNetwork();
+    ShutdownSystemLayer();
+
+    return (SUCCESS);
+}
+
+int main(int argc, char *argv[])
+{
+    SetSIGUSR1Handler();
+
+    if (!ParseArgs(TOOL_NAME, argc, argv, gToolOptionSets, NULL))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    nlTestSuite theSuite = {
+        "weave-exchange-mgr",
+        &sTests[0],
+        TestSetup,
+        TestTeardown
+    };
+
+    // Generate machine-readable, comma-separated value (CSV) output.
+    nl_test_set_output_style(OUTPUT_CSV);
+
+    // Run test suite against one context.
+    nlTestRunner(&theSuite, NULL);
+
+    return nlTestRunnerStats(&theSuite);
+}
@@ -30,9 +30,13 @@
 #include <errno.h>
 #include <stdint.h>
 #include <string.h>
+#include <time.h>
 
 #include <InetLayer/InetLayer.h>
 #include <InetLayer/InetError.h>
+#if INET_CONFIG_ENABLE_EVENT_LOOP_SHARDS
+#include <InetLayer/EventLoopShards.h>
+#endif // INET_CONFIG_ENABLE_EVENT_LOOP_SHARDS
 
 #include <SystemLayer/SystemError.h>
 #include <SystemLayer/SystemTimer.h>
@@ -511,6 +515,654 @@ static void TestInetEndPoint(nlTestSuite *inSuite, void *inContext)
     testTCPEP1->Shutdown();
 }
 
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+static double BenchmarkNow(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS && INET_CONFIG_ENABLE_UDP_ENDPOINT
+static uint32_t sUDPThroughputReceived = 0;
+
+static void HandleUDPThroughputMessage(IPEndPointBasis *endPoint, PacketBuffer *msg, const IPPacketInfo *pktInfo)
+{
+    sUDPThroughputReceived++;
+    PacketBuffer::Free(msg);
+}
+
+// Measure the datagram rate between two UDP endpoints over the IPv6 loopback
+// interface. Datagrams are sent in bursts (with a single SendMsgBatch call
+// per burst when INET_CONFIG_ENABLE_UDP_BATCH_IO is enabled) and each burst
+// is drained by the event loop before the next is sent.
+static void TestUDPThroughput(nlTestSuite *inSuite, void *inContext)
+{
+    enum
+    {
+        kNumBursts      = 1000,
+        kBurstSize      = 32,
+        kPayloadSize    = 64
+    };
+
+    INET_ERROR err;
+    IPAddress loopback;
+    UDPEndPoint *rxEP = NULL;
+    UDPEndPoint *txEP = NULL;
+    PacketBuffer *buf = NULL;
+    IPPacketInfo pktInfo;
+    uint32_t sent = 0;
+    double start, elapsed;
+
+    NL_TEST_ASSERT(inSuite, IPAddress::FromString("::1", loopback));
+
+    err = Inet.NewUDPEndPoint(&rxEP);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+    err = Inet.NewUDPEndPoint(&txEP);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+    VerifyOrExit(rxEP != NULL && txEP != NULL, );
+
+    err = rxEP->Bind(kIPAddressType_IPv6, loopback, 0);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+    rxEP->OnMessageReceived = HandleUDPThroughputMessage;
+    err = rxEP->Listen();
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+    err = txEP->Bind(kIPAddressType_IPv6, loopback, 0);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+    VerifyOrExit(err == INET_NO_ERROR, );
+
+    buf = PacketBuffer::New();
+    VerifyOrExit(buf != NULL, NL_TEST_ASSERT(inSuite, buf != NULL));
+    memset(buf->Start(), 0x5A, kPayloadSize);
+    buf->SetDataLength(kPayloadSize);
+
+    pktInfo.Clear();
+    pktInfo.DestAddress = loopback;
+    pktInfo.DestPort = rxEP->GetBoundPort();
+
+    sUDPThroughputReceived = 0;
+    start = BenchmarkNow();
+
+    for (int burst = 0; burst < kNumBursts; burst++)
+    {
+        int idle = 0;
+
+#if INET_CONFIG_ENABLE_UDP_BATCH_IO
+        IPPacketInfo pktInfos[kBurstSize];
+        INET_ERROR sendErrs[kBurstSize];
+
+        for (int i = 0; i < kBurstSize; i++)
+            pktInfos[i] = pktInfo;
+
+        err = txEP->SendMsgBatch(pktInfos, kBurstSize, buf, sendErrs);
+        NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+#else // !INET_CONFIG_ENABLE_UDP_BATCH_IO
+        for (int i = 0; i < kBurstSize; i++)
+        {
+            err = txEP->SendMsg(&pktInfo, buf, UDPEndPoint::kSendFlag_RetainBuffer);
+            NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+        }
+#endif // !INET_CONFIG_ENABLE_UDP_BATCH_IO
+
+        sent += kBurstSize;
+
+        // Loopback datagrams are not normally dropped, but give up on a burst
+        // rather than hang if some never arrive.
+        while (sUDPThroughputReceived < sent && idle < 100)
+        {
+            const uint32_t before = sUDPThroughputReceived;
+            struct timeval sleepTime = { 0, 1000 };
+
+            ServiceNetwork(sleepTime);
+
+            idle = (sUDPThroughputReceived == before) ? idle + 1 : 0;
+        }
+    }
+
+    elapsed = BenchmarkNow() - start;
+
+    printf("    UDP loopback: %u of %u datagrams received in %.3f s (%.0f datagrams/s, batch I/O %s)\n",
+           sUDPThroughputReceived, sent, elapsed, sUDPThroughputReceived / elapsed,
+           INET_CONFIG_ENABLE_UDP_BATCH_IO ? "enabled" : "disabled");
+
+    NL_TEST_ASSERT(inSuite, sUDPThroughputReceived > 0);
+
+exit:
+    if (buf != NULL)
+        PacketBuffer::Free(buf);
+    if (rxEP != NULL)
+        rxEP->Free();
+    if (txEP != NULL)
+        txEP->Free();
+}
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS && INET_CONFIG_ENABLE_UDP_ENDPOINT
+
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS && INET_CONFIG_ENABLE_TCP_ENDPOINT
+static TCPEndPoint *sTCPBulkRxEP = NULL;
+static bool sTCPBulkConnected = false;
+static uint32_t sTCPBulkReceived = 0;
+
+static void HandleTCPBulkDataReceived(TCPEndPoint *endPoint, PacketBuffer *data)
+{
+    for (PacketBuffer *buf = data; buf != NULL; buf = buf->Next())
+        sTCPBulkReceived += buf->DataLength();
+    PacketBuffer::Free(data);
+}
+
+static void HandleTCPBulkConnectionReceived(TCPEndPoint *listeningEndPoint, TCPEndPoint *conEndPoint,
+        const IPAddress &peerAddr, uint16_t peerPort)
+{
+    sTCPBulkRxEP = conEndPoint;
+    sTCPBulkRxEP->OnDataReceived = HandleTCPBulkDataReceived;
+}
+
+static void HandleTCPBulkConnectComplete(TCPEndPoint *endPoint, INET_ERROR err)
+{
+    sTCPBulkConnected = (err == INET_NO_ERROR);
+}
+
+// Measure the bulk transfer rate of a TCP connection over the IPv6 loopback
+// interface. The sender keeps a window of full-size buffers in flight so that
+// each writable event can send several of them (in one vectored send when
+// INET_CONFIG_ENABLE_TCP_SEND_GATHER is enabled).
+static void TestTCPBulkThroughput(nlTestSuite *inSuite, void *inContext)
+{
+    enum
+    {
+        kNumBufs        = 8192,
+        kWindowBufs     = 32,
+        kPort           = 3001
+    };
+
+    INET_ERROR err;
+    IPAddress loopback;
+    TCPEndPoint *listenEP = NULL;
+    TCPEndPoint *txEP = NULL;
+    uint32_t queued = 0;
+    uint32_t numBufs = 0;
+    int idle = 0;
+    double start, elapsed;
+
+    NL_TEST_ASSERT(inSuite, IPAddress::FromString("::1", loopback));
+
+    sTCPBulkRxEP = NULL;
+    sTCPBulkConnected = false;
+    sTCPBulkReceived = 0;
+
+    err = Inet.NewTCPEndPoint(&listenEP);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+    err = Inet.NewTCPEndPoint(&txEP);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+    VerifyOrExit(listenEP != NULL && txEP != NULL, );
+
+    err = listenEP->Bind(kIPAddressType_IPv6, loopback, kPort, true);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+    listenEP->OnConnectionReceived = HandleTCPBulkConnectionReceived;
+    err = listenEP->Listen(1);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+    VerifyOrExit(err == INET_NO_ERROR, );
+
+    txEP->OnConnectComplete = HandleTCPBulkConnectComplete;
+    err = txEP->Connect(loopback, kPort);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+    VerifyOrExit(err == INET_NO_ERROR, );
+
+    while ((!sTCPBulkConnected || sTCPBulkRxEP == NULL) && idle++ < 1000)
+    {
+        struct timeval sleepTime = { 0, 1000 };
+
+        ServiceNetwork(sleepTime);
+    }
+    VerifyOrExit(sTCPBulkConnected && sTCPBulkRxEP != NULL, NL_TEST_ASSERT(inSuite, false));
+
+    // Buffers are smaller than the loopback MSS; do not let Nagle hold them
+    // back waiting for delayed acknowledgements.
+    err = txEP->EnableNoDelay();
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+
+    start = BenchmarkNow();
+    idle = 0;
+
+    while (sTCPBulkReceived < queued || numBufs < kNumBufs)
+    {
+        const uint32_t before = sTCPBulkReceived;
+        struct timeval sleepTime = { 0, 1000 };
+
+        // Top the data in flight back up to the window, or for as long as
+        // the buffer pool allows.
+        while (numBufs < kNumBufs && queued - sTCPBulkReceived < kWindowBufs * WEAVE_SYSTEM_CONFIG_PACKETBUFFER_CAPACITY_MAX)
+        {
+            PacketBuffer *buf = PacketBuffer::New(0);
+
+            if (buf == NULL)
+                break;
+
+            memset(buf->Start(), 0xA5, buf->AvailableDataLength());
+            buf->SetDataLength(buf->AvailableDataLength());
+            queued += buf->DataLength();
+            numBufs++;
+
+            err = txEP->Send(buf);
+            NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+            VerifyOrExit(err == INET_NO_ERROR, );
+        }
+
+        ServiceNetwork(sleepTime);
+
+        idle = (sTCPBulkReceived == before) ? idle + 1 : 0;
+        VerifyOrExit(idle < 1000, NL_TEST_ASSERT(inSuite, false));
+    }
+
+    elapsed = BenchmarkNow() - start;
+
+    printf("    TCP loopback: %u bytes in %u buffers received in %.3f s (%.1f MB/s, send gather %s, zero-copy %s)\n",
+           sTCPBulkReceived, numBufs, elapsed, sTCPBulkReceived / elapsed / 1e6,
+           INET_CONFIG_ENABLE_TCP_SEND_GATHER ? "enabled" : "disabled",
+           INET_CONFIG_ENABLE_TCP_SEND_ZEROCOPY ? "enabled" : "disabled");
+
+    NL_TEST_ASSERT(inSuite, sTCPBulkReceived == queued);
+
+exit:
+    if (sTCPBulkRxEP != NULL)
+        sTCPBulkRxEP->Free();
+    if (txEP != NULL)
+        txEP->Free();
+    if (listenEP != NULL)
+        listenEP->Free();
+}
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS && INET_CONFIG_ENABLE_TCP_ENDPOINT
+
+#if INET_CONFIG_ENABLE_EPOLL && INET_CONFIG_ENABLE_UDP_ENDPOINT
+enum
+{
+    kNumEpollEndPoints  = 2,
+    kEpollWaitMs        = 5000
+};
+
+static UDPEndPoint *sEpollEPs[kNumEpollEndPoints];
+static uint32_t sEpollReceived[kNumEpollEndPoints];
+static bool sEpollFreeOther = false;
+
+static void HandleEpollMessage(IPEndPointBasis *endPoint, PacketBuffer *msg, const IPPacketInfo *pktInfo)
+{
+    const size_t index = reinterpret_cast<size_t>(endPoint->AppState);
+
+    sEpollReceived[index]++;
+    PacketBuffer::Free(msg);
+
+    // Close the other endpoint while its readiness, reported by the same wakeup, is still to be dispatched.
+    if (sEpollFreeOther)
+    {
+        const size_t other = (index + 1) % kNumEpollEndPoints;
+
+        sEpollEPs[other]->Free();
+        sEpollEPs[other] = NULL;
+        sEpollFreeOther = false;
+    }
+}
+
+static INET_ERROR NewEpollEndPoint(size_t aIndex, const IPAddress &aAddr)
+{
+    INET_ERROR err;
+
+    err = Inet.NewUDPEndPoint(&sEpollEPs[aIndex]);
+    SuccessOrExit(err);
+
+    sEpollEPs[aIndex]->AppState = reinterpret_cast<void *>(aIndex);
+    sEpollEPs[aIndex]->OnMessageReceived = HandleEpollMessage;
+
+    err = sEpollEPs[aIndex]->Bind(kIPAddressType_IPv6, aAddr, 0);
+    SuccessOrExit(err);
+
+    err = sEpollEPs[aIndex]->Listen();
+
+exit:
+    return err;
+}
+
+static INET_ERROR SendEpollDatagram(UDPEndPoint *aTxEP, const IPAddress &aAddr, size_t aIndex)
+{
+    PacketBuffer *buf = PacketBuffer::New();
+
+    if (buf == NULL)
+        return INET_ERROR_NO_MEMORY;
+
+    buf->SetDataLength(1);
+
+    return aTxEP->SendTo(aAddr, sEpollEPs[aIndex]->GetBoundPort(), buf);
+}
+
+// Run a single select() over the descriptors of the Inet layer alone, and dispatch its result.
+static int ServiceInetOnce(uint32_t aTimeoutMs, int *aNumFDsSet = NULL)
+{
+    fd_set readFDs, writeFDs, exceptFDs;
+    int numFDs = 0;
+    int selectRes;
+    struct timeval sleepTime;
+
+    FD_ZERO(&readFDs);
+    FD_ZERO(&writeFDs);
+    FD_ZERO(&exceptFDs);
+
+    sleepTime.tv_sec = aTimeoutMs / 1000;
+    sleepTime.tv_usec = (aTimeoutMs % 1000) * 1000;
+
+    Inet.PrepareSelect(numFDs, &readFDs, &writeFDs, &exceptFDs, sleepTime);
+
+    if (aNumFDsSet != NULL)
+    {
+        *aNumFDsSet = 0;
+        for (int fd = 0; fd < numFDs; fd++)
+        {
+            if (FD_ISSET(fd, &readFDs) || FD_ISSET(fd, &writeFDs) || FD_ISSET(fd, &exceptFDs))
+                (*aNumFDsSet)++;
+        }
+    }
+
+    selectRes = select(numFDs, &readFDs, &writeFDs, &exceptFDs, &sleepTime);
+
+    Inet.HandleSelectResult(selectRes, &readFDs, &writeFDs, &exceptFDs);
+
+    return selectRes;
+}
+
+// Exercise the epoll backend over the IPv6 loopback interface: the Inet layer
+// waits on a single descriptor, a ready socket wakes the event loop and is the
+// only one dispatched, an endpoint closed by an earlier callback in the same
+// wakeup drops its stale readiness, a socket reusing a closed descriptor is
+// watched afresh, and the System layer's wake pipe still interrupts select().
+static void TestEpollBackend(nlTestSuite *inSuite, void *inContext)
+{
+    INET_ERROR err;
+    IPAddress loopback;
+    UDPEndPoint *txEP = NULL;
+    int numFDsSet = 0;
+    int selectRes;
+    double start, elapsed;
+    struct timeval sleepTime;
+
+    NL_TEST_ASSERT(inSuite, IPAddress::FromString("::1", loopback));
+
+    memset(sEpollEPs, 0, sizeof(sEpollEPs));
+    memset(sEpollReceived, 0, sizeof(sEpollReceived));
+
+    err = Inet.NewUDPEndPoint(&txEP);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+    VerifyOrExit(err == INET_NO_ERROR, );
+
+    err = txEP->Bind(kIPAddressType_IPv6, loopback, 0);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+
+    for (size_t i = 0; i < kNumEpollEndPoints; i++)
+    {
+        err = NewEpollEndPoint(i, loopback);
+        NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+        VerifyOrExit(err == INET_NO_ERROR, );
+    }
+
+    // Let anything left ready by earlier tests be dispatched.
+    for (int i = 0; i < 100; i++)
+    {
+        if (ServiceInetOnce(0) == 0)
+            break;
+    }
+
+    // Only the epoll descriptor is handed to select(), and nothing is ready yet.
+    selectRes = ServiceInetOnce(0, &numFDsSet);
+    NL_TEST_ASSERT(inSuite, numFDsSet == 1);
+    NL_TEST_ASSERT(inSuite, selectRes == 0);
+
+    // Readiness: a datagram wakes a long wait promptly, and only its endpoint is dispatched.
+    err = SendEpollDatagram(txEP, loopback, 1);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+
+    start = BenchmarkNow();
+    selectRes = ServiceInetOnce(kEpollWaitMs);
+    elapsed = BenchmarkNow() - start;
+
+    NL_TEST_ASSERT(inSuite, selectRes == 1);
+    NL_TEST_ASSERT(inSuite, elapsed < 1.0);
+    NL_TEST_ASSERT(inSuite, sEpollReceived[0] == 0 && sEpollReceived[1] == 1);
+
+    // The datagram was drained, so the socket is no longer reported.
+    selectRes = ServiceInetOnce(0);
+    NL_TEST_ASSERT(inSuite, selectRes == 0);
+
+    // Removal: both endpoints become ready, and whichever is dispatched first closes the other. The closed
+    // endpoint's readiness is dropped, and its socket no longer wakes the event loop.
+    err = SendEpollDatagram(txEP, loopback, 0);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+    err = SendEpollDatagram(txEP, loopback, 1);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+
+    memset(sEpollReceived, 0, sizeof(sEpollReceived));
+    sEpollFreeOther = true;
+
+    selectRes = ServiceInetOnce(kEpollWaitMs);
+    NL_TEST_ASSERT(inSuite, selectRes == 1);
+    NL_TEST_ASSERT(inSuite, sEpollReceived[0] + sEpollReceived[1] == 1);
+    NL_TEST_ASSERT(inSuite, !sEpollFreeOther);
+
+    selectRes = ServiceInetOnce(0);
+    NL_TEST_ASSERT(inSuite, selectRes == 0);
+    NL_TEST_ASSERT(inSuite, sEpollReceived[0] + sEpollReceived[1] == 1);
+
+    // A new endpoint, most likely reusing the closed descriptor, is watched afresh.
+    for (size_t i = 0; i < kNumEpollEndPoints; i++)
+    {
+        if (sEpollEPs[i] == NULL)
+        {
+            err = NewEpollEndPoint(i, loopback);
+            NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+            VerifyOrExit(err == INET_NO_ERROR, );
+
+            memset(sEpollReceived, 0, sizeof(sEpollReceived));
+
+            err = SendEpollDatagram(txEP, loopback, i);
+            NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+
+            selectRes = ServiceInetOnce(kEpollWaitMs);
+            NL_TEST_ASSERT(inSuite, selectRes == 1);
+            NL_TEST_ASSERT(inSuite, sEpollReceived[i] == 1);
+        }
+    }
+
+    // Wakeup: the System layer's wake pipe, which stays on the select() path, interrupts a long wait. Closing
+    // endpoints also writes to it, so drain it first.
+    sleepTime.tv_sec = 0;
+    sleepTime.tv_usec = 0;
+    ServiceNetwork(sleepTime);
+
+    SystemLayer.WakeSelect();
+
+    sleepTime.tv_sec = kEpollWaitMs / 1000;
+    sleepTime.tv_usec = 0;
+
+    start = BenchmarkNow();
+    ServiceNetwork(sleepTime);
+    elapsed = BenchmarkNow() - start;
+
+    NL_TEST_ASSERT(inSuite, elapsed < 1.0);
+
+exit:
+    sEpollFreeOther = false;
+
+    for (size_t i = 0; i < kNumEpollEndPoints; i++)
+    {
+        if (sEpollEPs[i] != NULL)
+        {
+            sEpollEPs[i]->Free();
+            sEpollEPs[i] = NULL;
+        }
+    }
+
+    if (txEP != NULL)
+        txEP->Free();
+}
+#endif // INET_CONFIG_ENABLE_EPOLL && INET_CONFIG_ENABLE_UDP_ENDPOINT
+
+#if INET_CONFIG_ENABLE_EVENT_LOOP_SHARDS && INET_CONFIG_ENABLE_UDP_ENDPOINT
+enum
+{
+    kNumTestShards      = 4,
+    kNumShardHops       = 1000
+};
+
+static EventLoopShards sShards;
+static uint32_t sShardHops = 0;
+static uint32_t sShardHopsMisrouted = 0;
+static uint32_t sShardDatagramsReceived = 0;
+static uint32_t sShardDatagramsMisrouted = 0;
+
+// Pass a token around the ring of shards; each hop checks that it runs on the
+// shard it was scheduled on and schedules the next hop on the following shard.
+static void HandleShardHop(Layer *aLayer, void *aAppState, Error aError)
+{
+    const size_t shardIndex = reinterpret_cast<size_t>(aAppState);
+    const size_t nextIndex = (shardIndex + 1) % sShards.NumShards();
+
+    if (sShards.ShardIndexFor(aLayer) != static_cast<int>(shardIndex))
+        __atomic_add_fetch(&sShardHopsMisrouted, 1, __ATOMIC_RELAXED);
+
+    if (__atomic_add_fetch(&sShardHops, 1, __ATOMIC_ACQ_REL) < kNumShardHops)
+        sShards.ScheduleWork(nextIndex, HandleShardHop, reinterpret_cast<void *>(nextIndex));
+}
+
+static void HandleShardMessage(IPEndPointBasis *endPoint, PacketBuffer *msg, const IPPacketInfo *pktInfo)
+{
+    // Datagrams must be delivered on the thread of the shard that owns the end point.
+    if (sShards.ShardIndexFor(endPoint->Layer().SystemLayer()) < 0)
+        __atomic_add_fetch(&sShardDatagramsMisrouted, 1, __ATOMIC_RELAXED);
+
+    __atomic_add_fetch(&sShardDatagramsReceived, 1, __ATOMIC_RELEASE);
+    PacketBuffer::Free(msg);
+}
+
+// Run several event loop shards on their own threads. Work is handed from
+// shard to shard with ScheduleWork(), then a UDP end point bound to the same
+// port in every shard receives datagrams sent, from several source ports, by
+// an end point of the test's own (unsharded) InetLayer.
+static void TestEventLoopShards(nlTestSuite *inSuite, void *inContext)
+{
+    enum
+    {
+        kNumSenders         = 8,
+        kDatagramsPerSender = 64,
+        kPayloadSize        = 64
+    };
+
+    INET_ERROR err;
+    IPAddress loopback;
+    UDPEndPoint *rxEPs[kNumTestShards] = { NULL };
+    UDPEndPoint *txEPs[kNumSenders] = { NULL };
+    PacketBuffer *buf = NULL;
+    IPPacketInfo pktInfo;
+    uint16_t port = 0;
+    uint32_t sent = 0;
+    int idle = 0;
+
+    NL_TEST_ASSERT(inSuite, IPAddress::FromString("::1", loopback));
+
+    err = sShards.Init(kNumTestShards);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+    VerifyOrExit(err == INET_NO_ERROR, );
+
+    // End points are set up before the shard threads start, so this thread may touch them.
+    for (size_t i = 0; i < kNumTestShards; i++)
+    {
+        err = sShards.Inet(i).NewUDPEndPoint(&rxEPs[i]);
+        NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+        VerifyOrExit(err == INET_NO_ERROR, );
+
+        err = rxEPs[i]->Bind(kIPAddressType_IPv6, loopback, port);
+        NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+        VerifyOrExit(err == INET_NO_ERROR, );
+
+        rxEPs[i]->OnMessageReceived = HandleShardMessage;
+        err = rxEPs[i]->Listen();
+        NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+
+        port = rxEPs[i]->GetBoundPort();
+    }
+
+    sShardHops = 0;
+    sShardHopsMisrouted = 0;
+    sShardDatagramsReceived = 0;
+    sShardDatagramsMisrouted = 0;
+
+    err = sShards.Start();
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+    VerifyOrExit(err == INET_NO_ERROR, );
+
+    err = sShards.ScheduleWork(0, HandleShardHop, reinterpret_cast<void *>(0));
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+
+    for (idle = 0; __atomic_load_n(&sShardHops, __ATOMIC_ACQUIRE) < kNumShardHops && idle < 5000; idle++)
+    {
+        struct timespec sleepTime = { 0, 1000000 };
+        nanosleep(&sleepTime, NULL);
+    }
+
+    NL_TEST_ASSERT(inSuite, sShardHops == kNumShardHops);
+    NL_TEST_ASSERT(inSuite, sShardHopsMisrouted == 0);
+
+    buf = PacketBuffer::New();
+    VerifyOrExit(buf != NULL, NL_TEST_ASSERT(inSuite, buf != NULL));
+    memset(buf->Start(), 0x5A, kPayloadSize);
+    buf->SetDataLength(kPayloadSize);
+
+    pktInfo.Clear();
+    pktInfo.DestAddress = loopback;
+    pktInfo.DestPort = port;
+
+    for (size_t i = 0; i < kNumSenders; i++)
+    {
+        err = Inet.NewUDPEndPoint(&txEPs[i]);
+        NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+        VerifyOrExit(err == INET_NO_ERROR, );
+
+        err = txEPs[i]->Bind(kIPAddressType_IPv6, loopback, 0);
+        NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+        VerifyOrExit(err == INET_NO_ERROR, );
+
+        for (size_t j = 0; j < kDatagramsPerSender; j++)
+        {
+            err = txEPs[i]->SendMsg(&pktInfo, buf, UDPEndPoint::kSendFlag_RetainBuffer);
+            NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+            if (err == INET_NO_ERROR)
+                sent++;
+        }
+    }
+
+    for (idle = 0; __atomic_load_n(&sShardDatagramsReceived, __ATOMIC_ACQUIRE) < sent && idle < 5000; idle++)
+    {
+        struct timespec sleepTime = { 0, 1000000 };
+        nanosleep(&sleepTime, NULL);
+    }
+
+    NL_TEST_ASSERT(inSuite, sShardDatagramsReceived == sent);
+    NL_TEST_ASSERT(inSuite, sShardDatagramsMisrouted == 0);
+
+exit:
+    // Stopping the shards first makes it safe to free their end points from this thread.
+    sShards.Stop();
+
+    if (buf != NULL)
+        PacketBuffer::Free(buf);
+    for (size_t i = 0; i < kNumSenders; i++)
+        if (txEPs[i] != NULL)
+            txEPs[i]->Free();
+    for (size_t i = 0; i < kNumTestShards; i++)
+        if (rxEPs[i] != NULL)
+            rxEPs[i]->Free();
+
+    sShards.Shutdown();
+}
+#endif // INET_CONFIG_ENABLE_EVENT_LOOP_SHARDS && INET_CONFIG_ENABLE_UDP_ENDPOINT
+
 // Test the InetLayer resource limitation
 static void TestInetEndPointLimit(nlTestSuite *inSuite, void *inContext)
 {
@@ -571,6 +1223,18 @@ static const nlTest sTests[] = {
     NL_TEST_DEF("InetEndPoint::TestInetError",       TestInetError),
     NL_TEST_DEF("InetEndPoint::TestInetInterface",   TestInetInterface),
     NL_TEST_DEF("InetEndPoint::TestInetEndPoint",    TestInetEndPoint),
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS && INET_CONFIG_ENABLE_UDP_ENDPOINT
+    NL_TEST_DEF("InetEndPoint::TestUDPThroughput",   TestUDPThroughput),
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS && INET_CONFIG_ENABLE_UDP_ENDPOINT
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS && INET_CONFIG_ENABLE_TCP_ENDPOINT
+    NL_TEST_DEF("InetEndPoint::TestTCPBulkThroughput", TestTCPBulkThroughput),
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS && INET_CONFIG_ENABLE_TCP_ENDPOINT
+#if INET_CONFIG_ENABLE_EPOLL && INET_CONFIG_ENABLE_UDP_ENDPOINT
+    NL_TEST_DEF("InetEndPoint::TestEpollBackend",    TestEpollBackend),
+#endif // INET_CONFIG_ENABLE_EPOLL && INET_CONFIG_ENABLE_UDP_ENDPOINT
+#if INET_CONFIG_ENABLE_EVENT_LOOP_SHARDS && INET_CONFIG_ENABLE_UDP_ENDPOINT
+    NL_TEST_DEF("InetEndPoint::TestEventLoopShards", TestEventLoopShards),
+#endif // INET_CONFIG_ENABLE_EVENT_LOOP_SHARDS && INET_CONFIG_ENABLE_UDP_ENDPOINT
     NL_TEST_DEF("InetEndPoint::TestEndPointLimit",   TestInetEndPointLimit),
     NL_TEST_SENTINEL()
 };
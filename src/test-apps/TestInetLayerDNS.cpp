@@ -471,6 +471,142 @@ static void TestDNSResolution_Simultaneous(nlTestSuite *testSuite, void *inConte
     NL_TEST_ASSERT(testSuite, sNumResInProgress == 0);
 }
 
+#if INET_CONFIG_ENABLE_DNS_CACHE
+
+struct DNSCacheTestContext
+{
+    uint32_t callbackCount;
+    INET_ERROR err;
+    uint8_t addrCount;
+    IPAddress resultsBuf[kMaxResults];
+};
+
+static uint32_t sNumStubLookups = 0;
+
+static INET_ERROR StubResolve(const char *hostName, uint8_t options, uint8_t maxAddrs, IPAddress *addrArray,
+                              uint8_t &numAddrs, uint32_t &ttlSecs)
+{
+    sNumStubLookups++;
+
+    if (strcmp(hostName, "stub.nest.com") != 0)
+        return INET_ERROR_HOST_NOT_FOUND;
+
+    IPAddress::FromString("fd00::1", addrArray[0]);
+    IPAddress::FromString("fd00::2", addrArray[1]);
+    numAddrs = 2;
+
+    return INET_NO_ERROR;
+}
+
+static void HandleCachedResolutionComplete(void *appState, INET_ERROR err, uint8_t addrCount, IPAddress *addrArray)
+{
+    DNSCacheTestContext & testContext = *static_cast<DNSCacheTestContext *>(appState);
+
+    testContext.callbackCount++;
+    testContext.err = err;
+    testContext.addrCount = addrCount;
+
+    if (--sNumResInProgress == 0)
+    {
+        Done = true;
+    }
+}
+
+static INET_ERROR StartCachedResolution(const char *hostName, DNSCacheTestContext & testContext)
+{
+    Done = false;
+    sNumResInProgress++;
+
+    return Inet.ResolveHostAddress(hostName, kMaxResults, testContext.resultsBuf, HandleCachedResolutionComplete,
+                                   (void *)&testContext);
+}
+
+/**
+ * Test that the DNS cache coalesces concurrent requests and answers later ones from cached results.
+ */
+static void TestDNSResolution_Cache(nlTestSuite * testSuite, void * testContext)
+{
+    DNSCache & cache = Inet.GetDNSCache();
+    DNSCacheTestContext waiters[4];
+    DNSCacheTestContext canceled;
+    DNSCacheTestContext missing;
+    DNSCache::Stats stats;
+    IPAddress expectAddr;
+    INET_ERROR err;
+
+    memset(waiters, 0, sizeof(waiters));
+    memset(&canceled, 0, sizeof(canceled));
+    memset(&missing, 0, sizeof(missing));
+
+    cache.Flush();
+    cache.SetStubResolver(StubResolve);
+    sNumStubLookups = 0;
+    sNumResInProgress = 0;
+
+    // Requests made while a lookup is in progress wait for it.
+    for (DNSCacheTestContext & waiter : waiters)
+    {
+        err = StartCachedResolution("stub.nest.com", waiter);
+        NL_TEST_ASSERT(testSuite, err == INET_NO_ERROR);
+    }
+
+    err = Inet.ResolveHostAddress("stub.nest.com", kMaxResults, canceled.resultsBuf, HandleCachedResolutionComplete,
+                                  (void *)&canceled);
+    NL_TEST_ASSERT(testSuite, err == INET_NO_ERROR);
+    Inet.CancelResolveHostAddress(HandleCachedResolutionComplete, (void *)&canceled);
+
+    ServiceNetworkUntilDone(DEFAULT_TEST_DURATION_MILLISECS);
+    NL_TEST_ASSERT(testSuite, Done == true);
+    NL_TEST_ASSERT(testSuite, sNumStubLookups == 1);
+    NL_TEST_ASSERT(testSuite, canceled.callbackCount == 0);
+
+    IPAddress::FromString("fd00::2", expectAddr);
+    for (DNSCacheTestContext & waiter : waiters)
+    {
+        NL_TEST_ASSERT(testSuite, waiter.callbackCount == 1);
+        NL_TEST_ASSERT(testSuite, waiter.err == INET_NO_ERROR);
+        NL_TEST_ASSERT(testSuite, waiter.addrCount == 2);
+        NL_TEST_ASSERT(testSuite, waiter.resultsBuf[1] == expectAddr);
+    }
+
+    // A later request is answered from the cache before ResolveHostAddress() returns.
+    err = StartCachedResolution("stub.nest.com", waiters[0]);
+    NL_TEST_ASSERT(testSuite, err == INET_NO_ERROR);
+    NL_TEST_ASSERT(testSuite, waiters[0].callbackCount == 2);
+    NL_TEST_ASSERT(testSuite, sNumStubLookups == 1);
+
+    // Failed resolutions are cached too.
+    err = StartCachedResolution("missing.nest.com", missing);
+    NL_TEST_ASSERT(testSuite, err == INET_NO_ERROR);
+    ServiceNetworkUntilDone(DEFAULT_TEST_DURATION_MILLISECS);
+    err = StartCachedResolution("missing.nest.com", missing);
+    NL_TEST_ASSERT(testSuite, err == INET_NO_ERROR);
+    NL_TEST_ASSERT(testSuite, missing.callbackCount == 2);
+    NL_TEST_ASSERT(testSuite, missing.err == INET_ERROR_HOST_NOT_FOUND);
+    NL_TEST_ASSERT(testSuite, sNumStubLookups == 2);
+
+    // Flushing the cache forces a new lookup.
+    cache.Flush();
+    err = StartCachedResolution("stub.nest.com", waiters[1]);
+    NL_TEST_ASSERT(testSuite, err == INET_NO_ERROR);
+    ServiceNetworkUntilDone(DEFAULT_TEST_DURATION_MILLISECS);
+    NL_TEST_ASSERT(testSuite, waiters[1].callbackCount == 2);
+    NL_TEST_ASSERT(testSuite, sNumStubLookups == 3);
+
+    cache.GetStats(stats);
+    NL_TEST_ASSERT(testSuite, stats.Coalesced >= 4);
+    NL_TEST_ASSERT(testSuite, stats.Hits >= 1);
+    NL_TEST_ASSERT(testSuite, stats.NegativeHits >= 1);
+
+    cache.SetStubResolver(NULL);
+    cache.Flush();
+
+    Done = true;
+    sNumResInProgress = 0;
+}
+
+#endif // INET_CONFIG_ENABLE_DNS_CACHE
+
 static void RunTestCase(nlTestSuite * testSuite, const DNSResolutionTestCase & testCase)
 {
     DNSResolutionTestContext testContext {
@@ -670,6 +806,9 @@ int main(int argc, char *argv[])
         NL_TEST_DEF("TestDNSResolution:NoHostRecord", TestDNSResolution_NoHostRecord),
         NL_TEST_DEF("TestDNSResolution:Cancel", TestDNSResolution_Cancel),
         NL_TEST_DEF("TestDNSResolution:Simultaneous", TestDNSResolution_Simultaneous),
+#if INET_CONFIG_ENABLE_DNS_CACHE
+        NL_TEST_DEF("TestDNSResolution:Cache", TestDNSResolution_Cache),
+#endif // INET_CONFIG_ENABLE_DNS_CACHE
         NL_TEST_SENTINEL()
     };
 
@@ -27,6 +27,7 @@
 #define __STDC_LIMIT_MACROS
 #endif
 #include <stdint.h>
+#include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
 #include <errno.h>
@@ -37,6 +38,12 @@
 #include <lwip/tcpip.h>
 #endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
 
+#if WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE
+#include <pthread.h>
+
+#include <SystemLayer/SystemStats.h>
+#endif // WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE
+
 #include <nlunit-test.h>
 
 using ::nl::Weave::System::PacketBuffer;
@@ -134,10 +141,15 @@ static void BufferAlloc(struct TestContext* theContext)
     theContext->buf->pool = lPool;
 #endif // LWIP_PBUF_FROM_CUSTOM_POOLS
 #else // !WEAVE_SYSTEM_CONFIG_USE_LWIP
+#if WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES
+    const uint16_t lClassAllocSize = theContext->buf->alloc_size;
+#endif // WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES
     memset(theContext->buf, 0, lAllocSize);
 #if WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC == 0
     theContext->buf->alloc_size = lAllocSize;
-#endif // WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC == 0
+#elif WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES
+    theContext->buf->alloc_size = lClassAllocSize;
+#endif // WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES
 #endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
 
     theContext->start_buffer = reinterpret_cast<uint8_t*>(theContext->buf);
@@ -636,6 +648,93 @@ static void CheckCompactHead(nlTestSuite *inSuite, void *inContext)
     }
 }
 
+/**
+ *  Test PacketBuffer::EnsureContiguous() function.
+ *
+ *  Description: Build a chain of two buffers, the first one with reserved
+ *               space and both holding a run of consecutive byte values.
+ *               For a range of lengths around the buffer capacity, call
+ *               EnsureContiguous() on the first buffer. Then, verify that
+ *               the first buffer holds the requested data in order, that
+ *               the data is moved to the front of the buffer only when the
+ *               space after it is too small, that no more data than
+ *               requested is moved, and that an emptied second buffer is
+ *               removed from the chain.
+ */
+static void CheckEnsureContiguous(nlTestSuite *inSuite, void *inContext)
+{
+    const uint16_t kReserve = 64;
+    const uint16_t kLen1 = 100;
+    const uint16_t kCapacity = WEAVE_SYSTEM_CONFIG_PACKETBUFFER_CAPACITY_MAX;
+    const uint16_t kLengths[] = { 0, 10, kLen1, kLen1 + 1, kCapacity - kReserve, kCapacity - kReserve + 1, kCapacity,
+                                  kCapacity + 1, UINT16_MAX };
+
+    for (size_t ith = 0; ith < sizeof(kLengths) / sizeof(kLengths[0]); ith++)
+    {
+        PacketBuffer *buffer_1 = PacketBuffer::New(kReserve);
+        PacketBuffer *buffer_2 = PacketBuffer::New(0);
+        const uint16_t length = kLengths[ith];
+        uint16_t len2;
+        uint16_t total;
+        uint16_t avail;
+        uint8_t *origStart;
+
+        NL_TEST_ASSERT(inSuite, buffer_1 != NULL && buffer_2 != NULL);
+        if (buffer_1 == NULL || buffer_2 == NULL)
+        {
+            PacketBuffer::Free(buffer_1);
+            PacketBuffer::Free(buffer_2);
+            return;
+        }
+
+        len2 = buffer_2->MaxDataLength();
+        total = kLen1 + len2;
+
+        for (uint16_t i = 0; i < kLen1; i++)
+            buffer_1->Start()[i] = static_cast<uint8_t>(i);
+        for (uint16_t i = 0; i < len2; i++)
+            buffer_2->Start()[i] = static_cast<uint8_t>(kLen1 + i);
+        buffer_1->SetDataLength(kLen1);
+        buffer_2->SetDataLength(len2);
+        buffer_1->AddToEnd(buffer_2);
+
+        origStart = buffer_1->Start();
+        avail = buffer_1->AvailableDataLength();
+
+        if (length > buffer_1->MaxDataLength() + buffer_1->ReservedSize())
+        {
+            // Too long to ever fit: nothing changes.
+            NL_TEST_ASSERT(inSuite, !buffer_1->EnsureContiguous(length));
+            NL_TEST_ASSERT(inSuite, buffer_1->Start() == origStart);
+            NL_TEST_ASSERT(inSuite, buffer_1->DataLength() == kLen1);
+            NL_TEST_ASSERT(inSuite, buffer_1->Next() == buffer_2);
+        }
+        else
+        {
+            const uint16_t expectLen = (length > kLen1) ? length : kLen1;
+
+            NL_TEST_ASSERT(inSuite, buffer_1->EnsureContiguous(length));
+            NL_TEST_ASSERT(inSuite, buffer_1->DataLength() == expectLen);
+            NL_TEST_ASSERT(inSuite, buffer_1->TotalLength() == total);
+            NL_TEST_ASSERT(inSuite, (buffer_1->Start() == origStart) == (expectLen - kLen1 <= avail));
+
+            for (uint16_t i = 0; i < expectLen; i++)
+                NL_TEST_ASSERT(inSuite, buffer_1->Start()[i] == static_cast<uint8_t>(i));
+
+            if (expectLen == total)
+                NL_TEST_ASSERT(inSuite, buffer_1->Next() == NULL);
+            else
+            {
+                NL_TEST_ASSERT(inSuite, buffer_1->Next() == buffer_2);
+                NL_TEST_ASSERT(inSuite, buffer_2->DataLength() == total - expectLen);
+                NL_TEST_ASSERT(inSuite, buffer_2->Start()[0] == static_cast<uint8_t>(expectLen));
+            }
+        }
+
+        PacketBuffer::Free(buffer_1);
+    }
+}
+
 /**
  *  Test PacketBuffer::ConsumeHead() function.
  *
@@ -1098,6 +1197,176 @@ static void CheckFreeHead(nlTestSuite *inSuite, void *inContext)
     }
 }
 
+#if WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE
+
+enum
+{
+    kThreadCacheTestThreads     = 4,
+    kThreadCacheTestIterations  = 10000,
+    kThreadCacheTestHeld        = WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE_SIZE + 1
+};
+
+/**
+ *  Allocate every buffer that can currently be allocated, free them all again and return how many there were.
+ */
+static size_t CountAllocatableBuffers(void)
+{
+    PacketBuffer *buffers[WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC];
+    size_t count = 0;
+
+    while (count < WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC &&
+           (buffers[count] = PacketBuffer::NewWithAvailableSize(0, 0)) != NULL)
+    {
+        count++;
+    }
+
+    for (size_t ith = 0; ith < count; ith++)
+    {
+        PacketBuffer::Free(buffers[ith]);
+    }
+
+    return count;
+}
+
+/**
+ *  Repeatedly allocate and free a handful of buffers, enough to make the thread's cache overflow into the shared pool.
+ */
+static void *ThreadCacheWorker(void *inArg)
+{
+    PacketBuffer *buffers[kThreadCacheTestHeld];
+
+    (void)inArg;
+
+    for (size_t iteration = 0; iteration < kThreadCacheTestIterations; iteration++)
+    {
+        for (size_t ith = 0; ith < kThreadCacheTestHeld; ith++)
+        {
+            buffers[ith] = PacketBuffer::NewWithAvailableSize(0, 0);
+        }
+
+        for (size_t ith = 0; ith < kThreadCacheTestHeld; ith++)
+        {
+            if (buffers[ith] != NULL)
+            {
+                buffers[ith]->AddRef();
+                PacketBuffer::Free(buffers[ith]);
+                PacketBuffer::Free(buffers[ith]);
+            }
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ *  Test the per-thread packet buffer caches.
+ *
+ *  Description: Run several threads that allocate and free buffers concurrently, then verify that once the threads
+ *               have exited, every buffer they cached has been returned to the shared pool and no buffer has been
+ *               lost or handed out twice.
+ */
+static void CheckThreadCache(nlTestSuite *inSuite, void *inContext)
+{
+    pthread_t threads[kThreadCacheTestThreads];
+    nl::Weave::System::Stats::PacketBufferCacheCounters counters;
+    size_t countBefore;
+    size_t countAfter;
+
+    (void)inContext;
+
+    countBefore = CountAllocatableBuffers();
+
+    for (size_t ith = 0; ith < kThreadCacheTestThreads; ith++)
+    {
+        NL_TEST_ASSERT(inSuite, pthread_create(&threads[ith], NULL, ThreadCacheWorker, NULL) == 0);
+    }
+
+    for (size_t ith = 0; ith < kThreadCacheTestThreads; ith++)
+    {
+        pthread_join(threads[ith], NULL);
+    }
+
+    countAfter = CountAllocatableBuffers();
+
+    NL_TEST_ASSERT(inSuite, countBefore > 0);
+    NL_TEST_ASSERT(inSuite, countAfter == countBefore);
+
+    nl::Weave::System::Stats::GetPacketBufferCacheCounters(counters);
+
+    NL_TEST_ASSERT(inSuite, counters.mRefills > 0);
+    NL_TEST_ASSERT(inSuite, counters.mDrains > 0);
+
+    printf("thread cache: %zu buffers, %u refills, %u drains, %u pool contentions\n", countAfter,
+           counters.mRefills, counters.mDrains, counters.mPoolContentions);
+}
+
+#endif // WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE
+
+#if WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES
+
+/**
+ *  Test PacketBuffer size classes.
+ *
+ *  Description: Verify that NewWithAvailableSize() serves each request from the smallest size class that fits it, that it
+ *               falls back to a larger class once a pool is exhausted, and that RightSize() moves a short message from a
+ *               full-size buffer into a small one without changing its contents.
+ */
+static void CheckSizeClasses(nlTestSuite *inSuite, void *inContext)
+{
+    PacketBuffer *small[WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SMALL_MAXALLOC];
+    PacketBuffer *buffer;
+    size_t count = 0;
+
+    (void)inContext;
+
+    buffer = PacketBuffer::NewWithAvailableSize(0, 10);
+    NL_TEST_ASSERT(inSuite, buffer != NULL);
+    NL_TEST_ASSERT(inSuite, buffer->AllocSize() >= WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SMALL_CAPACITY);
+    NL_TEST_ASSERT(inSuite, buffer->AllocSize() < WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MEDIUM_CAPACITY);
+    PacketBuffer::Free(buffer);
+
+    buffer = PacketBuffer::NewWithAvailableSize(0, WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MEDIUM_CAPACITY);
+    NL_TEST_ASSERT(inSuite, buffer != NULL);
+    NL_TEST_ASSERT(inSuite, buffer->AllocSize() >= WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MEDIUM_CAPACITY);
+    NL_TEST_ASSERT(inSuite, buffer->AllocSize() < WEAVE_SYSTEM_CONFIG_PACKETBUFFER_CAPACITY_MAX);
+    PacketBuffer::Free(buffer);
+
+    buffer = PacketBuffer::New(0);
+    NL_TEST_ASSERT(inSuite, buffer != NULL);
+    NL_TEST_ASSERT(inSuite, buffer->AllocSize() >= WEAVE_SYSTEM_CONFIG_PACKETBUFFER_CAPACITY_MAX);
+
+    memset(buffer->Start(), 0xA5, 20);
+    buffer->SetDataLength(20);
+    buffer = PacketBuffer::RightSize(buffer);
+    NL_TEST_ASSERT(inSuite, buffer != NULL);
+    NL_TEST_ASSERT(inSuite, buffer->AllocSize() < WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MEDIUM_CAPACITY);
+    NL_TEST_ASSERT(inSuite, buffer->DataLength() == 20);
+    NL_TEST_ASSERT(inSuite, buffer->Start()[0] == 0xA5 && buffer->Start()[19] == 0xA5);
+    PacketBuffer::Free(buffer);
+
+    // Exhaust the small pool; the next small request is served by the medium pool.
+    while (count < WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SMALL_MAXALLOC)
+    {
+        small[count] = PacketBuffer::NewWithAvailableSize(0, 10);
+        NL_TEST_ASSERT(inSuite, small[count] != NULL);
+        if (small[count] == NULL)
+            break;
+        count++;
+    }
+
+    buffer = PacketBuffer::NewWithAvailableSize(0, 10);
+    NL_TEST_ASSERT(inSuite, buffer != NULL);
+    NL_TEST_ASSERT(inSuite, buffer->AllocSize() >= WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MEDIUM_CAPACITY);
+    PacketBuffer::Free(buffer);
+
+    for (size_t ith = 0; ith < count; ith++)
+    {
+        PacketBuffer::Free(small[ith]);
+    }
+}
+
+#endif // WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES
+
 /**
  *  Test PacketBuffer::BuildFreeList() function.
  */
@@ -1112,6 +1381,12 @@ static void CheckBuildFreeList(nlTestSuite *inSuite, void *inContext)
  *   Test Suite. It lists all the test functions.
  */
 static const nlTest sTests[] = {
+#if WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE
+    NL_TEST_DEF("PacketBuffer thread caches",                   CheckThreadCache),
+#endif // WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE
+#if WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES
+    NL_TEST_DEF("PacketBuffer size classes",                    CheckSizeClasses),
+#endif // WEAVE_SYSTEM_CONFIG_PACKETBUFFER_SIZE_CLASSES
     NL_TEST_DEF("PacketBuffer::NewWithAvailableSize&PacketBuffer::Free", CheckNewWithAvailableSizeAndFree),
     NL_TEST_DEF("PacketBuffer::Start",                          CheckStart),
     NL_TEST_DEF("PacketBuffer::SetStart",                       CheckSetStart),
@@ -1124,6 +1399,7 @@ static const nlTest sTests[] = {
     NL_TEST_DEF("PacketBuffer::AddToEnd",                       CheckAddToEnd),
     NL_TEST_DEF("PacketBuffer::DetachTail",                     CheckDetachTail),
     NL_TEST_DEF("PacketBuffer::CompactHead",                    CheckCompactHead),
+    NL_TEST_DEF("PacketBuffer::EnsureContiguous",               CheckEnsureContiguous),
     NL_TEST_DEF("PacketBuffer::ConsumeHead",                    CheckConsumeHead),
     NL_TEST_DEF("PacketBuffer::Consume",                        CheckConsume),
     NL_TEST_DEF("PacketBuffer::EnsureReservedSize",             CheckEnsureReservedSize),
@@ -69,6 +69,7 @@ public:
     Error Init(void);
 
     static void CheckRetention(nlTestSuite* inSuite, void* aContext);
+    static void CheckIteration(nlTestSuite* inSuite, void* aContext);
     static void CheckConcurrency(nlTestSuite* inSuite, void* aContext);
     static void CheckHighWatermark(nlTestSuite* inSuite, void* aContext);
     static void CheckHighWatermarkConcurrency(nlTestSuite* inSuite, void* aContext);
@@ -183,6 +184,81 @@ void TestObject::CheckRetention(nlTestSuite* inSuite, void* aContext)
 }
 
 
+// Test Object iteration and reuse
+
+void TestObject::CheckIteration(nlTestSuite* inSuite, void* aContext)
+{
+    TestContext&    lContext = *static_cast<TestContext*>(aContext);
+    Layer           lLayer;
+    TestObject*     lObject;
+    unsigned int    lVisited = 0;
+    unsigned int    lRetained = 0;
+    unsigned int    i;
+
+    lLayer.Init(lContext.mLayerContext);
+    memset(&sPool, 0, sizeof(sPool));
+
+    for (i = 0; i < kPoolSize; ++i)
+    {
+        lObject = sPool.TryCreate(lLayer);
+        NL_TEST_ASSERT(lContext.mTestSuite, lObject != NULL);
+    }
+
+    // Release every other object, then iterate over the pool.
+
+    for (i = 1; i < kPoolSize; i += 2)
+    {
+        lObject = sPool.Get(lLayer, i);
+        NL_TEST_ASSERT(lContext.mTestSuite, lObject != NULL);
+        if (lObject != NULL)
+            lObject->Release();
+    }
+
+    for (i = sPool.NextIndex(0); i < kPoolSize; i = sPool.NextIndex(i + 1))
+    {
+        lVisited++;
+
+        if (sPool.Get(lLayer, i) != NULL)
+        {
+            NL_TEST_ASSERT(lContext.mTestSuite, i % 2 == 0);
+            lRetained++;
+        }
+    }
+
+    NL_TEST_ASSERT(lContext.mTestSuite, lRetained == kPoolSize / 2);
+#if WEAVE_SYSTEM_CONFIG_USE_OBJECT_POOL_FREE_LIST
+    NL_TEST_ASSERT(lContext.mTestSuite, lVisited == lRetained);
+#else // !WEAVE_SYSTEM_CONFIG_USE_OBJECT_POOL_FREE_LIST
+    NL_TEST_ASSERT(lContext.mTestSuite, lVisited == kPoolSize);
+#endif // !WEAVE_SYSTEM_CONFIG_USE_OBJECT_POOL_FREE_LIST
+
+    // The released objects, and only those, can be allocated again.
+
+    for (i = 1; i < kPoolSize; i += 2)
+    {
+        lObject = sPool.TryCreate(lLayer);
+        NL_TEST_ASSERT(lContext.mTestSuite, lObject != NULL);
+    }
+
+    lObject = sPool.TryCreate(lLayer);
+    NL_TEST_ASSERT(lContext.mTestSuite, lObject == NULL);
+
+    // Cleanup
+
+    for (i = 0; i < kPoolSize; ++i)
+    {
+        lObject = sPool.Get(lLayer, i);
+        NL_TEST_ASSERT(lContext.mTestSuite, lObject != NULL);
+        if (lObject != NULL)
+            lObject->Release();
+    }
+
+    NL_TEST_ASSERT(lContext.mTestSuite, sPool.NextIndex(0) == (WEAVE_SYSTEM_CONFIG_USE_OBJECT_POOL_FREE_LIST ? kPoolSize : 0));
+
+    lLayer.Shutdown();
+}
+
+
 // Test Object concurrency
 
 #if WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
@@ -454,6 +530,7 @@ void TestObject::CheckHighWatermark(nlTestSuite* inSuite, void* aContext)
  */
 const nlTest sTests[] = {
     NL_TEST_DEF("Retention", TestObject::CheckRetention),
+    NL_TEST_DEF("Iteration", TestObject::CheckIteration),
     NL_TEST_DEF("Concurrency", TestObject::CheckConcurrency),
     NL_TEST_DEF("HighWatermark", TestObject::CheckHighWatermark),
     NL_TEST_DEF("HighWatermarkConcurrency", TestObject::CheckHighWatermarkConcurrency),
@@ -29,6 +29,8 @@
 #endif
 
 #include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <errno.h>
 
@@ -43,6 +45,12 @@
 #include <sys/select.h>
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS && WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS && WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
+
 #include <SystemLayer/SystemError.h>
 #include <SystemLayer/SystemLayer.h>
 #include <SystemLayer/SystemTimer.h>
@@ -189,6 +197,448 @@ static void CheckStarvation(nlTestSuite* inSuite, void* aContext)
 }
 
 
+static const size_t kNumCancelTimers = 16;
+static uint32_t sCancelTimerFired[kNumCancelTimers];
+
+void HandleCancelTimer(Layer *aLayer, void * aState, Error aError)
+{
+    uint32_t& lFired = *static_cast<uint32_t*>(aState);
+
+    lFired++;
+}
+
+static void CheckCancel(nlTestSuite* inSuite, void* aContext)
+{
+    TestContext& lContext = *static_cast<TestContext*>(aContext);
+    Layer& lSys = *lContext.mLayer;
+    const size_t lNumTimers = (kNumCancelTimers < WEAVE_SYSTEM_CONFIG_NUM_TIMERS) ? kNumCancelTimers : WEAVE_SYSTEM_CONFIG_NUM_TIMERS;
+    const Timer::Epoch kStartEpoch = Timer::GetCurrentEpoch();
+
+    memset(sCancelTimerFired, 0, sizeof(sCancelTimerFired));
+
+    for (size_t i = 0; i < lNumTimers; i++)
+    {
+        Error lError = lSys.StartTimer(static_cast<uint32_t>(5 + i), HandleCancelTimer, &sCancelTimerFired[i]);
+        NL_TEST_ASSERT(inSuite, lError == WEAVE_SYSTEM_NO_ERROR);
+    }
+
+    // Re-starting a timer replaces it; cancelling it prevents it from firing.
+    for (size_t i = 0; i < lNumTimers; i += 2)
+    {
+        lSys.StartTimer(static_cast<uint32_t>(10 + i), HandleCancelTimer, &sCancelTimerFired[i]);
+        lSys.CancelTimer(HandleCancelTimer, &sCancelTimerFired[i]);
+    }
+
+    while (Timer::GetCurrentEpoch() < kStartEpoch + 10 + lNumTimers + 20)
+    {
+        struct timeval sleepTime;
+        sleepTime.tv_sec = 0;
+        sleepTime.tv_usec = 1000; // 1 ms tick
+        ServiceEvents(lSys, sleepTime);
+    }
+
+    for (size_t i = 0; i < lNumTimers; i++)
+    {
+        NL_TEST_ASSERT(inSuite, sCancelTimerFired[i] == ((i % 2 == 0) ? 0 : 1));
+    }
+}
+
+static const Timer::Epoch kRestartTestDuration = 200;
+static const Timer::Epoch kRestartMaxGap = 100;
+static Timer::Epoch sRestartLastFired;
+static Timer::Epoch sRestartMaxGap;
+static uint32_t sRestartFired;
+
+void HandleRestartTimer(Layer *aLayer, void * aState, Error aError)
+{
+    const Timer::Epoch kNow = Timer::GetCurrentEpoch();
+
+    if (kNow - sRestartLastFired > sRestartMaxGap)
+        sRestartMaxGap = kNow - sRestartLastFired;
+
+    sRestartLastFired = kNow;
+    sRestartFired++;
+
+    aLayer->StartTimer(0, HandleRestartTimer, aState);
+}
+
+static void CheckRestartFromCallback(nlTestSuite* inSuite, void* aContext)
+{
+    TestContext& lContext = *static_cast<TestContext*>(aContext);
+    Layer& lSys = *lContext.mLayer;
+    const Timer::Epoch kStartEpoch = Timer::GetCurrentEpoch();
+
+    // The starvation test leaves its timer armed; keep it from firing while this test services the layer.
+    lSys.CancelTimer(HandleGreedyTimer, aContext);
+
+    sRestartLastFired = kStartEpoch;
+    sRestartMaxGap = 0;
+    sRestartFired = 0;
+
+    // A timer restarted with no delay from its own completion callback must fire again promptly, however the expiry pass that
+    // ran the callback fell relative to the timer tick.
+    lSys.StartTimer(0, HandleRestartTimer, aContext);
+
+    while (Timer::GetCurrentEpoch() < kStartEpoch + kRestartTestDuration)
+    {
+        struct timeval sleepTime;
+        sleepTime.tv_sec = 0;
+        sleepTime.tv_usec = 1000; // 1 ms tick
+        ServiceEvents(lSys, sleepTime);
+    }
+
+    lSys.CancelTimer(HandleRestartTimer, aContext);
+
+    NL_TEST_ASSERT(inSuite, sRestartFired > 0);
+    NL_TEST_ASSERT(inSuite, sRestartMaxGap < kRestartMaxGap);
+    NL_TEST_ASSERT(inSuite, Timer::GetCurrentEpoch() - sRestartLastFired < kRestartMaxGap);
+}
+
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS && WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
+static const size_t kNumWorkProducers = 4;
+static const size_t kNumWorkPerProducer = 2500;
+static uint32_t sWorkHandled[kNumWorkProducers];
+
+struct WorkProducer
+{
+    Layer* mLayer;
+    size_t mCount;
+    Layer::TimerCompleteFunct mComplete;
+    void* mAppState;
+    uint64_t* mPostTimes;
+};
+
+void HandleProducedWork(Layer *aLayer, void * aState, Error aError)
+{
+    uint32_t& lHandled = *static_cast<uint32_t*>(aState);
+
+    lHandled++;
+}
+
+// Post work to the layer from a thread other than the one servicing it, retrying while the layer is out of resources.
+static void* RunWorkProducer(void* aProducer)
+{
+    WorkProducer& lProducer = *static_cast<WorkProducer*>(aProducer);
+
+    for (size_t i = 0; i < lProducer.mCount; i++)
+    {
+        void* lAppState = lProducer.mAppState;
+
+        if (lProducer.mPostTimes != NULL)
+        {
+            lProducer.mPostTimes[i] = Layer::GetClock_MonotonicHiRes();
+            lAppState = &lProducer.mPostTimes[i];
+        }
+
+        while (lProducer.mLayer->ScheduleWork(lProducer.mComplete, lAppState) == WEAVE_SYSTEM_ERROR_NO_MEMORY)
+            sched_yield();
+    }
+
+    return NULL;
+}
+
+static void CheckCrossThreadScheduleWork(nlTestSuite* inSuite, void* aContext)
+{
+    TestContext& lContext = *static_cast<TestContext*>(aContext);
+    Layer& lSys = *lContext.mLayer;
+    WorkProducer lProducers[kNumWorkProducers];
+    pthread_t lThreads[kNumWorkProducers];
+    const uint64_t kDeadline = Layer::GetClock_MonotonicMS() + 10000;
+    bool lDone = false;
+
+    // The starvation test leaves its timer armed; keep it from firing while this test services the layer.
+    lSys.CancelTimer(HandleGreedyTimer, aContext);
+
+    memset(sWorkHandled, 0, sizeof(sWorkHandled));
+
+    for (size_t i = 0; i < kNumWorkProducers; i++)
+    {
+        lProducers[i].mLayer = &lSys;
+        lProducers[i].mCount = kNumWorkPerProducer;
+        lProducers[i].mComplete = HandleProducedWork;
+        lProducers[i].mAppState = &sWorkHandled[i];
+        lProducers[i].mPostTimes = NULL;
+
+        NL_TEST_ASSERT(inSuite, pthread_create(&lThreads[i], NULL, RunWorkProducer, &lProducers[i]) == 0);
+    }
+
+    // All work is run by this thread, which services the layer, and none of it is lost or run twice.
+    while (!lDone && Layer::GetClock_MonotonicMS() < kDeadline)
+    {
+        struct timeval sleepTime;
+        sleepTime.tv_sec = 0;
+        sleepTime.tv_usec = 10000;
+        ServiceEvents(lSys, sleepTime);
+
+        lDone = true;
+        for (size_t i = 0; i < kNumWorkProducers; i++)
+            lDone = lDone && (sWorkHandled[i] == kNumWorkPerProducer);
+    }
+
+    for (size_t i = 0; i < kNumWorkProducers; i++)
+    {
+        pthread_join(lThreads[i], NULL);
+        NL_TEST_ASSERT(inSuite, sWorkHandled[i] == kNumWorkPerProducer);
+    }
+}
+
+static const size_t kNumWakeRounds = 1000;
+static const size_t kNumWakeBurst = 32;
+static const useconds_t kWakeIdleUS = 200;
+static const uint32_t kMaxWakeSpin = 512;
+static const uint64_t kMaxWakeLatencyMS = 1000;
+static uint32_t sWakeWorkHandled;
+
+struct WakeProducer
+{
+    Layer* mLayer;
+    volatile bool mStalled;
+    volatile bool mDone;
+};
+
+void HandleWakeWork(Layer *aLayer, void * aState, Error aError)
+{
+    __atomic_add_fetch(&sWakeWorkHandled, 1, __ATOMIC_RELEASE);
+}
+
+static void ScheduleWakeWork(Layer& aLayer)
+{
+    while (aLayer.ScheduleWork(HandleWakeWork, NULL) == WEAVE_SYSTEM_ERROR_NO_MEMORY)
+        sched_yield();
+}
+
+// Post bursts of work while the select thread is asleep, waiting for each burst to run before posting the next.
+static void* RunWakeProducer(void* aProducer)
+{
+    WakeProducer& lProducer = *static_cast<WakeProducer*>(aProducer);
+    uint32_t lSpin = 1;
+
+    for (size_t i = 0; i < kNumWakeRounds && !lProducer.mStalled; i++)
+    {
+        const uint32_t lExpected = static_cast<uint32_t>(kNumWakeBurst * (i + 1));
+        uint64_t lPosted;
+
+        // Let the select thread go back to sleep, so that only this burst can wake it.
+        usleep(kWakeIdleUS);
+
+        // The first post wakes the select thread. The posts after it, spaced by varying delays, land at different points of
+        // that wake-up, including between HandleSelectResult() noticing it and draining the wake pipe.
+        for (size_t j = 0; j < kNumWakeBurst; j++)
+        {
+            ScheduleWakeWork(*lProducer.mLayer);
+
+            lSpin = lSpin * 1103515245 + 12345;
+            for (volatile uint32_t k = 0; k < (lSpin >> 16) % kMaxWakeSpin; k++)
+                continue;
+        }
+
+        lPosted = Layer::GetClock_MonotonicMS();
+        while (__atomic_load_n(&sWakeWorkHandled, __ATOMIC_ACQUIRE) < lExpected)
+        {
+            if (Layer::GetClock_MonotonicMS() - lPosted > kMaxWakeLatencyMS)
+            {
+                lProducer.mStalled = true;
+                break;
+            }
+
+            sched_yield();
+        }
+    }
+
+    lProducer.mDone = true;
+
+    // Wake the select thread so that it notices this thread is done.
+    ScheduleWakeWork(*lProducer.mLayer);
+
+    return NULL;
+}
+
+static void CheckScheduleWorkWakesSelect(nlTestSuite* inSuite, void* aContext)
+{
+    TestContext& lContext = *static_cast<TestContext*>(aContext);
+    Layer& lSys = *lContext.mLayer;
+    WakeProducer lProducer;
+    pthread_t lThread;
+
+    // Nothing but posted work may wake the select thread, so that a lost wake-up shows as work waiting out the sleep time.
+    lSys.CancelTimer(HandleGreedyTimer, aContext);
+
+    sWakeWorkHandled = 0;
+    lProducer.mLayer = &lSys;
+    lProducer.mStalled = false;
+    lProducer.mDone = false;
+
+    NL_TEST_ASSERT(inSuite, pthread_create(&lThread, NULL, RunWakeProducer, &lProducer) == 0);
+
+    while (!lProducer.mDone)
+    {
+        struct timeval sleepTime;
+        sleepTime.tv_sec = 2;
+        sleepTime.tv_usec = 0;
+        ServiceEvents(lSys, sleepTime);
+    }
+
+    pthread_join(lThread, NULL);
+
+    // Every pair ran promptly, however its posts lined up with the select thread waking.
+    NL_TEST_ASSERT(inSuite, !lProducer.mStalled);
+    NL_TEST_ASSERT(inSuite, sWakeWorkHandled >= kNumWakeBurst * kNumWakeRounds);
+}
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS && WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
+
+
+// Benchmark
+
+
+static const size_t kDefaultBenchmarkTimers = 10000;
+static const size_t kDefaultBenchmarkPosts = 1000000;
+
+void HandleBenchmarkTimer(Layer *aLayer, void * aState, Error aError)
+{
+}
+
+static uint64_t BenchmarkElapsedNanoseconds(uint64_t aStartMicroseconds, size_t aCount)
+{
+    return (aCount == 0) ? 0 : ((Layer::GetClock_MonotonicHiRes() - aStartMicroseconds) * 1000) / aCount;
+}
+
+/**
+ *  Measure the cost of starting, re-starting and cancelling timers while a large number of timers is armed.
+ *
+ *  The number of timers that can be armed is bounded by #WEAVE_SYSTEM_CONFIG_NUM_TIMERS; build with a pool at least as large as
+ *  the requested count. The benchmark fails if it cannot arm them all, since the costs would not be measured at that count.
+ */
+static int RunBenchmark(Layer& aLayer, size_t aCount)
+{
+    uint8_t* lStates = static_cast<uint8_t*>(calloc(aCount, 1));
+    size_t lArmed = 0;
+    uint64_t lStart;
+    uint64_t lStartCost, lRestartCost, lCancelCost;
+
+    if (lStates == NULL)
+    {
+        printf("Benchmark: unable to allocate state for %u timers\n", static_cast<unsigned>(aCount));
+        return EXIT_FAILURE;
+    }
+
+    // Spread the expirations between 1 and ~65 seconds so that none fires during the measurement.
+    lStart = Layer::GetClock_MonotonicHiRes();
+    for (lArmed = 0; lArmed < aCount; lArmed++)
+    {
+        const uint32_t lDelay = 1000 + static_cast<uint32_t>((lArmed * 7919) % 64000);
+
+        if (aLayer.StartTimer(lDelay, HandleBenchmarkTimer, &lStates[lArmed]) != WEAVE_SYSTEM_NO_ERROR)
+            break;
+    }
+    lStartCost = BenchmarkElapsedNanoseconds(lStart, lArmed);
+
+    lStart = Layer::GetClock_MonotonicHiRes();
+    for (size_t i = 0; i < lArmed; i++)
+    {
+        aLayer.StartTimer(2000 + static_cast<uint32_t>((i * 104729) % 60000), HandleBenchmarkTimer, &lStates[i]);
+    }
+    lRestartCost = BenchmarkElapsedNanoseconds(lStart, lArmed);
+
+    lStart = Layer::GetClock_MonotonicHiRes();
+    for (size_t i = 0; i < lArmed; i++)
+    {
+        aLayer.CancelTimer(HandleBenchmarkTimer, &lStates[i]);
+    }
+    lCancelCost = BenchmarkElapsedNanoseconds(lStart, lArmed);
+
+    printf("Benchmark: %u of %u timers armed (pool size %u, timer wheel %s)\n", static_cast<unsigned>(lArmed),
+           static_cast<unsigned>(aCount), static_cast<unsigned>(WEAVE_SYSTEM_CONFIG_NUM_TIMERS),
+           WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL ? "enabled" : "disabled");
+    printf("Benchmark: start   %llu ns/timer\n", static_cast<unsigned long long>(lStartCost));
+    printf("Benchmark: restart %llu ns/timer\n", static_cast<unsigned long long>(lRestartCost));
+    printf("Benchmark: cancel  %llu ns/timer\n", static_cast<unsigned long long>(lCancelCost));
+
+    free(lStates);
+
+    if (lArmed < aCount)
+    {
+        printf("Benchmark: timer pool exhausted; build with WEAVE_SYSTEM_CONFIG_NUM_TIMERS of at least %u\n",
+               static_cast<unsigned>(aCount));
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS && WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
+static size_t sPostedWorkHandled;
+static uint64_t sPostLatencyTotal;
+static uint64_t sPostLatencyMax;
+
+void HandleBenchmarkPost(Layer *aLayer, void * aState, Error aError)
+{
+    const uint64_t kLatency = Layer::GetClock_MonotonicHiRes() - *static_cast<uint64_t*>(aState);
+
+    sPostedWorkHandled++;
+    sPostLatencyTotal += kLatency;
+    if (kLatency > sPostLatencyMax)
+        sPostLatencyMax = kLatency;
+}
+
+/**
+ *  Measure the throughput of ScheduleWork() from another thread, and the latency from posting work to running it, while the
+ *  posting thread runs flat out.
+ */
+static int RunPostBenchmark(Layer& aLayer, size_t aCount)
+{
+    WorkProducer lProducer;
+    pthread_t lThread;
+    uint64_t lStart, lElapsed;
+
+    lProducer.mLayer = &aLayer;
+    lProducer.mCount = aCount;
+    lProducer.mComplete = HandleBenchmarkPost;
+    lProducer.mAppState = NULL;
+    lProducer.mPostTimes = static_cast<uint64_t*>(calloc(aCount, sizeof(uint64_t)));
+
+    if (aCount == 0 || lProducer.mPostTimes == NULL)
+    {
+        printf("Benchmark: unable to allocate state for %u posts\n", static_cast<unsigned>(aCount));
+        free(lProducer.mPostTimes);
+        return EXIT_FAILURE;
+    }
+
+    sPostedWorkHandled = 0;
+    sPostLatencyTotal = 0;
+    sPostLatencyMax = 0;
+
+    lStart = Layer::GetClock_MonotonicHiRes();
+
+    if (pthread_create(&lThread, NULL, RunWorkProducer, &lProducer) != 0)
+    {
+        free(lProducer.mPostTimes);
+        return EXIT_FAILURE;
+    }
+
+    while (sPostedWorkHandled < aCount)
+    {
+        struct timeval sleepTime;
+        sleepTime.tv_sec = 0;
+        sleepTime.tv_usec = 100000;
+        ServiceEvents(aLayer, sleepTime);
+    }
+
+    lElapsed = Layer::GetClock_MonotonicHiRes() - lStart;
+    pthread_join(lThread, NULL);
+
+    printf("Benchmark: %u cross-thread posts (work queue %s, eventfd %s)\n", static_cast<unsigned>(aCount),
+           WEAVE_SYSTEM_CONFIG_USE_WORK_QUEUE ? "enabled" : "disabled", WEAVE_SYSTEM_CONFIG_USE_EVENTFD ? "enabled" : "disabled");
+    printf("Benchmark: throughput %.0f posts/s\n", (lElapsed == 0) ? 0.0 : (aCount * 1000000.0) / lElapsed);
+    printf("Benchmark: latency    %llu us mean, %llu us max\n", static_cast<unsigned long long>(sPostLatencyTotal / aCount),
+           static_cast<unsigned long long>(sPostLatencyMax));
+
+    free(lProducer.mPostTimes);
+
+    return EXIT_SUCCESS;
+}
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS && WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
+
+
 // Test Suite
 
 
@@ -197,7 +647,13 @@ static void CheckStarvation(nlTestSuite* inSuite, void* aContext)
  */
 static const nlTest sTests[] = {
     NL_TEST_DEF("Timer::TestOverflow",             CheckOverflow),
+    NL_TEST_DEF("Timer::TestCancel",               CheckCancel),
     NL_TEST_DEF("Timer::TestTimerStarvation",      CheckStarvation),
+    NL_TEST_DEF("Timer::TestRestartFromCallback",  CheckRestartFromCallback),
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS && WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
+    NL_TEST_DEF("Timer::TestCrossThreadScheduleWork", CheckCrossThreadScheduleWork),
+    NL_TEST_DEF("Timer::TestScheduleWorkWakesSelect", CheckScheduleWorkWakesSelect),
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS && WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
     NL_TEST_SENTINEL()
 };
 
@@ -256,6 +712,34 @@ static int TestTeardown(void* aContext)
 
 int main(int argc, char *argv[])
 {
+    // With --benchmark [count], measure timer start/cancel cost instead of running the test suite.
+    if (argc > 1 && strcmp(argv[1], "--benchmark") == 0)
+    {
+        const size_t lCount = (argc > 2) ? static_cast<size_t>(strtoul(argv[2], NULL, 0)) : kDefaultBenchmarkTimers;
+        int lResult;
+
+        TestSetup(&sContext);
+        lResult = RunBenchmark(*sContext.mLayer, lCount);
+        TestTeardown(&sContext);
+
+        return lResult;
+    }
+
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS && WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
+    // With --benchmark-post [count], measure cross-thread ScheduleWork() throughput and latency instead.
+    if (argc > 1 && strcmp(argv[1], "--benchmark-post") == 0)
+    {
+        const size_t lCount = (argc > 2) ? static_cast<size_t>(strtoul(argv[2], NULL, 0)) : kDefaultBenchmarkPosts;
+        int lResult;
+
+        TestSetup(&sContext);
+        lResult = RunPostBenchmark(*sContext.mLayer, lCount);
+        TestTeardown(&sContext);
+
+        return lResult;
+    }
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS && WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
+
     // Generate machine-readable, comma-separated value (CSV) output.
     nl_test_set_output_style(OUTPUT_CSV);
 
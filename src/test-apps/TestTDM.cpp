@@ -38,6 +38,8 @@
 
 #include <Weave/Profiles/data-management/Current/WdmManagedNamespace.h>
 #include <Weave/Profiles/data-management/DataManagement.h>
+#include <Weave/Profiles/data-management/Current/GenericTraitCatalogImpl.h>
+#include <Weave/Profiles/data-management/Current/GenericTraitCatalogImpl.ipp>
 
 #include <nest/test/trait/TestHTrait.h>
 #include <nest/test/trait/TestCTrait.h>
@@ -56,6 +58,8 @@
 #include <set>
 #include <string>
 #include <iterator>
+#include <vector>
+#include <time.h>
 
 #if WEAVE_SYSTEM_CONFIG_USE_LWIP
 #include <lwip/init.h>
@@ -116,6 +120,17 @@ SubscriptionEngine * SubscriptionEngine::GetInstance()
 
 static void CheckDataSourceEmptySchema(nlTestSuite *inSuite, void *inContext);
 static void CheckDataSinkEmptySchema(nlTestSuite *inSuite, void *inContext);
+static void CheckWideSchemaChildLookup(nlTestSuite *inSuite, void *inContext);
+static double BenchmarkNow(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void CheckLargeGenericTraitCatalog(nlTestSuite *inSuite, void *inContext);
 
 static void TestTdmStatic_SingleLeafHandle(nlTestSuite *inSuite, void *inContext);
 static void TestTdmStatic_SingleLevelMerge(nlTestSuite *inSuite, void *inContext);
@@ -161,6 +176,7 @@ static void TestTdmDictionary_DeleteEntryTwice(nlTestSuite *inSuite, void *inCon
 static void TestRandomizedDataVersions(nlTestSuite *inSuite, void *inContext);
 
 static void TestTdmStatic_MultiInstance(nlTestSuite *inSuite, void *inContext);
+static void TestTdmStatic_MultipleHandlers(nlTestSuite *inSuite, void *inContext);
 static void CheckAllocateRightSizedBufferForNotifications(nlTestSuite *inSuite, void *inContext);
 
 // Test Suite
@@ -171,6 +187,8 @@ static void CheckAllocateRightSizedBufferForNotifications(nlTestSuite *inSuite,
 static const nlTest sTests[] = {
     NL_TEST_DEF("Test TraitDataSource + schema with no properties",  CheckDataSourceEmptySchema),
     NL_TEST_DEF("Test TraitDataSink + schema with no properties",    CheckDataSinkEmptySchema),
+    NL_TEST_DEF("Test child handle lookup on a wide schema",         CheckWideSchemaChildLookup),
+    NL_TEST_DEF("Test generic trait catalog with many instances",    CheckLargeGenericTraitCatalog),
 
     // Tests the static schema portions of TDM
     NL_TEST_DEF("Test Tdm (Static schema): Single leaf handle", TestTdmStatic_SingleLeafHandle),
@@ -223,6 +241,7 @@ static const nlTest sTests[] = {
     NL_TEST_DEF("Test Tdm (Randomized Data Versions): Randomized Data Versions", TestRandomizedDataVersions),
 
     NL_TEST_DEF("Test Tdm (Multi Instance): Multi Instance", TestTdmStatic_MultiInstance),
+    NL_TEST_DEF("Test Tdm (Multiple Handlers): Dirty marking across subscriptions", TestTdmStatic_MultipleHandlers),
 
     // Tests the allocation of buffer for building and sending Notifies and
     // Updates.
@@ -389,6 +408,237 @@ exit:
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Testing child handle lookup on a wide schema
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+enum
+{
+    kWideSchemaNumTopLevel       = 200,
+    kWideSchemaNumStructs        = 20,
+    kWideSchemaNumStructChildren = 15,
+    kWideSchemaNumEntries        = kWideSchemaNumTopLevel + (kWideSchemaNumStructs * kWideSchemaNumStructChildren),
+};
+
+TraitSchemaEngine::PropertyInfo gWideSchemaPropertyMap[kWideSchemaNumEntries];
+
+#if (TDM_SCHEMA_CHILD_INDEX_SUPPORT)
+PropertySchemaHandle gWideSchemaChildIndex[TDM_SCHEMA_CHILD_INDEX_SIZE(kWideSchemaNumEntries)];
+#endif
+
+static void InitWideSchemaPropertyMap(void)
+{
+    // A root with kWideSchemaNumTopLevel children, the first kWideSchemaNumStructs of which are structures with
+    // kWideSchemaNumStructChildren children each. Tags are assigned in descending order so that handle order and
+    // tag order differ.
+    for (int i = 0; i < kWideSchemaNumTopLevel; i++)
+    {
+        gWideSchemaPropertyMap[i].mParentHandle = kRootPropertyPathHandle;
+        gWideSchemaPropertyMap[i].mContextTag   = kWideSchemaNumTopLevel - i;
+    }
+
+    for (int i = 0; i < kWideSchemaNumStructs * kWideSchemaNumStructChildren; i++)
+    {
+        gWideSchemaPropertyMap[kWideSchemaNumTopLevel + i].mParentHandle = (i / kWideSchemaNumStructChildren) + TraitSchemaEngine::kHandleTableOffset;
+        gWideSchemaPropertyMap[kWideSchemaNumTopLevel + i].mContextTag   = kWideSchemaNumStructChildren - (i % kWideSchemaNumStructChildren);
+    }
+}
+
+const TraitSchemaEngine gWideTraitSchema = {
+    {
+        0x0,
+        gWideSchemaPropertyMap,
+        kWideSchemaNumEntries,
+        2,
+#if (TDM_EXTENSION_SUPPORT) || (TDM_VERSIONING_SUPPORT)
+        2,
+#endif
+#if (TDM_DICTIONARY_SUPPORT)
+        NULL,
+#endif
+        NULL,
+        NULL,
+        NULL,
+        NULL,
+#if (TDM_EXTENSION_SUPPORT)
+        NULL,
+#endif
+#if (TDM_VERSIONING_SUPPORT)
+        NULL,
+#endif
+#if (TDM_SCHEMA_CHILD_INDEX_SUPPORT)
+        NULL,
+#endif
+    }
+};
+
+#if (TDM_SCHEMA_CHILD_INDEX_SUPPORT)
+const TraitSchemaEngine gWideIndexedTraitSchema = {
+    {
+        0x0,
+        gWideSchemaPropertyMap,
+        kWideSchemaNumEntries,
+        2,
+#if (TDM_EXTENSION_SUPPORT) || (TDM_VERSIONING_SUPPORT)
+        2,
+#endif
+#if (TDM_DICTIONARY_SUPPORT)
+        NULL,
+#endif
+        NULL,
+        NULL,
+        NULL,
+        NULL,
+#if (TDM_EXTENSION_SUPPORT)
+        NULL,
+#endif
+#if (TDM_VERSIONING_SUPPORT)
+        NULL,
+#endif
+        gWideSchemaChildIndex,
+    }
+};
+#endif // TDM_SCHEMA_CHILD_INDEX_SUPPORT
+
+/*
+ * Look up every child of the root and of each structure by tag, checking the result against the schema table, and check
+ * that tags with no child and handles with no children are reported as such.
+ */
+static void CheckWideSchemaChildren(nlTestSuite *inSuite, const TraitSchemaEngine &aEngine)
+{
+    for (int i = 0; i < kWideSchemaNumEntries; i++)
+    {
+        PropertyPathHandle parentHandle = gWideSchemaPropertyMap[i].mParentHandle;
+        PropertyPathHandle childHandle  = aEngine.GetChildHandle(parentHandle, gWideSchemaPropertyMap[i].mContextTag);
+
+        NL_TEST_ASSERT(inSuite, childHandle == static_cast<PropertyPathHandle>(i + TraitSchemaEngine::kHandleTableOffset));
+        NL_TEST_ASSERT(inSuite, aEngine.IsLeaf(childHandle) == (i >= kWideSchemaNumStructs));
+    }
+
+    for (int i = 0; i < kWideSchemaNumStructs; i++)
+    {
+        PropertyPathHandle structHandle = i + TraitSchemaEngine::kHandleTableOffset;
+
+        NL_TEST_ASSERT(inSuite, aEngine.GetChildHandle(structHandle, kWideSchemaNumStructChildren + 1) == kNullPropertyPathHandle);
+        NL_TEST_ASSERT(inSuite, aEngine.GetChildHandle(structHandle, 0) == kNullPropertyPathHandle);
+    }
+
+    // Neither a leaf nor the root has a child with a tag not in the schema.
+    NL_TEST_ASSERT(inSuite, aEngine.GetChildHandle(kWideSchemaNumStructs + TraitSchemaEngine::kHandleTableOffset, 1) ==
+                   kNullPropertyPathHandle);
+    NL_TEST_ASSERT(inSuite, aEngine.GetChildHandle(kRootPropertyPathHandle, kWideSchemaNumTopLevel + 1) == kNullPropertyPathHandle);
+    NL_TEST_ASSERT(inSuite, aEngine.GetChildHandle(kRootPropertyPathHandle, 0) == kNullPropertyPathHandle);
+}
+
+static void CheckWideSchemaChildLookup(nlTestSuite *inSuite, void *inContext)
+{
+    InitWideSchemaPropertyMap();
+
+    CheckWideSchemaChildren(inSuite, gWideTraitSchema);
+
+#if (TDM_SCHEMA_CHILD_INDEX_SUPPORT)
+    // The index is built on first use; its end marker then holds the number of children, one per schema entry.
+    memset(gWideSchemaChildIndex, 0, sizeof(gWideSchemaChildIndex));
+
+    CheckWideSchemaChildren(inSuite, gWideIndexedTraitSchema);
+
+    NL_TEST_ASSERT(inSuite, gWideSchemaChildIndex[kWideSchemaNumEntries + TraitSchemaEngine::kHandleTableOffset] ==
+                   kWideSchemaNumEntries);
+#endif
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Testing GenericTraitCatalogImpl with many trait instances
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+enum
+{
+    kLargeCatalogNumInstances = 4000,
+};
+
+static void CheckLargeGenericTraitCatalog(nlTestSuite *inSuite, void *inContext)
+{
+    WEAVE_ERROR err;
+    GenericTraitSourceCatalog catalog;
+    std::vector<TestEmptyDataSource *> sources;
+    TraitDataHandle handle;
+    TraitDataSource *source;
+    ResourceIdentifier resourceId(ResourceIdentifier::SELF_NODE_ID);
+    double start, addTime, locatePathTime, locateInstanceTime;
+
+    for (int i = 0; i < kLargeCatalogNumInstances; i++)
+    {
+        sources.push_back(new TestEmptyDataSource(&gEmptyTraitSchema));
+    }
+
+    start = BenchmarkNow();
+    for (int i = 0; i < kLargeCatalogNumInstances; i++)
+    {
+        err = catalog.Add(resourceId, i, kRootPropertyPathHandle, sources[i], handle);
+        NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, handle == i);
+    }
+    addTime = BenchmarkNow() - start;
+
+    NL_TEST_ASSERT(inSuite, catalog.Size() == kLargeCatalogNumInstances);
+
+    // Adding the same path again must fail
+    err = catalog.Add(resourceId, 0, kRootPropertyPathHandle, sources[1], handle);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_ERROR_DUPLICATE_KEY_ID);
+
+    start = BenchmarkNow();
+    for (int i = 0; i < kLargeCatalogNumInstances; i++)
+    {
+        err = catalog.Locate(gEmptyTraitSchema.GetProfileId(), i, resourceId, handle);
+        NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR && handle == i);
+    }
+    locatePathTime = BenchmarkNow() - start;
+
+    start = BenchmarkNow();
+    for (int i = 0; i < kLargeCatalogNumInstances; i++)
+    {
+        err = catalog.Locate(sources[i], handle);
+        NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR && handle == i);
+    }
+    locateInstanceTime = BenchmarkNow() - start;
+
+    // Remove every other instance and check that the rest can still be found and the handles are reused
+    for (int i = 0; i < kLargeCatalogNumInstances; i += 2)
+    {
+        err = catalog.Remove(sources[i]);
+        NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    }
+
+    NL_TEST_ASSERT(inSuite, catalog.Size() == kLargeCatalogNumInstances / 2);
+
+    for (int i = 0; i < kLargeCatalogNumInstances; i++)
+    {
+        err = catalog.Locate(gEmptyTraitSchema.GetProfileId(), i, resourceId, &source);
+        NL_TEST_ASSERT(inSuite, (i % 2 == 0) ? (err != WEAVE_NO_ERROR) : (err == WEAVE_NO_ERROR && source == sources[i]));
+
+        err = catalog.Locate(static_cast<TraitDataHandle>(i), &source);
+        NL_TEST_ASSERT(inSuite, (i % 2 == 0) ? (err != WEAVE_NO_ERROR) : (err == WEAVE_NO_ERROR && source == sources[i]));
+    }
+
+    err = catalog.Add(resourceId, 0, kRootPropertyPathHandle, sources[0], handle);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR && handle == 0);
+
+    printf("Generic trait catalog, %u instances: Add %.0f ns, Locate(path) %.0f ns, Locate(instance) %.0f ns\n",
+           kLargeCatalogNumInstances, addTime * 1e9 / kLargeCatalogNumInstances,
+           locatePathTime * 1e9 / kLargeCatalogNumInstances, locateInstanceTime * 1e9 / kLargeCatalogNumInstances);
+
+    catalog.Clear();
+
+    for (int i = 0; i < kLargeCatalogNumInstances; i++)
+    {
+        delete sources[i];
+    }
+}
+
 //
 // Testing NotificationEngine + TraitData
 //
@@ -691,6 +941,7 @@ public:
     int Teardown();
     int Reset();
     int BuildAndProcessNotify();
+    int BuildAndProcessNotify(SubscriptionHandler *aSubHandler);
 
     void TestTdmStatic_SingleLeafHandle(nlTestSuite *inSuite);
     void TestTdmStatic_SingleLevelMerge(nlTestSuite *inSuite);
@@ -737,6 +988,7 @@ public:
     void TestRandomizedDataVersions(nlTestSuite *inSuite);
 
     void TestTdmStatic_MultiInstance(nlTestSuite *inSuite);
+    void TestTdmStatic_MultipleHandlers(nlTestSuite *inSuite);
 
     void CheckAllocateRightSizedBufferForNotifications(nlTestSuite *inSuite);
 
@@ -767,6 +1019,11 @@ private:
     uint32_t mTestCase;
 
     WEAVE_ERROR AllocateBuffer(uint32_t desiredSize, uint32_t minSize);
+
+    WEAVE_ERROR NewTestSubscriptionHandler(SubscriptionHandler *&aSubHandler);
+    void FreeTestSubscriptionHandler(SubscriptionHandler *aSubHandler);
+    void AddTestTraitInstance(SubscriptionHandler *aSubHandler, TraitDataHandle aTraitDataHandle);
+    bool DirtyCountsConsistent();
 };
 
 TestTdm::TestTdm()
@@ -859,6 +1116,15 @@ int TestTdm::Setup()
     traitInstance->mTraitDataHandle = testBSourceHandle;
     traitInstance->mRequestedVersion = 1;
 
+#if WDM_PUBLISHER_ENABLE_DIRTY_INDEX
+    for (uint16_t i = 0; i < mSubHandler->mNumTraitInstances; i++)
+    {
+        mSubHandler->mTraitInstanceList[i].mHandlerId = mSubscriptionEngine.GetHandlerId(mSubHandler);
+    }
+
+    mSubscriptionEngine.RebuildTraitInfoIndex();
+#endif
+
 exit:
     if (err != WEAVE_NO_ERROR) {
         WeaveLogError(DataManagement, "Error setting up test: %d", err);
@@ -903,6 +1169,11 @@ int TestTdm::Reset()
 }
 
 int TestTdm::BuildAndProcessNotify()
+{
+    return BuildAndProcessNotify(mSubHandler);
+}
+
+int TestTdm::BuildAndProcessNotify(SubscriptionHandler *aSubHandler)
 {
     bool isSubscriptionClean;
     NotificationEngine::NotifyRequestBuilder notifyRequest;
@@ -916,15 +1187,15 @@ int TestTdm::BuildAndProcessNotify()
     uint32_t maxNotificationSize = 0;
     uint32_t maxPayloadSize = 0;
 
-    maxNotificationSize = mSubHandler->GetMaxNotificationSize();
+    maxNotificationSize = aSubHandler->GetMaxNotificationSize();
 
-    err = mSubHandler->mBinding->AllocateRightSizedBuffer(buf, maxNotificationSize, WDM_MIN_NOTIFICATION_SIZE, maxPayloadSize);
+    err = aSubHandler->mBinding->AllocateRightSizedBuffer(buf, maxNotificationSize, WDM_MIN_NOTIFICATION_SIZE, maxPayloadSize);
     SuccessOrExit(err);
 
-    err = notifyRequest.Init(buf, &writer, mSubHandler, maxPayloadSize);
+    err = notifyRequest.Init(buf, &writer, aSubHandler, maxPayloadSize);
     SuccessOrExit(err);
 
-    err = mNotificationEngine->BuildSingleNotifyRequestDataList(mSubHandler, notifyRequest, isSubscriptionClean, neWriteInProgress);
+    err = mNotificationEngine->BuildSingleNotifyRequestDataList(aSubHandler, notifyRequest, isSubscriptionClean, neWriteInProgress);
     SuccessOrExit(err);
 
     if (neWriteInProgress)
@@ -1001,6 +1272,223 @@ exit:
     NL_TEST_ASSERT(inSuite, testPass);
 }
 
+WEAVE_ERROR TestTdm::NewTestSubscriptionHandler(SubscriptionHandler *&aSubHandler)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+
+    err = mSubscriptionEngine.NewSubscriptionHandler(&aSubHandler);
+    SuccessOrExit(err);
+
+    aSubHandler->mBinding = ExchangeMgr.NewBinding();
+    VerifyOrExit(aSubHandler->mBinding != NULL, err = WEAVE_ERROR_NO_MEMORY);
+
+    aSubHandler->mBinding->BeginConfiguration().Transport_UDP();
+    aSubHandler->MoveToState(SubscriptionHandler::kState_SubscriptionEstablished_Idle);
+
+exit:
+    return err;
+}
+
+void TestTdm::FreeTestSubscriptionHandler(SubscriptionHandler *aSubHandler)
+{
+    mSubscriptionEngine.ReclaimTraitInfo(aSubHandler);
+
+    if (aSubHandler->mBinding != NULL)
+    {
+        aSubHandler->mBinding->Release();
+    }
+
+    aSubHandler->InitAsFree();
+}
+
+// Append a trait instance to the handler, which must own the last trait instances in the pool.
+void TestTdm::AddTestTraitInstance(SubscriptionHandler *aSubHandler, TraitDataHandle aTraitDataHandle)
+{
+    SubscriptionHandler::TraitInstanceInfo *traitInstance = mSubscriptionEngine.mTraitInfoPool + mSubscriptionEngine.mNumTraitInfosInPool;
+
+    if (aSubHandler->mNumTraitInstances == 0)
+    {
+        aSubHandler->mTraitInstanceList = traitInstance;
+    }
+
+    aSubHandler->mNumTraitInstances++;
+    mSubscriptionEngine.mNumTraitInfosInPool++;
+
+    traitInstance->Init();
+    traitInstance->mTraitDataHandle = aTraitDataHandle;
+    traitInstance->mRequestedVersion = 1;
+
+#if WDM_PUBLISHER_ENABLE_DIRTY_INDEX
+    traitInstance->mHandlerId = mSubscriptionEngine.GetHandlerId(aSubHandler);
+    mSubscriptionEngine.IndexTraitInfo(traitInstance);
+#endif
+}
+
+// Check the dirty counts kept by the dirty index against the dirty flags of the trait instances.
+bool TestTdm::DirtyCountsConsistent()
+{
+#if WDM_PUBLISHER_ENABLE_DIRTY_INDEX
+    for (size_t i = 0; i < SubscriptionEngine::kMaxNumSubscriptionHandlers; i++)
+    {
+        SubscriptionHandler *subHandler = &mSubscriptionEngine.mHandlers[i];
+        uint16_t numDirty = 0;
+
+        for (uint16_t j = 0; j < subHandler->mNumTraitInstances; j++)
+        {
+            if (subHandler->mTraitInstanceList[j].IsDirty())
+            {
+                numDirty++;
+            }
+        }
+
+        if (subHandler->mNumDirtyTraitInstances != numDirty)
+        {
+            return false;
+        }
+    }
+
+    return true;
+#else
+    return true;
+#endif
+}
+
+void TestTdm::TestTdmStatic_MultipleHandlers(nlTestSuite *inSuite)
+{
+#if (WDM_MAX_NUM_SUBSCRIPTION_HANDLERS >= 3) && (WDM_PUBLISHER_MAX_NUM_PATH_GROUPS >= 8)
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    SubscriptionHandler *subHandler1 = NULL;
+    SubscriptionHandler *subHandler2 = NULL;
+    SubscriptionHandler::TraitInstanceInfo *traitInstances = mSubHandler->mTraitInstanceList;
+    const TraitDataHandle testTdmSourceHandle = traitInstances[0].mTraitDataHandle;
+    const TraitDataHandle testTdmSourceHandle1 = traitInstances[1].mTraitDataHandle;
+    const TraitDataHandle testBSourceHandle = traitInstances[3].mTraitDataHandle;
+
+    Reset();
+
+    for (uint16_t i = 0; i < mSubHandler->mNumTraitInstances; i++)
+    {
+        mSubHandler->ClearTraitInstanceDirty(&traitInstances[i]);
+    }
+
+    // mSubHandler subscribes to all four sources, subHandler1 to the H and B sources and subHandler2 to both H sources,
+    // so that the trait instances of each source are spread over several handlers.
+    err = NewTestSubscriptionHandler(subHandler1);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    SuccessOrExit(err);
+
+    AddTestTraitInstance(subHandler1, testTdmSourceHandle);
+    AddTestTraitInstance(subHandler1, testBSourceHandle);
+
+    err = NewTestSubscriptionHandler(subHandler2);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    SuccessOrExit(err);
+
+    AddTestTraitInstance(subHandler2, testTdmSourceHandle1);
+    AddTestTraitInstance(subHandler2, testTdmSourceHandle);
+
+    NL_TEST_ASSERT(inSuite, DirtyCountsConsistent());
+
+    // Only the trait instances subscribed to a source are marked dirty by it.
+    mTestBSource.SetDirty(TestBTrait::kPropertyHandle_Root);
+
+    NL_TEST_ASSERT(inSuite, !traitInstances[0].IsDirty() && !traitInstances[1].IsDirty());
+    NL_TEST_ASSERT(inSuite, !traitInstances[2].IsDirty() && traitInstances[3].IsDirty());
+    NL_TEST_ASSERT(inSuite, !subHandler1->mTraitInstanceList[0].IsDirty() && subHandler1->mTraitInstanceList[1].IsDirty());
+    NL_TEST_ASSERT(inSuite, !subHandler2->mTraitInstanceList[0].IsDirty() && !subHandler2->mTraitInstanceList[1].IsDirty());
+    NL_TEST_ASSERT(inSuite, DirtyCountsConsistent());
+
+    mTestTdmSource.SetValue(TestHTrait::kPropertyHandle_A, 2);
+    mTestTdmSource.SetValue(TestHTrait::kPropertyHandle_A, 3);
+
+    NL_TEST_ASSERT(inSuite, traitInstances[0].IsDirty() && !traitInstances[1].IsDirty());
+    NL_TEST_ASSERT(inSuite, subHandler1->mTraitInstanceList[0].IsDirty());
+    NL_TEST_ASSERT(inSuite, !subHandler2->mTraitInstanceList[0].IsDirty() && subHandler2->mTraitInstanceList[1].IsDirty());
+    NL_TEST_ASSERT(inSuite, DirtyCountsConsistent());
+
+#if WDM_PUBLISHER_ENABLE_DIRTY_INDEX
+    NL_TEST_ASSERT(inSuite, mSubHandler->mNumDirtyTraitInstances == 2);
+    NL_TEST_ASSERT(inSuite, subHandler1->mNumDirtyTraitInstances == 2);
+    NL_TEST_ASSERT(inSuite, subHandler2->mNumDirtyTraitInstances == 1);
+#endif
+
+    // Notifying each handler cleans all of its trait instances.
+    err = BuildAndProcessNotify(mSubHandler);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    err = BuildAndProcessNotify(subHandler1);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    err = BuildAndProcessNotify(subHandler2);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    NL_TEST_ASSERT(inSuite, !traitInstances[0].IsDirty() && !traitInstances[3].IsDirty());
+    NL_TEST_ASSERT(inSuite, !subHandler1->mTraitInstanceList[0].IsDirty() && !subHandler1->mTraitInstanceList[1].IsDirty());
+    NL_TEST_ASSERT(inSuite, !subHandler2->mTraitInstanceList[1].IsDirty());
+    NL_TEST_ASSERT(inSuite, DirtyCountsConsistent());
+
+#if WDM_PUBLISHER_ENABLE_DIRTY_INDEX
+    NL_TEST_ASSERT(inSuite, mSubHandler->mNumDirtyTraitInstances == 0);
+    NL_TEST_ASSERT(inSuite, subHandler1->mNumDirtyTraitInstances == 0);
+    NL_TEST_ASSERT(inSuite, subHandler2->mNumDirtyTraitInstances == 0);
+#endif
+
+    // Reclaiming the trait instances of the middle handler moves those of subHandler2 down the pool; marking sources
+    // dirty still reaches exactly the subscribed trait instances of the remaining handlers.
+    mTestTdmSource.SetValue(TestHTrait::kPropertyHandle_A, 4);
+
+    mSubscriptionEngine.ReclaimTraitInfo(subHandler1);
+
+    NL_TEST_ASSERT(inSuite, subHandler1->mNumTraitInstances == 0);
+    NL_TEST_ASSERT(inSuite, subHandler2->mTraitInstanceList == traitInstances + 4);
+    NL_TEST_ASSERT(inSuite, subHandler2->mTraitInstanceList[0].mTraitDataHandle == testTdmSourceHandle1);
+    NL_TEST_ASSERT(inSuite, subHandler2->mTraitInstanceList[1].mTraitDataHandle == testTdmSourceHandle);
+    NL_TEST_ASSERT(inSuite, subHandler2->mTraitInstanceList[1].IsDirty());
+    NL_TEST_ASSERT(inSuite, DirtyCountsConsistent());
+
+    mTestTdmSource1.SetValue(TestHTrait::kPropertyHandle_B, 2);
+    mTestBSource.SetDirty(TestBTrait::kPropertyHandle_Root);
+
+    NL_TEST_ASSERT(inSuite, traitInstances[0].IsDirty() && traitInstances[1].IsDirty());
+    NL_TEST_ASSERT(inSuite, !traitInstances[2].IsDirty() && traitInstances[3].IsDirty());
+    NL_TEST_ASSERT(inSuite, subHandler2->mTraitInstanceList[0].IsDirty() && subHandler2->mTraitInstanceList[1].IsDirty());
+    NL_TEST_ASSERT(inSuite, DirtyCountsConsistent());
+
+#if WDM_PUBLISHER_ENABLE_DIRTY_INDEX
+    NL_TEST_ASSERT(inSuite, mSubHandler->mNumDirtyTraitInstances == 3);
+    NL_TEST_ASSERT(inSuite, subHandler1->mNumDirtyTraitInstances == 0);
+    NL_TEST_ASSERT(inSuite, subHandler2->mNumDirtyTraitInstances == 2);
+#endif
+
+    err = BuildAndProcessNotify(mSubHandler);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    err = BuildAndProcessNotify(subHandler2);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    NL_TEST_ASSERT(inSuite, DirtyCountsConsistent());
+
+#if WDM_PUBLISHER_ENABLE_DIRTY_INDEX
+    NL_TEST_ASSERT(inSuite, mSubHandler->mNumDirtyTraitInstances == 0);
+    NL_TEST_ASSERT(inSuite, subHandler2->mNumDirtyTraitInstances == 0);
+#endif
+
+exit:
+    // Leave mSubHandler as the only subscription for the tests that follow
+    if (subHandler2 != NULL)
+    {
+        FreeTestSubscriptionHandler(subHandler2);
+    }
+
+    if (subHandler1 != NULL)
+    {
+        FreeTestSubscriptionHandler(subHandler1);
+    }
+
+    NL_TEST_ASSERT(inSuite, mSubscriptionEngine.mNumTraitInfosInPool == mSubHandler->mNumTraitInstances);
+#endif // (WDM_MAX_NUM_SUBSCRIPTION_HANDLERS >= 3) && (WDM_PUBLISHER_MAX_NUM_PATH_GROUPS >= 8)
+}
+
 void TestTdm::TestTdmStatic_SingleLeafHandle(nlTestSuite *inSuite)
 {
     WEAVE_ERROR err = WEAVE_NO_ERROR;
@@ -2252,6 +2740,11 @@ static void TestTdmStatic_MultiInstance(nlTestSuite *inSuite, void *inContext)
     gTestTdm->TestTdmStatic_MultiInstance(inSuite);
 }
 
+static void TestTdmStatic_MultipleHandlers(nlTestSuite *inSuite, void *inContext)
+{
+    gTestTdm->TestTdmStatic_MultipleHandlers(inSuite);
+}
+
 static void CheckAllocateRightSizedBufferForNotifications(nlTestSuite *inSuite, void *inContext)
 {
     gTestTdm->CheckAllocateRightSizedBufferForNotifications(inSuite);
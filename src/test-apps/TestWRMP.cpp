@@ -182,6 +182,13 @@ static const char *gToolOptionHelp =
     "       TestWRMPDuplicateMsgAckOnClosedExResponder------------[14]\n"
     "       TestWRMPDuplicateMsgAckOnClosedExInitiator------------[15]\n"
     "       TestWRMPDuplicateMsgDetection-------------------------[16]\n"
+    "       TestWRMPThrottleExpiry--------------------------------[17]\n"
+    "       TestWRMPMultiAckReceipt-------------------------------[18]\n"
+    "       TestWRMPMultiAckCoalescing----------------------------[19]\n"
+    "       TestWRMPSendWindow------------------------------------[20]\n"
+    "       Tests 19 and 20 pass without running unless the build enables\n"
+    "       WEAVE_CONFIG_WRMP_COALESCE_ACKS and WEAVE_CONFIG_WRMP_ENABLE_SEND_WINDOW\n"
+    "       respectively.\n"
     "\n"
     "  -W, --wait <TestWaitTime>\n"
     "\n"
@@ -835,6 +842,85 @@ testStatus_t TestWRMPThrottleFlowBehavior(void)
     return TEST_FAIL;
 }
 
+//Receive a Throttle Flow message that is never lifted and check that
+//sending resumes once its pause time has passed
+testStatus_t TestWRMPThrottleExpiry(void)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    PacketBuffer *payloadBuf = NULL;
+    uint64_t throttleRcvdTime = 0;
+    PrepareNewBuf(&payloadBuf);
+    isAckRcvd = false;
+    throttleRcvd = false;
+    Done = false;
+    LastEchoTime = Now();
+
+    //Set the retrans timeout
+    if (RetransInterval)
+    {
+        WRMPClient.ExchangeCtx->mWRMPConfig.mInitialRetransTimeout = RetransInterval;
+        WRMPClient.ExchangeCtx->mWRMPConfig.mActiveRetransTimeout = RetransInterval;
+    }
+
+    //Request a Throttle message
+    err = SendCustomMessage(WRMPClient.ExchangeCtx, kWeaveProfile_Test, kWeaveTestMessageType_Request_Throttle,
+                            ExchangeContext::kSendFlag_RequestAck, payloadBuf);
+    if (err != WEAVE_NO_ERROR)
+    {
+        printf("WRMPTestClient.SendCustomMessage failed: %s\n", ErrorStr(err));
+        Done = true;
+        return TEST_FAIL;
+    }
+
+    while (!Done)
+    {
+        struct timeval sleepTime;
+        sleepTime.tv_sec = 0;
+        sleepTime.tv_usec = 100000;
+
+        ServiceNetwork(sleepTime);
+
+        if (!Listening)
+        {
+            if (throttleRcvd && throttleRcvdTime == 0)
+            {
+                throttleRcvdTime = Now();
+
+                //Sending must be refused while the peer's pause is in effect
+                PrepareNewBuf(&payloadBuf);
+                err = SendCustomMessage(WRMPClient.ExchangeCtx, kWeaveProfile_Test, kWeaveTestMessageType_No_Response,
+                                        ExchangeContext::kSendFlag_RequestAck, payloadBuf);
+                if (err != WEAVE_ERROR_SEND_THROTTLED)
+                {
+                    printf("Send while throttled returned %s\n", ErrorStr(err));
+                    Done = true;
+                    return TEST_FAIL;
+                }
+            }
+            else if (throttleRcvdTime != 0 && Now() > throttleRcvdTime + ThrottlePauseTime * 1000)
+            {
+                //The pause has passed without an unthrottle; sending must succeed again
+                PrepareNewBuf(&payloadBuf);
+                err = SendCustomMessage(WRMPClient.ExchangeCtx, kWeaveProfile_Test, kWeaveTestMessageType_No_Response,
+                                        ExchangeContext::kSendFlag_RequestAck, payloadBuf);
+                if (err != WEAVE_NO_ERROR)
+                {
+                    printf("Send after throttle expiry returned %s\n", ErrorStr(err));
+                    Done = true;
+                    return TEST_FAIL;
+                }
+                return TEST_PASS;
+            }
+            else if (throttleRcvdTime == 0 && Now() > LastEchoTime + MaxAckReceiptInterval + RetransInterval)
+            {
+                Done = true;
+                return TEST_FAIL;
+            }
+        }
+    }
+    return TEST_FAIL;
+}
+
 //Send a Request for a Delayed Delivery and check on receipt
 testStatus_t TestWRMPSendDelayedDeliveryMessage(void)
 {
@@ -1423,6 +1509,438 @@ testStatus_t TestWRMPDuplicateMsgDetection(void)
     return TEST_FAIL;
 }
 
+enum
+{
+    kMultiAckTestExchanges          = 4,        // Number of exchanges acknowledged by one multi-ack message
+    kMultiAckTestEntrySize          = 7,        // ExchangeId (16), flags (8), AckMsgId (32)
+    kMultiAckTestRetransTimeout     = 10000,    // Longer than the test, so only a multi-ack clears the retransmit entries
+};
+
+static ExchangeContext *MultiAckTestEC[kMultiAckTestExchanges];
+static uint32_t MultiAckTestCtxt[kMultiAckTestExchanges];
+static uint32_t MultiAckTestMsgId[kMultiAckTestExchanges];
+static bool MultiAckTestAcked[kMultiAckTestExchanges];
+static uint8_t MultiAckTestMsgCount = 0;
+static bool MultiAckTestWrongAck = false;
+
+static void HandleMultiAckTestAckRcvd(ExchangeContext *ec, void *msgCtxt)
+{
+    for (int i = 0; i < kMultiAckTestExchanges; i++)
+    {
+        if (ec == MultiAckTestEC[i])
+        {
+            printf("Received Ack on exchange %04X\n", ec->ExchangeId);
+            if (msgCtxt == &MultiAckTestCtxt[i])
+            {
+                MultiAckTestAcked[i] = true;
+            }
+            else
+            {
+                MultiAckTestWrongAck = true;
+            }
+        }
+    }
+}
+
+static void HandleMultiAckTestMessage(ExchangeContext *ec, const IPPacketInfo *pktInfo, const WeaveMessageInfo *msgInfo,
+                                      uint32_t profileId, uint8_t msgType, PacketBuffer *payload)
+{
+    if (profileId == kWeaveProfile_Test && msgType == kWeaveTestMessageType_DD_Test)
+    {
+        MultiAckTestMsgCount++;
+    }
+    PacketBuffer::Free(payload);
+}
+
+static ExchangeContext *NewMultiAckTestContext(void)
+{
+    ExchangeContext *ec = WRMPClient.ExchangeMgr->NewContext(WRMPClient.ExchangeCtx->PeerNodeId, WRMPClient.ExchangeCtx->PeerAddr,
+                                                             WRMPClient.ExchangeCtx->PeerPort, WRMPClient.ExchangeCtx->PeerIntf,
+                                                             &WRMPClient);
+    if (ec != NULL)
+    {
+        ec->EncryptionType = EncryptionType;
+        ec->KeyId = KeyId;
+        ec->OnAckRcvd = HandleMultiAckTestAckRcvd;
+        ec->OnMessageReceived = HandleMultiAckTestMessage;
+        ec->mWRMPConfig.mInitialRetransTimeout = kMultiAckTestRetransTimeout;
+        ec->mWRMPConfig.mActiveRetransTimeout = kMultiAckTestRetransTimeout;
+    }
+    return ec;
+}
+
+static void CloseMultiAckTestContexts(void)
+{
+    for (int i = 0; i < kMultiAckTestExchanges; i++)
+    {
+        if (MultiAckTestEC[i] != NULL)
+        {
+            MultiAckTestEC[i]->Abort();
+            MultiAckTestEC[i] = NULL;
+        }
+    }
+}
+
+static void FormMultiAckTestPayload(PacketBuffer **buf, uint16_t len)
+{
+    uint8_t *p;
+
+    PrepareNewBuf(buf);
+    p = (*buf)->Start();
+    for (int i = 0; i < kMultiAckTestExchanges; i++)
+    {
+        // The peer is the responder on all the exchanges, so the initiator flag is clear.
+        nl::Weave::Encoding::LittleEndian::Write16(p, MultiAckTestEC[i]->ExchangeId);
+        nl::Weave::Encoding::Write8(p, 0);
+        nl::Weave::Encoding::LittleEndian::Write32(p, MultiAckTestMsgId[i]);
+    }
+    (*buf)->SetDataLength(len);
+}
+
+//Have the peer acknowledge messages on several exchanges in one multi-ack message, then check that
+//each entry clears the retransmit entry of its own exchange, and that entries for an exchange with
+//another key or encryption type, or in a payload of the wrong length, are ignored
+testStatus_t TestWRMPMultiAckReceipt(void)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    PacketBuffer *payloadBuf = NULL;
+    ExchangeContext *requestEC = NULL;
+    WeaveMessageInfo msgInfo;
+    testStatus_t res;
+
+    Done = false;
+    MultiAckTestWrongAck = false;
+
+    for (int i = 0; i < kMultiAckTestExchanges; i++)
+    {
+        MultiAckTestAcked[i] = false;
+        MultiAckTestEC[i] = NewMultiAckTestContext();
+        VerifyOrFail(MultiAckTestEC[i] != NULL, "NewContext failed\n");
+
+        //Keep the message from the peer so that only the multi-ack can acknowledge it
+        WRMPClient.ExchangeMgr->MessageLayer->mDropMessage = true;
+
+        PrepareNewBuf(&payloadBuf);
+        msgInfo.Clear();
+        msgInfo.SourceNodeId = WRMPClient.ExchangeMgr->FabricState->LocalNodeId;
+        msgInfo.DestNodeId = MultiAckTestEC[i]->PeerNodeId;
+        msgInfo.EncryptionType = EncryptionType;
+        msgInfo.KeyId = KeyId;
+        err = MultiAckTestEC[i]->SendMessage(kWeaveProfile_Test, kWeaveTestMessageType_No_Response, payloadBuf,
+                                             ExchangeContext::kSendFlag_RequestAck, &msgInfo, &MultiAckTestCtxt[i]);
+
+        WRMPClient.ExchangeMgr->MessageLayer->mDropMessage = false;
+        SuccessOrFail(err, "SendMessage failed\n");
+
+        MultiAckTestMsgId[i] = msgInfo.MessageId;
+    }
+
+    //The last two exchanges pretend to use another key and another encryption type; their entries must be ignored
+    MultiAckTestEC[kMultiAckTestExchanges - 2]->KeyId = (KeyId == WeaveKeyId::kNone) ? WeaveKeyId::kFabricSecret :
+                                                                                         WeaveKeyId::kNone;
+    MultiAckTestEC[kMultiAckTestExchanges - 1]->EncryptionType = (EncryptionType == kWeaveEncryptionType_None) ?
+                                                                   kWeaveEncryptionType_AES128CTRSHA1 : kWeaveEncryptionType_None;
+
+    //The peer sends the payload back as a multi-ack
+    requestEC = NewMultiAckTestContext();
+    VerifyOrFail(requestEC != NULL, "NewContext failed\n");
+
+    //First with a trailing byte, which must cause the whole message to be dropped
+    FormMultiAckTestPayload(&payloadBuf, kMultiAckTestExchanges * kMultiAckTestEntrySize + 1);
+    err = requestEC->SendMessage(kWeaveProfile_Test, kWeaveTestMessageType_Request_MultiAck, payloadBuf, 0);
+    SuccessOrFail(err, "SendMessage failed to send Request_MultiAck message\n");
+
+    LastEchoTime = Now();
+    while (Now() < LastEchoTime + MaxAckReceiptInterval / 2)
+    {
+        struct timeval sleepTime;
+        sleepTime.tv_sec = 0;
+        sleepTime.tv_usec = 100000;
+
+        ServiceNetwork(sleepTime);
+    }
+
+    for (int i = 0; i < kMultiAckTestExchanges; i++)
+    {
+        if (MultiAckTestAcked[i])
+        {
+            printf("Multi-ack with a bad length acknowledged exchange %04X\n", MultiAckTestEC[i]->ExchangeId);
+            CloseMultiAckTestContexts();
+            requestEC->Close();
+            return TEST_FAIL;
+        }
+    }
+
+#if WEAVE_CONFIG_WRMP_COALESCE_ACKS || WEAVE_CONFIG_WRMP_ENABLE_SEND_WINDOW
+    if (WRMPClient.ExchangeMgr->WRMPPeerAcceptsMultiAck(requestEC->PeerNodeId))
+    {
+        printf("Peer learned from a multi-ack with a bad length\n");
+        CloseMultiAckTestContexts();
+        requestEC->Close();
+        return TEST_FAIL;
+    }
+#endif
+
+    FormMultiAckTestPayload(&payloadBuf, kMultiAckTestExchanges * kMultiAckTestEntrySize);
+    err = requestEC->SendMessage(kWeaveProfile_Test, kWeaveTestMessageType_Request_MultiAck, payloadBuf, 0);
+    SuccessOrFail(err, "SendMessage failed to send Request_MultiAck message\n");
+
+    LastEchoTime = Now();
+    while (!Done)
+    {
+        struct timeval sleepTime;
+        sleepTime.tv_sec = 0;
+        sleepTime.tv_usec = 100000;
+
+        ServiceNetwork(sleepTime);
+
+        //All the entries of a multi-ack are processed together
+        if (MultiAckTestAcked[0] || Now() > LastEchoTime + MaxAckReceiptInterval)
+        {
+            Done = true;
+        }
+    }
+
+    for (int i = 0; i < kMultiAckTestExchanges; i++)
+    {
+        printf("Exchange %04X %s\n", MultiAckTestEC[i]->ExchangeId, MultiAckTestAcked[i] ? "acknowledged" : "not acknowledged");
+    }
+
+    res = (MultiAckTestAcked[0] && MultiAckTestAcked[1] && !MultiAckTestAcked[2] && !MultiAckTestAcked[3] &&
+           !MultiAckTestWrongAck) ? TEST_PASS : TEST_FAIL;
+
+#if WEAVE_CONFIG_WRMP_COALESCE_ACKS || WEAVE_CONFIG_WRMP_ENABLE_SEND_WINDOW
+    //Having received a well-formed multi-ack from the peer, acks sent to it may be coalesced
+    if (!WRMPClient.ExchangeMgr->WRMPPeerAcceptsMultiAck(requestEC->PeerNodeId))
+    {
+        printf("Peer not learned from its multi-ack\n");
+        res = TEST_FAIL;
+    }
+#endif
+
+    CloseMultiAckTestContexts();
+    requestEC->Close();
+
+    return res;
+}
+
+#if WEAVE_CONFIG_WRMP_COALESCE_ACKS
+//Have the peer send a message requesting an ack on each of several exchanges at about the same time,
+//and collect the ack stats once all the messages have been received and the acks sent
+static WEAVE_ERROR ReceiveMultiAckTestMessages(WeaveExchangeManager::WRMPAckStats &stats)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    PacketBuffer *payloadBuf = NULL;
+
+    Done = false;
+    MultiAckTestMsgCount = 0;
+    WRMPClient.ExchangeMgr->ResetWRMPAckStats();
+
+    //The peer answers each DD_Test message with one that requests an ack
+    for (int i = 0; i < kMultiAckTestExchanges; i++)
+    {
+        MultiAckTestEC[i] = NewMultiAckTestContext();
+        VerifyOrExit(MultiAckTestEC[i] != NULL, err = WEAVE_ERROR_NO_MEMORY);
+
+        PrepareNewBuf(&payloadBuf);
+        err = MultiAckTestEC[i]->SendMessage(kWeaveProfile_Test, kWeaveTestMessageType_DD_Test, payloadBuf, 0);
+        SuccessOrExit(err);
+    }
+
+    LastEchoTime = Now();
+    while (!Done)
+    {
+        struct timeval sleepTime;
+        sleepTime.tv_sec = 0;
+        sleepTime.tv_usec = 10000;
+
+        ServiceNetwork(sleepTime);
+
+        //Without multi-acks, each exchange sends its ack alone once the ack timeout expires
+        WRMPClient.ExchangeMgr->GetWRMPAckStats(stats);
+        if ((MultiAckTestMsgCount == kMultiAckTestExchanges && stats.MultiAcksSent != 0) ||
+            Now() > LastEchoTime + MaxAckReceiptInterval)
+        {
+            Done = true;
+        }
+    }
+
+    printf("%d messages received; %" PRIu32 " multi-acks sent with %" PRIu32 " acks in the payload\n",
+           MultiAckTestMsgCount, stats.MultiAcksSent, stats.AcksSaved);
+
+exit:
+    CloseMultiAckTestContexts();
+
+    return err;
+}
+
+//Receive messages requesting an ack on several exchanges with the peer at about the same time
+//Expect the acks to be sent one per message until the peer is known to accept multi-acks, and then
+//to leave in a single multi-ack message
+testStatus_t TestWRMPMultiAckCoalescing(void)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    WeaveExchangeManager::WRMPAckStats stats;
+    uint64_t peerNodeId = WRMPClient.ExchangeCtx->PeerNodeId;
+
+    //A peer that has not been seen sending a multi-ack may not understand one
+    VerifyOrFail(!WRMPClient.ExchangeMgr->WRMPPeerAcceptsMultiAck(peerNodeId), "Peer unexpectedly accepts multi-acks\n");
+
+    err = ReceiveMultiAckTestMessages(stats);
+    SuccessOrFail(err, "ReceiveMultiAckTestMessages failed\n");
+
+    if (MultiAckTestMsgCount != kMultiAckTestExchanges || stats.MultiAcksSent != 0)
+    {
+        printf("Multi-ack sent to a peer not known to accept it\n");
+        return TEST_FAIL;
+    }
+
+    WRMPClient.ExchangeMgr->WRMPSetPeerAcceptsMultiAck(peerNodeId);
+
+    err = ReceiveMultiAckTestMessages(stats);
+    SuccessOrFail(err, "ReceiveMultiAckTestMessages failed\n");
+
+    return (stats.MultiAcksSent == 1 && stats.AcksSaved == kMultiAckTestExchanges - 1) ? TEST_PASS : TEST_FAIL;
+}
+#else // WEAVE_CONFIG_WRMP_COALESCE_ACKS
+//Keep the test numbers the same in every build
+testStatus_t TestWRMPMultiAckCoalescing(void)
+{
+    printf("Skipped: built without WEAVE_CONFIG_WRMP_COALESCE_ACKS\n");
+    return TEST_PASS;
+}
+#endif // WEAVE_CONFIG_WRMP_COALESCE_ACKS
+
+#if WEAVE_CONFIG_WRMP_ENABLE_SEND_WINDOW
+//Lose a full send window of messages, then let them be retransmitted
+//Expect the window to be halved once for the loss, rather than once per retransmitted message
+static testStatus_t TestWRMPSendWindowLoss(ExchangeContext *ec, uint8_t sendWindow)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    PacketBuffer *payloadBuf = NULL;
+
+    ackCount = 0;
+    LastEchoTime = Now();
+
+    WRMPClient.ExchangeMgr->MessageLayer->mDropMessage = true;
+    for (uint8_t i = 0; i < sendWindow; i++)
+    {
+        PrepareNewBuf(&payloadBuf);
+        err = SendCustomMessage(ec, kWeaveProfile_Test, kWeaveTestMessageType_No_Response, ExchangeContext::kSendFlag_RequestAck,
+                                payloadBuf);
+        if (err != WEAVE_NO_ERROR)
+            break;
+    }
+    WRMPClient.ExchangeMgr->MessageLayer->mDropMessage = false;
+    SuccessOrFail(err, "SendCustomMessage failed\n");
+
+    while (ackCount < sendWindow)
+    {
+        struct timeval sleepTime;
+        sleepTime.tv_sec = 0;
+        sleepTime.tv_usec = 10000;
+
+        ServiceNetwork(sleepTime);
+
+        if (Now() > LastEchoTime + sendWindow * (MaxAckReceiptInterval + RetransInterval))
+        {
+            printf("%d of %d lost messages acknowledged\n", ackCount, sendWindow);
+            return TEST_FAIL;
+        }
+    }
+
+    //Having grown to its maximum, the window still covers the configured one after being halved once
+    printf("Send window is %d messages after the loss\n", ec->WRMPGetSendWindow());
+
+    return (ec->WRMPGetSendWindow() == sendWindow) ? TEST_PASS : TEST_FAIL;
+}
+
+//Send several messages that do not solicit a reply, keeping as many in flight as the send window allows
+//Expect sending beyond the window to be refused, all messages to be acknowledged, and the window to
+//shrink once when a window of messages is lost
+testStatus_t TestWRMPSendWindow(void)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    PacketBuffer *payloadBuf = NULL;
+    uint16_t sendFlags = ExchangeContext::kSendFlag_RequestAck;
+    const uint8_t kSendWindow = 4;
+    const uint8_t kMsgCount = 16;
+    uint8_t sentCount = 0;
+    bool windowFull = false;
+    ExchangeContext *ec = WRMPClient.ExchangeCtx;
+
+    isAckRcvd = false;
+    ackCount = 0;
+    Done = false;
+    LastEchoTime = Now();
+
+    //Set the retrans timeout
+    if (RetransInterval)
+    {
+        ec->mWRMPConfig.mInitialRetransTimeout = RetransInterval;
+        ec->mWRMPConfig.mActiveRetransTimeout = RetransInterval;
+    }
+    ec->mWRMPConfig.mSendWindow = kSendWindow;
+
+    while (!Done)
+    {
+        struct timeval sleepTime;
+        sleepTime.tv_sec = 0;
+        sleepTime.tv_usec = 10000;
+
+        //Fill the send window
+        while (sentCount < kMsgCount)
+        {
+            PrepareNewBuf(&payloadBuf);
+            err = SendCustomMessage(ec, kWeaveProfile_Test, kWeaveTestMessageType_No_Response, sendFlags, payloadBuf);
+            if (err == WEAVE_ERROR_SEND_THROTTLED)
+            {
+                windowFull = true;
+                break;
+            }
+            if (err != WEAVE_NO_ERROR)
+            {
+                printf("WRMPTestClient.SendCustomMessage failed: %s\n", ErrorStr(err));
+                Done = true;
+                return TEST_FAIL;
+            }
+            sentCount++;
+
+            if (ec->WRMPGetInFlightCount() > kSendWindow)
+            {
+                printf("%d messages in flight; send window is %d\n", ec->WRMPGetInFlightCount(), kSendWindow);
+                Done = true;
+                return TEST_FAIL;
+            }
+        }
+
+        ServiceNetwork(sleepTime);
+
+        if (ackCount == kMsgCount)
+        {
+            printf("Send window reached %d messages\n", ec->WRMPGetSendWindow());
+            return windowFull ? TestWRMPSendWindowLoss(ec, kSendWindow) : TEST_FAIL;
+        }
+
+        if (Now() > LastEchoTime + kMsgCount * (MaxAckReceiptInterval + RetransInterval))
+        {
+            printf("%d of %d messages acknowledged\n", ackCount, kMsgCount);
+            Done = true;
+            return TEST_FAIL;
+        }
+    }
+
+    return TEST_FAIL;
+}
+#else // WEAVE_CONFIG_WRMP_ENABLE_SEND_WINDOW
+//Keep the test numbers the same in every build
+testStatus_t TestWRMPSendWindow(void)
+{
+    printf("Skipped: built without WEAVE_CONFIG_WRMP_ENABLE_SEND_WINDOW\n");
+    return TEST_PASS;
+}
+#endif // WEAVE_CONFIG_WRMP_ENABLE_SEND_WINDOW
+
 struct Tests {
     testStatus_t (*mTest)(void);
     const char * mTestName;
@@ -1445,7 +1963,11 @@ Tests gTests[] =
     { .mTest = TestWRMPDuplicateMsgLostAck, .mTestName = "TestWRMPDuplicateMsgLostAck" },
     { .mTest = TestWRMPDuplicateMsgAckOnClosedExResponder, .mTestName = "TestWRMPDuplicateMsgAckOnClosedExResponder" },
     { .mTest = TestWRMPDuplicateMsgAckOnClosedExInitiator, .mTestName = "TestWRMPDuplicateMsgAckOnClosedExInitiator" },
-    { .mTest = TestWRMPDuplicateMsgDetection, .mTestName = "TestWRMPDuplicateMsgDetection" }
+    { .mTest = TestWRMPDuplicateMsgDetection, .mTestName = "TestWRMPDuplicateMsgDetection" },
+    { .mTest = TestWRMPThrottleExpiry, .mTestName = "TestWRMPThrottleExpiry" },
+    { .mTest = TestWRMPMultiAckReceipt, .mTestName = "TestWRMPMultiAckReceipt" },
+    { .mTest = TestWRMPMultiAckCoalescing, .mTestName = "TestWRMPMultiAckCoalescing" },
+    { .mTest = TestWRMPSendWindow, .mTestName = "TestWRMPSendWindow" },
 };
 
 #endif // WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
@@ -1978,6 +2500,8 @@ WEAVE_ERROR WRMPTestServer::Init(WeaveExchangeManager *exchangeMgr)
                                                    AllowDuplicateMsgs, this);
     ExchangeMgr->RegisterUnsolicitedMessageHandler(kWeaveProfile_Test, kWeaveTestMessageType_DontAllowDup, HandleRcvdMessage,
                                                    AllowDuplicateMsgs, this);
+    ExchangeMgr->RegisterUnsolicitedMessageHandler(kWeaveProfile_Test, kWeaveTestMessageType_Request_MultiAck, HandleRcvdMessage,
+                                                   AllowDuplicateMsgs, this);
 
     return WEAVE_NO_ERROR;
 }
@@ -2160,6 +2684,14 @@ void WRMPTestServer::HandleRcvdMessage(ExchangeContext *ec, const IPPacketInfo *
         ec->AllowDuplicateMsgs = false;
         PacketBuffer::Free(payload);
     }
+    else if (profileId == kWeaveProfile_Test && msgType == kWeaveTestMessageType_Request_MultiAck)
+    {
+        printf("TestWRMP: Received Test Msg Type Request_MultiAck; Sending the payload back as a multi-ack\n");
+        WEAVE_ERROR err = ec->SendMessage(nl::Weave::Profiles::kWeaveProfile_Common,
+                                          nl::Weave::Profiles::Common::kMsgType_WRMP_Multi_Ack, payload,
+                                          ExchangeContext::kSendFlag_NoAutoRequestAck);
+        SuccessOrFail(err, "ec->SendMessage failed to send multi-ack message\n");
+    }
     else if (profileId == kWeaveProfile_Test && msgType == kWeaveTestMessageType_EchoRequestForDup)
     {
         // If test echo request message is a duplicate send echo response.
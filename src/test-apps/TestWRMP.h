@@ -57,6 +57,7 @@ enum
     kWeaveTestMessageType_DontAllowDup            = 14,
     kWeaveTestMessageType_EchoRequestForDup       = 15,
     kWeaveTestMessageType_Response                = 16,
+    kWeaveTestMessageType_Request_MultiAck        = 17,
 };
 
 typedef enum
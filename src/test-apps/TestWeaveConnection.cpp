@@ -0,0 +1,326 @@
+/*
+ *
+ *    Copyright (c) 2018 Google LLC.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements a unit test suite for the receive and send
+ *      buffering budgets of WeaveConnection, over a TCP connection from
+ *      the node to itself.
+ *
+ */
+
+#ifndef __STDC_FORMAT_MACROS
+#define __STDC_FORMAT_MACROS
+#endif
+
+#ifndef __STDC_LIMIT_MACROS
+#define __STDC_LIMIT_MACROS
+#endif
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <nlunit-test.h>
+
+#include "ToolCommon.h"
+
+#define TOOL_NAME "TestWeaveConnection"
+
+static HelpOptions gHelpOptions(
+    TOOL_NAME,
+    "Usage: " TOOL_NAME " [<options...>]\n",
+    WEAVE_VERSION_STRING "\n" WEAVE_TOOL_COPYRIGHT
+);
+
+static OptionSet *gToolOptionSets[] =
+{
+    &gNetworkOptions,
+    &gWeaveNodeOptions,
+    &gFaultInjectionOptions,
+    &gHelpOptions,
+    NULL
+};
+
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS && WEAVE_CONFIG_CONNECTION_RECEIVE_BUDGET && WEAVE_CONFIG_CONNECTION_SEND_BUDGET
+
+enum
+{
+    kTestMessageLength      = 1024,     // Payload length of each test message.
+    kMaxTestMessages        = 16384,    // Upper bound on the messages sent to fill the budgets.
+    kMaxServiceIterations   = 1000      // Upper bound on the event loop iterations spent waiting.
+};
+
+static WeaveConnection *sClientCon = NULL;
+static WeaveConnection *sServerCon = NULL;
+static bool sConnectionComplete = false;
+static uint32_t sMessagesSent = 0;
+static uint32_t sMessagesReceived = 0;
+static uint32_t sSendPausedCount = 0;
+static uint32_t sSendResumedCount = 0;
+
+static void HandleMessageReceived(WeaveConnection *con, WeaveMessageInfo *msgInfo, PacketBuffer *msgBuf)
+{
+    sMessagesReceived++;
+    PacketBuffer::Free(msgBuf);
+}
+
+static void HandleConnectionReceived(WeaveMessageLayer *msgLayer, WeaveConnection *con)
+{
+    // Hold off delivery on the receiving side, so that the data sent to it can only accumulate.
+    sServerCon = con;
+    con->OnMessageReceived = HandleMessageReceived;
+    con->DisableReceive();
+}
+
+static void HandleConnectionComplete(WeaveConnection *con, WEAVE_ERROR conErr)
+{
+    sConnectionComplete = (conErr == WEAVE_NO_ERROR);
+}
+
+static void HandleSendBackpressure(WeaveConnection *con, bool paused)
+{
+    if (paused)
+        sSendPausedCount++;
+    else
+        sSendResumedCount++;
+}
+
+static void ServiceNetworkOnce(void)
+{
+    struct timeval sleepTime;
+
+    sleepTime.tv_sec = 0;
+    sleepTime.tv_usec = 10000;
+
+    ServiceNetwork(sleepTime);
+}
+
+static WEAVE_ERROR SendTestMessage(void)
+{
+    WeaveMessageInfo msgInfo;
+    PacketBuffer *msgBuf = PacketBuffer::New();
+
+    if (msgBuf == NULL)
+        return WEAVE_ERROR_NO_MEMORY;
+
+    memset(msgBuf->Start(), 0x5A, kTestMessageLength);
+    msgBuf->SetDataLength(kTestMessageLength);
+
+    msgInfo.Clear();
+    msgInfo.MessageVersion = kWeaveMessageVersion_V1;
+    msgInfo.DestNodeId = FabricState.LocalNodeId;
+    msgInfo.EncryptionType = kWeaveEncryptionType_None;
+    msgInfo.KeyId = WeaveKeyId::kNone;
+
+    return sClientCon->SendMessage(&msgInfo, msgBuf);
+}
+
+static void GetBufferStats(WeaveMessageLayer::ConnectionBufferStats &stats)
+{
+    MessageLayer.GetConnectionBufferStats(stats);
+}
+
+// Connect to the node itself, with the receiving end of the connection holding off delivery.
+static void CheckConnect(nlTestSuite *inSuite, void *inContext)
+{
+    WEAVE_ERROR err;
+    IPAddress loopbackAddr;
+
+    MessageLayer.OnConnectionReceived = HandleConnectionReceived;
+
+    NL_TEST_ASSERT(inSuite, IPAddress::FromString("::1", loopbackAddr));
+
+    sClientCon = MessageLayer.NewConnection();
+    NL_TEST_ASSERT(inSuite, sClientCon != NULL);
+
+    sClientCon->OnConnectionComplete = HandleConnectionComplete;
+    sClientCon->OnSendBackpressure = HandleSendBackpressure;
+
+    err = sClientCon->Connect(FabricState.LocalNodeId, loopbackAddr);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    for (int i = 0; i < kMaxServiceIterations && !(sConnectionComplete && sServerCon != NULL); i++)
+        ServiceNetworkOnce();
+
+    NL_TEST_ASSERT(inSuite, sConnectionComplete);
+    NL_TEST_ASSERT(inSuite, sServerCon != NULL);
+}
+
+// Data the receiver cannot take accumulates until the connection exceeds its receive budget, and reading then pauses.
+static void CheckReceiveBudget(nlTestSuite *inSuite, void *inContext)
+{
+    WEAVE_ERROR err;
+    WeaveMessageLayer::ConnectionBufferStats before, after;
+
+    GetBufferStats(before);
+    after = before;
+
+    while (sMessagesSent < kMaxTestMessages && after.ReceivePauseCount == before.ReceivePauseCount)
+    {
+        err = SendTestMessage();
+        if (err == WEAVE_NO_ERROR)
+            sMessagesSent++;
+        else
+            NL_TEST_ASSERT(inSuite, err == WEAVE_ERROR_SENDING_BLOCKED);
+
+        ServiceNetworkOnce();
+        GetBufferStats(after);
+    }
+
+    NL_TEST_ASSERT(inSuite, after.ReceivePauseCount == before.ReceivePauseCount + 1);
+    NL_TEST_ASSERT(inSuite, sServerCon->PendingReceiveLength() > WEAVE_CONFIG_CONNECTION_RECEIVE_BUDGET);
+    NL_TEST_ASSERT(inSuite, after.PendingReceiveLength >= sServerCon->PendingReceiveLength());
+    NL_TEST_ASSERT(inSuite, sMessagesReceived == 0);
+}
+
+// With the receiver paused, the sender's queue grows past its send budget, sending pauses and further messages are
+// refused.
+static void CheckSendBudget(nlTestSuite *inSuite, void *inContext)
+{
+    WEAVE_ERROR err;
+    WeaveMessageLayer::ConnectionBufferStats before, after;
+    uint32_t pendingReceiveLength = sServerCon->PendingReceiveLength();
+
+    GetBufferStats(before);
+
+    while (sMessagesSent < kMaxTestMessages && !sClientCon->IsSendPaused())
+    {
+        err = SendTestMessage();
+        NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+        if (err != WEAVE_NO_ERROR)
+            break;
+
+        sMessagesSent++;
+        ServiceNetworkOnce();
+    }
+
+    GetBufferStats(after);
+
+    NL_TEST_ASSERT(inSuite, sClientCon->IsSendPaused());
+    NL_TEST_ASSERT(inSuite, sSendPausedCount == 1 && sSendResumedCount == 0);
+    NL_TEST_ASSERT(inSuite, after.SendPauseCount == before.SendPauseCount + 1);
+    NL_TEST_ASSERT(inSuite, sClientCon->PendingSendLength() > WEAVE_CONFIG_CONNECTION_SEND_BUDGET);
+
+    err = SendTestMessage();
+    NL_TEST_ASSERT(inSuite, err == WEAVE_ERROR_SENDING_BLOCKED);
+
+    // The paused receiver has not read any further.
+    NL_TEST_ASSERT(inSuite, sServerCon->PendingReceiveLength() == pendingReceiveLength);
+    NL_TEST_ASSERT(inSuite, after.ReceivePauseCount == before.ReceivePauseCount);
+    NL_TEST_ASSERT(inSuite, sMessagesReceived == 0);
+}
+
+// Enabling receive resumes reading: the held data and everything queued behind it is delivered, and the sender is told
+// it may send again once its queue drains.
+static void CheckResume(nlTestSuite *inSuite, void *inContext)
+{
+    WEAVE_ERROR err;
+    WeaveMessageLayer::ConnectionBufferStats stats;
+
+    sServerCon->EnableReceive();
+
+    for (int i = 0; i < kMaxServiceIterations && (sMessagesReceived < sMessagesSent || sClientCon->IsSendPaused()); i++)
+        ServiceNetworkOnce();
+
+    GetBufferStats(stats);
+
+    NL_TEST_ASSERT(inSuite, sMessagesReceived == sMessagesSent);
+    NL_TEST_ASSERT(inSuite, !sClientCon->IsSendPaused());
+    NL_TEST_ASSERT(inSuite, sSendPausedCount == 1 && sSendResumedCount == 1);
+    NL_TEST_ASSERT(inSuite, sServerCon->PendingReceiveLength() == 0);
+    NL_TEST_ASSERT(inSuite, stats.PendingReceiveLength == 0);
+
+    err = SendTestMessage();
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    if (err == WEAVE_NO_ERROR)
+        sMessagesSent++;
+
+    for (int i = 0; i < kMaxServiceIterations && sMessagesReceived < sMessagesSent; i++)
+        ServiceNetworkOnce();
+
+    NL_TEST_ASSERT(inSuite, sMessagesReceived == sMessagesSent);
+}
+
+static const nlTest sTests[] = {
+    NL_TEST_DEF("WeaveConnection::Connect",        CheckConnect),
+    NL_TEST_DEF("WeaveConnection::ReceiveBudget",  CheckReceiveBudget),
+    NL_TEST_DEF("WeaveConnection::SendBudget",     CheckSendBudget),
+    NL_TEST_DEF("WeaveConnection::Resume",         CheckResume),
+    NL_TEST_SENTINEL()
+};
+
+/**
+ *  Set up the test suite.
+ */
+static int TestSetup(void *inContext)
+{
+    InitSystemLayer();
+    InitNetwork();
+    InitWeaveStack(true, false);
+
+    return (SUCCESS);
+}
+
+/**
+ *  Tear down the test suite.
+ */
+static int TestTeardown(void *inContext)
+{
+    if (sClientCon != NULL)
+        sClientCon->Abort();
+    if (sServerCon != NULL)
+        sServerCon->Abort();
+
+    ShutdownWeaveStack();
+    ShutdownNetwork();
+    ShutdownSystemLayer();
+
+    return (SUCCESS);
+}
+
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS && WEAVE_CONFIG_CONNECTION_RECEIVE_BUDGET && WEAVE_CONFIG_CONNECTION_SEND_BUDGET
+
+int main(int argc, char *argv[])
+{
+    SetSIGUSR1Handler();
+
+    if (!ParseArgs(TOOL_NAME, argc, argv, gToolOptionSets, NULL))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS && WEAVE_CONFIG_CONNECTION_RECEIVE_BUDGET && WEAVE_CONFIG_CONNECTION_SEND_BUDGET
+    nlTestSuite theSuite = {
+        "weave-connection",
+        &sTests[0],
+        TestSetup,
+        TestTeardown
+    };
+
+    // Generate machine-readable, comma-separated value (CSV) output.
+    nl_test_set_output_style(OUTPUT_CSV);
+
+    // Run test suite against one context.
+    nlTestRunner(&theSuite, NULL);
+
+    return nlTestRunnerStats(&theSuite);
+#else
+    return 0;
+#endif
+}
@@ -31,6 +31,60 @@
 
 #include "ToolCommon.h"
 
+namespace nl {
+namespace Weave {
+
+class NL_DLL_EXPORT WeaveFabricStateTestObject
+{
+public:
+    typedef WeaveFabricState::PeerIndexType PeerIndexType;
+
+    static bool FindPeer(WeaveFabricState &fabricState, uint64_t peerNodeId, PeerIndexType &peerIndex)
+    {
+        return fabricState.FindPeerEntry(peerNodeId, peerIndex);
+    }
+
+    static PeerIndexType UsePeer(WeaveFabricState &fabricState, uint64_t peerNodeId)
+    {
+        PeerIndexType peerIndex;
+
+        fabricState.FindOrAllocPeerEntry(peerNodeId, true, peerIndex);
+        return peerIndex;
+    }
+
+    static uint64_t PeerNodeId(const WeaveFabricState &fabricState, PeerIndexType peerIndex)
+    {
+        return fabricState.PeerStates.NodeId[peerIndex];
+    }
+
+    static PeerIndexType PeerCount(const WeaveFabricState &fabricState)
+    {
+        return fabricState.PeerCount;
+    }
+
+#if WEAVE_CONFIG_ENABLE_PEER_STATE_INDEX
+    static bool SamePeerHashBucket(WeaveFabricState &fabricState, uint64_t peerNodeId1, uint64_t peerNodeId2)
+    {
+        return WeaveFabricState::GetPeerHashBucket(fabricState.PeerStates.HashBuckets, peerNodeId1) ==
+               WeaveFabricState::GetPeerHashBucket(fabricState.PeerStates.HashBuckets, peerNodeId2);
+    }
+#endif
+
+#if WEAVE_CONFIG_USE_APP_GROUP_KEYS_FOR_MSG_ENC
+    // Mark the group key message counter of a peer as synchronized, without using the peer's entry.
+    static void SetPeerSynchronized(WeaveFabricState &fabricState, uint64_t peerNodeId)
+    {
+        PeerIndexType peerIndex;
+
+        if (fabricState.FindPeerEntry(peerNodeId, peerIndex))
+            fabricState.PeerStates.GroupKeyRcvFlags[peerIndex] |= WeaveSessionState::kReceiveFlags_MessageIdSynchronized;
+    }
+#endif
+};
+
+} // namespace Weave
+} // namespace nl
+
 static const uint64_t kTestNodeId = 0x18B43000002DCF71ULL;
 static const uint64_t kTestFabricId = 0xFEEDBEEFULL;
 static const uint16_t kDefaultSubnet = 0x01;
@@ -101,6 +155,303 @@ static void CheckSelectNodeAddressWithSubnet(nlTestSuite *inSuite, void *inConte
     }
 }
 
+/**
+ * Test allocating, finding and removing session keys.
+ */
+static void CheckSessionKeys(nlTestSuite *inSuite, void *inContext)
+{
+    const uint64_t kPeerNodeIdBase = 0x18B4300000000000ULL;
+    WeaveSessionKey *sessionKey;
+    WEAVE_ERROR err;
+#if WEAVE_CONFIG_ENABLE_SESSION_KEY_INDEX
+    WeaveFabricState::SessionKeyStats stats;
+
+    sFabricState.ResetSessionKeyStats();
+#endif
+
+    // Fill the session key table, using the same key id with every peer.
+    for (uint64_t i = 0; i < WEAVE_CONFIG_MAX_SESSION_KEYS; i++)
+    {
+        err = sFabricState.AllocSessionKey(kPeerNodeIdBase + i, WeaveKeyId::MakeSessionKeyId(1), NULL, sessionKey);
+        NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    }
+
+    err = sFabricState.AllocSessionKey(kPeerNodeIdBase + WEAVE_CONFIG_MAX_SESSION_KEYS, WeaveKeyId::MakeSessionKeyId(1), NULL, sessionKey);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_ERROR_TOO_MANY_KEYS);
+
+    err = sFabricState.AllocSessionKey(kPeerNodeIdBase, WeaveKeyId::MakeSessionKeyId(1), NULL, sessionKey);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_ERROR_DUPLICATE_KEY_ID);
+
+    for (uint64_t i = 0; i < WEAVE_CONFIG_MAX_SESSION_KEYS; i++)
+    {
+        err = sFabricState.GetSessionKey(WeaveKeyId::MakeSessionKeyId(1), kPeerNodeIdBase + i, sessionKey);
+        NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, err != WEAVE_NO_ERROR || sessionKey->NodeId == kPeerNodeIdBase + i);
+
+        err = sFabricState.GetSessionKey(WeaveKeyId::MakeSessionKeyId(2), kPeerNodeIdBase + i, sessionKey);
+        NL_TEST_ASSERT(inSuite, err == WEAVE_ERROR_KEY_NOT_FOUND);
+    }
+
+    // Removing a key frees its entry for a new key.
+    err = sFabricState.RemoveSessionKey(WeaveKeyId::MakeSessionKeyId(1), kPeerNodeIdBase);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    err = sFabricState.GetSessionKey(WeaveKeyId::MakeSessionKeyId(1), kPeerNodeIdBase, sessionKey);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_ERROR_KEY_NOT_FOUND);
+
+    err = sFabricState.AllocSessionKey(kPeerNodeIdBase, WeaveKeyId::MakeSessionKeyId(2), NULL, sessionKey);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    err = sFabricState.GetSessionKey(WeaveKeyId::MakeSessionKeyId(2), kPeerNodeIdBase, sessionKey);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+#if WEAVE_CONFIG_ENABLE_SESSION_KEY_INDEX
+    sFabricState.GetSessionKeyStats(stats);
+    NL_TEST_ASSERT(inSuite, stats.NumKeys == WEAVE_CONFIG_MAX_SESSION_KEYS);
+    NL_TEST_ASSERT(inSuite, stats.MaxKeys == WEAVE_CONFIG_MAX_SESSION_KEYS);
+    NL_TEST_ASSERT(inSuite, stats.LookupHits == WEAVE_CONFIG_MAX_SESSION_KEYS + 3);
+    NL_TEST_ASSERT(inSuite, stats.LookupMisses == 2 * WEAVE_CONFIG_MAX_SESSION_KEYS + 3);
+#endif
+
+    sFabricState.RemoveSessionKey(WeaveKeyId::MakeSessionKeyId(2), kPeerNodeIdBase);
+    for (uint64_t i = 1; i < WEAVE_CONFIG_MAX_SESSION_KEYS; i++)
+    {
+        err = sFabricState.RemoveSessionKey(WeaveKeyId::MakeSessionKeyId(1), kPeerNodeIdBase + i);
+        NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    }
+
+#if WEAVE_CONFIG_ENABLE_SESSION_KEY_INDEX
+    sFabricState.GetSessionKeyStats(stats);
+    NL_TEST_ASSERT(inSuite, stats.NumKeys == 0);
+#endif
+}
+
+#if WEAVE_CONFIG_WRMP_ADAPTIVE_RETRANS_TIMEOUT
+static uint32_t BoundRetransTimeout(uint32_t timeout)
+{
+    if (timeout < WEAVE_CONFIG_WRMP_MIN_ADAPTIVE_RETRANS_TIMEOUT)
+        return WEAVE_CONFIG_WRMP_MIN_ADAPTIVE_RETRANS_TIMEOUT;
+    if (timeout > WEAVE_CONFIG_WRMP_MAX_ADAPTIVE_RETRANS_TIMEOUT)
+        return WEAVE_CONFIG_WRMP_MAX_ADAPTIVE_RETRANS_TIMEOUT;
+    return timeout;
+}
+
+/**
+ * Test the round trip time estimate and retransmission timeout kept for a peer.
+ */
+static void CheckPeerRTT(nlTestSuite *inSuite, void *inContext)
+{
+    const uint64_t kPeerNodeId = 0x18B4300000000ABCULL;
+    WeaveFabricState::PeerRTTStats stats;
+    WeaveSessionState sessionState;
+    uint32_t timeout;
+    uint32_t steadyTimeout;
+
+    NL_TEST_ASSERT(inSuite, !sFabricState.GetPeerRTTStats(kPeerNodeId, stats));
+
+    // Messages and measurements do not create a peer entry.
+    sFabricState.OnReliableMessageSent(kPeerNodeId, false);
+    sFabricState.OnPeerRTTSample(kPeerNodeId, 800);
+    NL_TEST_ASSERT(inSuite, !sFabricState.GetPeerRTTStats(kPeerNodeId, stats));
+
+    // The entry is created when a message is received from the peer.
+    NL_TEST_ASSERT(inSuite, sFabricState.GetSessionState(kPeerNodeId, WeaveKeyId::kNone, kWeaveEncryptionType_None, NULL,
+                                                         sessionState) == WEAVE_NO_ERROR);
+
+    // Messages are counted, but there is no timeout until a round trip is measured.
+    sFabricState.OnReliableMessageSent(kPeerNodeId, false);
+    sFabricState.OnReliableMessageSent(kPeerNodeId, true);
+    NL_TEST_ASSERT(inSuite, sFabricState.GetPeerRTTStats(kPeerNodeId, stats));
+    NL_TEST_ASSERT(inSuite, stats.MessagesSent == 1 && stats.Retransmissions == 1);
+    NL_TEST_ASSERT(inSuite, stats.SmoothedRTT == 0 && stats.RetransTimeout == 0);
+    NL_TEST_ASSERT(inSuite, !sFabricState.GetPeerRetransTimeout(kPeerNodeId, timeout));
+
+    // The first measurement sets SRTT = R and RTTVAR = R / 2, for a timeout of SRTT + 4 * RTTVAR.
+    sFabricState.OnPeerRTTSample(kPeerNodeId, 800);
+    sFabricState.GetPeerRTTStats(kPeerNodeId, stats);
+    NL_TEST_ASSERT(inSuite, stats.SmoothedRTT == 800 && stats.RTTVariation == 400);
+    NL_TEST_ASSERT(inSuite, stats.RetransTimeout == BoundRetransTimeout(800 + 4 * 400));
+    NL_TEST_ASSERT(inSuite, sFabricState.GetPeerRetransTimeout(kPeerNodeId, timeout) && timeout == stats.RetransTimeout);
+
+    // A steady, shorter round trip time draws the estimate down to it, leaving one timer tick of margin.
+    for (int i = 0; i < 100; i++)
+        sFabricState.OnPeerRTTSample(kPeerNodeId, 100);
+    sFabricState.GetPeerRTTStats(kPeerNodeId, stats);
+    NL_TEST_ASSERT(inSuite, stats.SmoothedRTT == 100 && stats.RTTVariation == 0);
+    NL_TEST_ASSERT(inSuite, stats.RetransTimeout == BoundRetransTimeout(100 + WEAVE_CONFIG_WRMP_TIMER_DEFAULT_PERIOD));
+    steadyTimeout = stats.RetransTimeout;
+
+    // A delayed acknowledgment raises the variation, and with it the timeout.
+    sFabricState.OnPeerRTTSample(kPeerNodeId, 2000);
+    sFabricState.GetPeerRTTStats(kPeerNodeId, stats);
+    NL_TEST_ASSERT(inSuite, stats.SmoothedRTT > 100 && stats.RTTVariation > 0);
+    NL_TEST_ASSERT(inSuite, stats.RetransTimeout > steadyTimeout || stats.RetransTimeout == WEAVE_CONFIG_WRMP_MAX_ADAPTIVE_RETRANS_TIMEOUT);
+}
+#endif // WEAVE_CONFIG_WRMP_ADAPTIVE_RETRANS_TIMEOUT
+
+typedef WeaveFabricStateTestObject::PeerIndexType PeerIndexType;
+
+static const uint64_t kPeerStateNodeIdBase = 0x18B4300000010000ULL;
+
+// Start a test with an empty peer state table.
+static void ResetPeerStates(void)
+{
+    sFabricState.Shutdown();
+    (void)sFabricState.Init();
+    sFabricState.LocalNodeId = kTestNodeId;
+    sFabricState.FabricId = kTestFabricId;
+    sFabricState.DefaultSubnet = kDefaultSubnet;
+}
+
+// Return the next node id after the given one that is indexed with the first, or simply the next one without an index.
+static uint64_t NextCollidingNodeId(uint64_t firstNodeId, uint64_t nodeId)
+{
+    do
+        nodeId++;
+#if WEAVE_CONFIG_ENABLE_PEER_STATE_INDEX
+    while (!WeaveFabricStateTestObject::SamePeerHashBucket(sFabricState, firstNodeId, nodeId));
+#else
+    while (false);
+#endif
+
+    return nodeId;
+}
+
+static bool HasPeer(uint64_t peerNodeId)
+{
+    PeerIndexType peerIndex;
+
+    return WeaveFabricStateTestObject::FindPeer(sFabricState, peerNodeId, peerIndex) &&
+           WeaveFabricStateTestObject::PeerNodeId(sFabricState, peerIndex) == peerNodeId;
+}
+
+/**
+ * Test looking up peers whose node ids share a hash bucket.
+ */
+static void CheckPeerStateCollisions(nlTestSuite *inSuite, void *inContext)
+{
+    enum { kNumPeers = (WEAVE_CONFIG_MAX_PEER_NODES < 8) ? WEAVE_CONFIG_MAX_PEER_NODES : 8 };
+    uint64_t nodeIds[kNumPeers];
+    PeerIndexType peerIndexes[kNumPeers];
+    PeerIndexType peerIndex;
+
+    ResetPeerStates();
+
+    nodeIds[0] = kPeerStateNodeIdBase;
+    for (int i = 1; i < kNumPeers; i++)
+        nodeIds[i] = NextCollidingNodeId(nodeIds[0], nodeIds[i - 1]);
+
+    for (int i = 0; i < kNumPeers; i++)
+    {
+        NL_TEST_ASSERT(inSuite, !HasPeer(nodeIds[i]));
+        peerIndexes[i] = WeaveFabricStateTestObject::UsePeer(sFabricState, nodeIds[i]);
+    }
+
+    NL_TEST_ASSERT(inSuite, WeaveFabricStateTestObject::PeerCount(sFabricState) == kNumPeers);
+
+    // Each peer has its own entry, found again from any position in the chain.
+    for (int i = 0; i < kNumPeers; i++)
+    {
+        NL_TEST_ASSERT(inSuite, WeaveFabricStateTestObject::FindPeer(sFabricState, nodeIds[i], peerIndex));
+        NL_TEST_ASSERT(inSuite, peerIndex == peerIndexes[i]);
+        NL_TEST_ASSERT(inSuite, WeaveFabricStateTestObject::PeerNodeId(sFabricState, peerIndex) == nodeIds[i]);
+
+        for (int j = i + 1; j < kNumPeers; j++)
+            NL_TEST_ASSERT(inSuite, peerIndexes[i] != peerIndexes[j]);
+    }
+
+    // Using a peer again returns its existing entry.
+    NL_TEST_ASSERT(inSuite, WeaveFabricStateTestObject::UsePeer(sFabricState, nodeIds[kNumPeers / 2]) == peerIndexes[kNumPeers / 2]);
+    NL_TEST_ASSERT(inSuite, WeaveFabricStateTestObject::PeerCount(sFabricState) == kNumPeers);
+
+    // A node id in the same bucket that has no entry is not found, nor is the wildcard node id.
+    NL_TEST_ASSERT(inSuite, !HasPeer(NextCollidingNodeId(nodeIds[0], nodeIds[kNumPeers - 1])));
+    NL_TEST_ASSERT(inSuite, !WeaveFabricStateTestObject::FindPeer(sFabricState, kAnyNodeId, peerIndex));
+}
+
+/**
+ * Test that a full peer state table gives the entry of the least recently used peer to a new peer.
+ */
+static void CheckPeerStateEviction(nlTestSuite *inSuite, void *inContext)
+{
+    const uint64_t kNewNodeId = kPeerStateNodeIdBase + WEAVE_CONFIG_MAX_PEER_NODES;
+    PeerIndexType evictedIndex;
+    PeerIndexType peerIndex;
+
+    ResetPeerStates();
+
+    for (uint64_t i = 0; i < WEAVE_CONFIG_MAX_PEER_NODES; i++)
+        WeaveFabricStateTestObject::UsePeer(sFabricState, kPeerStateNodeIdBase + i);
+
+    NL_TEST_ASSERT(inSuite, WeaveFabricStateTestObject::PeerCount(sFabricState) == WEAVE_CONFIG_MAX_PEER_NODES);
+
+    // Use the first half of the peers again, leaving the first peer of the second half least recently used.
+    for (uint64_t i = 0; i < WEAVE_CONFIG_MAX_PEER_NODES / 2; i++)
+        WeaveFabricStateTestObject::UsePeer(sFabricState, kPeerStateNodeIdBase + i);
+
+    // Finding a peer does not make it more recently used.
+    NL_TEST_ASSERT(inSuite, HasPeer(kPeerStateNodeIdBase + WEAVE_CONFIG_MAX_PEER_NODES / 2));
+
+    // Each new peer takes the entry of the least recently used one, in order.
+    for (uint64_t i = 0; i < 2; i++)
+    {
+        const uint64_t evictedNodeId = kPeerStateNodeIdBase + WEAVE_CONFIG_MAX_PEER_NODES / 2 + i;
+
+        WeaveFabricStateTestObject::FindPeer(sFabricState, evictedNodeId, evictedIndex);
+        peerIndex = WeaveFabricStateTestObject::UsePeer(sFabricState, kNewNodeId + i);
+
+        NL_TEST_ASSERT(inSuite, peerIndex == evictedIndex);
+        NL_TEST_ASSERT(inSuite, !HasPeer(evictedNodeId));
+        NL_TEST_ASSERT(inSuite, HasPeer(kNewNodeId + i));
+        NL_TEST_ASSERT(inSuite, WeaveFabricStateTestObject::PeerCount(sFabricState) == WEAVE_CONFIG_MAX_PEER_NODES);
+    }
+
+    for (uint64_t i = 0; i < WEAVE_CONFIG_MAX_PEER_NODES; i++)
+    {
+        const bool evicted = (i == WEAVE_CONFIG_MAX_PEER_NODES / 2 || i == WEAVE_CONFIG_MAX_PEER_NODES / 2 + 1);
+        NL_TEST_ASSERT(inSuite, HasPeer(kPeerStateNodeIdBase + i) == !evicted);
+    }
+}
+
+#if WEAVE_CONFIG_USE_APP_GROUP_KEYS_FOR_MSG_ENC
+/**
+ * Test that a full peer state table prefers to give away the entry of a peer whose group key message counter
+ * is not synchronized, including peers that became synchronized after they were last used.
+ */
+static void CheckPeerStateUnsynchronizedEviction(nlTestSuite *inSuite, void *inContext)
+{
+    const uint64_t kNewNodeId = kPeerStateNodeIdBase + WEAVE_CONFIG_MAX_PEER_NODES;
+    const uint64_t kNumSynchronized = (WEAVE_CONFIG_MAX_PEER_NODES > 4) ? 3 : 0;
+
+    ResetPeerStates();
+
+    for (uint64_t i = 0; i < WEAVE_CONFIG_MAX_PEER_NODES; i++)
+        WeaveFabricStateTestObject::UsePeer(sFabricState, kPeerStateNodeIdBase + i);
+
+    // The least recently used peers become synchronized, without being used again.
+    for (uint64_t i = 0; i < kNumSynchronized; i++)
+        WeaveFabricStateTestObject::SetPeerSynchronized(sFabricState, kPeerStateNodeIdBase + i);
+
+    // The new peer takes the entry of the least recently used unsynchronized peer.
+    WeaveFabricStateTestObject::UsePeer(sFabricState, kNewNodeId);
+    NL_TEST_ASSERT(inSuite, HasPeer(kNewNodeId));
+    NL_TEST_ASSERT(inSuite, !HasPeer(kPeerStateNodeIdBase + kNumSynchronized));
+    for (uint64_t i = 0; i < kNumSynchronized; i++)
+        NL_TEST_ASSERT(inSuite, HasPeer(kPeerStateNodeIdBase + i));
+
+    // Once every peer is synchronized, the least recently used peer is replaced.
+    for (uint64_t i = 0; i < WEAVE_CONFIG_MAX_PEER_NODES; i++)
+        WeaveFabricStateTestObject::SetPeerSynchronized(sFabricState, kPeerStateNodeIdBase + i);
+    WeaveFabricStateTestObject::SetPeerSynchronized(sFabricState, kNewNodeId);
+
+    WeaveFabricStateTestObject::UsePeer(sFabricState, kNewNodeId + 1);
+    NL_TEST_ASSERT(inSuite, HasPeer(kNewNodeId + 1));
+    NL_TEST_ASSERT(inSuite, !HasPeer(kPeerStateNodeIdBase));
+    NL_TEST_ASSERT(inSuite, HasPeer(kNewNodeId));
+    NL_TEST_ASSERT(inSuite, WeaveFabricStateTestObject::PeerCount(sFabricState) == WEAVE_CONFIG_MAX_PEER_NODES);
+}
+#endif // WEAVE_CONFIG_USE_APP_GROUP_KEYS_FOR_MSG_ENC
+
 /**
  *  Set up the test suite.
  */
@@ -131,6 +482,15 @@ static const nlTest sTests[] =
     // more thorough collection of tests should be written.
     NL_TEST_DEF("WeaveFabricState::SelectNodeAddress", CheckSelectNodeAddress),
     NL_TEST_DEF("WeaveFabricState::SelectNodeAddress", CheckSelectNodeAddressWithSubnet),
+    NL_TEST_DEF("WeaveFabricState::SessionKeys", CheckSessionKeys),
+#if WEAVE_CONFIG_WRMP_ADAPTIVE_RETRANS_TIMEOUT
+    NL_TEST_DEF("WeaveFabricState::PeerRTT", CheckPeerRTT),
+#endif
+    NL_TEST_DEF("WeaveFabricState::PeerStateCollisions", CheckPeerStateCollisions),
+    NL_TEST_DEF("WeaveFabricState::PeerStateEviction", CheckPeerStateEviction),
+#if WEAVE_CONFIG_USE_APP_GROUP_KEYS_FOR_MSG_ENC
+    NL_TEST_DEF("WeaveFabricState::PeerStateUnsynchronizedEviction", CheckPeerStateUnsynchronizedEviction),
+#endif
     NL_TEST_SENTINEL()
 };
 
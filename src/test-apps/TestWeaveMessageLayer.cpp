@@ -32,6 +32,12 @@
 
 #define TOOL_NAME "TestWeaveMessageLayer"
 
+// Builds that run the duplicate detection stress test as a check set this to
+// the number of messages to stress it with when run without arguments.
+#ifndef TEST_DUP_STRESS_DEFAULT_COUNT
+#define TEST_DUP_STRESS_DEFAULT_COUNT 0
+#endif
+
 static bool HandleOption(const char *progName, OptionSet *optSet, int id, const char *name, const char *arg);
 static bool HandleNonOptionArgs(const char *progName, int argc, char *argv[]);
 static void DriveSending();
@@ -44,6 +50,13 @@ static void HandleConnectionReceived(WeaveMessageLayer *msgLayer, WeaveConnectio
 static void HandleConnectionComplete(WeaveConnection *con, WEAVE_ERROR conErr);
 static void HandleOutboundConnectionClosed(WeaveConnection *con, WEAVE_ERROR err);
 static void HandleInboundConnectionClosed(WeaveConnection *con, WEAVE_ERROR err);
+static void HandleSendBackpressure(WeaveConnection *con, bool paused);
+static bool RunDuplicateDetectionStress(uint32_t msgCount);
+
+enum
+{
+    kToolOpt_DupStress              = 1000
+};
 
 
 bool SendMsgs = false;
@@ -55,6 +68,7 @@ int32_t SendInterval = 1000000;
 int32_t SendLength = -1;
 bool UseTCP = false;
 bool UseSessionKey = false;
+int32_t DupStressCount = TEST_DUP_STRESS_DEFAULT_COUNT;
 
 static OptionDef gToolOptionDefs[] =
 {
@@ -63,6 +77,7 @@ static OptionDef gToolOptionDefs[] =
     { "length",             kArgumentRequired,  'l' },
     { "interval",           kArgumentRequired,  'i' },
     { "tcp",                kNoArgument,        't' },
+    { "dup-stress",         kArgumentRequired,  kToolOpt_DupStress },
 #if WEAVE_CONFIG_SECURITY_TEST_MODE
     { "use-session-key",    kNoArgument,        'S' },
 #endif
@@ -86,6 +101,11 @@ static const char *gToolOptionHelp =
     "  -t, --tcp\n"
     "       Use TCP to send weave messages. Defaults to using UDP.\n"
     "\n"
+    "  --dup-stress <num>\n"
+    "       Check duplicate message detection by passing the specified number of\n"
+    "       message ids, delivered out of order and with replays, through the\n"
+    "       receive state for the destination node, then exit.\n"
+    "\n"
 #if WEAVE_CONFIG_SECURITY_TEST_MODE
     "  -S, --use-session-key\n"
     "       Use a session key when encrypting weave messages.\n"
@@ -143,6 +163,17 @@ int main(int argc, char *argv[])
 
     PrintNodeConfig();
 
+    if (DupStressCount > 0)
+    {
+        bool passed = RunDuplicateDetectionStress((uint32_t) DupStressCount);
+
+        ShutdownWeaveStack();
+        ShutdownNetwork();
+        ShutdownSystemLayer();
+
+        return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
     if (!SendMsgs)
         printf("Waiting for incoming messages...\n");
 
@@ -199,6 +230,13 @@ bool HandleOption(const char *progName, OptionSet *optSet, int id, const char *n
         }
         SendInterval = SendInterval * 1000;
         break;
+    case kToolOpt_DupStress:
+        if (!ParseInt(arg, DupStressCount) || DupStressCount <= 0)
+        {
+            PrintArgError("%s: Invalid value specified for duplicate detection message count: %s\n", progName, arg);
+            return false;
+        }
+        break;
     case 'D':
         if (!ParseIPAddress(arg, DestAddr))
         {
@@ -282,6 +320,7 @@ void DriveSending()
             con->OnConnectionClosed = HandleOutboundConnectionClosed;
             con->OnMessageReceived = HandleMessageReceived;
             con->OnReceiveError = HandleReceiveError;
+            con->OnSendBackpressure = HandleSendBackpressure;
 
             res = con->Connect(DestNodeId, DestAddr);
             if (res != WEAVE_NO_ERROR)
@@ -292,7 +331,7 @@ void DriveSending()
             }
         }
 
-        if (con->State != WeaveConnection::kState_Connected)
+        if (con->State != WeaveConnection::kState_Connected || con->IsSendPaused())
             return;
 
         msgBuf = MakeWeaveMessage(&msgInfo);
@@ -482,3 +521,87 @@ void HandleInboundConnectionClosed(WeaveConnection *con, WEAVE_ERROR err)
     HandleOutboundConnectionClosed(con, err);
     con->Close();
 }
+
+void HandleSendBackpressure(WeaveConnection *con, bool paused)
+{
+    WeaveMessageLayer::ConnectionBufferStats stats;
+
+    MessageLayer.GetConnectionBufferStats(stats);
+
+    printf("Sending %s on connection to node %" PRIX64 " (%" PRIu32 " bytes queued, %" PRIu32 " in total)\n",
+           paused ? "paused" : "resumed", con->PeerNodeId, con->PendingSendLength(), stats.PendingSendLength);
+}
+
+/**
+ *  Pass message ids through the duplicate detection state of the destination node, as they would be received
+ *  over a link that reorders messages by up to the number that duplicate detection tracks, with messages
+ *  already received delivered again at random. The ids start just short of wrapping. Every new message must
+ *  be accepted and every replay rejected.
+ */
+bool RunDuplicateDetectionStress(uint32_t msgCount)
+{
+#if WEAVE_CONFIG_MSG_ID_RCV_WINDOW_SIZE
+    enum { kReorderSpan = WEAVE_CONFIG_MSG_ID_RCV_WINDOW_SIZE - 1 };
+#else
+    enum { kReorderSpan = WeaveSessionState::kReceiveFlags_NumMessageIdFlags };
+#endif
+    WEAVE_ERROR err;
+    WeaveSessionState sessionState;
+    uint16_t keyId = WeaveKeyId::kNone;
+    uint8_t encType = kWeaveEncryptionType_None;
+    uint32_t block[kReorderSpan];
+    uint32_t firstMsgId = UINT32_MAX - (msgCount / 2);
+    uint32_t numMisflagged = 0, numReplaysAccepted = 0, numReplays = 0;
+
+#if WEAVE_CONFIG_SECURITY_TEST_MODE
+    if (UseSessionKey)
+    {
+        keyId = sTestDefaultUDPSessionKeyId;
+        encType = kWeaveEncryptionType_AES128CTRSHA1;
+    }
+#endif
+
+    err = FabricState.GetSessionState(DestNodeId, keyId, encType, NULL, sessionState);
+    if (err != WEAVE_NO_ERROR)
+    {
+        printf("GetSessionState failed: %s\n", ErrorStr(err));
+        return false;
+    }
+
+    // The first message received synchronizes the receive state.
+    sessionState.IsDuplicateMessage(firstMsgId - 1);
+
+    for (uint32_t i = 0; i < msgCount; i += kReorderSpan)
+    {
+        uint32_t blockLen = (msgCount - i < kReorderSpan) ? msgCount - i : kReorderSpan;
+
+        for (uint32_t j = 0; j < blockLen; j++)
+            block[j] = firstMsgId + i + j;
+
+        for (uint32_t j = blockLen; j > 1; j--)
+        {
+            uint32_t k = (uint32_t) (random() % j);
+            uint32_t tmp = block[j - 1];
+            block[j - 1] = block[k];
+            block[k] = tmp;
+        }
+
+        for (uint32_t j = 0; j < blockLen; j++)
+        {
+            if (sessionState.IsDuplicateMessage(block[j]))
+                numMisflagged++;
+
+            if ((random() % 4) == 0)
+            {
+                numReplays++;
+                if (!sessionState.IsDuplicateMessage(block[random() % (j + 1)]))
+                    numReplaysAccepted++;
+            }
+        }
+    }
+
+    printf("Duplicate detection: %" PRIu32 " messages, %" PRIu32 " misflagged as duplicates, %" PRIu32 " of %" PRIu32 " replays accepted\n",
+           msgCount, numMisflagged, numReplaysAccepted, numReplays);
+
+    return numMisflagged == 0 && numReplaysAccepted == 0;
+}
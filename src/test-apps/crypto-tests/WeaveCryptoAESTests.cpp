@@ -22,12 +22,15 @@
  *
  */
 
+#include <stdio.h>
 #include <string.h>
+#include <time.h>
 
 #include <nlunit-test.h>
 
 #include <Weave/Support/crypto/AESBlockCipher.h>
 #include <Weave/Support/crypto/CTRMode.h>
+#include <Weave/Support/crypto/HMAC.h>
 
 #include "WeaveCryptoTests.h"
 
@@ -402,11 +405,65 @@ static void Check_AES256BlockCipher_Test1(nlTestSuite *inSuite, void *inContext)
     NL_TEST_ASSERT(inSuite, res == true);
 }
 
+static void Check_AES128CTRMode_WithMAC(nlTestSuite *inSuite, void *inContext)
+{
+    static uint8_t key[]          = { 0x76, 0x91, 0xBE, 0x03, 0x5E, 0x50, 0x20, 0xA8, 0xAC, 0x6E, 0x61, 0x85, 0x29, 0xF9, 0xA0, 0xDC };
+    static uint8_t integrityKey[] = { 0x0B, 0x0B, 0x0B, 0x0B, 0x0B, 0x0B, 0x0B, 0x0B, 0x0B, 0x0B, 0x0B, 0x0B, 0x0B, 0x0B, 0x0B, 0x0B,
+                                      0x0B, 0x0B, 0x0B, 0x0B };
+    static uint64_t nodeId        = 0x18B43000001E8687ULL;
+    static uint32_t msgId         = 42;
+    uint8_t plainText[1000];
+    uint8_t expectedCipherText[sizeof(plainText)];
+    uint8_t cipherText[sizeof(plainText)];
+    uint8_t expectedMAC[HMACSHA1::kDigestLength];
+    uint8_t mac[HMACSHA1::kDigestLength];
+
+    for (size_t i = 0; i < sizeof(plainText); i++)
+        plainText[i] = (uint8_t)(i * 7 + 3);
+
+    for (uint16_t dataLen = 0; dataLen <= sizeof(plainText); dataLen += 37)
+    {
+        AES128CTRMode aes128CTR;
+        HMACSHA1 hmacSHA1;
+
+        // Compute the expected result by hashing and encrypting in separate passes.
+        hmacSHA1.Begin(integrityKey, sizeof(integrityKey));
+        hmacSHA1.AddData(plainText, dataLen);
+        hmacSHA1.Finish(expectedMAC);
+        aes128CTR.SetKey(key);
+        aes128CTR.SetWeaveMessageCounter(nodeId, msgId);
+        aes128CTR.EncryptData(plainText, dataLen, expectedCipherText);
+
+        // Hash and encrypt in a single pass.
+        hmacSHA1.Begin(integrityKey, sizeof(integrityKey));
+        aes128CTR.Reset();
+        aes128CTR.SetKey(key);
+        aes128CTR.SetWeaveMessageCounter(nodeId, msgId);
+        aes128CTR.EncryptDataWithMAC(plainText, dataLen, cipherText, hmacSHA1);
+        hmacSHA1.Finish(mac);
+
+        NL_TEST_ASSERT(inSuite, memcmp(cipherText, expectedCipherText, dataLen) == 0);
+        NL_TEST_ASSERT(inSuite, memcmp(mac, expectedMAC, sizeof(mac)) == 0);
+
+        // Decrypt and hash in place in a single pass.
+        hmacSHA1.Begin(integrityKey, sizeof(integrityKey));
+        aes128CTR.Reset();
+        aes128CTR.SetKey(key);
+        aes128CTR.SetWeaveMessageCounter(nodeId, msgId);
+        aes128CTR.DecryptDataWithMAC(cipherText, dataLen, cipherText, hmacSHA1);
+        hmacSHA1.Finish(mac);
+
+        NL_TEST_ASSERT(inSuite, memcmp(cipherText, plainText, dataLen) == 0);
+        NL_TEST_ASSERT(inSuite, memcmp(mac, expectedMAC, sizeof(mac)) == 0);
+    }
+}
+
 static const nlTest sTests[] = {
     NL_TEST_DEF("AES128CTRMode Test1",        Check_AES128CTRMode_Test1),
     NL_TEST_DEF("AES128CTRMode Test2",        Check_AES128CTRMode_Test2),
     NL_TEST_DEF("AES128CTRMode Test3",        Check_AES128CTRMode_Test3),
     NL_TEST_DEF("AES128CTRMode Test4",        Check_AES128CTRMode_Test4),
+    NL_TEST_DEF("AES128CTRMode WithMAC",      Check_AES128CTRMode_WithMAC),
     NL_TEST_DEF("AES256CTRMode Test1",        Check_AES256CTRMode_Test1),
     NL_TEST_DEF("AES256CTRMode Test2",        Check_AES256CTRMode_Test2),
     NL_TEST_DEF("AES256CTRMode Test3",        Check_AES256CTRMode_Test3),
@@ -428,3 +485,77 @@ int WeaveCryptoAESTests(void)
 
     return nlTestRunnerStats(&theSuite);
 }
+
+static double BenchmarkNow(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/*
+ * Measure the throughput of AES-128-CTR encryption with an HMAC-SHA1 integrity check, as
+ * used for Weave message encryption, comparing separate hash and encrypt passes over the
+ * message with the combined single-pass operation.
+ */
+int WeaveCryptoAESBenchmark(void)
+{
+    static const uint16_t kMessageSizes[] = { 64, 256, 1024, 1400, 8192 };
+    static const uint32_t kTotalBytes = 64 * 1024 * 1024;
+    static uint8_t key[AES128BlockCipher::kKeyLength] = { 0 };
+    static uint8_t integrityKey[HMACSHA1::kDigestLength] = { 0 };
+    static uint8_t msgBuf[8192 + HMACSHA1::kDigestLength];
+    HMACSHA1 hmacSHA1;
+
+    printf("%-8s %16s %16s %16s\n", "size", "aes-ctr MB/s", "separate MB/s", "combined MB/s");
+
+    for (size_t i = 0; i < sizeof(kMessageSizes) / sizeof(kMessageSizes[0]); i++)
+    {
+        uint16_t msgLen = kMessageSizes[i];
+        uint32_t iterations = kTotalBytes / msgLen;
+        double start, ctrTime, separateTime, combinedTime;
+
+        start = BenchmarkNow();
+        for (uint32_t n = 0; n < iterations; n++)
+        {
+            AES128CTRMode aes128CTR;
+            aes128CTR.SetKey(key);
+            aes128CTR.SetWeaveMessageCounter(0x18B43000001E8687ULL, n);
+            aes128CTR.EncryptData(msgBuf, msgLen, msgBuf);
+        }
+        ctrTime = BenchmarkNow() - start;
+
+        start = BenchmarkNow();
+        for (uint32_t n = 0; n < iterations; n++)
+        {
+            hmacSHA1.Begin(integrityKey, sizeof(integrityKey));
+            hmacSHA1.AddData(msgBuf, msgLen);
+            hmacSHA1.Finish(msgBuf + msgLen);
+            AES128CTRMode aes128CTR;
+            aes128CTR.SetKey(key);
+            aes128CTR.SetWeaveMessageCounter(0x18B43000001E8687ULL, n);
+            aes128CTR.EncryptData(msgBuf, msgLen + HMACSHA1::kDigestLength, msgBuf);
+        }
+        separateTime = BenchmarkNow() - start;
+
+        start = BenchmarkNow();
+        for (uint32_t n = 0; n < iterations; n++)
+        {
+            AES128CTRMode aes128CTR;
+            hmacSHA1.Begin(integrityKey, sizeof(integrityKey));
+            aes128CTR.SetKey(key);
+            aes128CTR.SetWeaveMessageCounter(0x18B43000001E8687ULL, n);
+            aes128CTR.EncryptDataWithMAC(msgBuf, msgLen, msgBuf, hmacSHA1);
+            hmacSHA1.Finish(msgBuf + msgLen);
+            aes128CTR.EncryptData(msgBuf + msgLen, HMACSHA1::kDigestLength, msgBuf + msgLen);
+        }
+        combinedTime = BenchmarkNow() - start;
+
+        printf("%-8u %16.1f %16.1f %16.1f\n", msgLen,
+               kTotalBytes / ctrTime / 1e6, kTotalBytes / separateTime / 1e6, kTotalBytes / combinedTime / 1e6);
+    }
+
+    return 0;
+}
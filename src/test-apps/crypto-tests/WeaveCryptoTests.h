@@ -52,4 +52,9 @@ int WeaveCryptoHKDFTests(void);
  */
 int WeaveCryptoAESTests(void);
 
+/*
+ * Throughput benchmark for AES-CTR message encryption.
+ */
+int WeaveCryptoAESBenchmark(void);
+
 #endif /* WEAVE_CRYPTO_TESTS_H_ */
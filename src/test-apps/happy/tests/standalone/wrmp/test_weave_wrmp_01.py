@@ -37,6 +37,9 @@ import WeaveStateUnload
 import WeaveWRMP
 import WeaveUtilities
 
+# The number of tests in the TestWRMP table, run by their numbers 1 to WRMP_TEST_COUNT.
+WRMP_TEST_COUNT = 20
+
 
 class test_weave_wrmp(unittest.TestCase):
     def setUp(self):
@@ -95,7 +98,7 @@ class test_weave_wrmp(unittest.TestCase):
                 print "Skip WRMP test on client and server running on the same node."
                 continue
 
-            for t in range(1,17):
+            for t in range(1, WRMP_TEST_COUNT + 1):
                 value, data = self.__run_wrmp_test_between(pair[0], pair[1], t)
                 self.__process_result(pair[0], pair[1], value, data, t)
 
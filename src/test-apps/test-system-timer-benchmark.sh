@@ -0,0 +1,31 @@
+#!/bin/sh
+
+
+#
+#    Copyright (c) 2018 Google LLC.
+#    All rights reserved.
+#
+#    Licensed under the Apache License, Version 2.0 (the "License");
+#    you may not use this file except in compliance with the License.
+#    You may obtain a copy of the License at
+#
+#        http://www.apache.org/licenses/LICENSE-2.0
+#
+#    Unless required by applicable law or agreed to in writing, software
+#    distributed under the License is distributed on an "AS IS" BASIS,
+#    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#    See the License for the specific language governing permissions and
+#    limitations under the License.
+#
+
+
+
+# The feature test build enables the timer wheel, with a timer pool large
+# enough for the benchmark to arm every timer it asks for.
+
+program="${builddir}/TestSystemTimerFeatures"
+
+${program} --benchmark 10000
+if test ${?} -ne 0 ; then
+    exit -1
+fi